@@ -23,20 +23,83 @@ DEFAULT_CONFIG ?= jenkins-common-8w-lockableDB.cfg
 # Number of elements in EDT local storage
 # CFLAGS += -DELS_USER_SIZE=0
 
+# **** Legacy extension parameters (ENABLE_EXTENSION_LEGACY) ****
+
+# Time a thread blocked in ocrLegacyBlockProgress sleeps on the event
+# before calling into the runtime to help it progress
+# CFLAGS += -DLEGACY_WAIT_PROGRESS_US=1000
+
+# **** Workers Parameters ****
+
+# Impl-specific for HC workers running EDTs on fibers (x86-64 only). By
+# default a blocked EDT runs other EDTs on top of its own stack (helper
+# mode). With fibers, it is suspended and its worker goes on with other EDTs.
+# CFLAGS += -DENABLE_WORKER_HC_FIBER
+# - Size of each fiber's stack in bytes
+# CFLAGS += -DHC_FIBER_STACK_SIZE=8388608
+# - Maximum number of idle fibers each worker keeps for reuse
+# CFLAGS += -DHC_FIBER_POOL_MAX=16
+
+# Impl-specific for HC comm-workers
+# - Maximum number of outgoing and incoming messages handled per work shift
+# CFLAGS += -DHC_COMM_WORKER_MSG_BATCH=32
+
 # **** Workpiles Parameters ****
 
 # Impl-specific for Work-stealing deques
-# - Static size for deques used to contain EDTs
+# - Static size for locked and non-concurrent deques
 # CFLAGS += -DINIT_DEQUE_CAPACITY=2048
+# - Initial and minimal size of the growable work-stealing
+#   deques used to contain EDTs (must be a power of two)
+# CFLAGS += -DINIT_WST_DEQUE_CAPACITY=256
+# - Initial and minimal size of the growable binary heaps
+#   used by the priority scheduler objects
+# CFLAGS += -DINIT_BIN_HEAP_CAPACITY=256
+
+# **** Scheduler Parameters ****
+
+# Impl-specific for the HC scheduler heuristic idle policy. Set
+# OCR_SCHED_STATS at run time to print the time each worker spent
+# stealing and parked at shutdown.
+# - Failed work requests before a worker starts backing off (cpu pause)
+# CFLAGS += -DHC_SCHED_IDLE_SPIN_COUNT=64
+# - Failed work requests with back-off before a worker parks
+# CFLAGS += -DHC_SCHED_IDLE_BACKOFF_COUNT=64
+# - Maximum time a worker stays parked (0 disables parking)
+# CFLAGS += -DHC_SCHED_IDLE_PARK_TIMEOUT_US=1000
+# - Maximum number of parked workers woken up per ready EDT
+# CFLAGS += -DHC_SCHED_IDLE_WAKE_COUNT=1
+
+# Impl-specific for the HC scheduler heuristic steal policy. Victims are
+# tried from the closest to the farthest (same core, same last level
+# cache, same socket, remote) when workers are bound to CPUs.
+# - Number of EDTs taken per successful steal at each level (0 takes half)
+# CFLAGS += -DHC_SCHED_STEAL_SIZE_SMT=1
+# CFLAGS += -DHC_SCHED_STEAL_SIZE_LLC=1
+# CFLAGS += -DHC_SCHED_STEAL_SIZE_SOCKET=1
+# CFLAGS += -DHC_SCHED_STEAL_SIZE_REMOTE=0
+
+# Impl-specific for the HC_LOCALITY scheduler heuristic
+# - Number of DBs whose last writing worker is remembered (must be a power of two)
+# CFLAGS += -DHC_LOCALITY_WRITER_TABLE_SIZE=4096
+
+# Impl-specific for the PR_MQ relaxed priority scheduler object
+# - Default number of heaps per worker when the config does not set
+#   'relax' (0 uses a single heap and keeps strict priority order)
+# CFLAGS += -DPR_MQ_RELAX_FACTOR=2
 
 # **** Events Parameters ****
 
 # Initialisation size for statically allocated HC event's waiter array
 # CFLAGS += -DHCEVT_WAITER_STATIC_COUNT=4
 
-# Initialisation size for dynamically allocated HC event's waiter array
+# Size of the first dynamically allocated chunk of an HC event's waiters;
+# each subsequent chunk doubles in size
 # CFLAGS += -DHCEVT_WAITER_DYNAMIC_COUNT=4
 
+# Number of dynamic waiters satisfied per runtime EDT when an event fans out
+# CFLAGS += -DHCEVT_SATISFY_BATCH=256
+
 # **** GUID-Provider Parameters ****
 
 # All impl-specific for counted-map and labeled-guid providers
@@ -52,6 +115,24 @@ CFLAGS += -DGUID_PROVIDER_LOCID_SIZE=10
 #   Warning: Necessitates an additional -D activating the alternate implementation
 # CFLAGS += -DGUID_PROVIDER_CUSTOM_MAP -D_TODO_FILL_ME_IN
 
+# Impl-specific for the hybrid guid provider ('type = HYBRID')
+# - Number of GUID bits holding the slot index, the remaining
+#   counter bits hold the slot generation
+# CFLAGS += -DGUID_PROVIDER_INDEX_SIZE=26
+# - Slots are allocated by chunks of 2^GUID_PROVIDER_SLOT_CHUNK_LOG2
+# CFLAGS += -DGUID_PROVIDER_SLOT_CHUNK_LOG2=12
+# - Number of free slots moved at once between a worker and the shared free list
+# CFLAGS += -DGUID_PROVIDER_SLOT_BATCH=64
+
+# Impl-specific for the resizable hashmap ('maptype = RESIZABLE')
+# - Number of locks serializing writers
+# CFLAGS += -DHASHTABLE_RESIZABLE_NB_LOCKS=1024
+# - Number of slots migrated per operation while resizing
+# CFLAGS += -DHASHTABLE_RESIZABLE_MIGRATE_CHUNK=64
+# - Number of counters operations register with, so that migrated tables
+#   can be freed once no operation uses them anymore
+# CFLAGS += -DHASHTABLE_RESIZABLE_NB_READERS=32
+
 # **** EDTs parameters ****
 
 # Maximum number of blocks of 64 slots that an EDT
@@ -59,6 +140,95 @@ CFLAGS += -DGUID_PROVIDER_LOCID_SIZE=10
 # multiple slots
 # CFLAGS += -DOCR_MAX_MULTI_SLOT=1
 
+# Largest number of dependences for which an EDT's DBs are
+# ordered with an insertion sort rather than a radix sort
+# CFLAGS += -DOCR_EDT_SORT_INSERTION_MAX=32
+
+# Per EDT function execution statistics (ENABLE_EDT_STATS, on by default
+# on x86). Set OCR_EDT_STATS=csv or json at run time to dump them at
+# shutdown, or query them with ocrQuery(OCR_QUERY_EDT_STATS, ...).
+# - Turn the collection off
+# CFLAGS += -DDISABLE_EDT_STATS
+# - Number of distinct EDT functions tracked per worker (power of 2)
+# CFLAGS += -DEDT_STATS_TABLE_SIZE=256
+
+# **** Allocator parameters ****
+
+# Per worker caches of small runtime objects (ENABLE_SLAB_CACHE, on by
+# default on x86). Set OCR_SLAB_STATS at run time to print their
+# statistics at shutdown.
+# - Turn the caches off
+# CFLAGS += -DDISABLE_SLAB_CACHE
+# - Size of the pages objects are carved from (in bytes)
+# CFLAGS += -DSLAB_CACHE_PAGE_SIZE=32768
+# - Objects up to 2^SLAB_CACHE_MAX_SIZE_LOG2 bytes are cached
+# CFLAGS += -DSLAB_CACHE_MAX_SIZE_LOG2=11
+# - Empty pages each size class keeps, the others go back to the allocator
+# CFLAGS += -DSLAB_CACHE_CLASS_MAX_EMPTY_PAGES=2
+
+# NUMA placement of datablocks by the HC policy domain, when its allocators
+# sit on numa_alloc mem-platforms bound to nodes ('numa_node' in the
+# config). Set OCR_NUMA_STATS at run time to print the DBs allocated on
+# each node at shutdown.
+# - 0: node of the creating worker, 1: interleave, 2: first touch
+# CFLAGS += -DHC_DB_NUMA_PLACEMENT=0
+
+# **** Datablock parameters ****
+
+# ocrDbCopy splits copies of at least twice this size (in bytes)
+# into chunks copied in parallel (at most one per worker)
+# CFLAGS += -DDB_COPY_CHUNK_SIZE=1048576
+
+# Background hal_memCopy of at least this size (in bytes) use
+# non-temporal stores on x86
+# CFLAGS += -DHAL_MEMCOPY_NT_MIN=262144
+
+# Distributed policy-domain: number of locks serializing the lookup
+# of proxies for remote DBs
+# CFLAGS += -DHCDIST_PROXY_DB_NB_LOCKS=64
+
+# Distributed policy-domain: number of released proxies for remote DBs
+# (and their data copy) kept for subsequent acquires (0 disables retention)
+# CFLAGS += -DHCDIST_PROXY_DB_RETAIN=128
+
+# Distributed policy-domain: number of remote DBs a PD keeps a read-only
+# copy of after their last local release, until the owner PD recalls it
+# (0 disables caching). Set OCR_DIST_STATS at run time to print the cache
+# hits, misses and invalidations of each PD at shutdown.
+# CFLAGS += -DHCDIST_PROXY_DB_CACHE=64
+
+# **** Comm-platform parameters ****
+
+# Size in bytes of the MPI comm-platform per-destination buffers that
+# aggregate one-way messages into a single MPI send (0 disables coalescing)
+# CFLAGS += -DMPI_COMM_COALESCE_SIZE=8192
+
+# Maximum time in nanoseconds a message waits in an MPI coalescing buffer
+# CFLAGS += -DMPI_COMM_COALESCE_AGE_NS=20000
+
+# DB payloads of at least this size (in bytes) are sent by the MPI
+# comm-platform straight from the DB instead of being copied in the
+# policy message (0 disables the rendezvous). Set OCR_DIST_STATS at run
+# time to print the payload bytes copied and sent without a copy.
+# CFLAGS += -DMPI_COMM_RDV_THRESHOLD=65536
+
+# Size in bytes of each ring of the shared-memory comm-platform
+# (one per ordered pair of PDs, must be a power of 2)
+# CFLAGS += -DSHM_COMM_RING_SIZE=262144
+
+# Size in bytes of each PD's heap in the shared memory segment
+# CFLAGS += -DSHM_COMM_HEAP_SIZE=1073741824
+
+# Smallest fragment a message is split in when it wraps around a ring
+# CFLAGS += -DSHM_COMM_FRAGMENT_MIN=256
+
+# **** Comp-platform parameters ****
+
+# Disables the initial-exec __thread fast path of the pthread
+# comp-platform and looks up the current environment through the
+# pthread key only. Needed if the runtime is dlopen'ed.
+# CFLAGS += -DCOMP_PLATFORM_PTHREAD_NO_TLS
+
 # **** Debugging parameters ****
 
 # Maximum number of characters handled by a single PRINTF
@@ -148,6 +318,10 @@ endif
 # (Primarily for LLNL tools inter-operability)
 # CFLAGS += -DOCR_TRACE_BINARY
 
+# Number of trace records buffered per worker before new ones are
+# dropped (power of 2), and size of the trace file write buffer
+# CFLAGS += -DTRACE_RING_CAPACITY=4096 -DTRACE_FLUSH_BUFFER_SIZE=1048576
+
 ####################################################
 # Experimental flags
 ####################################################
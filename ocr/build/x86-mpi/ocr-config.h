@@ -24,6 +24,10 @@
 #define ENABLE_ALLOCATOR_SIMPLE
 #define ENABLE_ALLOCATOR_QUICK
 #define ENABLE_ALLOCATOR_MALLOCPROXY
+// Per worker caches of small runtime objects in front of the allocators
+#ifndef DISABLE_SLAB_CACHE
+#define ENABLE_SLAB_CACHE
+#endif
 
 // Comm-api
 #define ENABLE_COMM_API_DELEGATE
@@ -54,6 +58,7 @@
 #define ENABLE_GUID_PTR
 #define ENABLE_GUID_COUNTED_MAP
 #define ENABLE_GUID_LABELED
+#define ENABLE_GUID_HYBRID
 
 // Hints
 #define ENABLE_HINTS
@@ -100,6 +105,7 @@
 #define ENABLE_SCHEDULER_OBJECT_DBTIME
 #define ENABLE_SCHEDULER_OBJECT_PR_WSH
 #define ENABLE_SCHEDULER_OBJECT_BIN_HEAP
+#define ENABLE_SCHEDULER_OBJECT_PR_MQ
 
 // Support for MPIlite blocking operations
 #ifndef DISABLE_EXTENSION_BLOCKING_SUPPORT
@@ -111,6 +117,10 @@
 
 // Task
 #define ENABLE_TASK_HC
+// Per EDT function execution statistics
+#ifndef DISABLE_EDT_STATS
+#define ENABLE_EDT_STATS
+#endif
 
 // Task template
 #define ENABLE_TASKTEMPLATE_HC
@@ -119,6 +129,9 @@
 #define ENABLE_WORKER_HC
 #define ENABLE_WORKER_HC_COMM
 #define ENABLE_WORKER_SYSTEM
+// Run EDTs on fibers so that blocked EDTs can be suspended (each
+// worker keeps up to HC_FIBER_POOL_MAX stacks mapped, see common.mk)
+//#define ENABLE_WORKER_HC_FIBER
 
 // Workpile
 #define ENABLE_WORKPILE_HC
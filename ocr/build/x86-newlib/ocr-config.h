@@ -53,6 +53,7 @@
 #define ENABLE_GUID_PTR
 #define ENABLE_GUID_COUNTED_MAP
 #define ENABLE_GUID_LABELED
+#define ENABLE_GUID_HYBRID
 
 // Hints
 #define ENABLE_HINTS
@@ -93,6 +94,7 @@
 #define ENABLE_SCHEDULER_OBJECT_DBTIME
 #define ENABLE_SCHEDULER_OBJECT_PR_WSH
 #define ENABLE_SCHEDULER_OBJECT_BIN_HEAP
+#define ENABLE_SCHEDULER_OBJECT_PR_MQ
 
 // Sysboot layer to use
 #define ENABLE_SYSBOOT_LINUX
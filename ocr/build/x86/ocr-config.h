@@ -24,6 +24,10 @@
 #define ENABLE_ALLOCATOR_SIMPLE
 #define ENABLE_ALLOCATOR_QUICK
 #define ENABLE_ALLOCATOR_MALLOCPROXY
+// Per worker caches of small runtime objects in front of the allocators
+#ifndef DISABLE_SLAB_CACHE
+#define ENABLE_SLAB_CACHE
+#endif
 
 // Comm-api
 #define ENABLE_COMM_API_HANDLELESS
@@ -53,6 +57,7 @@
 #define ENABLE_GUID_PTR
 #define ENABLE_GUID_COUNTED_MAP
 #define ENABLE_GUID_LABELED
+#define ENABLE_GUID_HYBRID
 
 // Hints
 #define ENABLE_HINTS
@@ -79,6 +84,7 @@
 // Scheduler Heuristic
 #define ENABLE_SCHEDULER_HEURISTIC_NULL
 #define ENABLE_SCHEDULER_HEURISTIC_HC
+#define ENABLE_SCHEDULER_HEURISTIC_HC_LOCALITY
 #define ENABLE_SCHEDULER_HEURISTIC_ST
 #define ENABLE_SCHEDULER_HEURISTIC_PRIORITY
 #define ENABLE_SCHEDULER_HEURISTIC_STATIC
@@ -94,12 +100,17 @@
 #define ENABLE_SCHEDULER_OBJECT_DBTIME
 #define ENABLE_SCHEDULER_OBJECT_PR_WSH
 #define ENABLE_SCHEDULER_OBJECT_BIN_HEAP
+#define ENABLE_SCHEDULER_OBJECT_PR_MQ
 
 // Sysboot layer to use
 #define ENABLE_SYSBOOT_LINUX
 
 // Task
 #define ENABLE_TASK_HC
+// Per EDT function execution statistics
+#ifndef DISABLE_EDT_STATS
+#define ENABLE_EDT_STATS
+#endif
 
 // Task template
 #define ENABLE_TASKTEMPLATE_HC
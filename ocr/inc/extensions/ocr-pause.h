@@ -41,7 +41,8 @@ u32 ocrPause(bool isBlocking);
  * caller's responsibility to destroy.
  *
  * @note If ocrQuery() gets called while runtime is not paused it will be
- * ignored.
+ * ignored, except for OCR_QUERY_EDT_STATS which returns the statistics
+ * gathered so far.
  *
  * @param[in] query     The type of query performed. See inc/ocr-types.h
  * @param[in] guid      Guid of previous <query type>, NULL_GUID for first
@@ -243,7 +243,11 @@ u8 ocrDbFreeOffset(ocrGuid_t guid, u64 offset);
  *      - EPERM: Overlapping data blocks
  *      - ENOMEM: Destination too small to copy into or source too small to copy from
  *
- * @note This call is not supported at this time.
+ * @note The copy runs in a runtime EDT that acquires the destination in
+ * DB_MODE_RW and the source in DB_MODE_RO; large copies may be split
+ * across several EDTs. 'completionEvt' is a sticky event that the caller
+ * is responsible for destroying. The bounds of the copy are not checked
+ * when the call is made and ENOMEM is never returned at this time.
  */
 u8 ocrDbCopy(ocrGuid_t destination, u64 destinationOffset, ocrGuid_t source,
              u64 sourceOffset, u64 size, u64 copyType, ocrGuid_t * completionEvt);
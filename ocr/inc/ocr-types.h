@@ -358,6 +358,7 @@ typedef enum {
     OCR_HINT_DB_INTER,                      /* [u64] : Prefer intermediate memory if possible */
     OCR_HINT_DB_FAR,                        /* [u64] : Prefer far memory if possible */
     OCR_HINT_DB_HIGHBW,                     /* [u64] : Prefer high bandwidth memory if possible */
+    OCR_HINT_DB_NUMA_NODE,                  /* [u64] : NUMA node to allocate the DB on, if the PD has memory on that node */
     OCR_HINT_DB_PROP_END,                   /* This is NOT a hint. Its use is reserved for the runtime */
 
     //EVT Hint Properties                   (OCR_HINT_EVT_T)
@@ -410,8 +411,33 @@ typedef enum {
     OCR_QUERY_EVENTS,
     OCR_QUERY_LAST_SATISFIED_DB,
     OCR_QUERY_ALL_EDTS,
+    OCR_QUERY_EDT_STATS,  /**< Per EDT function execution statistics (ocrEdtStats_t array).
+                               Answered whether or not the runtime is paused */
 } ocrQueryType_t;
 
+/**
+ * @brief Number of buckets of the execution time histogram of ocrEdtStats_t
+ */
+#define OCR_EDT_STATS_HISTOGRAM_SIZE 16
+
+/**
+ * @brief Execution statistics of the EDTs running one function
+ *
+ * All times are in nanoseconds. Bucket 0 of the histogram counts the
+ * executions shorter than 1us, bucket i the ones in [2^(i-1), 2^i) us
+ * and the last bucket all the longer ones.
+ */
+typedef struct {
+    ocrEdt_t funcPtr;       /**< Function the EDTs executed */
+    u64 count;              /**< Number of executions */
+    u64 totalTime;          /**< Sum of the execution times */
+    u64 minTime;            /**< Shortest execution */
+    u64 maxTime;            /**< Longest execution */
+    u64 readyTime;          /**< Sum of the times from the last dependence satisfied to the start */
+    u64 dbBytes;            /**< Sum of the sizes of the DBs acquired by the EDTs */
+    u64 histogram[OCR_EDT_STATS_HISTOGRAM_SIZE];
+} ocrEdtStats_t;
+
 
 /**
  * @brief OCR Trace Object types
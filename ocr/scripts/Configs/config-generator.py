@@ -12,26 +12,34 @@ import sys
 # 2. Read FSim machine config to spit out OCR-FSim configs
 
 parser = argparse.ArgumentParser(description='Generate an OCR config file.')
-parser.add_argument('--guid', dest='guid', default='PTR', choices=['PTR', 'COUNTED_MAP', 'LABELED'],
+parser.add_argument('--guid', dest='guid', default='PTR', choices=['PTR', 'COUNTED_MAP', 'LABELED', 'HYBRID'],
                    help='guid type to use (default: PTR)')
+parser.add_argument('--guidmap', dest='guidmap', default='BUCKET_LOCKED', choices=['BUCKET_LOCKED', 'RESIZABLE'],
+                   help='hashtable used by the COUNTED_MAP, LABELED and HYBRID guid providers (default: BUCKET_LOCKED)')
 parser.add_argument('--platform', dest='platform', default='X86', choices=['X86', 'FSIM'],
                    help='platform type to use (default: X86)')
-parser.add_argument('--target', dest='target', default='x86', choices=['x86', 'fsim', 'mpi', 'gasnet'],
+parser.add_argument('--target', dest='target', default='x86', choices=['x86', 'fsim', 'mpi', 'gasnet', 'shm'],
                    help='target type to use (default: X86)')
 parser.add_argument('--threads', dest='threads', type=int, default=4,
                    help='number of threads available to OCR (default: 4)')
+parser.add_argument('--commworkers', dest='commworkers', type=int, default=1,
+                   help='number of threads dedicated to communication in distributed targets (default: 1)')
 parser.add_argument('--binding', dest='binding', default='none', choices=['none', 'seq', 'block', 'spread'],
                    help='perform thread binding (default: no binding)')
 parser.add_argument('--sysworker', dest='sysworker', action='store_true',
                    help='use 1 worker exclusively for system activities (e.g., tracing) (default: no)')
 parser.add_argument('--alloc', dest='alloc', default='32',
                    help='size (in MB) of memory available for app use (default: 32)')
-parser.add_argument('--alloctype', dest='alloctype', default='mallocproxy', choices=['quick', 'mallocproxy', 'tlsf', 'simple'],
-                   help='type of allocator to use (default: mallocproxy)')
+parser.add_argument('--alloctype', dest='alloctype', default=None, choices=['quick', 'mallocproxy', 'tlsf', 'simple'],
+                   help='type of allocator to use (default: mallocproxy, tlsf for shm so that DBs live in shared memory)')
 parser.add_argument('--dbtype', dest='dbtype', default='Lockable', choices=['Lockable', 'Regular'],
                    help='type of datablocks to use (default: Lockable)')
-parser.add_argument('--scheduler', dest='scheduler', default='HC', choices=['HC', 'PRIORITY', 'PLACEMENT_AFFINITY', 'LEGACY', 'ST', 'STATIC'],
+parser.add_argument('--scheduler', dest='scheduler', default='HC', choices=['HC', 'HC_LOCALITY', 'PRIORITY', 'PLACEMENT_AFFINITY', 'LEGACY', 'ST', 'STATIC'],
                    help='scheduler heuristic (default: HC)')
+parser.add_argument('--prqueue', dest='prqueue', default='BIN_HEAP', choices=['BIN_HEAP', 'MULTIQUEUE'],
+                   help='ready queue to use with PRIORITY scheduler (default: BIN_HEAP)')
+parser.add_argument('--prrelax', dest='prrelax', type=int, default=-1,
+                   help='heaps per worker for the MULTIQUEUE ready queue, 0 keeps strict priority order (default: runtime default)')
 parser.add_argument('--dequetype', dest='dequetype', default='WORK_STEALING_DEQUE', choices=['WORK_STEALING_DEQUE', 'LOCKED_DEQUE'],
                    help='deque type to use with LEGACY scheduler (default: WORK_STEALING_DEQUE)')
 parser.add_argument('--output', dest='output', default='default.cfg',
@@ -42,16 +50,22 @@ parser.add_argument('--remove-destination', dest='rmdest', action='store_true',
 
 args = parser.parse_args()
 guid = args.guid
+guidmap = args.guidmap
 platform = args.platform
 target = args.target.upper()
 if target == 'GASNET':
     target = 'GASNet'
 threads = args.threads
+commworkers = args.commworkers
 binding = args.binding
 alloc = args.alloc
 alloctype = args.alloctype
+if alloctype == None:
+    alloctype = 'tlsf' if (target == 'SHM') else 'mallocproxy'
 dbtype = args.dbtype
 scheduler = args.scheduler
+prqueue = args.prqueue
+prrelax = args.prrelax
 dequetype = args.dequetype
 outputfilename = args.output
 rmdest = args.rmdest
@@ -59,15 +73,28 @@ sysworker = args.sysworker
 if sysworker == True and platform != 'X86':
     print 'Sysworker currently supported only with platform x86'
     sys.exit(0)
+if commworkers < 1 or (commworkers > 1 and target not in ['MPI', 'SHM']):
+    print 'Multiple comm workers currently supported only with targets mpi and shm'
+    sys.exit(0)
+if commworkers >= threads and target in ['MPI', 'GASNet', 'SHM']:
+    print 'At least one thread besides the comm workers is required'
+    sys.exit(0)
+
+def IdRange(first, last):
+    if first == last:
+        return "%d" % (first)
+    return "%d-%d" % (first, last)
 
 def GenerateVersion(output):
     version = "1.1.0"
     output.write("[General]\n\tversion\t=\t%s\n\n" % (version))
     output.write("\n#======================================================\n")
 
-def GenerateGuid(output, guid):
+def GenerateGuid(output, guid, guidmap):
     output.write("[GuidType0]\n\tname\t=\t%s\n\n" % (guid))
     output.write("[GuidInst0]\n\tid\t=\t%d\n\ttype\t=\t%s\n" % (0, guid))
+    if guid != 'PTR':
+        output.write("\tmaptype\t=\t%s\n" % (guidmap))
     output.write("\n#======================================================\n")
 
 def GeneratePd(output, pdtype, dbtype, threads):
@@ -123,24 +150,25 @@ def GenerateMem(output, size, count, alloctype):
 def GenerateComm(output, comms, pdtype, threads):
     output.write("\n#======================================================\n")
     if pdtype == 'HCDist':
+        # One comm-platform instance per comm worker, the others delegate to them
         output.write("[CommApiType0]\n\tname\t=\t%s\n" % ("Simple"))
         output.write("[CommApiInst0]\n")
-        output.write("\tid\t=\t0\n")
+        output.write("\tid\t=\t%s\n" % IdRange(0, commworkers-1))
         output.write("\ttype\t=\t%s\n" % ("Simple"))
-        output.write("\tcommplatform\t=\t0\n")
+        output.write("\tcommplatform\t=\t%s\n" % IdRange(0, commworkers-1))
         output.write("[CommApiType1]\n\tname\t=\t%s\n" % ("Delegate"))
         output.write("[CommApiInst1]\n")
-        output.write("\tid\t=\t1-%d\n" % (threads-1))
+        output.write("\tid\t=\t%d-%d\n" % (commworkers, threads-1))
         output.write("\ttype\t=\t%s\n" % ("Delegate"))
-        output.write("\tcommplatform\t=\t1-%d\n" % (threads-1))
+        output.write("\tcommplatform\t=\t%d-%d\n" % (commworkers, threads-1))
         output.write("\n#======================================================\n")
         output.write("[CommPlatformType0]\n\tname\t=\t%s\n" % ("None"))
         output.write("[CommPlatformInst0]\n")
-        output.write("\tid\t=\t1-%d\n" % (threads-1))
+        output.write("\tid\t=\t%d-%d\n" % (commworkers, threads-1))
         output.write("\ttype\t=\t%s\n" % ("None"))
         output.write("[CommPlatformType1]\n\tname\t=\t%s\n" % (comms))
         output.write("[CommPlatformInst1]\n")
-        output.write("\tid\t=\t0\n")
+        output.write("\tid\t=\t%s\n" % IdRange(0, commworkers-1))
         output.write("\ttype\t=\t%s\n" % (comms))
     else:
         output.write("[CommPlatformType0]\n\tname\t=\t%s\n" % ("None"))
@@ -215,24 +243,33 @@ def GenerateComp(output, pdtype, threads, binding, sysworker, schedtype):
     output.write("\ttype\t=\t%s\n" % (masterWorkerType))
     output.write("\tworkertype\t=\tmaster\n")
     output.write("\tcomptarget\t=\t0\n")
+    # Additional comm workers come right after the master one
+    firstSlave = commworkers if (pdtype == 'HCDist') else 1
+    if firstSlave > 1:
+        output.write("[WorkerInst1]\n")
+        output.write("\tid\t=\t%s\n" % IdRange(1, firstSlave-1))
+        output.write("\ttype\t=\t%s\n" % (masterWorkerType))
+        output.write("\tworkertype\t=\tslave\n")
+        output.write("\tcomptarget\t=\t%s\n" % IdRange(1, firstSlave-1))
+    slaveInst = 2 if (firstSlave > 1) else 1
     if threads > 1:
         if (pdtype == 'HCDist'): # Need a second type for distributed
             output.write("[WorkerType1]\n\tname\t=\tHC\n")
-        output.write("[WorkerInst1]\n")
+        output.write("[WorkerInst%d]\n" % (slaveInst))
         if sysworker:
-            output.write("\tid\t=\t1-%d\n" % (threads-2))
+            output.write("\tid\t=\t%d-%d\n" % (firstSlave, threads-2))
         else:
-            output.write("\tid\t=\t1-%d\n" % (threads-1))
+            output.write("\tid\t=\t%d-%d\n" % (firstSlave, threads-1))
         output.write("\ttype\t=\tHC\n")
         output.write("\tworkertype\t=\tslave\n")
         if sysworker:
-            output.write("\tcomptarget\t=\t1-%d\n" % (threads-2))
+            output.write("\tcomptarget\t=\t%d-%d\n" % (firstSlave, threads-2))
         else:
-            output.write("\tcomptarget\t=\t1-%d\n" % (threads-1))
+            output.write("\tcomptarget\t=\t%d-%d\n" % (firstSlave, threads-1))
 
         if sysworker:
             output.write("[WorkerType2]\n\tname\t=\tSYSTEM\n")
-            output.write("[WorkerInst2]\n")
+            output.write("[WorkerInst%d]\n" % (slaveInst+1))
             output.write("\tid\t=\t%d\n" % (threads-1))
             output.write("\ttype\t=\tSYSTEM\n")
             output.write("\tworkertype\t=\tsystem\n")
@@ -270,7 +307,7 @@ def GenerateComp(output, pdtype, threads, binding, sysworker, schedtype):
         output.write("\tname\t=\t%s\n" % ("NULL"))
         output.write("[SchedulerObjectType1]\n")
         output.write("\tname\t=\t%s\n" % ("WST"))
-        if scheduler == 'HC' or scheduler == 'PLACEMENT_AFFINITY' or scheduler == 'STATIC':
+        if scheduler in ['HC', 'HC_LOCALITY', 'PLACEMENT_AFFINITY', 'STATIC']:
             output.write("\tkind\t=\t%s\n" % ("root"))
             rootObj = 'WST'
         output.write("[SchedulerObjectType2]\n")
@@ -290,16 +327,26 @@ def GenerateComp(output, pdtype, threads, binding, sysworker, schedtype):
         output.write("\tname\t=\t%s\n" % ("DBTIME"))
         output.write("[SchedulerObjectType8]\n")
         output.write("\tname\t=\t%s\n" % ("PR_WSH"))
-        if scheduler == 'PRIORITY':
+        if scheduler == 'PRIORITY' and prqueue == 'BIN_HEAP':
             output.write("\tkind\t=\t%s\n" % ("root"))
             rootObj = 'PR_WSH'
         output.write("[SchedulerObjectType9]\n")
         output.write("\tname\t=\t%s\n" % ("BIN_HEAP"))
+        if scheduler == 'PRIORITY' and prqueue == 'MULTIQUEUE':
+            output.write("[SchedulerObjectType10]\n")
+            output.write("\tname\t=\t%s\n" % ("PR_MQ"))
+            output.write("\tkind\t=\t%s\n" % ("root"))
+            rootObj = 'PR_MQ'
         output.write("[SchedulerObjectInst0]\n")
         output.write("\tid\t\t=\t0\n")
         output.write("\ttype\t=\t%s\n" % (rootObj))
         if scheduler == 'STATIC':
             output.write("\tconfig\t=\t%s\n" % ("STATIC"))
+        if scheduler == 'HC_LOCALITY':
+            # Ready EDTs are pushed to other workers' deques
+            output.write("\tconfig\t=\t%s\n" % ("LOCKED"))
+        if rootObj == 'PR_MQ' and prrelax >= 0:
+            output.write("\trelax\t=\t%d\n" % (prrelax))
         output.write("\n#======================================================\n")
         if (pdtype == 'HCDist'):
             output.write("[SchedulerHeuristicType0]\n\tname\t=\t%s\n" % ("NULL"))
@@ -338,6 +385,7 @@ def GenerateComp(output, pdtype, threads, binding, sysworker, schedtype):
             output.write("[SchedulerHeuristicType2]\n\tname\t=\t%s\n" % ("ST"))
             output.write("[SchedulerHeuristicType3]\n\tname\t=\t%s\n" % ("PRIORITY"))
             output.write("[SchedulerHeuristicType4]\n\tname\t=\t%s\n" % ("STATIC"))
+            output.write("[SchedulerHeuristicType5]\n\tname\t=\t%s\n" % ("HC_LOCALITY"))
             output.write("[SchedulerHeuristicInst0]\n")
             output.write("\tid\t\t=\t0\n")
             output.write("\ttype\t=\t%s\n" % (scheduler))
@@ -365,7 +413,7 @@ def GenerateConfig(filehandle, guid, platform, target, threads, binding, syswork
     filehandle.write("# Generated by python script, modify as desired.\n")
     filehandle.write("# To use this config file, set OCR_CONFIG to the filename prior to running the OCR program.\n\n")
     GenerateVersion(filehandle)
-    GenerateGuid(filehandle, guid)
+    GenerateGuid(filehandle, guid, guidmap)
     if target=='X86':
         GeneratePd(filehandle, "HC", dbtype, threads)
         GenerateCommon(filehandle, "HC", dbtype)
@@ -377,14 +425,18 @@ def GenerateConfig(filehandle, guid, platform, target, threads, binding, syswork
         GeneratePd(filehandle, "XE", dbtype, threads)
         GenerateCommon(filehandle, "HC", dbtype)
         GenerateMem(filehandle, alloc, 1, alloctype)
-    elif (target=='MPI') or (target=='GASNet'):
+    elif (target=='MPI') or (target=='GASNet') or (target=='SHM'):
         # catch default value errors for distributed
         if dbtype != 'Lockable':
             print 'error: target ', target, ' only supports Lockable datablocks; received ', dbtype
             os.unlink(filehandle.name)
             raise
-        if guid != 'COUNTED_MAP' and guid != 'LABELED':
-            print 'error: target ', target, ' only supports counted-map guid provider; received ', guid
+        if scheduler == 'HC_LOCALITY':
+            print 'error: target ', target, ' does not support the HC_LOCALITY scheduler'
+            os.unlink(filehandle.name)
+            raise
+        if guid != 'COUNTED_MAP' and guid != 'LABELED' and guid != 'HYBRID':
+            print 'error: target ', target, ' only supports counted-map, labeled or hybrid guid providers; received ', guid
             os.unlink(filehandle.name)
             raise
         pdtype="HCDist"
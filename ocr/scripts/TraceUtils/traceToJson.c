@@ -0,0 +1,288 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ocr.h"
+#include "utils/tracer/tracer.h"
+#include "utils/tracer/trace-events.h"
+
+/*
+ * Converts a binary trace (trace.bin) to the Chrome trace-event JSON format,
+ * which chrome://tracing and Perfetto (ui.perfetto.dev) open directly.
+ *
+ * Each PD is a process and each worker a thread. EDT executions are
+ * duration slices (EXECUTE to FINISH on the same worker), everything else is
+ * an instant event on the worker that traced it.
+ */
+
+#define IDX_OFFSET OCR_TRACE_TYPE_EDT
+#define SYS_CALL_COMMAND_LENGTH 256
+#define SYMBOL_NAME_LENGTH 128
+#define MAX_THREADS 4096
+
+typedef struct {
+    unsigned long addr;
+    char name[SYMBOL_NAME_LENGTH];
+} symbol_t;
+
+typedef struct {
+    u64 location;
+    u64 workerId;
+} thread_t;
+
+static symbol_t *symbols = NULL;
+static int symbolCount = 0;
+static thread_t threads[MAX_THREADS];
+static int threadCount = 0;
+static int firstEvent = 1;
+
+static void readSymbols(char *binaryPath);
+static const char *symbolName(unsigned long addr);
+static void registerThread(u64 location, u64 workerId);
+static void printEvent(ocrTraceObj_t *trace, u64 baseTime);
+
+int main(int argc, char *argv[]){
+
+    if(argc != 3 && argc != 2){
+        fprintf(stderr, "\n-------- Incorrect Input ---------\n");
+        fprintf(stderr, "Usage: %s <filename>  optional : <application binary>\n\n", argv[0]);
+        return 1;
+    }
+
+    FILE *f = fopen(argv[1], "r");
+    if(f == NULL){
+        fprintf(stderr, "Error:  Unable to open provided trace binary\n");
+        return 1;
+    }
+
+    //Optional application binary to name EDT slices after their function
+    if(argc == 3){
+        readSymbols(argv[2]);
+    }
+
+    //First pass: records are flushed per worker so the file is not sorted,
+    //find the earliest timestamp and all the (PD, worker) pairs.
+    ocrTraceObj_t trace;
+    u64 baseTime = (u64)-1;
+    while(fread(&trace, sizeof(ocrTraceObj_t), 1, f)){
+        if(trace.time < baseTime)
+            baseTime = trace.time;
+        registerThread(trace.location, trace.workerId);
+    }
+
+    printf("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+
+    int i;
+    for(i = 0; i < threadCount; i++){
+        printf("%s{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":%lu,\"args\":{\"name\":\"PD 0x%lx\"}}",
+               firstEvent ? "" : ",\n", threads[i].location, threads[i].location);
+        firstEvent = 0;
+        printf(",\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%lu,\"tid\":%lu,\"args\":{\"name\":\"Worker %lu\"}}",
+               threads[i].location, threads[i].workerId, threads[i].workerId);
+    }
+
+    //Second pass: one JSON event per record
+    rewind(f);
+    while(fread(&trace, sizeof(ocrTraceObj_t), 1, f)){
+        printEvent(&trace, baseTime);
+    }
+
+    printf("\n]}\n");
+    fclose(f);
+    free(symbols);
+    return 0;
+}
+
+static void registerThread(u64 location, u64 workerId){
+    int i;
+    for(i = 0; i < threadCount; i++){
+        if(threads[i].location == location && threads[i].workerId == workerId)
+            return;
+    }
+    if(threadCount < MAX_THREADS){
+        threads[threadCount].location = location;
+        threads[threadCount].workerId = workerId;
+        threadCount++;
+    }
+}
+
+//Common part of all events: phase, name, category, timestamp in us and track
+static void printHeader(const char *phase, const char *name, const char *category,
+                        ocrTraceObj_t *trace, u64 baseTime){
+    u64 ns = trace->time - baseTime;
+    printf("%s{\"ph\":\"%s\",\"name\":\"%s\",\"cat\":\"%s,%s\",\"ts\":%lu.%03lu,\"pid\":%lu,\"tid\":%lu",
+           firstEvent ? "" : ",\n", phase, name, category, evt_type[trace->eventType],
+           ns / 1000, ns % 1000, trace->location, trace->workerId);
+    firstEvent = 0;
+}
+
+static void printInstant(const char *name, const char *category, ocrTraceObj_t *trace, u64 baseTime){
+    printHeader("i", name, category, trace, baseTime);
+    printf(",\"s\":\"t\"");
+}
+
+static void printEvent(ocrTraceObj_t *trace, u64 baseTime){
+
+    const char *category = obj_type[trace->typeSwitch - IDX_OFFSET];
+    char name[SYMBOL_NAME_LENGTH + 16];
+    snprintf(name, sizeof(name), "%s_%s", category, action_type[trace->actionSwitch]);
+
+    switch(trace->typeSwitch){
+
+    case OCR_TRACE_TYPE_EDT:
+
+        switch(trace->actionSwitch){
+
+            case OCR_ACTION_CREATE:
+                printInstant(name, category, trace, baseTime);
+                printf(",\"args\":{\"parent\":\""GUIDF"\"}}", GUIDA(TRACE_FIELD(TASK, taskCreate, trace, parentID)));
+                break;
+
+            case OCR_ACTION_SATISFY:
+                printInstant(name, category, trace, baseTime);
+                printf(",\"args\":{\"dep\":\""GUIDF"\"}}", GUIDA(TRACE_FIELD(TASK, taskDepSatisfy, trace, depID)));
+                break;
+
+            case OCR_ACTION_ADD_DEP:
+                printInstant(name, category, trace, baseTime);
+                printf(",\"args\":{\"dep\":\""GUIDF"\"}}", GUIDA(TRACE_FIELD(TASK, taskDepReady, trace, depID)));
+                break;
+
+            case OCR_ACTION_EXECUTE:
+            {
+                unsigned long funcPtr = (unsigned long)TRACE_FIELD(TASK, taskExeBegin, trace, funcPtr);
+                const char *symbol = symbolName(funcPtr);
+                if(symbol != NULL){
+                    snprintf(name, sizeof(name), "%s", symbol);
+                }else if(symbols != NULL){
+                    //Not in the application: a runtime EDT (processRequestEdt)
+                    snprintf(name, sizeof(name), "<runtime EDT>");
+                }else{
+                    snprintf(name, sizeof(name), "EDT 0x%lx", funcPtr);
+                }
+                printHeader("B", name, category, trace, baseTime);
+                printf(",\"args\":{\"funcPtr\":\"0x%lx\"}}", funcPtr);
+                break;
+            }
+
+            case OCR_ACTION_FINISH:
+                printHeader("E", "", category, trace, baseTime);
+                printf("}");
+                break;
+
+            case OCR_ACTION_DATA_ACQUIRE:
+            case OCR_ACTION_DATA_RELEASE:
+            {
+                //Both actions share the layout of their fields
+                ocrGuid_t edtGuid = TRACE_FIELD(TASK, taskDataAcquire, trace, taskGuid);
+                ocrGuid_t dbGuid = TRACE_FIELD(TASK, taskDataAcquire, trace, dbGuid);
+                u64 size = TRACE_FIELD(TASK, taskDataAcquire, trace, size);
+                printInstant(name, category, trace, baseTime);
+                printf(",\"args\":{\"edt\":\""GUIDF"\",\"db\":\""GUIDF"\",\"size\":%lu}}",
+                       GUIDA(edtGuid), GUIDA(dbGuid), size);
+                break;
+            }
+
+            default:
+                printInstant(name, category, trace, baseTime);
+                printf("}");
+                break;
+        }
+        break;
+
+    case OCR_TRACE_TYPE_EVENT:
+
+        switch(trace->actionSwitch){
+
+            case OCR_ACTION_CREATE:
+                printInstant(name, category, trace, baseTime);
+                printf(",\"args\":{\"parent\":\""GUIDF"\"}}", GUIDA(TRACE_FIELD(EVENT, eventCreate, trace, parentID)));
+                break;
+
+            case OCR_ACTION_SATISFY:
+                printInstant(name, category, trace, baseTime);
+                printf(",\"args\":{\"dep\":\""GUIDF"\"}}", GUIDA(TRACE_FIELD(EVENT, eventDepSatisfy, trace, depID)));
+                break;
+
+            case OCR_ACTION_ADD_DEP:
+                printInstant(name, category, trace, baseTime);
+                printf(",\"args\":{\"dep\":\""GUIDF"\",\"parent\":\""GUIDF"\"}}",
+                       GUIDA(TRACE_FIELD(EVENT, eventDepAdd, trace, depID)),
+                       GUIDA(TRACE_FIELD(EVENT, eventDepAdd, trace, parentID)));
+                break;
+
+            default:
+                printInstant(name, category, trace, baseTime);
+                printf("}");
+                break;
+        }
+        break;
+
+    case OCR_TRACE_TYPE_DATABLOCK:
+
+        switch(trace->actionSwitch){
+
+            case OCR_ACTION_CREATE:
+                printInstant(name, category, trace, baseTime);
+                printf(",\"args\":{\"parent\":\""GUIDF"\",\"size\":%lu}}",
+                       GUIDA(TRACE_FIELD(DATA, dataCreate, trace, parentID)),
+                       TRACE_FIELD(DATA, dataCreate, trace, size));
+                break;
+
+            default:
+                printInstant(name, category, trace, baseTime);
+                printf("}");
+                break;
+        }
+        break;
+    }
+}
+
+static int compareSymbols(const void *a, const void *b){
+    unsigned long addrA = ((const symbol_t *)a)->addr;
+    unsigned long addrB = ((const symbol_t *)b)->addr;
+    return (addrA > addrB) - (addrA < addrB);
+}
+
+static void readSymbols(char *binaryPath){
+    char sysCommand[SYS_CALL_COMMAND_LENGTH];
+    snprintf(sysCommand, sizeof(sysCommand), "nm %s", binaryPath);
+
+    FILE *fp = popen(sysCommand, "r");
+    if(fp == NULL){
+        fprintf(stderr, "Error: Unable to open application binary, EDTs will not be named\n");
+        return;
+    }
+
+    //Keep the text symbols, sorted by address for lookups
+    int capacity = 1024;
+    symbols = malloc(capacity * sizeof(symbol_t));
+    char line[SYS_CALL_COMMAND_LENGTH + SYMBOL_NAME_LENGTH];
+    while(fgets(line, sizeof(line), fp)){
+        unsigned long addr;
+        char type;
+        char symbol[SYMBOL_NAME_LENGTH];
+        if(sscanf(line, "%lx %c %127s", &addr, &type, symbol) != 3)
+            continue;
+        if(type != 'T' && type != 't')
+            continue;
+        if(symbolCount == capacity){
+            capacity *= 2;
+            symbols = realloc(symbols, capacity * sizeof(symbol_t));
+        }
+        symbols[symbolCount].addr = addr;
+        strcpy(symbols[symbolCount].name, symbol);
+        symbolCount++;
+    }
+    pclose(fp);
+    qsort(symbols, symbolCount, sizeof(symbol_t), compareSymbols);
+}
+
+static const char *symbolName(unsigned long addr){
+    symbol_t key;
+    key.addr = addr;
+    if(symbols == NULL)
+        return NULL;
+    symbol_t *found = bsearch(&key, symbols, symbolCount, sizeof(symbol_t), compareSymbols);
+    return found ? found->name : NULL;
+}
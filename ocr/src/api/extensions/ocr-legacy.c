@@ -24,6 +24,12 @@
 extern void freeUpRuntime(bool, u8*);
 extern void bringUpRuntime(ocrConfig_t *ocrConfig);
 
+#ifndef LEGACY_WAIT_PROGRESS_US
+// Time a thread blocked on an event stays asleep before giving the
+// runtime a chance to make progress through it
+#define LEGACY_WAIT_PROGRESS_US 1000
+#endif
+
 void ocrLegacyInit(ocrGuid_t *legacyContext, ocrConfig_t * ocrConfig) {
     START_PROFILE(api_ocrLegacyInit);
     // Bug #492: legacyContext is ignored
@@ -112,6 +118,35 @@ u8 ocrLegacySpawnOCR(ocrGuid_t* handle, ocrGuid_t finishEdtTemplate, u64 paramc,
     RETURN_PROFILE(0);
 }
 
+// Blocks until the local event 'evt' is satisfied, without consuming CPU
+// when the event supports it. EDTs are left to poll when blocking support
+// is built in: their worker runs other EDTs while it waits.
+static u8 legacyWaitLocalEvent(ocrPolicyDomain_t *pd, ocrTask_t *curTask, ocrEvent_t *evt) {
+#ifdef ENABLE_SCHEDULER_BLOCKING_SUPPORT
+    if(curTask != NULL) {
+        return 0;
+    }
+#endif
+    ASSERT(evt->fctId == pd->eventFactories[0]->factoryId);
+    ocrEventFcts_t *fcts = &(pd->eventFactories[0]->fcts[evt->kind]);
+    if(fcts->wait == NULL) {
+        return 0;
+    }
+    while(fcts->wait(evt, LEGACY_WAIT_PROGRESS_US * 1000ULL) != 0) {
+        PD_MSG_STACK(msg);
+        getCurrentEnv(NULL, NULL, NULL, &msg);
+#define PD_MSG (&msg)
+#define PD_TYPE PD_MSG_MGT_MONITOR_PROGRESS
+        msg.type = PD_MSG_MGT_MONITOR_PROGRESS | PD_MSG_REQUEST | PD_MSG_REQ_RESPONSE;
+        PD_MSG_FIELD_IO(properties) = 0;
+        PD_MSG_FIELD_I(monitoree) = NULL;
+        RESULT_PROPAGATE(pd->fcts.processMessage(pd, &msg, true));
+#undef PD_MSG
+#undef PD_TYPE
+    }
+    return 0;
+}
+
 ocrGuid_t ocrWait(ocrGuid_t outputEvent) {
     START_PROFILE(api_ocrWait);
     //DPRINTF(DEBUG_LVL_WARN, "ocrWait is deprecated -- use ocrLegacyBlockProgress instead\n");
@@ -180,12 +215,11 @@ u8 ocrLegacyBlockProgress(ocrGuid_t evtHandle, ocrGuid_t* guid, void** result, u
                 }
             }
             else {
-#ifdef OCR_ASSERT
-
                 ocrEvent_t* eventToYieldFor = (ocrEvent_t *)PD_MSG_FIELD_IO(guid.metaDataPtr);
                 ASSERT(eventToYieldFor->kind == OCR_EVENT_STICKY_T ||
                        eventToYieldFor->kind == OCR_EVENT_IDEM_T);
-#endif
+                // Sleep until satisfied so that the EVT_GET below succeeds right away
+                RESULT_PROPAGATE(legacyWaitLocalEvent(pd, curTask, eventToYieldFor));
                 break;
             }
         } while(true);
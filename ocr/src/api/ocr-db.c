@@ -9,14 +9,21 @@
  */
 
 
+#include "ocr-config.h"
 #include "debug.h"
 #include "ocr-allocator.h"
 #include "ocr-datablock.h"
 #include "ocr-db.h"
+#include "ocr-edt.h"
 #include "ocr-errors.h"
 #include "ocr-policy-domain.h"
 #include "ocr-runtime-types.h"
 
+#ifdef ENABLE_EXTENSION_AFFINITY
+#include "extensions/ocr-affinity.h"
+#include "extensions/ocr-hints.h"
+#endif
+
 #ifdef OCR_ENABLE_STATISTICS
 #include "ocr-statistics.h"
 #endif
@@ -238,9 +245,151 @@ u8 ocrDbMallocOffset(ocrGuid_t guid, u64 size, u64* offset) {
     return OCR_EINVAL; /* not yet implemented */
 }
 
+/**
+ * @brief Copies of at least this many bytes are split across several
+ * runtime EDTs (at most one per worker), each copying one chunk
+ */
+#ifndef DB_COPY_CHUNK_SIZE
+#define DB_COPY_CHUNK_SIZE (1ULL << 20)
+#endif
+
+// paramv layout shared by the copy EDTs; depv[0] is the destination and
+// depv[1] the source
+#define DB_COPY_PARAM_DST_OFFSET 0
+#define DB_COPY_PARAM_SRC_OFFSET 1
+#define DB_COPY_PARAM_SIZE       2
+#define DB_COPY_PARAMC           3
+
+static ocrGuid_t dbCopyChunkEdt(u32 paramc, u64 *paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ASSERT((paramc == DB_COPY_PARAMC) && (depc == 2));
+    char *dst = ((char*)depv[0].ptr) + paramv[DB_COPY_PARAM_DST_OFFSET];
+    char *src = ((char*)depv[1].ptr) + paramv[DB_COPY_PARAM_SRC_OFFSET];
+    // The copy is the whole point of this EDT; let the HAL use its
+    // background (cache-bypassing) path for large sizes
+    hal_memCopy(dst, src, paramv[DB_COPY_PARAM_SIZE], true);
+    hal_fence();
+    // Carried by the completion event
+    return depv[0].guid;
+}
+
+// Creates a copy EDT on (destination, source), linking its output event to
+// 'completionEvt' (if not NULL_GUID) before it can run. The source is acquired
+// RO so that a remote source is fetched once and never written back.
+static u8 dbCopySpawn(ocrGuid_t *edtGuid, ocrGuid_t templateGuid, u64 *paramv,
+                      ocrGuid_t destination, ocrGuid_t source, u16 properties,
+                      ocrHint_t *hint, ocrGuid_t completionEvt) {
+    ocrGuid_t outputEvent = NULL_GUID;
+    bool hasCompletion = !ocrGuidIsNull(completionEvt);
+    u8 returnCode = ocrEdtCreate(edtGuid, templateGuid, DB_COPY_PARAMC, paramv, 2, NULL,
+                                 properties, hint, hasCompletion ? &outputEvent : NULL);
+    if ((returnCode == 0) && hasCompletion)
+        returnCode = ocrAddDependence(outputEvent, completionEvt, 0, DB_MODE_RO);
+    if (returnCode == 0)
+        returnCode = ocrAddDependence(destination, *edtGuid, 0, DB_MODE_RW);
+    if (returnCode == 0)
+        returnCode = ocrAddDependence(source, *edtGuid, 1, DB_MODE_RO);
+    return returnCode;
+}
+
+// Root of an ocrDbCopy. Small copies are done in place; large ones are
+// split into chunks copied in parallel. The root is a finish EDT so its
+// output event (the user's completion event) fires once all chunks are done.
+static ocrGuid_t dbCopyEdt(u32 paramc, u64 *paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ASSERT((paramc == DB_COPY_PARAMC) && (depc == 2));
+    u64 size = paramv[DB_COPY_PARAM_SIZE];
+    ocrPolicyDomain_t *pd = NULL;
+    ocrTask_t *task = NULL;
+    getCurrentEnv(&pd, NULL, &task, NULL);
+    u64 chunkCount = size / DB_COPY_CHUNK_SIZE;
+    if (chunkCount > pd->workerCount)
+        chunkCount = pd->workerCount;
+    // Only a finish root covers its chunks with the completion event
+    if ((chunkCount < 2) || ocrGuidIsNull(task->finishLatch))
+        return dbCopyChunkEdt(paramc, paramv, depc, depv);
+
+    DPRINTF(DEBUG_LVL_VERB, "ocrDbCopy: splitting %"PRIu64" bytes in %"PRIu64" chunks\n", size, chunkCount);
+    ocrGuid_t chunkTemplate;
+    ocrEdtTemplateCreate(&chunkTemplate, dbCopyChunkEdt, DB_COPY_PARAMC, 2);
+    u64 chunkSize = size / chunkCount;
+    u64 done = 0;
+    u64 i;
+    for (i = 0; i < chunkCount; ++i) {
+        u64 chunkParamv[DB_COPY_PARAMC];
+        chunkParamv[DB_COPY_PARAM_DST_OFFSET] = paramv[DB_COPY_PARAM_DST_OFFSET] + done;
+        chunkParamv[DB_COPY_PARAM_SRC_OFFSET] = paramv[DB_COPY_PARAM_SRC_OFFSET] + done;
+        chunkParamv[DB_COPY_PARAM_SIZE] = (i == (chunkCount - 1)) ? (size - done) : chunkSize;
+        ocrGuid_t chunkGuid;
+        RESULT_ASSERT(dbCopySpawn(&chunkGuid, chunkTemplate, chunkParamv, depv[0].guid, depv[1].guid,
+                                  EDT_PROP_NONE, NULL_HINT, NULL_GUID), ==, 0);
+        done += chunkSize;
+    }
+    ocrEdtTemplateDestroy(chunkTemplate);
+    return depv[0].guid;
+}
+
 u8 ocrDbCopy(ocrGuid_t destination, u64 destinationOffset, ocrGuid_t source,
              u64 sourceOffset, u64 size, u64 copyType, ocrGuid_t *completionEvt) {
-    return OCR_EINVAL; /* not yet implemented */
+
+    START_PROFILE(api_ocrDbCopy);
+    DPRINTF(DEBUG_LVL_INFO, "ENTER ocrDbCopy(dst="GUIDF", dstOffset=%"PRIu64", src="GUIDF", srcOffset=%"PRIu64
+            ", size=%"PRIu64", copyType=%"PRIu64")\n", GUIDA(destination), destinationOffset,
+            GUIDA(source), sourceOffset, size, copyType);
+    u8 returnCode = 0;
+    if (ocrGuidIsNull(destination) || ocrGuidIsNull(source)) {
+        returnCode = OCR_EINVAL;
+    } else if (ocrGuidIsEq(destination, source) &&
+               (destinationOffset < (sourceOffset + size)) &&
+               (sourceOffset < (destinationOffset + size))) {
+        returnCode = OCR_EPERM;
+    }
+    if (returnCode != 0) {
+        DPRINTF(DEBUG_LVL_WARN, "EXIT ocrDbCopy -> %"PRIu32"; invalid arguments\n", returnCode);
+        RETURN_PROFILE(returnCode);
+    }
+
+    ocrHint_t *hint = NULL_HINT;
+#ifdef ENABLE_EXTENSION_AFFINITY
+    // Run the copy where the destination lives: only the source then
+    // crosses the network, in a single acquire, and the destination is
+    // written in place instead of being fetched and written back
+    ocrHint_t copyHint;
+    ocrGuid_t dstAffinity, curAffinity;
+    u64 count = 1;
+    ocrAffinityQuery(destination, &count, &dstAffinity);
+    ocrAffinityGetCurrent(&curAffinity);
+    if (!ocrGuidIsEq(dstAffinity, curAffinity)) {
+        ocrHintInit(&copyHint, OCR_HINT_EDT_T);
+        ocrSetHintValue(&copyHint, OCR_HINT_EDT_AFFINITY, ocrAffinityToHintValue(dstAffinity));
+        hint = &copyHint;
+    }
+#endif
+
+    u64 paramv[DB_COPY_PARAMC];
+    paramv[DB_COPY_PARAM_DST_OFFSET] = destinationOffset;
+    paramv[DB_COPY_PARAM_SRC_OFFSET] = sourceOffset;
+    paramv[DB_COPY_PARAM_SIZE] = size;
+    ocrGuid_t templateGuid, edtGuid;
+    ocrEdtTemplateCreate(&templateGuid, dbCopyEdt, DB_COPY_PARAMC, 2);
+    // Creation is synchronous (we ask for the EDT's GUID) so the
+    // template can go away right after, even if the EDT is remote.
+    // Only copies that may be split pay for a finish scope.
+    u16 properties = (size >= (2 * DB_COPY_CHUNK_SIZE)) ? EDT_PROP_FINISH : EDT_PROP_NONE;
+    // EDT output events are ONCE and a copy from a DB may complete before
+    // the caller gets to use its event; hand out a sticky one instead
+    ocrGuid_t stickyEvt = NULL_GUID;
+    if (completionEvt != NULL) {
+        returnCode = ocrEventCreate(&stickyEvt, OCR_EVENT_STICKY_T, EVT_PROP_TAKES_ARG);
+        *completionEvt = stickyEvt;
+    }
+    if (returnCode == 0)
+        returnCode = dbCopySpawn(&edtGuid, templateGuid, paramv, destination, source,
+                                 properties, hint, stickyEvt);
+    ocrEdtTemplateDestroy(templateGuid);
+
+    DPRINTF_COND_LVL(returnCode, DEBUG_LVL_WARN, DEBUG_LVL_INFO,
+                     "EXIT ocrDbCopy(dst="GUIDF", src="GUIDF") -> %"PRIu32"\n",
+                     GUIDA(destination), GUIDA(source), returnCode);
+    RETURN_PROFILE(returnCode);
 }
 
 u8 ocrDbFree(ocrGuid_t guid, void* addr) {
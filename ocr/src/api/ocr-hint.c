@@ -65,6 +65,7 @@ u8 ocrHintInit(ocrHint_t *hint, ocrHintType_t hintType) {
             OCR_HINT_FIELD(hint, OCR_HINT_DB_INTER) = 0;
             OCR_HINT_FIELD(hint, OCR_HINT_DB_FAR) = 0;
             OCR_HINT_FIELD(hint, OCR_HINT_DB_HIGHBW) = 0;
+            OCR_HINT_FIELD(hint, OCR_HINT_DB_NUMA_NODE) = 0;
         }
         break;
     case OCR_HINT_EVT_T:
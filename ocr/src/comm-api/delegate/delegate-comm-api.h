@@ -17,6 +17,7 @@
 #include "ocr-policy-domain.h"
 #include "ocr-types.h"
 #include "utils/ocr-utils.h"
+#include "utils/mpsc-queue.h"
 
 typedef struct {
     ocrCommApiFactory_t base;
@@ -34,8 +35,14 @@ typedef struct {
     ocrMsgHandle_t handle;
     // Allows to remember the source and thus destination for the callback
     u64 boxId; // set by the scheduler
+    // Links the handle in the scheduler's comm queues
+    mpscQueueNode_t queueNode;
 } delegateMsgHandle_t;
 
+// Handle a comm queue node is embedded in
+#define DELEGATE_HANDLE_OF_NODE(node) \
+    ((delegateMsgHandle_t *) (((u8 *) (node)) - offsetof(delegateMsgHandle_t, queueNode)))
+
 extern ocrCommApiFactory_t* newCommApiFactoryDelegate(ocrParamList_t *perType);
 
 #endif /* ENABLE_COMM_API_DELEGATE */
@@ -30,6 +30,9 @@ const char * commplatform_types[] = {
 #endif
 #ifdef ENABLE_COMM_PLATFORM_GASNET
     "GASNet",
+#endif
+#ifdef ENABLE_COMM_PLATFORM_SHM
+    "SHM",
 #endif
     NULL
 };
@@ -65,6 +68,10 @@ ocrCommPlatformFactory_t *newCommPlatformFactory(commPlatformType_t type, ocrPar
 #ifdef ENABLE_COMM_PLATFORM_GASNET
     case commPlatformGasnet_id:
         return newCommPlatformFactoryGasnet(typeArg);
+#endif
+#ifdef ENABLE_COMM_PLATFORM_SHM
+    case commPlatformShm_id:
+        return newCommPlatformFactoryShm(typeArg);
 #endif
     default:
         ASSERT(0);
@@ -74,5 +81,7 @@ ocrCommPlatformFactory_t *newCommPlatformFactory(commPlatformType_t type, ocrPar
 
 void initializeCommPlatformOcr(ocrCommPlatformFactory_t * factory, ocrCommPlatform_t * self, ocrParamList_t *perInstance) {
     self->location = ((paramListCommPlatformInst_t *)perInstance)->location;
+    self->laneId = 0;
+    self->laneCount = 1;
     self->fcts = factory->platformFcts;
 }
@@ -33,6 +33,9 @@ typedef enum _commPlatformType_t {
 #endif
 #ifdef ENABLE_COMM_PLATFORM_GASNET
     commPlatformGasnet_id,
+#endif
+#ifdef ENABLE_COMM_PLATFORM_SHM
+    commPlatformShm_id,
 #endif
     commPlatformMax_id
 } commPlatformType_t;
@@ -60,6 +63,9 @@ extern const char * commplatform_types[];
 #ifdef ENABLE_COMM_PLATFORM_GASNET
 #include "comm-platform/gasnet/gasnet-comm-platform.h"
 #endif
+#ifdef ENABLE_COMM_PLATFORM_SHM
+#include "comm-platform/shm/shm-comm-platform.h"
+#endif
 
 // Add other communication platforms using the same pattern as above
 
@@ -227,8 +227,7 @@ static u8 GasnetCommSendMessage(ocrCommPlatform_t * self,
     ocrPolicyMsgGetMsgSize(message, &baseSize, &marshalledSize, MARSHALL_DBPTR | MARSHALL_NSADDR);
     u64 fullMsgSize = baseSize + marshalledSize;
 
-    //BUG #602 multi-comm-worker: msgId incr only works if a single comm-worker per rank,
-    // Do we want OCR to provide PD, system level counters ?
+    // Ids are per instance and there is a single instance per rank (see RL_GUID_OK)
     // Always generate an identifier for a new communication to give back to upper-layer
     u64 gasnetId = gasnetComm->msgId++;
 
@@ -444,6 +443,8 @@ u8 GasnetCommSwitchRunlevel(ocrCommPlatform_t *self, ocrPolicyDomain_t *PD, ocrR
     case RL_GUID_OK:
         ASSERT(self->pd == PD);
         if((properties & RL_BRING_UP) && RL_IS_LAST_PHASE_UP(self->pd, RL_GUID_OK, phase)) {
+            // Instances are registered by PD (see addCommPlatform), one per rank
+            ASSERT((self->laneCount == 1) && "gasnet comm-platform supports a single comm-worker");
             gasnetComm->incoming = newLinkedList(PD);
             gasnetComm->incomingIt = gasnetComm->incoming->iterator(gasnetComm->incoming);
 
@@ -17,6 +17,7 @@
 
 #include "mpi-comm-platform.h"
 #include <mpi.h>
+#include <stdlib.h>
 
  #ifdef DEBUG_MPI_HOSTNAMES
 // For gethostname
@@ -39,11 +40,17 @@
 // MPI library Init/Finalize
 //
 
+// Thread support level granted by the MPI library
+static int mpiThreadLevel = MPI_THREAD_SINGLE;
+
 /**
  * @brief Initialize the MPI library.
+ *
+ * Full thread support is requested because each communication worker
+ * drives its own comm-platform instance concurrently with the others.
  */
 void platformInitMPIComm(int * argc, char *** argv) {
-    RESULT_ASSERT(MPI_Init(argc, argv), ==, MPI_SUCCESS);
+    RESULT_ASSERT(MPI_Init_thread(argc, argv, MPI_THREAD_MULTIPLE, &mpiThreadLevel), ==, MPI_SUCCESS);
 }
 
 /**
@@ -72,6 +79,24 @@ void platformFinalizeMPIComm() {
 #define RECV_ANY_ID 0
 #define SEND_ANY_ID 0
 
+// Aggregate messages sent with SEND_ANY_ID in per-destination buffers.
+// When enabled, every RECV_ANY_ID payload is a batch of messages.
+#define MPI_COMM_COALESCE (STRATEGY_PROBE_RECV && (MPI_COMM_COALESCE_SIZE > 0))
+
+// Send large DB payloads out of the policy message (see rdvSend)
+#define MPI_COMM_RDV (STRATEGY_PROBE_RECV && (MPI_COMM_RDV_THRESHOLD > 0))
+
+// Largest piece of a rendezvous payload sent in a single MPI call
+#define RDV_CHUNK_SIZE (1ULL<<30)
+
+/**
+ * @brief Outstanding sends of a rendezvous payload
+ */
+typedef struct {
+    MPI_Request * reqs;
+    u32 nbReqs;
+} mpiCommRdv_t;
+
 typedef struct {
     u64 msgId; // The MPI comm layer message id for this communication
     u32 properties;
@@ -81,6 +106,8 @@ typedef struct {
     int src;
 #endif
     u8 deleteSendMsg;
+    u8 isBatch; // 'msg' points to a coalesced batch, not a policy message
+    mpiCommRdv_t * rdv; // Payload sent along with a two-way message, if any
 } mpiCommHandle_t;
 
 static ocrLocation_t mpiRankToLocation(int mpiRank) {
@@ -112,9 +139,292 @@ static mpiCommHandle_t * createMpiHandle(ocrCommPlatform_t * self, u64 id, u32 p
     handle->properties = properties;
     handle->msg = msg;
     handle->deleteSendMsg = deleteSendMsg;
+    handle->isBatch = false;
+    handle->rdv = NULL;
     return handle;
 }
 
+/**
+ * @brief Internal use - Returns the address of the DB payload pointer of 'msg'
+ * along with the payload size and the message's DB properties.
+ * Returns NULL if 'msg' is not of a kind that carries DB data.
+ */
+static void ** dbPayloadFields(ocrPolicyMsg_t * msg, u64 * size, u32 ** properties) {
+    if (((msg->type & PD_MSG_TYPE_ONLY) == PD_MSG_DB_ACQUIRE) && (msg->type & PD_MSG_RESPONSE)) {
+#define PD_MSG (msg)
+#define PD_TYPE PD_MSG_DB_ACQUIRE
+        *size = PD_MSG_FIELD_O(size);
+        *properties = &(PD_MSG_FIELD_IO(properties));
+        return &(PD_MSG_FIELD_O(ptr));
+#undef PD_MSG
+#undef PD_TYPE
+    }
+    if (((msg->type & PD_MSG_TYPE_ONLY) == PD_MSG_DB_RELEASE) && (msg->type & PD_MSG_REQUEST)) {
+#define PD_MSG (msg)
+#define PD_TYPE PD_MSG_DB_RELEASE
+        *size = PD_MSG_FIELD_I(size);
+        *properties = &(PD_MSG_FIELD_I(properties));
+        return &(PD_MSG_FIELD_I(ptr));
+#undef PD_MSG
+#undef PD_TYPE
+    }
+    return NULL;
+}
+
+//
+// Rendezvous
+//
+// The DB payload of a large acquire response or write-back release is not
+// copied in the message. It is sent from the DB memory with its own tag on
+// a dedicated communicator and the message carries that tag in place of the
+// pointer. The receiver gets the payload straight into a buffer it hands
+// over to the upper layers (DB_FLAG_RT_RDV_PTR), which adopt it instead of
+// copying from the message.
+//
+// The sender must leave the payload alone until the sends complete. For
+// acquire responses this holds because the DB stays acquired on behalf of
+// the requester until it releases. For releases the response is only handed
+// up once the payload sends have completed.
+//
+
+/**
+ * @brief Internal use - Posts the sends of a rendezvous payload
+ */
+static mpiCommRdv_t * rdvSend(ocrCommPlatform_t * self, void * ptr, u64 size, int rank, int tag) {
+    ocrCommPlatformMPI_t * mpiComm = (ocrCommPlatformMPI_t *) self;
+    u32 nbReqs = (u32) ((size + RDV_CHUNK_SIZE - 1) / RDV_CHUNK_SIZE);
+    mpiCommRdv_t * rdv = self->pd->fcts.pdMalloc(self->pd, sizeof(mpiCommRdv_t) + (sizeof(MPI_Request) * nbReqs));
+    rdv->reqs = (MPI_Request *) (rdv + 1);
+    rdv->nbReqs = nbReqs;
+    DPRINTF(DEBUG_LVL_VVERB,"[MPI %"PRId32"] posting rendezvous isend of %"PRIu64" bytes with tag %"PRId32" to MPI rank %"PRId32"\n",
+            locationToMpiRank(self->pd->myLocation), size, tag, rank);
+    u64 offset = 0;
+    u32 i;
+    for (i = 0; i < nbReqs; ++i) {
+        u64 count = ((size - offset) < RDV_CHUNK_SIZE) ? (size - offset) : RDV_CHUNK_SIZE;
+        RESULT_ASSERT(MPI_Isend(((u8 *) ptr) + offset, (int) count, MPI_BYTE, rank, tag, mpiComm->rdvComm, &(rdv->reqs[i])), ==, MPI_SUCCESS);
+        offset += count;
+    }
+    mpiComm->statRdvSent++;
+    mpiComm->statRdvSentBytes += size;
+    return rdv;
+}
+
+/**
+ * @brief Internal use - Receives the rendezvous payload 'tag' from 'rank' in a new buffer
+ */
+static void * rdvRecv(ocrCommPlatform_t * self, int rank, int tag, u64 size) {
+    ocrCommPlatformMPI_t * mpiComm = (ocrCommPlatformMPI_t *) self;
+    u8 * buf = (u8 *) self->pd->fcts.pdMalloc(self->pd, size);
+    DPRINTF(DEBUG_LVL_VVERB,"[MPI %"PRId32"] receiving rendezvous payload of %"PRIu64" bytes with tag %"PRId32" from MPI rank %"PRId32"\n",
+            locationToMpiRank(self->pd->myLocation), size, tag, rank);
+    u64 offset = 0;
+    while (offset < size) {
+        u64 count = ((size - offset) < RDV_CHUNK_SIZE) ? (size - offset) : RDV_CHUNK_SIZE;
+        RESULT_ASSERT(MPI_Recv(buf + offset, (int) count, MPI_BYTE, rank, tag, mpiComm->rdvComm, MPI_STATUS_IGNORE), ==, MPI_SUCCESS);
+        offset += count;
+    }
+    mpiComm->statRdvRecv++;
+    mpiComm->statRdvRecvBytes += size;
+    return buf;
+}
+
+/**
+ * @brief Internal use - Returns true and frees 'rdv' if its sends have completed.
+ * If 'wait' is true, blocks until they do.
+ */
+static bool rdvComplete(ocrCommPlatform_t * self, mpiCommRdv_t * rdv, bool wait) {
+    if (wait) {
+        RESULT_ASSERT(MPI_Waitall((int) rdv->nbReqs, rdv->reqs, MPI_STATUSES_IGNORE), ==, MPI_SUCCESS);
+    } else {
+        int completed = 0;
+        RESULT_ASSERT(MPI_Testall((int) rdv->nbReqs, rdv->reqs, &completed, MPI_STATUSES_IGNORE), ==, MPI_SUCCESS);
+        if (!completed) {
+            return false;
+        }
+    }
+    self->pd->fcts.pdFree(self->pd, rdv);
+    return true;
+}
+
+#if STRATEGY_PROBE_RECV
+/**
+ * @brief Internal use - Checks and unmarshalls a message just received in 'msg'
+ */
+static void unmarshallIncoming(ocrCommPlatform_t * self, ocrPolicyMsg_t * msg, u64 count, bool batched) {
+    ocrCommPlatformMPI_t * mpiComm = (ocrCommPlatformMPI_t *) self;
+    // After recv, the message size must be updated since it has just been overwritten.
+    msg->usefulSize = count;
+    msg->bufferSize = count;
+
+    // This check usually fails in the 'ocrPolicyMsgGetMsgSize' when there
+    // has been an issue in MPI. It manifest as a received buffer being complete
+    // garbage whereas the sender doesn't detect any corruption of the message when
+    // it is recycled. Tinkering with multiple MPI implementation it sounds the issue
+    // is with the MPI library not being able to register a hook for malloc calls.
+    ASSERT(((msg->type & (PD_MSG_REQUEST | PD_MSG_RESPONSE)) != (PD_MSG_REQUEST | PD_MSG_RESPONSE)) &&
+       ((msg->type & PD_MSG_REQUEST) || (msg->type & PD_MSG_RESPONSE)) &&
+       "error: Try to link the MPI library first when compiling your OCR program");
+
+    // A rendezvous payload is not part of the message
+    u64 dbSize = 0;
+    u32 * dbProperties = NULL;
+    void ** dbPtrField = dbPayloadFields(msg, &dbSize, &dbProperties);
+    bool rdv = (dbPtrField != NULL) && (*dbProperties & DB_FLAG_RT_RDV_PTR);
+    u32 marshallFlags = rdv ? MARSHALL_NSADDR : (MARSHALL_DBPTR | MARSHALL_NSADDR);
+
+    // Unmarshall the message. We check to make sure the size is OK
+    // This should be true since MPI seems to make sure to send the whole message
+    u64 baseSize = 0, marshalledSize = 0;
+    ocrPolicyMsgGetMsgSize(msg, &baseSize, &marshalledSize, marshallFlags);
+    ASSERT((baseSize+marshalledSize) == count);
+    // The unmarshalling is just fixing up fields to point to the correct
+    // payload address trailing after the base message.
+    //BUG #604 Communication API extensions
+    //1)     I'm thinking we can further customize un/marshalling for MPI. Because we use
+    //       mpi tags, we actually don't need to send the header part of response message.
+    //       We can directly recv the message at msg + header, update the msg header
+    //       to be a response + flip src/dst.
+    //2)     See if we can improve unmarshalling by keeping around pointers for the various
+    //       payload to be unmarshalled
+    //3)     We also need to deguidify all the fatGuids that are 'local' and decide
+    //       where it is appropriate to do it.
+    //       - REC: I think the right place would be in the user code (ie: not the comm layer)
+    ocrPolicyMsgUnMarshallMsg((u8*)msg, NULL, msg, MARSHALL_APPEND | marshallFlags);
+    if (rdv) {
+        // Fetch the payload the message stands for
+        *dbPtrField = rdvRecv(self, locationToMpiRank(msg->srcLocation), (int) (u64) *dbPtrField, dbSize);
+    }
+    if (((msg->type & PD_MSG_TYPE_ONLY) == PD_MSG_DB_ACQUIRE) && (dbSize != 0)) {
+        mpiComm->statAcqRecv++;
+        if (batched && !rdv) {
+            mpiComm->statAcqRecvCopied += dbSize;
+        }
+    }
+}
+#endif
+
+#if MPI_COMM_COALESCE
+//
+// Message coalescing
+//
+// One-way messages (tagged SEND_ANY_ID) are copied in a per-destination
+// buffer instead of being sent right away. A buffer is sent in a single
+// MPI_Isend when it is full, when its oldest message is older than
+// MPI_COMM_COALESCE_AGE_NS or when a message someone waits on is added.
+// The receiver unpacks the batch one message per poll.
+//
+
+#define COALESCE_ENTRY_SIZE(size) (sizeof(u64) + (((size) + 7) & ~((u64)7)))
+
+/**
+ * @brief Internal use - Sends the content of the coalescing buffer for 'rank'
+ */
+static void coalesceFlush(ocrCommPlatform_t * self, int rank) {
+    ocrCommPlatformMPI_t * mpiComm = (ocrCommPlatformMPI_t *) self;
+    mpiCommCoalesceBuf_t * buf = &(mpiComm->coalesceBufs[rank]);
+    if (buf->used == 0) {
+        return;
+    }
+    // The batch is freed like any one-way message once the send completes
+    mpiCommHandle_t * handle = createMpiHandle(self, SEND_ANY_ID, PERSIST_MSG_PROP, (ocrPolicyMsg_t *) buf->data, false);
+    handle->isBatch = true;
+    DPRINTF(DEBUG_LVL_VVERB,"[MPI %"PRId32"] posting isend for a %"PRIu64" bytes batch to MPI rank %"PRId32"\n",
+            locationToMpiRank(self->pd->myLocation), buf->used, rank);
+    ASSERT((buf->used < INT_MAX) && "Outgoing batch is too large");
+    RESULT_ASSERT(MPI_Isend(buf->data, (int) buf->used, MPI_BYTE, rank, SEND_ANY_ID, mpiComm->comm, &(handle->status)), ==, MPI_SUCCESS);
+    mpiComm->outgoing->pushFront(mpiComm->outgoing, handle);
+    buf->data = NULL;
+    buf->used = 0;
+    buf->capacity = 0;
+    mpiComm->coalescePending--;
+}
+
+/**
+ * @brief Internal use - Sends the coalescing buffers older than MPI_COMM_COALESCE_AGE_NS
+ * or all of them if 'all' is true
+ */
+static void coalesceFlushAged(ocrCommPlatform_t * self, bool all) {
+    ocrCommPlatformMPI_t * mpiComm = (ocrCommPlatformMPI_t *) self;
+    if (mpiComm->coalescePending == 0) {
+        return;
+    }
+    u64 now = all ? 0 : salGetTime();
+    u32 i;
+    for (i = 0; (i < mpiComm->coalesceBufCount) && (mpiComm->coalescePending != 0); ++i) {
+        mpiCommCoalesceBuf_t * buf = &(mpiComm->coalesceBufs[i]);
+        if ((buf->used != 0) && (all || ((now - buf->startTime) >= MPI_COMM_COALESCE_AGE_NS))) {
+            coalesceFlush(self, (int) i);
+        }
+    }
+}
+
+/**
+ * @brief Internal use - Appends the marshalled message 'msg' to the coalescing buffer for 'rank'
+ */
+static void coalesceAppend(ocrCommPlatform_t * self, int rank, ocrPolicyMsg_t * msg, u64 size) {
+    ocrCommPlatformMPI_t * mpiComm = (ocrCommPlatformMPI_t *) self;
+    ASSERT(rank < mpiComm->coalesceBufCount);
+    mpiCommCoalesceBuf_t * buf = &(mpiComm->coalesceBufs[rank]);
+    u64 entrySize = COALESCE_ENTRY_SIZE(size);
+    if ((buf->used + entrySize) > buf->capacity) {
+        coalesceFlush(self, rank);
+    }
+    if (buf->data == NULL) {
+        // Messages larger than the buffer get a batch of their own
+        buf->capacity = (entrySize > MPI_COMM_COALESCE_SIZE) ? entrySize : MPI_COMM_COALESCE_SIZE;
+        buf->data = (u8 *) self->pd->fcts.pdMalloc(self->pd, buf->capacity);
+    }
+    if (buf->used == 0) {
+        buf->startTime = salGetTime();
+        mpiComm->coalescePending++;
+    }
+    *((u64 *) (buf->data + buf->used)) = size;
+    hal_memCopy(buf->data + buf->used + sizeof(u64), msg, size, false);
+    buf->used += entrySize;
+    if (buf->used >= MPI_COMM_COALESCE_SIZE) {
+        coalesceFlush(self, rank);
+    }
+}
+
+/**
+ * @brief Internal use - Returns the next message of the incoming batch, receiving
+ * a new batch if the current one has been consumed
+ */
+static u8 coalesceNextIncoming(ocrCommPlatform_t * self, ocrPolicyMsg_t ** msg) {
+    ocrCommPlatformMPI_t * mpiComm = (ocrCommPlatformMPI_t *) self;
+    ocrPolicyDomain_t * pd = self->pd;
+    if (mpiComm->rxBatch == NULL) {
+        MPI_Status status;
+        int available = 0;
+        RESULT_ASSERT(MPI_Iprobe(MPI_ANY_SOURCE, RECV_ANY_ID, mpiComm->comm, &available, &status), ==, MPI_SUCCESS);
+        if (!available) {
+            return POLL_NO_MESSAGE;
+        }
+        int count;
+        RESULT_ASSERT(MPI_Get_count(&status, MPI_BYTE, &count), ==, MPI_SUCCESS);
+        ASSERT(count != 0);
+        mpiComm->rxBatch = (u8 *) pd->fcts.pdMalloc(pd, count);
+        RESULT_ASSERT(MPI_Recv(mpiComm->rxBatch, count, MPI_BYTE, status.MPI_SOURCE, RECV_ANY_ID, mpiComm->comm, MPI_STATUS_IGNORE), ==, MPI_SUCCESS);
+        mpiComm->rxBatchSize = count;
+        mpiComm->rxBatchOffset = 0;
+    }
+    u8 * entry = mpiComm->rxBatch + mpiComm->rxBatchOffset;
+    u64 size = *((u64 *) entry);
+    ASSERT((mpiComm->rxBatchOffset + COALESCE_ENTRY_SIZE(size)) <= mpiComm->rxBatchSize);
+    // Upper layers own and free each message individually
+    *msg = allocateNewMessage(self, size);
+    hal_memCopy(*msg, entry + sizeof(u64), size, false);
+    unmarshallIncoming(self, *msg, size, true);
+    mpiComm->rxBatchOffset += COALESCE_ENTRY_SIZE(size);
+    if (mpiComm->rxBatchOffset == mpiComm->rxBatchSize) {
+        pd->fcts.pdFree(pd, mpiComm->rxBatch);
+        mpiComm->rxBatch = NULL;
+    }
+    return POLL_MORE_MESSAGE;
+}
+#endif /* MPI_COMM_COALESCE */
+
 #if STRATEGY_PRE_POST_RECV
 /**
  * @brief Internal use - Asks the comm-platform to listen for incoming communication.
@@ -131,7 +441,7 @@ static void postRecvAny(ocrCommPlatform_t * self) {
     handle->src = MPI_ANY_SOURCE;
 #endif
     int tag = RECV_ANY_ID;
-    MPI_Comm comm = MPI_COMM_WORLD;
+    MPI_Comm comm = mpiComm->comm;
     DPRINTF(DEBUG_LVL_VERB,"[MPI %"PRId32"] posting irecv ANY\n", mpiRankToLocation(self->pd->myLocation));
     int res = MPI_Irecv(buf, count, datatype, src, tag, comm, &(handle->status));
     ASSERT(res == MPI_SUCCESS);
@@ -151,12 +461,26 @@ u8 MPICommSendMessage(ocrCommPlatform_t * self,
     u64 bufferSize = message->bufferSize;
     ocrCommPlatformMPI_t * mpiComm = ((ocrCommPlatformMPI_t *) self);
 
+    // Large DB payloads are left out of the message when we do the marshalling
+    u32 marshallFlags = MARSHALL_DBPTR | MARSHALL_NSADDR;
+    u64 dbSize = 0;
+    u32 * dbProperties = NULL;
+    void ** dbPtrField = dbPayloadFields(message, &dbSize, &dbProperties);
+    void * rdvPtr = NULL;
+#if MPI_COMM_RDV
+    if ((dbPtrField != NULL) && (dbSize >= MPI_COMM_RDV_THRESHOLD) && (*dbPtrField != NULL) &&
+        (GET_PROP_U8_MARSHALL(properties) == 0)) {
+        rdvPtr = *dbPtrField;
+        marshallFlags = MARSHALL_NSADDR;
+    }
+#endif
+
     u64 baseSize = 0, marshalledSize = 0;
-    ocrPolicyMsgGetMsgSize(message, &baseSize, &marshalledSize, MARSHALL_DBPTR | MARSHALL_NSADDR);
+    ocrPolicyMsgGetMsgSize(message, &baseSize, &marshalledSize, marshallFlags);
     u64 fullMsgSize = baseSize + marshalledSize;
 
-    //BUG #602 multi-comm-worker: msgId incr only works if a single comm-worker per rank,
-    //do we want OCR to provide PD, system level counters ?
+    // Ids are per instance: a lane is driven by a single comm-worker and
+    // responses are matched on the lane's own communicator.
     // Always generate an identifier for a new communication to give back to upper-layer
     u64 mpiId = mpiComm->msgId++;
 
@@ -183,7 +507,7 @@ u8 MPICommSendMessage(ocrCommPlatform_t * self,
         // Allocate message and marshall a copy
         messageBuffer = allocateNewMessage(self, fullMsgSize);
         ocrPolicyMsgMarshallMsg(message, baseSize, (u8*)messageBuffer,
-            MARSHALL_FULL_COPY | MARSHALL_DBPTR | MARSHALL_NSADDR);
+            MARSHALL_FULL_COPY | marshallFlags);
         if (properties & PERSIST_MSG_PROP) {
             // Message was persistent, two cases:
             if ((properties & TWOWAY_MSG_PROP) && (!(properties & ASYNC_MSG_PROP))) {
@@ -209,7 +533,7 @@ u8 MPICommSendMessage(ocrCommPlatform_t * self,
         if (marshallMode == 0) {
             // Marshall the message. We made sure we had enough space.
             ocrPolicyMsgMarshallMsg(messageBuffer, baseSize, (u8*)messageBuffer,
-                                    MARSHALL_APPEND | MARSHALL_DBPTR | MARSHALL_NSADDR);
+                                    MARSHALL_APPEND | marshallFlags);
         } else {
             ASSERT(marshallMode == MARSHALL_FULL_COPY);
             //BUG #604 Communication API extensions
@@ -231,10 +555,64 @@ u8 MPICommSendMessage(ocrCommPlatform_t * self,
     MPI_Datatype datatype = MPI_BYTE;
     int targetRank = locationToMpiRank(target);
     ASSERT(targetRank > -1);
-    MPI_Comm comm = MPI_COMM_WORLD;
+    MPI_Comm comm = mpiComm->comm;
+
+    // If this send is for a response, use message's msgId as tag to
+    // match the source recv operation that had been posted on the request send.
+    // Note that msgId is set to SEND_ANY_ID a little earlier in the case of asynchronous
+    // message like DB_ACQUIRE. It allows to handle the response as a one-way message that
+    // is not tied to any particular request at destination
+    int tag = (messageBuffer->type & PD_MSG_RESPONSE) ? messageBuffer->msgId : SEND_ANY_ID;
+    bool oneWay = !(properties & TWOWAY_MSG_PROP) || (properties & ASYNC_MSG_PROP);
+
+    mpiCommRdv_t * rdv = NULL;
+    if (rdvPtr != NULL) {
+        int rdvTag = (int) (mpiComm->rdvId++ % mpiComm->rdvTagUb);
+        rdv = rdvSend(self, rdvPtr, dbSize, targetRank, rdvTag);
+        // The message carries the payload's tag instead of its address
+        dbPtrField = dbPayloadFields(messageBuffer, &dbSize, &dbProperties);
+        *dbPtrField = (void *) (u64) rdvTag;
+        *dbProperties |= DB_FLAG_RT_RDV_PTR;
+        if (oneWay) {
+            // Nobody waits on the message, track the payload on its own
+            mpiComm->rdvOutgoing->pushFront(mpiComm->rdvOutgoing, rdv);
+            rdv = NULL;
+        }
+    }
+    if (((messageBuffer->type & PD_MSG_TYPE_ONLY) == PD_MSG_DB_ACQUIRE) && (dbSize != 0)) {
+        mpiComm->statAcqSent++;
+        if (rdvPtr == NULL) {
+            // Marshalled in the message, and once more in the batch if coalesced
+            mpiComm->statAcqSentCopied += (MPI_COMM_COALESCE && (tag == SEND_ANY_ID)) ? (2 * dbSize) : dbSize;
+        }
+    }
+
+#if MPI_COMM_COALESCE
+    if (tag == SEND_ANY_ID) {
+        ASSERT((messageBuffer->srcLocation == self->pd->myLocation) &&
+            (messageBuffer->destLocation != self->pd->myLocation) &&
+            (targetRank == messageBuffer->destLocation));
+        coalesceAppend(self, targetRank, messageBuffer, fullMsgSize);
+        // Do not hold back requests someone is blocked on nor runtime management
+        // messages: the shutdown protocol stops polling right after sending those.
+        // The receiver of a rendezvous can only start fetching the payload once
+        // it has the message.
+        if (!oneWay || (messageBuffer->type & PD_MSG_MGT_OP) || (rdvPtr != NULL)) {
+            coalesceFlush(self, targetRank);
+        }
+        if (oneWay) {
+            // The message has been copied, we're done with it
+            self->pd->fcts.pdFree(self->pd, messageBuffer);
+            *id = mpiId;
+            return 0;
+        }
+        // The message buffer is kept to receive the response into
+    }
+#endif
 
     // Setup request's MPI send
     mpiCommHandle_t * handle = createMpiHandle(self, mpiId, properties, messageBuffer, deleteSendMsg);
+    handle->rdv = rdv;
 
     // Setup request's response
     if ((messageBuffer->type & PD_MSG_REQ_RESPONSE) && !(properties & ASYNC_MSG_PROP)) {
@@ -264,12 +642,14 @@ u8 MPICommSendMessage(ocrCommPlatform_t * self,
     #endif
     }
 
-    // If this send is for a response, use message's msgId as tag to
-    // match the source recv operation that had been posted on the request send.
-    // Note that msgId is set to SEND_ANY_ID a little earlier in the case of asynchronous
-    // message like DB_ACQUIRE. It allows to handle the response as a one-way message that
-    // is not tied to any particular request at destination
-    int tag = (messageBuffer->type & PD_MSG_RESPONSE) ? messageBuffer->msgId : SEND_ANY_ID;
+#if MPI_COMM_COALESCE
+    if (tag == SEND_ANY_ID) {
+        // The request went out in a batch, directly wait for the response
+        mpiComm->incoming->pushFront(mpiComm->incoming, handle);
+        *id = mpiId;
+        return 0;
+    }
+#endif
 
     MPI_Request * status = &(handle->status);
 
@@ -303,9 +683,10 @@ u8 probeIncoming(ocrCommPlatform_t *self, int src, int tag, ocrPolicyMsg_t ** ms
     //rather than having all this book-keeping for receiving and reusing requests space ?
     //Sound we should get a pool of small messages (let say sizeof(ocrPolicyMsg_t) and allocate
     //variable size message on the fly).
+    ocrCommPlatformMPI_t * mpiComm = (ocrCommPlatformMPI_t *) self;
     MPI_Status status;
     int available = 0;
-    RESULT_ASSERT(MPI_Iprobe(src, tag, MPI_COMM_WORLD, &available, &status), ==, MPI_SUCCESS);
+    RESULT_ASSERT(MPI_Iprobe(src, tag, mpiComm->comm, &available, &status), ==, MPI_SUCCESS);
     if (available) {
         ASSERT(msg != NULL);
         ASSERT((bufferSize == 0) ? ((tag == RECV_ANY_ID) && (*msg == NULL)) : 1);
@@ -320,40 +701,9 @@ u8 probeIncoming(ocrCommPlatform_t *self, int src, int tag, ocrPolicyMsg_t ** ms
             *msg = allocateNewMessage(self, count);
         }
         ASSERT(*msg != NULL);
-        MPI_Comm comm = MPI_COMM_WORLD;
+        MPI_Comm comm = mpiComm->comm;
         RESULT_ASSERT(MPI_Recv(*msg, count, datatype, src, tag, comm, MPI_STATUS_IGNORE), ==, MPI_SUCCESS);
-        // After recv, the message size must be updated since it has just been overwritten.
-        (*msg)->usefulSize = count;
-        (*msg)->bufferSize = count;
-
-        // This check usually fails in the 'ocrPolicyMsgGetMsgSize' when there
-        // has been an issue in MPI. It manifest as a received buffer being complete
-        // garbage whereas the sender doesn't detect any corruption of the message when
-        // it is recycled. Tinkering with multiple MPI implementation it sounds the issue
-        // is with the MPI library not being able to register a hook for malloc calls.
-        ASSERT((((*msg)->type & (PD_MSG_REQUEST | PD_MSG_RESPONSE)) != (PD_MSG_REQUEST | PD_MSG_RESPONSE)) &&
-           (((*msg)->type & PD_MSG_REQUEST) || ((*msg)->type & PD_MSG_RESPONSE)) &&
-           "error: Try to link the MPI library first when compiling your OCR program");
-
-        // Unmarshall the message. We check to make sure the size is OK
-        // This should be true since MPI seems to make sure to send the whole message
-        u64 baseSize = 0, marshalledSize = 0;
-        ocrPolicyMsgGetMsgSize(*msg, &baseSize, &marshalledSize, MARSHALL_DBPTR | MARSHALL_NSADDR);
-        ASSERT((baseSize+marshalledSize) == count);
-        // The unmarshalling is just fixing up fields to point to the correct
-        // payload address trailing after the base message.
-        //BUG #604 Communication API extensions
-        //1)     I'm thinking we can further customize un/marshalling for MPI. Because we use
-        //       mpi tags, we actually don't need to send the header part of response message.
-        //       We can directly recv the message at msg + header, update the msg header
-        //       to be a response + flip src/dst.
-        //2)     See if we can improve unmarshalling by keeping around pointers for the various
-        //       payload to be unmarshalled
-        //3)     We also need to deguidify all the fatGuids that are 'local' and decide
-        //       where it is appropriate to do it.
-        //       - REC: I think the right place would be in the user code (ie: not the comm layer)
-        ocrPolicyMsgUnMarshallMsg((u8*)*msg, NULL, *msg,
-                                  MARSHALL_APPEND | MARSHALL_NSADDR | MARSHALL_DBPTR);
+        unmarshallIncoming(self, *msg, count, false);
         return POLL_MORE_MESSAGE;
     }
     return POLL_NO_MESSAGE;
@@ -368,6 +718,10 @@ u8 MPICommPollMessageInternal(ocrCommPlatform_t *self, ocrPolicyMsg_t **msg,
     ASSERT(msg != NULL);
     ASSERT((*msg == NULL) && "MPI comm-layer cannot poll for a specific message");
 
+#if MPI_COMM_COALESCE
+    coalesceFlushAged(self, false);
+#endif
+
     // Iterate over outgoing communications (mpi sends)
     iterator_t * outgoingIt = mpiComm->outgoingIt;
     outgoingIt->reset(outgoingIt);
@@ -376,10 +730,12 @@ u8 MPICommPollMessageInternal(ocrCommPlatform_t *self, ocrPolicyMsg_t **msg,
         int completed = 0;
         RESULT_ASSERT(MPI_Test(&(mpiHandle->status), &completed, MPI_STATUS_IGNORE), ==, MPI_SUCCESS);
         if(completed) {
-            DPRINTF(DEBUG_LVL_VVERB,"[MPI %"PRId32"] sent msg=%p src=%"PRId32", dst=%"PRId32", msgId=%"PRIu64", type=0x%"PRIx32", usefulSize=%"PRIu64"\n",
-                    locationToMpiRank(self->pd->myLocation), mpiHandle->msg,
-                    locationToMpiRank(mpiHandle->msg->srcLocation), locationToMpiRank(mpiHandle->msg->destLocation),
-                    mpiHandle->msg->msgId, mpiHandle->msg->type, mpiHandle->msg->usefulSize);
+            if (!mpiHandle->isBatch) {
+                DPRINTF(DEBUG_LVL_VVERB,"[MPI %"PRId32"] sent msg=%p src=%"PRId32", dst=%"PRId32", msgId=%"PRIu64", type=0x%"PRIx32", usefulSize=%"PRIu64"\n",
+                        locationToMpiRank(self->pd->myLocation), mpiHandle->msg,
+                        locationToMpiRank(mpiHandle->msg->srcLocation), locationToMpiRank(mpiHandle->msg->destLocation),
+                        mpiHandle->msg->msgId, mpiHandle->msg->type, mpiHandle->msg->usefulSize);
+            }
             u32 msgProperties = mpiHandle->properties;
             // By construction, either messages are persistent in API's upper levels
             // or they've been made persistent on the send through a copy.
@@ -397,6 +753,16 @@ u8 MPICommPollMessageInternal(ocrCommPlatform_t *self, ocrPolicyMsg_t **msg,
         }
     }
 
+    // Iterate over the payload sends of one-way rendezvous
+    iterator_t * rdvOutgoingIt = mpiComm->rdvOutgoingIt;
+    rdvOutgoingIt->reset(rdvOutgoingIt);
+    while (rdvOutgoingIt->hasNext(rdvOutgoingIt)) {
+        mpiCommRdv_t * rdv = (mpiCommRdv_t *) rdvOutgoingIt->next(rdvOutgoingIt);
+        if (rdvComplete(self, rdv, false)) {
+            rdvOutgoingIt->removeCurrent(rdvOutgoingIt);
+        }
+    }
+
     // Iterate over incoming communications (mpi recvs)
     iterator_t * incomingIt = mpiComm->incomingIt;
     incomingIt->reset(incomingIt);
@@ -435,6 +801,11 @@ u8 MPICommPollMessageInternal(ocrCommPlatform_t *self, ocrPolicyMsg_t **msg,
                 pd->fcts.pdFree(pd, reqMsg);
             }
             ASSERT(mpiHandle->msg->msgId == mpiHandle->msgId);
+            if (mpiHandle->rdv != NULL) {
+                // The peer got the payload since it responded, only let go
+                // of it once MPI is done with the sends too
+                rdvComplete(self, mpiHandle->rdv, true);
+            }
             *msg = mpiHandle->msg;
             pd->fcts.pdFree(pd, mpiHandle);
             incomingIt->removeCurrent(incomingIt);
@@ -481,11 +852,16 @@ u8 MPICommPollMessageInternal(ocrCommPlatform_t *self, ocrPolicyMsg_t **msg,
 #if STRATEGY_PROBE_RECV
     // Check for outstanding incoming. If any, a message is allocated
     // and returned through 'msg'.
+#if MPI_COMM_COALESCE
+    retCode = coalesceNextIncoming(self, msg);
+#else
     retCode = probeIncoming(self, MPI_ANY_SOURCE, RECV_ANY_ID, msg, 0);
+#endif
     // Message is properly un-marshalled at this point
 #endif
     if (retCode == POLL_NO_MESSAGE) {
-        retCode |= (mpiComm->outgoing->isEmpty(mpiComm->outgoing)) ? POLL_NO_OUTGOING_MESSAGE : 0;
+        retCode |= ((mpiComm->outgoing->isEmpty(mpiComm->outgoing)) && (mpiComm->coalescePending == 0) &&
+                    (mpiComm->rdvOutgoing->isEmpty(mpiComm->rdvOutgoing))) ? POLL_NO_OUTGOING_MESSAGE : 0;
         retCode |= (mpiComm->incoming->isEmpty(mpiComm->incoming)) ? POLL_NO_INCOMING_MESSAGE : 0;
     }
     return retCode;
@@ -505,6 +881,10 @@ u8 MPICommPollMessage(ocrCommPlatform_t *self, ocrPolicyMsg_t **msg,
 u8 MPICommWaitMessage(ocrCommPlatform_t *self, ocrPolicyMsg_t **msg,
                       u32 properties, u32 *mask) {
     u8 ret = 0;
+#if MPI_COMM_COALESCE
+    // Do not let messages sit in the buffers while we wait
+    coalesceFlushAged(self, true);
+#endif
     do {
         ret = self->fcts.pollMessage(self, msg, properties, mask);
     } while(ret != POLL_MORE_MESSAGE);
@@ -512,6 +892,27 @@ u8 MPICommWaitMessage(ocrCommPlatform_t *self, ocrPolicyMsg_t **msg,
     return ret;
 }
 
+/**
+ * @brief Internal use - Prints the DB payload statistics of this lane if the
+ * OCR_DIST_STATS environment variable is set
+ */
+static void mpiCommDumpStats(ocrCommPlatform_t * self) {
+    ocrCommPlatformMPI_t * mpiComm = (ocrCommPlatformMPI_t *) self;
+    char * enabled = getenv("OCR_DIST_STATS");
+    if ((enabled == NULL) || (enabled[0] == '\0')) {
+        return;
+    }
+    PRINTF("[MPI %"PRId32" lane %"PRIu32"] DB acquire payloads: %"PRIu64" sent, %"PRIu64" bytes copied per acquire; "
+           "%"PRIu64" received, %"PRIu64" bytes copied per acquire\n",
+           locationToMpiRank(self->pd->myLocation), self->laneId,
+           mpiComm->statAcqSent, mpiComm->statAcqSent ? (mpiComm->statAcqSentCopied / mpiComm->statAcqSent) : 0,
+           mpiComm->statAcqRecv, mpiComm->statAcqRecv ? (mpiComm->statAcqRecvCopied / mpiComm->statAcqRecv) : 0);
+    PRINTF("[MPI %"PRId32" lane %"PRIu32"] Rendezvous payloads: %"PRIu64" sent (%"PRIu64" KB not copied), "
+           "%"PRIu64" received (%"PRIu64" KB not copied)\n",
+           locationToMpiRank(self->pd->myLocation), self->laneId,
+           mpiComm->statRdvSent, mpiComm->statRdvSentBytes >> 10, mpiComm->statRdvRecv, mpiComm->statRdvRecvBytes >> 10);
+}
+
 u8 MPICommSwitchRunlevel(ocrCommPlatform_t *self, ocrPolicyDomain_t *PD, ocrRunlevel_t runlevel,
                                 phase_t phase, u32 properties, void (*callback)(ocrPolicyDomain_t*, u64), u64 val) {
     ocrCommPlatformMPI_t * mpiComm = ((ocrCommPlatformMPI_t *) self);
@@ -543,13 +944,39 @@ u8 MPICommSwitchRunlevel(ocrCommPlatform_t *self, ocrPolicyDomain_t *PD, ocrRunl
     case RL_GUID_OK:
         ASSERT(self->pd == PD);
         if((properties & RL_BRING_UP) && RL_IS_LAST_PHASE_UP(self->pd, RL_GUID_OK, phase)) {
-            //BUG #602 multi-comm-worker: multi-initialization if multiple comm-worker
+            // Each lane gets its own communicators. Duplication is collective:
+            // lanes are brought up in the same order on all ranks.
+            ASSERT(((self->laneCount == 1) || (mpiThreadLevel == MPI_THREAD_MULTIPLE)) &&
+                   "Several comm-workers require MPI_THREAD_MULTIPLE");
+            RESULT_ASSERT(MPI_Comm_dup(MPI_COMM_WORLD, &(mpiComm->comm)), ==, MPI_SUCCESS);
             //Initialize mpi comm internal queues
             mpiComm->msgId = 1;
             mpiComm->incoming = newLinkedList(PD);
             mpiComm->outgoing = newLinkedList(PD);
             mpiComm->incomingIt = mpiComm->incoming->iterator(mpiComm->incoming);
             mpiComm->outgoingIt = mpiComm->outgoing->iterator(mpiComm->outgoing);
+            mpiComm->rdvOutgoing = newLinkedList(PD);
+            mpiComm->rdvOutgoingIt = mpiComm->rdvOutgoing->iterator(mpiComm->rdvOutgoing);
+            RESULT_ASSERT(MPI_Comm_dup(MPI_COMM_WORLD, &(mpiComm->rdvComm)), ==, MPI_SUCCESS);
+            int * tagUb = NULL;
+            int hasTagUb = 0;
+            RESULT_ASSERT(MPI_Comm_get_attr(MPI_COMM_WORLD, MPI_TAG_UB, &tagUb, &hasTagUb), ==, MPI_SUCCESS);
+            // The standard guarantees at least 32767
+            mpiComm->rdvTagUb = (hasTagUb && (tagUb != NULL)) ? (u64) *tagUb : 32767;
+            mpiComm->rdvId = 0;
+#if MPI_COMM_COALESCE
+            int nbBufs;
+            MPI_Comm_size(MPI_COMM_WORLD, &nbBufs);
+            mpiComm->coalesceBufCount = (u32) nbBufs;
+            mpiComm->coalesceBufs = PD->fcts.pdMalloc(PD, sizeof(mpiCommCoalesceBuf_t) * nbBufs);
+            int b;
+            for (b = 0; b < nbBufs; ++b) {
+                mpiComm->coalesceBufs[b].data = NULL;
+                mpiComm->coalesceBufs[b].used = 0;
+                mpiComm->coalesceBufs[b].capacity = 0;
+                mpiComm->coalesceBufs[b].startTime = 0;
+            }
+#endif
 
             // Default max size is customizable through setMaxExpectedMessageSize()
 #if STRATEGY_PRE_POST_RECV
@@ -560,26 +987,28 @@ u8 MPICommSwitchRunlevel(ocrCommPlatform_t *self, ocrPolicyDomain_t *PD, ocrRunl
             // Do not need that with probe
             ASSERT(mpiComm->maxMsgSize == 0);
 #endif
-            // Generate the list of known neighbors (All-to-all)
-            //BUG #606 Neighbor registration: neighbor information should come from discovery or topology description
-            int nbRanks;
-            MPI_Comm_size(MPI_COMM_WORLD, &nbRanks);
-            PD->neighborCount = nbRanks - 1;
-            PD->neighbors = PD->fcts.pdMalloc(PD, sizeof(ocrLocation_t) * PD->neighborCount);
-            int myRank = (int) locationToMpiRank(PD->myLocation);
-            int i = 0;
-            while(i < (nbRanks-1)) {
-                PD->neighbors[i] = mpiRankToLocation((myRank+i+1)%nbRanks);
-                DPRINTF(DEBUG_LVL_VERB,"[MPI %"PRId32"] Neighbors[%"PRId32"] is %"PRIu64"\n", myRank, i, PD->neighbors[i]);
-                i++;
-            }
+            if (self->laneId == 0) {
+                // Generate the list of known neighbors (All-to-all)
+                //BUG #606 Neighbor registration: neighbor information should come from discovery or topology description
+                int nbRanks;
+                MPI_Comm_size(MPI_COMM_WORLD, &nbRanks);
+                PD->neighborCount = nbRanks - 1;
+                PD->neighbors = PD->fcts.pdMalloc(PD, sizeof(ocrLocation_t) * PD->neighborCount);
+                int myRank = (int) locationToMpiRank(PD->myLocation);
+                int i = 0;
+                while(i < (nbRanks-1)) {
+                    PD->neighbors[i] = mpiRankToLocation((myRank+i+1)%nbRanks);
+                    DPRINTF(DEBUG_LVL_VERB,"[MPI %"PRId32"] Neighbors[%"PRId32"] is %"PRIu64"\n", myRank, i, PD->neighbors[i]);
+                    i++;
+                }
 #ifdef DEBUG_MPI_HOSTNAMES
-            char hostname[256];
-            gethostname(hostname,255);
-            PRINTF("MPI rank %"PRId32" on host %s\n", myRank, hostname);
+                char hostname[256];
+                gethostname(hostname,255);
+                PRINTF("MPI rank %"PRId32" on host %s\n", myRank, hostname);
 #endif
+            }
             // Runlevel barrier across policy-domains
-            MPI_Barrier(MPI_COMM_WORLD);
+            MPI_Barrier(mpiComm->comm);
 
 #if STRATEGY_PRE_POST_RECV
             // Post a recv any to start listening to incoming communications
@@ -601,10 +1030,26 @@ u8 MPICommSwitchRunlevel(ocrCommPlatform_t *self, ocrPolicyDomain_t *PD, ocrRunl
             mpiComm->incoming->destruct(mpiComm->incoming);
             ASSERT(mpiComm->outgoing->isEmpty(mpiComm->outgoing));
             mpiComm->outgoing->destruct(mpiComm->outgoing);
+#if MPI_COMM_COALESCE
+            ASSERT(mpiComm->coalescePending == 0);
+            ASSERT(mpiComm->rxBatch == NULL);
+            PD->fcts.pdFree(PD, mpiComm->coalesceBufs);
+            mpiComm->coalesceBufs = NULL;
+            mpiComm->coalesceBufCount = 0;
+#endif
+            ASSERT(mpiComm->rdvOutgoing->isEmpty(mpiComm->rdvOutgoing));
+            mpiComm->rdvOutgoingIt->destruct(mpiComm->rdvOutgoingIt);
+            mpiComm->rdvOutgoing->destruct(mpiComm->rdvOutgoing);
+            mpiComm->rdvOutgoing = NULL;
+            MPI_Comm_free(&(mpiComm->rdvComm));
+            MPI_Comm_free(&(mpiComm->comm));
+            mpiCommDumpStats(self);
             mpiComm->incomingIt->destruct(mpiComm->incomingIt);
             mpiComm->outgoingIt->destruct(mpiComm->outgoingIt);
-            PD->fcts.pdFree(PD, PD->neighbors);
-            PD->neighbors = NULL;
+            if (self->laneId == 0) {
+                PD->fcts.pdFree(PD, PD->neighbors);
+                PD->neighbors = NULL;
+            }
         }
         break;
     case RL_COMPUTE_OK:
@@ -630,7 +1075,9 @@ u8 MPICommSwitchRunlevel(ocrCommPlatform_t *self, ocrPolicyDomain_t *PD, ocrRunl
 
 void MPICommDestruct (ocrCommPlatform_t * self) {
     //This should be called only once per rank and by the same thread that did MPI_Init.
-    platformFinalizeMPIComm();
+    if (self->laneId == 0) {
+        platformFinalizeMPIComm();
+    }
     runtimeChunkFree((u64)self, PERSISTENT_CHUNK);
 }
 
@@ -657,12 +1104,31 @@ void destructCommPlatformFactoryMPI(ocrCommPlatformFactory_t *factory) {
 void initializeCommPlatformMPI(ocrCommPlatformFactory_t * factory, ocrCommPlatform_t * base, ocrParamList_t * perInstance) {
     initializeCommPlatformOcr(factory, base, perInstance);
     ocrCommPlatformMPI_t * mpiComm = (ocrCommPlatformMPI_t*) base;
+    mpiComm->comm = MPI_COMM_NULL;
     mpiComm->msgId = 1; // all recv ANY use id '0'
     mpiComm->incoming = NULL;
     mpiComm->outgoing = NULL;
     mpiComm->incomingIt = NULL;
     mpiComm->outgoingIt = NULL;
     mpiComm->maxMsgSize = 0;
+    mpiComm->coalesceBufs = NULL;
+    mpiComm->coalesceBufCount = 0;
+    mpiComm->coalescePending = 0;
+    mpiComm->rxBatch = NULL;
+    mpiComm->rxBatchSize = 0;
+    mpiComm->rxBatchOffset = 0;
+    mpiComm->rdvId = 0;
+    mpiComm->rdvTagUb = 0;
+    mpiComm->rdvOutgoing = NULL;
+    mpiComm->rdvOutgoingIt = NULL;
+    mpiComm->statAcqSent = 0;
+    mpiComm->statAcqSentCopied = 0;
+    mpiComm->statAcqRecv = 0;
+    mpiComm->statAcqRecvCopied = 0;
+    mpiComm->statRdvSent = 0;
+    mpiComm->statRdvSentBytes = 0;
+    mpiComm->statRdvRecv = 0;
+    mpiComm->statRdvRecvBytes = 0;
     mpiComm->curState = 0;
 }
 
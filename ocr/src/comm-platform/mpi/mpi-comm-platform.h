@@ -16,6 +16,7 @@
 #include "utils/ocr-utils.h"
 #include "utils/list.h"
 #include "ocr-comm-platform.h"
+#include <mpi.h>
 
 typedef struct {
     ocrCommPlatformFactory_t base;
@@ -23,14 +24,70 @@ typedef struct {
 
 #define MPI_COMM_RL_MAX 3
 
+// Size in bytes of the per-destination buffers one-way messages are
+// aggregated in before being sent in a single MPI call (0 disables coalescing)
+#ifndef MPI_COMM_COALESCE_SIZE
+#define MPI_COMM_COALESCE_SIZE 8192
+#endif
+
+// Maximum time in nanoseconds a message stays in a coalescing buffer
+#ifndef MPI_COMM_COALESCE_AGE_NS
+#define MPI_COMM_COALESCE_AGE_NS 20000
+#endif
+
+// DB payloads (acquire responses and write-back releases) of at least this
+// many bytes are not marshalled in the policy message. They are sent from the
+// DB memory in a separate MPI message the receiver matches with a tag carried
+// in place of the pointer (0 disables the rendezvous)
+#ifndef MPI_COMM_RDV_THRESHOLD
+#define MPI_COMM_RDV_THRESHOLD (64*1024)
+#endif
+
+/**
+ * @brief Aggregation buffer for messages going to one MPI rank
+ *
+ * Each entry is the size of the marshalled message (u64) followed by
+ * the message itself, padded to 8 bytes.
+ */
+typedef struct {
+    u8 * data;
+    u64 used;
+    u64 capacity;
+    u64 startTime; // When the first entry was added
+} mpiCommCoalesceBuf_t;
+
 typedef struct {
     ocrCommPlatform_t base;
+    MPI_Comm comm;       // Communicator of this lane (a duplicate of MPI_COMM_WORLD)
     u64 msgId;
     linkedlist_t * incoming;
     linkedlist_t * outgoing;
     iterator_t * incomingIt;
     iterator_t * outgoingIt;
     u64 maxMsgSize;
+    // Outgoing coalescing buffers, indexed by MPI rank
+    mpiCommCoalesceBuf_t * coalesceBufs;
+    u32 coalesceBufCount;
+    u32 coalescePending; // Number of non-empty coalescing buffers
+    // Incoming batch being unpacked
+    u8 * rxBatch;
+    u64 rxBatchSize;
+    u64 rxBatchOffset;
+    // Rendezvous payload transfers
+    MPI_Comm rdvComm;    // Payloads are matched on their own communicator
+    u64 rdvId;           // Tag of the next outgoing payload
+    u64 rdvTagUb;        // Largest tag the MPI library supports
+    linkedlist_t * rdvOutgoing; // Payload sends of one-way messages
+    iterator_t * rdvOutgoingIt;
+    // DB acquire payloads statistics
+    u64 statAcqSent;        // Acquire responses with a payload sent
+    u64 statAcqSentCopied;  // Bytes of these payloads copied by the comm-platform
+    u64 statAcqRecv;        // Acquire responses with a payload received
+    u64 statAcqRecvCopied;  // Bytes of these payloads copied by the comm-platform
+    u64 statRdvSent;        // Payloads sent through the rendezvous
+    u64 statRdvSentBytes;   // Bytes of these payloads, not copied by the comm-platform
+    u64 statRdvRecv;        // Payloads received through the rendezvous
+    u64 statRdvRecvBytes;   // Bytes of these payloads, not copied by the comm-platform
     // The state encodes the RL (top 4 bits) and the phase (bottom 4 bits)
     // This is mainly for debugging purpose
     volatile u8 curState;
@@ -0,0 +1,802 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#include "ocr-config.h"
+#ifdef ENABLE_COMM_PLATFORM_SHM
+
+#include "debug.h"
+
+#include "ocr-datablock.h"
+#include "ocr-sysboot.h"
+#include "ocr-policy-domain.h"
+#include "ocr-worker.h"
+
+#include "utils/ocr-utils.h"
+
+#include "shm-comm-platform.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define DEBUG_TYPE COMM_PLATFORM
+
+#if (SHM_COMM_RING_SIZE & (SHM_COMM_RING_SIZE - 1)) || (SHM_COMM_RING_SIZE < 4096)
+#error SHM_COMM_RING_SIZE must be a power of 2 of at least 4096
+#endif
+
+// To tag responses that are not tied to a request (asynchronous responses)
+#define SEND_ANY_ID 0
+
+//
+// Shared segment layout
+//
+
+// Ring records are a header followed by the payload, padded to SHM_REC_ALIGN
+#define SHM_REC_ALIGN 32
+#define SHM_REC_SIZE(len) (sizeof(shmCommRecord_t) + (((len) + SHM_REC_ALIGN - 1) & ~((u64) SHM_REC_ALIGN - 1)))
+
+#define SHM_REC_PAD      0x1  // Filler up to the end of the ring
+#define SHM_REC_FIRST    0x2  // First fragment of a message
+#define SHM_REC_MORE     0x4  // Other fragments of the message follow
+#define SHM_REC_RESPONSE 0x8  // Response to the request 'msgId' of the receiver
+#define SHM_REC_NO_DBPTR 0x10 // Marshalled without the DB payload (shared ptr)
+
+typedef struct {
+    u32 len;   // Bytes of payload in this record
+    u32 flags;
+    u64 total; // Size of the whole message
+    u64 msgId;
+    u64 pad;
+} shmCommRecord_t;
+
+typedef struct {
+    volatile u64 tail; // Only written by the producer
+    u8 pad0[56];
+    volatile u64 head; // Only written by the consumer
+    u8 pad1[56];
+    u8 data[SHM_COMM_RING_SIZE];
+} shmCommRing_t;
+
+typedef struct {
+    u32 nbRanks;
+    volatile u32 barrierCount;
+    volatile u32 barrierGen;
+} shmCommSegment_t;
+
+#define SHM_SEGMENT_HDR_SIZE 4096
+#define SHM_PAGE_ALIGN(size) (((size) + 4095) & ~((u64) 4095))
+
+// Process-wide state, set up before the runtime is brought up
+static u8 * shmSegment = NULL;
+static u64 shmSegmentSize = 0;
+static u32 shmRank = 0;
+static u32 shmNbRanks = 0;
+static u64 shmHeapUsed = 0;
+static u8 * shmHeapsStart = NULL; // Kept after unmapping for shmCommIsSharedPtr
+static u8 * shmHeapsEnd = NULL;
+static volatile pid_t * shmChildren = NULL; // Indexed by rank, only used by rank 0
+
+static shmCommRing_t * shmRing(u32 src, u32 dst) {
+    return (shmCommRing_t *) (shmSegment + SHM_SEGMENT_HDR_SIZE +
+                              ((((u64) src) * shmNbRanks) + dst) * sizeof(shmCommRing_t));
+}
+
+static u8 * shmHeap(u32 rank) {
+    u64 ringsEnd = SHM_PAGE_ALIGN(SHM_SEGMENT_HDR_SIZE + ((u64) shmNbRanks) * shmNbRanks * sizeof(shmCommRing_t));
+    return shmSegment + ringsEnd + (((u64) rank) * SHM_COMM_HEAP_SIZE);
+}
+
+/**
+ * @brief Internal use - Waits for all the PDs to get there
+ */
+static void shmBarrier() {
+    shmCommSegment_t * seg = (shmCommSegment_t *) shmSegment;
+    u32 gen = hal_loadAcquire(&(seg->barrierGen));
+    if (hal_xadd32(&(seg->barrierCount), 1) == (shmNbRanks - 1)) {
+        seg->barrierCount = 0;
+        hal_storeRelease(&(seg->barrierGen), gen + 1);
+    } else {
+        while (hal_loadAcquire(&(seg->barrierGen)) == gen) {
+            hal_pause();
+        }
+    }
+}
+
+/**
+ * @brief Internal use - Reaps the PDs that terminate before rank 0 waits for them.
+ * A PD killed by a signal takes the others down with it.
+ */
+static void shmChildHandler(int sig) {
+    int status;
+    pid_t pid;
+    while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+        u32 i;
+        for (i = 1; i < shmNbRanks; ++i) {
+            if (shmChildren[i] == pid) {
+                shmChildren[i] = 0;
+            }
+        }
+        if (WIFSIGNALED(status)) {
+            for (i = 1; i < shmNbRanks; ++i) {
+                if (shmChildren[i] != 0) {
+                    kill(shmChildren[i], SIGKILL);
+                }
+            }
+            _exit(128 + WTERMSIG(status));
+        }
+    }
+}
+
+//
+// Process setup and teardown
+//
+
+/**
+ * @brief Maps the shared segment and forks one process per additional PD.
+ *
+ * Must be called before any thread is created. The calling process becomes
+ * PD 0 and the children PD 1 to OCR_SHM_NUM_PDS-1. All of them then go on
+ * bringing up the runtime.
+ */
+void platformInitShmComm(int * argc, char *** argv) {
+    const char * nbRanksEnv = getenv("OCR_SHM_NUM_PDS");
+    shmNbRanks = (nbRanksEnv != NULL) ? (u32) atoi(nbRanksEnv) : 1;
+    if (shmNbRanks == 0) {
+        shmNbRanks = 1;
+    }
+    shmSegmentSize = SHM_PAGE_ALIGN(SHM_SEGMENT_HDR_SIZE + ((u64) shmNbRanks) * shmNbRanks * sizeof(shmCommRing_t)) +
+                     (((u64) shmNbRanks) * SHM_COMM_HEAP_SIZE);
+    char name[64];
+    snprintf(name, sizeof(name), "/ocr-shm-%"PRId32, (s32) getpid());
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd == -1) {
+        fprintf(stderr, "error: unable to create shared memory segment %s\n", name);
+        hal_exit(1);
+    }
+    // The mappings keep the segment alive, no need for a name anymore
+    shm_unlink(name);
+    if (ftruncate(fd, shmSegmentSize) != 0) {
+        fprintf(stderr, "error: unable to size shared memory segment to %"PRIu64" bytes\n", shmSegmentSize);
+        hal_exit(1);
+    }
+    void * seg = mmap(NULL, shmSegmentSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_NORESERVE, fd, 0);
+    close(fd);
+    if (seg == MAP_FAILED) {
+        fprintf(stderr, "error: unable to map shared memory segment of %"PRIu64" bytes\n", shmSegmentSize);
+        hal_exit(1);
+    }
+    // The segment comes zeroed, so are the rings' head and tail
+    shmSegment = (u8 *) seg;
+    ((shmCommSegment_t *) shmSegment)->nbRanks = shmNbRanks;
+    shmHeapsStart = shmHeap(0);
+    shmHeapsEnd = shmSegment + shmSegmentSize;
+    shmChildren = (volatile pid_t *) calloc(shmNbRanks, sizeof(pid_t));
+    signal(SIGCHLD, shmChildHandler);
+    fflush(stdout);
+    fflush(stderr);
+    pid_t parent = getpid();
+    u32 i;
+    for (i = 1; i < shmNbRanks; ++i) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            shmRank = i;
+            signal(SIGCHLD, SIG_DFL);
+            // Do not outlive rank 0
+            prctl(PR_SET_PDEATHSIG, SIGKILL);
+            if (getppid() != parent) {
+                _exit(1);
+            }
+            break;
+        }
+        if (pid == -1) {
+            fprintf(stderr, "error: unable to fork process for PD %"PRIu32"\n", i);
+            hal_exit(1);
+        }
+        shmChildren[i] = pid;
+    }
+}
+
+/**
+ * @brief Unmaps the shared segment. Rank 0 waits for the other PDs to terminate.
+ */
+void platformFinalizeShmComm() {
+    // Nobody uses the rings anymore once all PDs got here
+    shmBarrier();
+    if (shmRank == 0) {
+        signal(SIGCHLD, SIG_DFL);
+        u32 i;
+        for (i = 1; i < shmNbRanks; ++i) {
+            if (shmChildren[i] != 0) {
+                int status;
+                waitpid(shmChildren[i], &status, 0);
+                shmChildren[i] = 0;
+            }
+        }
+    }
+    free((void *) shmChildren);
+    shmChildren = NULL;
+    munmap(shmSegment, shmSegmentSize);
+    shmSegment = NULL;
+}
+
+void * shmCommHeapAlloc(u64 size) {
+    if (shmSegment == NULL) {
+        return NULL;
+    }
+    size = SHM_PAGE_ALIGN(size);
+    if ((shmHeapUsed + size) > SHM_COMM_HEAP_SIZE) {
+        DPRINTF(DEBUG_LVL_WARN, "Shared heap exhausted, %"PRIu64" bytes allocated in private memory\n", size);
+        return NULL;
+    }
+    void * ptr = shmHeap(shmRank) + shmHeapUsed;
+    shmHeapUsed += size;
+    return ptr;
+}
+
+bool shmCommIsSharedPtr(void * ptr) {
+    return (((u8 *) ptr) >= shmHeapsStart) && (((u8 *) ptr) < shmHeapsEnd);
+}
+
+//
+// Communication implementation
+//
+
+typedef struct _shmCommHandle_t {
+    u64 msgId; // The shm comm layer message id for this communication
+    u32 properties;
+    u32 recFlags;
+    ocrPolicyMsg_t * msg;
+    u64 size;   // Marshalled size of 'msg'
+    u64 offset; // Bytes of 'msg' already written to the ring
+    struct _shmCommHandle_t * next;
+    u8 deleteSendMsg;
+} shmCommHandle_t;
+
+static ocrLocation_t shmRankToLocation(u32 rank) {
+    //BUG #605 Locations spec: identity integer cast for now
+    return (ocrLocation_t) rank;
+}
+
+static u32 locationToShmRank(ocrLocation_t location) {
+    //BUG #605 Locations spec: identity integer cast for now
+    return (u32) location;
+}
+
+/**
+ * @brief Internal use - Returns a new message
+ */
+static ocrPolicyMsg_t * allocateNewMessage(ocrCommPlatform_t * self, u64 size) {
+    ocrPolicyDomain_t * pd = self->pd;
+    ocrPolicyMsg_t * message = pd->fcts.pdMalloc(pd, size);
+    initializePolicyMessage(message, size);
+    return message;
+}
+
+/**
+ * @brief Internal use - Writes as much of the message of 'handle' as fits in 'ring'
+ * @return true if the whole message has been written
+ */
+static bool ringWrite(shmCommRing_t * ring, shmCommHandle_t * handle) {
+    u64 tail = ring->tail;
+    bool done = true;
+    while (handle->offset < handle->size) {
+        u64 head = hal_loadAcquire(&(ring->head));
+        u64 freeSpace = SHM_COMM_RING_SIZE - (tail - head);
+        u64 contiguous = SHM_COMM_RING_SIZE - (tail & (SHM_COMM_RING_SIZE - 1));
+        u64 space = (freeSpace < contiguous) ? freeSpace : contiguous;
+        u64 remaining = handle->size - handle->offset;
+        u64 minChunk = (remaining < SHM_COMM_FRAGMENT_MIN) ? remaining : SHM_COMM_FRAGMENT_MIN;
+        shmCommRecord_t * rec = (shmCommRecord_t *) &(ring->data[tail & (SHM_COMM_RING_SIZE - 1)]);
+        if (space < SHM_REC_SIZE(minChunk)) {
+            if (contiguous < freeSpace) {
+                // Not worth splitting the message here, wrap around
+                rec->len = (u32) (contiguous - sizeof(shmCommRecord_t));
+                rec->flags = SHM_REC_PAD;
+                tail += contiguous;
+                continue;
+            }
+            done = false; // Ring is full
+            break;
+        }
+        u64 chunk = space - sizeof(shmCommRecord_t);
+        if (chunk > remaining) {
+            chunk = remaining;
+        }
+        rec->len = (u32) chunk;
+        rec->flags = handle->recFlags | ((handle->offset == 0) ? SHM_REC_FIRST : 0) |
+                     ((chunk < remaining) ? SHM_REC_MORE : 0);
+        rec->total = handle->size;
+        rec->msgId = handle->msg->msgId;
+        hal_memCopy(rec + 1, ((u8 *) handle->msg) + handle->offset, chunk, false);
+        handle->offset += chunk;
+        tail += SHM_REC_SIZE(chunk);
+    }
+    hal_storeRelease(&(ring->tail), tail);
+    return done;
+}
+
+/**
+ * @brief Internal use - Called once the message of 'handle' has been fully written
+ */
+static void sendCompleted(ocrCommPlatform_t * self, shmCommHandle_t * handle) {
+    ocrCommPlatformShm_t * shmComm = (ocrCommPlatformShm_t *) self;
+    ocrPolicyDomain_t * pd = self->pd;
+    DPRINTF(DEBUG_LVL_VVERB,"[SHM %"PRIu32"] sent msg=%p dst=%"PRIu32", msgId=%"PRIu64", type=0x%"PRIx32", usefulSize=%"PRIu64"\n",
+            shmRank, handle->msg, locationToShmRank(handle->msg->destLocation),
+            handle->msg->msgId, handle->msg->type, handle->size);
+    // By construction, either messages are persistent in API's upper levels
+    // or they've been made persistent on the send through a copy.
+    ASSERT(handle->properties & PERSIST_MSG_PROP);
+    if (!(handle->properties & TWOWAY_MSG_PROP) || (handle->properties & ASYNC_MSG_PROP)) {
+        pd->fcts.pdFree(pd, handle->msg);
+        pd->fcts.pdFree(pd, handle);
+    } else {
+        // The message requires a response, the buffer may be reused to receive it
+        shmComm->incoming->pushFront(shmComm->incoming, handle);
+    }
+}
+
+/**
+ * @brief Internal use - Writes the messages queued for destinations whose ring was full
+ */
+static void progressPending(ocrCommPlatform_t * self) {
+    ocrCommPlatformShm_t * shmComm = (ocrCommPlatformShm_t *) self;
+    u32 dst;
+    for (dst = 0; (dst < shmComm->nbRanks) && (shmComm->pendingCount != 0); ++dst) {
+        shmCommHandle_t * handle = shmComm->pendingHead[dst];
+        while ((handle != NULL) && ringWrite(shmRing(shmRank, dst), handle)) {
+            shmComm->pendingHead[dst] = handle->next;
+            shmComm->pendingCount--;
+            sendCompleted(self, handle);
+            handle = shmComm->pendingHead[dst];
+        }
+        if (handle == NULL) {
+            shmComm->pendingTail[dst] = NULL;
+        }
+    }
+}
+
+/**
+ * @brief Internal use - Removes and returns the request 'msgId' is the response of
+ */
+static shmCommHandle_t * takeIncoming(ocrCommPlatform_t * self, u64 msgId) {
+    ocrCommPlatformShm_t * shmComm = (ocrCommPlatformShm_t *) self;
+    iterator_t * incomingIt = shmComm->incomingIt;
+    incomingIt->reset(incomingIt);
+    while (incomingIt->hasNext(incomingIt)) {
+        shmCommHandle_t * handle = (shmCommHandle_t *) incomingIt->next(incomingIt);
+        if (handle->msgId == msgId) {
+            incomingIt->removeCurrent(incomingIt);
+            return handle;
+        }
+    }
+    ASSERT(false && "Received a response for an unknown request");
+    return NULL;
+}
+
+/**
+ * @brief Internal use - Unmarshalls the message fully received in 'rx'
+ */
+static ocrPolicyMsg_t * receiveCompleted(ocrCommPlatform_t * self, shmCommRx_t * rx) {
+    ocrPolicyDomain_t * pd = self->pd;
+    ocrPolicyMsg_t * msg = rx->msg;
+    // The header has been overwritten by the sender's
+    msg->bufferSize = rx->bufferSize;
+    msg->usefulSize = rx->offset;
+    ASSERT(((msg->type & (PD_MSG_REQUEST | PD_MSG_RESPONSE)) != (PD_MSG_REQUEST | PD_MSG_RESPONSE)) &&
+           ((msg->type & PD_MSG_REQUEST) || (msg->type & PD_MSG_RESPONSE)));
+    u32 marshallFlags = MARSHALL_NSADDR | ((rx->flags & SHM_REC_NO_DBPTR) ? 0 : MARSHALL_DBPTR);
+    u64 baseSize = 0, marshalledSize = 0;
+    ocrPolicyMsgGetMsgSize(msg, &baseSize, &marshalledSize, marshallFlags);
+    ASSERT((baseSize + marshalledSize) == rx->offset);
+    ocrPolicyMsgUnMarshallMsg((u8*)msg, NULL, msg, MARSHALL_APPEND | marshallFlags);
+    shmCommHandle_t * handle = rx->handle;
+    if (handle != NULL) {
+        if ((msg != handle->msg) && handle->deleteSendMsg) {
+            // The request was a copy made by the comm-platform that
+            // could not hold the response, it is only known here.
+            pd->fcts.pdFree(pd, handle->msg);
+        }
+        ASSERT(msg->msgId == handle->msgId);
+        pd->fcts.pdFree(pd, handle);
+    }
+    DPRINTF(DEBUG_LVL_VVERB,"[SHM %"PRIu32"] received msg=%p src=%"PRIu32", msgId=%"PRIu64", type=0x%"PRIx32", usefulSize=%"PRIu64"\n",
+            shmRank, msg, locationToShmRank(msg->srcLocation), msg->msgId, msg->type, msg->usefulSize);
+    rx->msg = NULL;
+    rx->handle = NULL;
+    return msg;
+}
+
+/**
+ * @brief Internal use - Consumes records from the ring of 'src' until a message is complete
+ */
+static u8 ringRead(ocrCommPlatform_t * self, u32 src, ocrPolicyMsg_t ** msg) {
+    ocrCommPlatformShm_t * shmComm = (ocrCommPlatformShm_t *) self;
+    shmCommRing_t * ring = shmRing(src, shmRank);
+    shmCommRx_t * rx = &(shmComm->rx[src]);
+    u64 head = ring->head;
+    u64 tail = hal_loadAcquire(&(ring->tail));
+    if (head == tail) {
+        return POLL_NO_MESSAGE;
+    }
+    u8 ret = POLL_NO_MESSAGE;
+    while ((head != tail) && (ret == POLL_NO_MESSAGE)) {
+        shmCommRecord_t * rec = (shmCommRecord_t *) &(ring->data[head & (SHM_COMM_RING_SIZE - 1)]);
+        if (!(rec->flags & SHM_REC_PAD)) {
+            if (rec->flags & SHM_REC_FIRST) {
+                ASSERT(rx->msg == NULL);
+                rx->flags = rec->flags;
+                rx->offset = 0;
+                if (rec->flags & SHM_REC_RESPONSE) {
+                    // Receive in the request if it is large enough
+                    rx->handle = takeIncoming(self, rec->msgId);
+                    if (rx->handle->msg->bufferSize >= rec->total) {
+                        rx->msg = rx->handle->msg;
+                    }
+                }
+                if (rx->msg == NULL) {
+                    rx->msg = allocateNewMessage(self, rec->total);
+                }
+                rx->bufferSize = rx->msg->bufferSize;
+            }
+            ASSERT((rx->msg != NULL) && ((rx->offset + rec->len) <= rec->total));
+            hal_memCopy(((u8 *) rx->msg) + rx->offset, rec + 1, rec->len, false);
+            rx->offset += rec->len;
+            if (!(rec->flags & SHM_REC_MORE)) {
+                *msg = receiveCompleted(self, rx);
+                ret = POLL_MORE_MESSAGE;
+            }
+        }
+        head += SHM_REC_SIZE(rec->len);
+    }
+    hal_storeRelease(&(ring->head), head);
+    return ret;
+}
+
+//
+// Communication API
+//
+
+u8 shmCommSendMessage(ocrCommPlatform_t * self,
+                      ocrLocation_t target, ocrPolicyMsg_t * message,
+                      u64 *id, u32 properties, u32 mask) {
+
+    u64 bufferSize = message->bufferSize;
+    ocrCommPlatformShm_t * shmComm = ((ocrCommPlatformShm_t *) self);
+    u32 recFlags = 0;
+    u32 marshallFlags = MARSHALL_DBPTR | MARSHALL_NSADDR;
+
+    if (((message->type & PD_MSG_TYPE_ONLY) == PD_MSG_DB_ACQUIRE) && (message->type & PD_MSG_RESPONSE)) {
+#define PD_MSG (message)
+#define PD_TYPE PD_MSG_DB_ACQUIRE
+        if (shmCommIsSharedPtr(PD_MSG_FIELD_O(ptr))) {
+            // The requester maps the DB's pages: hand over the pointer instead of a copy
+            PD_MSG_FIELD_IO(properties) |= DB_FLAG_RT_SHARED_PTR;
+            marshallFlags = MARSHALL_NSADDR;
+            recFlags |= SHM_REC_NO_DBPTR;
+        }
+#undef PD_MSG
+#undef PD_TYPE
+    }
+
+    u64 baseSize = 0, marshalledSize = 0;
+    ocrPolicyMsgGetMsgSize(message, &baseSize, &marshalledSize, marshallFlags);
+    u64 fullMsgSize = baseSize + marshalledSize;
+
+    // Only this lane writes to the target's ring, ids are per instance
+    ASSERT(commPlatformLaneOf(self->pd->myLocation, target, self->laneCount) == self->laneId);
+    u64 shmId = shmComm->msgId++;
+
+    // If we're sending a request, set the message's msgId to this communication id
+    if (message->type & PD_MSG_REQUEST) {
+        message->msgId = shmId;
+    } else {
+        // For response in ASYNC set the message ID as any.
+        ASSERT(message->type & PD_MSG_RESPONSE);
+        if (properties & ASYNC_MSG_PROP) {
+            message->msgId = SEND_ANY_ID;
+        }
+        // else, for regular responses, just keep the original
+        // message's msgId the calling PD is waiting on.
+    }
+
+    ocrPolicyMsg_t * messageBuffer = message;
+
+    // Check if we need to allocate a new message buffer:
+    //  - Does the serialized message fit in the current message ?
+    //  - Is the message persistent (then need a copy anyway) ?
+    bool deleteSendMsg = false;
+    if ((fullMsgSize > bufferSize) || !(properties & PERSIST_MSG_PROP)) {
+        // Allocate message and marshall a copy
+        messageBuffer = allocateNewMessage(self, fullMsgSize);
+        ocrPolicyMsgMarshallMsg(message, baseSize, (u8*)messageBuffer,
+            MARSHALL_FULL_COPY | marshallFlags);
+        if (properties & PERSIST_MSG_PROP) {
+            if ((properties & TWOWAY_MSG_PROP) && (!(properties & ASYNC_MSG_PROP))) {
+                // The caller keeps 'message', the copy is freed when the response comes in
+                deleteSendMsg = true;
+            } else {
+                // One-way messages are heap-allocated copies the comm-platform frees
+                self->pd->fcts.pdFree(self->pd, message);
+                message = NULL; // to catch misuses later in this function call
+            }
+        } else {
+            // Message wasn't persistent, hence the caller is responsible for deallocation.
+            properties |= PERSIST_MSG_PROP;
+            ASSERT(false && "not used in current implementation (hence not tested)");
+        }
+    } else {
+        ocrMarshallMode_t marshallMode = (ocrMarshallMode_t) GET_PROP_U8_MARSHALL(properties);
+        if (marshallMode == 0) {
+            // Marshall the message. We made sure we had enough space.
+            ocrPolicyMsgMarshallMsg(messageBuffer, baseSize, (u8*)messageBuffer,
+                                    MARSHALL_APPEND | marshallFlags);
+        } else {
+            ASSERT(marshallMode == MARSHALL_FULL_COPY);
+        }
+    }
+
+    // Warning: From now on, exclusively use 'messageBuffer' instead of 'message'
+    ASSERT(fullMsgSize == messageBuffer->usefulSize);
+    u32 dst = locationToShmRank(target);
+    ASSERT((messageBuffer->srcLocation == self->pd->myLocation) &&
+        (messageBuffer->destLocation != self->pd->myLocation) &&
+        (dst == locationToShmRank(messageBuffer->destLocation)) && (dst < shmComm->nbRanks));
+    if ((messageBuffer->type & PD_MSG_RESPONSE) && (messageBuffer->msgId != SEND_ANY_ID)) {
+        recFlags |= SHM_REC_RESPONSE;
+    }
+
+    shmCommHandle_t * handle = self->pd->fcts.pdMalloc(self->pd, sizeof(shmCommHandle_t));
+    handle->msgId = shmId;
+    handle->properties = properties;
+    handle->recFlags = recFlags;
+    handle->msg = messageBuffer;
+    handle->size = fullMsgSize;
+    handle->offset = 0;
+    handle->next = NULL;
+    handle->deleteSendMsg = deleteSendMsg;
+
+    DPRINTF(DEBUG_LVL_VVERB,"[SHM %"PRIu32"] sending msgId=%"PRIu64" msg=%p type=%"PRIx32" "
+            "fullMsgSize=%"PRIu64" marshalledSize=%"PRIu64" to rank %"PRIu32"\n",
+            shmRank, messageBuffer->msgId, messageBuffer, messageBuffer->type, fullMsgSize, marshalledSize, dst);
+
+    // Preserve ordering with messages still waiting for room in the ring
+    if ((shmComm->pendingHead[dst] == NULL) && ringWrite(shmRing(shmRank, dst), handle)) {
+        sendCompleted(self, handle);
+    } else {
+        if (shmComm->pendingTail[dst] == NULL) {
+            shmComm->pendingHead[dst] = handle;
+        } else {
+            shmComm->pendingTail[dst]->next = handle;
+        }
+        shmComm->pendingTail[dst] = handle;
+        shmComm->pendingCount++;
+    }
+    *id = shmId;
+    return 0;
+}
+
+u8 shmCommPollMessageInternal(ocrCommPlatform_t *self, ocrPolicyMsg_t **msg,
+                              u32 properties, u32 *mask) {
+    ocrCommPlatformShm_t * shmComm = ((ocrCommPlatformShm_t *) self);
+
+    ASSERT(msg != NULL);
+    ASSERT((*msg == NULL) && "shm comm-layer cannot poll for a specific message");
+
+    if (shmComm->pendingCount != 0) {
+        progressPending(self);
+    }
+
+    // Visit the rings round-robin so that a busy sender does not starve the others.
+    // Rings of PDs talking to us through another lane are read by that lane.
+    u32 i;
+    u32 nbRanks = shmComm->nbRanks;
+    for (i = 0; i < nbRanks; ++i) {
+        u32 src = (shmComm->nextSrc + i) % nbRanks;
+        if ((src != shmRank) &&
+            (commPlatformLaneOf(shmRankToLocation(shmRank), shmRankToLocation(src), self->laneCount) == self->laneId) &&
+            (ringRead(self, src, msg) == POLL_MORE_MESSAGE)) {
+            shmComm->nextSrc = (src + 1) % nbRanks;
+            return POLL_MORE_MESSAGE;
+        }
+    }
+
+    u8 retCode = POLL_NO_MESSAGE;
+    retCode |= (shmComm->pendingCount == 0) ? POLL_NO_OUTGOING_MESSAGE : 0;
+    retCode |= (shmComm->incoming->isEmpty(shmComm->incoming)) ? POLL_NO_INCOMING_MESSAGE : 0;
+    return retCode;
+}
+
+u8 shmCommPollMessage(ocrCommPlatform_t *self, ocrPolicyMsg_t **msg,
+                      u32 properties, u32 *mask) {
+    ocrCommPlatformShm_t * shmComm __attribute__((unused)) = ((ocrCommPlatformShm_t *) self);
+    // Not supposed to be polled outside RL_USER_OK
+    ASSERT_BLOCK_BEGIN(((shmComm->curState >> 4) == RL_USER_OK))
+    DPRINTF(DEBUG_LVL_WARN,"[SHM %"PRIu32"] Illegal runlevel[%"PRId32"] reached in shm-comm-platform pollMessage\n",
+            shmRank, (shmComm->curState >> 4));
+    ASSERT_BLOCK_END
+    return shmCommPollMessageInternal(self, msg, properties, mask);
+}
+
+u8 shmCommWaitMessage(ocrCommPlatform_t *self, ocrPolicyMsg_t **msg,
+                      u32 properties, u32 *mask) {
+    u8 ret = 0;
+    do {
+        ret = self->fcts.pollMessage(self, msg, properties, mask);
+    } while(ret != POLL_MORE_MESSAGE);
+
+    return ret;
+}
+
+u8 shmCommSwitchRunlevel(ocrCommPlatform_t *self, ocrPolicyDomain_t *PD, ocrRunlevel_t runlevel,
+                         phase_t phase, u32 properties, void (*callback)(ocrPolicyDomain_t*, u64), u64 val) {
+    ocrCommPlatformShm_t * shmComm = ((ocrCommPlatformShm_t *) self);
+    u8 toReturn = 0;
+    // Verify properties for this call
+    ASSERT((properties & RL_REQUEST) && !(properties & RL_RESPONSE)
+           && !(properties & RL_RELEASE));
+    ASSERT(!(properties & RL_FROM_MSG));
+
+    switch(runlevel) {
+    case RL_CONFIG_PARSE:
+    case RL_NETWORK_OK:
+        // Nothing
+        break;
+    case RL_PD_OK:
+        if ((properties & RL_BRING_UP) && RL_IS_FIRST_PHASE_UP(PD, RL_PD_OK, phase)) {
+            self->pd = PD;
+            ASSERT((shmSegment != NULL) && "platformInitShmComm must be called first");
+            DPRINTF(DEBUG_LVL_VERB,"[SHM %"PRIu32"] comm-platform starts\n", shmRank);
+            PD->myLocation = shmRankToLocation(shmRank);
+        }
+        break;
+    case RL_MEMORY_OK:
+        // Nothing to do
+        break;
+    case RL_GUID_OK:
+        ASSERT(self->pd == PD);
+        if((properties & RL_BRING_UP) && RL_IS_LAST_PHASE_UP(self->pd, RL_GUID_OK, phase)) {
+            // Rings stay single producer/single consumer with several comm-workers
+            // since a single lane of each PD talks to a given PD.
+            shmComm->msgId = 1;
+            shmComm->incoming = newLinkedList(PD);
+            shmComm->incomingIt = shmComm->incoming->iterator(shmComm->incoming);
+            u32 nbRanks = shmNbRanks;
+            shmComm->nbRanks = nbRanks;
+            shmComm->pendingHead = PD->fcts.pdMalloc(PD, sizeof(shmCommHandle_t *) * nbRanks);
+            shmComm->pendingTail = PD->fcts.pdMalloc(PD, sizeof(shmCommHandle_t *) * nbRanks);
+            shmComm->rx = PD->fcts.pdMalloc(PD, sizeof(shmCommRx_t) * nbRanks);
+            u32 i;
+            for (i = 0; i < nbRanks; ++i) {
+                shmComm->pendingHead[i] = NULL;
+                shmComm->pendingTail[i] = NULL;
+                shmComm->rx[i].msg = NULL;
+                shmComm->rx[i].handle = NULL;
+                shmComm->rx[i].offset = 0;
+                shmComm->rx[i].bufferSize = 0;
+                shmComm->rx[i].flags = 0;
+            }
+            shmComm->pendingCount = 0;
+            shmComm->nextSrc = 0;
+            if (self->laneId == 0) {
+                // Generate the list of known neighbors (All-to-all)
+                //BUG #606 Neighbor registration: neighbor information should come from discovery or topology description
+                PD->neighborCount = nbRanks - 1;
+                PD->neighbors = PD->fcts.pdMalloc(PD, sizeof(ocrLocation_t) * PD->neighborCount);
+                for (i = 0; i < (nbRanks - 1); ++i) {
+                    PD->neighbors[i] = shmRankToLocation((shmRank + i + 1) % nbRanks);
+                    DPRINTF(DEBUG_LVL_VERB,"[SHM %"PRIu32"] Neighbors[%"PRIu32"] is %"PRIu64"\n", shmRank, i, PD->neighbors[i]);
+                }
+            }
+            // Runlevel barrier across policy-domains
+            shmBarrier();
+        }
+        if ((properties & RL_TEAR_DOWN) && RL_IS_FIRST_PHASE_DOWN(self->pd, RL_GUID_OK, phase)) {
+            ASSERT(shmComm->pendingCount == 0);
+            ASSERT(shmComm->incoming->isEmpty(shmComm->incoming));
+            shmComm->incomingIt->destruct(shmComm->incomingIt);
+            shmComm->incoming->destruct(shmComm->incoming);
+            u32 i;
+            for (i = 0; i < shmComm->nbRanks; ++i) {
+                ASSERT(shmComm->rx[i].msg == NULL);
+            }
+            PD->fcts.pdFree(PD, shmComm->pendingHead);
+            PD->fcts.pdFree(PD, shmComm->pendingTail);
+            PD->fcts.pdFree(PD, shmComm->rx);
+            shmComm->pendingHead = NULL;
+            shmComm->pendingTail = NULL;
+            shmComm->rx = NULL;
+            if (self->laneId == 0) {
+                PD->fcts.pdFree(PD, PD->neighbors);
+                PD->neighbors = NULL;
+            }
+        }
+        break;
+    case RL_COMPUTE_OK:
+        break;
+    case RL_USER_OK:
+        // Messages sent before this PD reaches this runlevel wait in the rings
+        break;
+    default:
+        // Unknown runlevel
+        ASSERT(0);
+    }
+    // Store the runlevel/phase in curState for debugging purpose
+    shmComm->curState = ((runlevel<<4) | phase);
+    return toReturn;
+}
+
+//
+// Init and destruct
+//
+
+void shmCommDestruct (ocrCommPlatform_t * self) {
+    if (self->laneId == 0) {
+        platformFinalizeShmComm();
+    }
+    runtimeChunkFree((u64)self, PERSISTENT_CHUNK);
+}
+
+ocrCommPlatform_t* newCommPlatformShm(ocrCommPlatformFactory_t *factory,
+                                      ocrParamList_t *perInstance) {
+    ocrCommPlatformShm_t * commPlatformShm = (ocrCommPlatformShm_t*)
+    runtimeChunkAlloc(sizeof(ocrCommPlatformShm_t), PERSISTENT_CHUNK);
+    commPlatformShm->base.location = ((paramListCommPlatformInst_t *)perInstance)->location;
+    commPlatformShm->base.fcts = factory->platformFcts;
+    factory->initialize(factory, (ocrCommPlatform_t *) commPlatformShm, perInstance);
+    return (ocrCommPlatform_t*) commPlatformShm;
+}
+
+
+/******************************************************/
+/* SHM COMM-PLATFORM FACTORY                          */
+/******************************************************/
+
+void destructCommPlatformFactoryShm(ocrCommPlatformFactory_t *factory) {
+    runtimeChunkFree((u64)factory, NONPERSISTENT_CHUNK);
+}
+
+void initializeCommPlatformShm(ocrCommPlatformFactory_t * factory, ocrCommPlatform_t * base, ocrParamList_t * perInstance) {
+    initializeCommPlatformOcr(factory, base, perInstance);
+    ocrCommPlatformShm_t * shmComm = (ocrCommPlatformShm_t*) base;
+    shmComm->msgId = 1; // SEND_ANY_ID is '0'
+    shmComm->incoming = NULL;
+    shmComm->incomingIt = NULL;
+    shmComm->pendingHead = NULL;
+    shmComm->pendingTail = NULL;
+    shmComm->pendingCount = 0;
+    shmComm->rx = NULL;
+    shmComm->nbRanks = 0;
+    shmComm->nextSrc = 0;
+    shmComm->curState = 0;
+}
+
+ocrCommPlatformFactory_t *newCommPlatformFactoryShm(ocrParamList_t *perType) {
+    ocrCommPlatformFactory_t *base = (ocrCommPlatformFactory_t*)
+        runtimeChunkAlloc(sizeof(ocrCommPlatformFactoryShm_t), NONPERSISTENT_CHUNK);
+    base->instantiate = &newCommPlatformShm;
+    base->initialize = &initializeCommPlatformShm;
+    base->destruct = FUNC_ADDR(void (*)(ocrCommPlatformFactory_t*), destructCommPlatformFactoryShm);
+
+    base->platformFcts.destruct = FUNC_ADDR(void (*)(ocrCommPlatform_t*), shmCommDestruct);
+    base->platformFcts.switchRunlevel = FUNC_ADDR(u8 (*)(ocrCommPlatform_t*, ocrPolicyDomain_t*, ocrRunlevel_t,
+                                                  phase_t, u32, void (*)(ocrPolicyDomain_t*,u64), u64), shmCommSwitchRunlevel);
+    base->platformFcts.sendMessage = FUNC_ADDR(u8 (*)(ocrCommPlatform_t*,ocrLocation_t,
+                                               ocrPolicyMsg_t*,u64*,u32,u32), shmCommSendMessage);
+    base->platformFcts.pollMessage = FUNC_ADDR(u8 (*)(ocrCommPlatform_t*,ocrPolicyMsg_t**,u32,u32*),
+                                               shmCommPollMessage);
+    base->platformFcts.waitMessage = FUNC_ADDR(u8 (*)(ocrCommPlatform_t*,ocrPolicyMsg_t**,u32,u32*),
+                                               shmCommWaitMessage);
+    return base;
+}
+
+#endif /* ENABLE_COMM_PLATFORM_SHM */
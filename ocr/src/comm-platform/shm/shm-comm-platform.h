@@ -0,0 +1,108 @@
+/**
+ * @brief Shared-memory communication platform
+ **/
+
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+#ifndef __SHM_COMM_PLATFORM_H__
+#define __SHM_COMM_PLATFORM_H__
+
+#include "ocr-config.h"
+#ifdef ENABLE_COMM_PLATFORM_SHM
+
+#include "utils/ocr-utils.h"
+#include "utils/list.h"
+#include "ocr-comm-platform.h"
+
+/**
+ * Policy domains are processes of the same host. They are forked from the
+ * launching process before the runtime is brought up, after it has mapped a
+ * POSIX shared memory segment, so the segment is at the same address in
+ * every process. The segment holds:
+ *  - One single-producer/single-consumer ring per ordered pair of PDs.
+ *    The comm-worker of the source PD is the producer and the comm-worker
+ *    of the destination PD the consumer.
+ *  - One heap per PD the mem-platform takes its memory from. Datablocks
+ *    allocated there are handed over by pointer to remote PDs instead of
+ *    being copied into the acquire response.
+ *
+ * The number of PDs is read from the OCR_SHM_NUM_PDS environment variable.
+ */
+
+// Size in bytes of each ring (must be a power of 2)
+#ifndef SHM_COMM_RING_SIZE
+#define SHM_COMM_RING_SIZE (256*1024)
+#endif
+
+// Size in bytes of each PD's heap in the shared segment (pages are only
+// committed when touched)
+#ifndef SHM_COMM_HEAP_SIZE
+#define SHM_COMM_HEAP_SIZE (1024ULL*1024*1024)
+#endif
+
+// Messages are not split in fragments smaller than this when the
+// end of the ring is reached, the ring wraps around instead
+#ifndef SHM_COMM_FRAGMENT_MIN
+#define SHM_COMM_FRAGMENT_MIN 256
+#endif
+
+typedef struct {
+    ocrCommPlatformFactory_t base;
+} ocrCommPlatformFactoryShm_t;
+
+struct _shmCommHandle_t;
+
+/**
+ * @brief Reassembly state of the message being received from one PD
+ */
+typedef struct {
+    ocrPolicyMsg_t * msg;             // Buffer the message is received into
+    struct _shmCommHandle_t * handle; // Request this is the response of, if any
+    u64 offset;                       // Bytes received so far
+    u64 bufferSize;                   // Size of the 'msg' buffer
+    u32 flags;                        // Flags of the first fragment
+} shmCommRx_t;
+
+typedef struct {
+    ocrCommPlatform_t base;
+    u64 msgId;
+    // Two-way requests waiting for their response
+    linkedlist_t * incoming;
+    iterator_t * incomingIt;
+    // Per destination FIFO of messages not fully written to their ring
+    struct _shmCommHandle_t ** pendingHead;
+    struct _shmCommHandle_t ** pendingTail;
+    u32 pendingCount;
+    // Per source reassembly state
+    shmCommRx_t * rx;
+    u32 nbRanks;
+    u32 nextSrc; // Ring polled first on the next poll
+    // The state encodes the RL (top 4 bits) and the phase (bottom 4 bits)
+    // This is mainly for debugging purpose
+    volatile u8 curState;
+} ocrCommPlatformShm_t;
+
+typedef struct {
+    paramListCommPlatformInst_t base;
+} paramListCommPlatformShm_t;
+
+extern ocrCommPlatformFactory_t* newCommPlatformFactoryShm(ocrParamList_t *perType);
+
+/**
+ * @brief Carves 'size' bytes out of the calling PD's shared heap
+ *
+ * Meant for the mem-platform's one-time allocation of its region.
+ * @return NULL if the segment is not set up or the heap is exhausted
+ */
+void * shmCommHeapAlloc(u64 size);
+
+/**
+ * @brief Returns true if 'ptr' lies in one of the PDs' shared heaps
+ */
+bool shmCommIsSharedPtr(void * ptr);
+
+#endif /* ENABLE_COMM_PLATFORM_SHM */
+#endif /* __SHM_COMM_PLATFORM_H__ */
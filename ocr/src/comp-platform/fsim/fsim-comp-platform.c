@@ -104,6 +104,10 @@ u8 fsimCompSetThrottle(ocrCompPlatform_t *self, u64 value) {
     return 1;
 }
 
+u8 fsimCompGetBinding(ocrCompPlatform_t *self, u32 *cpu) {
+    return 1;
+}
+
 u8 fsimCompSetCurrentEnv(ocrCompPlatform_t *self, ocrPolicyDomain_t *pd,
                          ocrWorker_t *worker) {
 
@@ -161,6 +165,7 @@ ocrCompPlatformFactory_t *newCompPlatformFactoryFsim(ocrParamList_t *perType) {
                                                          phase_t, u32, void (*)(ocrPolicyDomain_t*, u64), u64), fsimCompSwitchRunlevel);
     base->platformFcts.getThrottle = FUNC_ADDR(u8 (*)(ocrCompPlatform_t*, u64*), fsimCompGetThrottle);
     base->platformFcts.setThrottle = FUNC_ADDR(u8 (*)(ocrCompPlatform_t*, u64), fsimCompSetThrottle);
+    base->platformFcts.getBinding = FUNC_ADDR(u8 (*)(ocrCompPlatform_t*, u32*), fsimCompGetBinding);
     base->platformFcts.setCurrentEnv = FUNC_ADDR(u8 (*)(ocrCompPlatform_t*, ocrPolicyDomain_t*, ocrWorker_t*), fsimCompSetCurrentEnv);
 
     return base;
@@ -37,6 +37,38 @@ pthread_key_t _profilerThreadData;
 
 static pthread_once_t selfKeyInitialized = PTHREAD_ONCE_INIT;
 
+#ifndef COMP_PLATFORM_PTHREAD_NO_TLS
+/**
+ * Fast-path copy of the selfKey value. The initial-exec model turns
+ * the lookup into a single thread-pointer relative load. It is only
+ * set for threads the runtime brings up itself; getCurrentEnv falls
+ * back on selfKey when it is NULL (legacy and foreign threads).
+ */
+static __thread perThreadStorage_t *selfTls __attribute__((tls_model("initial-exec"))) = NULL;
+#endif
+
+static inline void setSelfTls(perThreadStorage_t *tls) {
+    RESULT_ASSERT(pthread_setspecific(selfKey, tls), ==, 0);
+#ifndef COMP_PLATFORM_PTHREAD_NO_TLS
+    selfTls = tls;
+#endif
+}
+
+static inline perThreadStorage_t *getSelfTls() {
+#ifndef COMP_PLATFORM_PTHREAD_NO_TLS
+    perThreadStorage_t *tls = selfTls;
+    if (tls != NULL)
+        return tls;
+#endif
+    // Key may not have been initialized at runtime boot
+    // but the logging facility may invoke getCurrentEnv
+    // We cannot rely on 'pthread_getspecific' as behavior
+    // is undefined when 'selfKey' hasn't been initialized yet.
+    if (!selfKeyInit)
+        return NULL;
+    return (perThreadStorage_t*)pthread_getspecific(selfKey);
+}
+
 static void * pthreadRoutineExecute(ocrWorker_t * worker) {
     return worker->fcts.run(worker);
 }
@@ -70,7 +102,7 @@ static void * pthreadRoutineWrapper(void * arg) {
     ocrCompPlatformPthread_t * pthreadCompPlatform = (ocrCompPlatformPthread_t *) arg;
     pthreadRoutineInitializer(pthreadCompPlatform);
     // Real initialization happens in workers's run routine
-    RESULT_ASSERT(pthread_setspecific(selfKey, &(pthreadCompPlatform->tls)), ==, 0);
+    setSelfTls(&(pthreadCompPlatform->tls));
 
     // Depending on whether we are a node master or a PD master or just a worker
     // we do different things
@@ -174,7 +206,7 @@ u8 pthreadSwitchRunlevel(ocrCompPlatform_t *self, ocrPolicyDomain_t *PD, ocrRunl
             if (tls != NULL) {
                 // This is necessary for legacy mode support so that the next time
                 // we start the runtime we do not reuse the current thread old TLS.
-                pthread_setspecific(selfKey, NULL);
+                setSelfTls(NULL);
             }
         }
 
@@ -198,7 +230,7 @@ u8 pthreadSwitchRunlevel(ocrCompPlatform_t *self, ocrPolicyDomain_t *PD, ocrRunl
                 // need to start another thread. Instead, we set the current environment
                 // for ourself
                 ASSERT(pthread_getspecific(selfKey) == NULL); // The key has not been setup yet
-                RESULT_ASSERT(pthread_setspecific(selfKey, &pthreadCompPlatform->tls), ==, 0);
+                setSelfTls(&pthreadCompPlatform->tls);
                 self->fcts.setCurrentEnv(self, self->pd, NULL);
             } else if(properties & RL_PD_MASTER) {
                 // Excludes NODE_MASTER since that is caught in the first part of this if statement
@@ -281,11 +313,19 @@ u8 pthreadSetThrottle(ocrCompPlatform_t *self, u64 value) {
     return 1;
 }
 
+u8 pthreadGetBinding(ocrCompPlatform_t *self, u32 *cpu) {
+    s32 binding = ((ocrCompPlatformPthread_t*)self)->binding;
+    if(binding == -1)
+        return 1;
+    *cpu = (u32)binding;
+    return 0;
+}
+
 u8 pthreadSetCurrentEnv(ocrCompPlatform_t *self, ocrPolicyDomain_t *pd,
                         ocrWorker_t *worker) {
 
     ASSERT(ocrGuidIsEq(pd->fguid.guid, self->pd->fguid.guid));
-    perThreadStorage_t *tls = pthread_getspecific(selfKey);
+    perThreadStorage_t *tls = getSelfTls();
     tls->pd = pd;
     tls->worker = worker;
     return 0;
@@ -329,16 +369,9 @@ void destructCompPlatformFactoryPthread(ocrCompPlatformFactory_t *factory) {
 void getCurrentEnv(ocrPolicyDomain_t** pd, ocrWorker_t** worker,
                    ocrTask_t **task, ocrPolicyMsg_t* msg) {
     START_PROFILE(cp_getCurrentEnv);
-    if (!selfKeyInit) {
-        // Key may not have been initialized at runtime boot
-        // but the logging facility may invoke getCurrentEnv
-        // We cannot rely on 'pthread_getspecific' as behavior
-        // is undefined when 'selfKey' hasn't been initialized yet.
-        RETURN_PROFILE();
-    }
-    perThreadStorage_t *tls = pthread_getspecific(selfKey);
+    perThreadStorage_t *tls = getSelfTls();
     if(tls == NULL) {
-        // TLS may be NULLat runtime boot but the logging facility
+        // TLS may be NULL at runtime boot but the logging facility
         // may invoke getCurrentEnv
         RETURN_PROFILE();
     }
@@ -372,6 +405,7 @@ ocrCompPlatformFactory_t *newCompPlatformFactoryPthread(ocrParamList_t *perType)
                                                          phase_t, u32, void (*)(ocrPolicyDomain_t*, u64), u64), pthreadSwitchRunlevel);
     base->platformFcts.getThrottle = FUNC_ADDR(u8 (*)(ocrCompPlatform_t*, u64*), pthreadGetThrottle);
     base->platformFcts.setThrottle = FUNC_ADDR(u8 (*)(ocrCompPlatform_t*, u64), pthreadSetThrottle);
+    base->platformFcts.getBinding = FUNC_ADDR(u8 (*)(ocrCompPlatform_t*, u32*), pthreadGetBinding);
     base->platformFcts.setCurrentEnv = FUNC_ADDR(u8 (*)(ocrCompPlatform_t*, ocrPolicyDomain_t*, ocrWorker_t*), pthreadSetCurrentEnv);
 
     paramListCompPlatformPthread_t * params =
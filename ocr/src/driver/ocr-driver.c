@@ -447,6 +447,12 @@ void platformSpecificInit(ocrConfig_t * ocrConfig) {
     extern void platformInitGasnetComm(int *argc, char *** argv);
     platformInitGasnetComm(&ocrConfig->userArgc, &ocrConfig->userArgv);
 #endif
+
+#ifdef ENABLE_COMM_PLATFORM_SHM
+    // Forks the processes of the other policy domains
+    extern void platformInitShmComm(int *argc, char *** argv);
+    platformInitShmComm(&ocrConfig->userArgc, &ocrConfig->userArgv);
+#endif
 }
 
 /**
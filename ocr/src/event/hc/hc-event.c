@@ -20,6 +20,10 @@
 #include "ocr-worker.h"
 #include "ocr-errors.h"
 
+#ifdef ENABLE_EXTENSION_LEGACY
+#include "ocr-sal.h"
+#endif
+
 #ifdef OCR_ENABLE_STATISTICS
 #include "ocr-statistics.h"
 #include "ocr-statistics-callbacks.h"
@@ -78,49 +82,130 @@ ocrStaticAssert(OCR_HINT_COUNT_EVT_HC < OCR_RUNTIME_HINT_PROP_BITS);
 /******************************************************/
 
 
-static u8 createDbRegNode(ocrFatGuid_t * dbFatGuid, u32 nbElems, bool doRelease, regNode_t ** node) {
-    ocrPolicyDomain_t *pd = NULL;
-    PD_MSG_STACK(msg);
-    ocrTask_t *curTask = NULL;
-    u32 i;
-    getCurrentEnv(&pd, NULL, &curTask, &msg);
-    ocrFatGuid_t curEdt = {.guid = curTask!=NULL?curTask->guid:NULL_GUID, .metaDataPtr = curTask};
-#define PD_MSG (&msg)
-#define PD_TYPE PD_MSG_DB_CREATE
-    getCurrentEnv(NULL, NULL, NULL, &msg);
-    msg.type = PD_MSG_DB_CREATE | PD_MSG_REQUEST | PD_MSG_REQ_RESPONSE;
-    PD_MSG_FIELD_IO(guid) = (*dbFatGuid);
-    PD_MSG_FIELD_IO(size) = sizeof(regNode_t)*nbElems;
-    PD_MSG_FIELD_IO(properties) = DB_PROP_RT_ACQUIRE;
-    PD_MSG_FIELD_I(edt) = curEdt;
-    PD_MSG_FIELD_I(hint) = NULL_HINT;
-    PD_MSG_FIELD_I(dbType) = RUNTIME_DBTYPE;
-    PD_MSG_FIELD_I(allocator) = NO_ALLOC;
-    RESULT_PROPAGATE(pd->fcts.processMessage(pd, &msg, true));
-    (*dbFatGuid) = PD_MSG_FIELD_IO(guid);
-    regNode_t * temp = (regNode_t*) PD_MSG_FIELD_O(ptr);
-    *node = temp;
-    for(i = 0; i < nbElems; ++i) {
-        temp[i].guid = UNINITIALIZED_GUID;
-        temp[i].slot = 0;
-        temp[i].mode = -1;
+#define STATE_CHECKED_IN ((u32)-1)
+#define STATE_CHECKED_OUT ((u32)-2)
+#define STATE_DESTROY_SEEN ((u32)-3)
+// Set in waitersCount while a satisfier publishes a persistent event's data.
+// All the STATE_* values above have it set as well.
+#define STATE_SATISFY_CLAIMED ((u32)1 << 31)
+
+// Publication state of a waiter node, kept in its (otherwise unused) mode
+// field. A registration reserves a node by incrementing waitersCount and
+// only then fills it in, so a satisfy must wait for the nodes it covers
+// to be READY.
+#define WAITER_EMPTY   ((u32)-1)
+#define WAITER_READY   ((u32)-2)
+#define WAITER_REMOVED ((u32)-3)
+
+#define WAITER_STATE(node) (*((volatile u32*)&((node)->mode)))
+
+static void waitersDirFree(ocrPolicyDomain_t *pd, hcWaiterDir_t *dir) {
+    u32 k;
+    for (k = 0; k < HCEVT_WAITER_CHUNK_MAX; ++k) {
+        if (dir->chunks[k] != NULL)
+            pd->fcts.pdFree(pd, dir->chunks[k]);
     }
-#undef PD_TYPE
-#define PD_TYPE PD_MSG_DB_RELEASE
-    if (doRelease) {
-        getCurrentEnv(NULL, NULL, NULL, &msg);
-        msg.type = PD_MSG_DB_RELEASE | PD_MSG_REQUEST | PD_MSG_REQ_RESPONSE;
-        PD_MSG_FIELD_IO(guid) = (*dbFatGuid);
-        PD_MSG_FIELD_I(edt) = curEdt;
-        PD_MSG_FIELD_I(ptr) = NULL;
-        PD_MSG_FIELD_I(size) = 0;
-        PD_MSG_FIELD_I(properties) = DB_PROP_RT_ACQUIRE;
-        RESULT_PROPAGATE(pd->fcts.processMessage(pd, &msg, true));
-        *node = NULL;
+    pd->fcts.pdFree(pd, dir);
+}
+
+// Returns the node for the dynamic waiter 'idx', installing its chunk if needed
+static regNode_t * waitersDirNode(ocrPolicyDomain_t *pd, hcWaiterDir_t *dir, u32 idx) {
+    // Chunk k starts at HCEVT_WAITER_DYNAMIC_COUNT * (2^k - 1)
+    u32 k = fls64((idx / HCEVT_WAITER_DYNAMIC_COUNT) + 1);
+    u32 offset = idx - (HCEVT_WAITER_DYNAMIC_COUNT * ((1U << k) - 1));
+    ASSERT(k < HCEVT_WAITER_CHUNK_MAX);
+    regNode_t *chunk = dir->chunks[k];
+    if (chunk == NULL) {
+        u32 i, size = HCEVT_WAITER_DYNAMIC_COUNT << k;
+        regNode_t *newChunk = (regNode_t*) pd->fcts.pdMalloc(pd, sizeof(regNode_t) * size);
+        for (i = 0; i < size; ++i) {
+            newChunk[i].guid = NULL_GUID;
+            newChunk[i].slot = 0;
+            WAITER_STATE(&newChunk[i]) = WAITER_EMPTY;
+        }
+        chunk = (regNode_t*) hal_cmpswap64((u64*)&(dir->chunks[k]), (u64)NULL, (u64)newChunk);
+        if (chunk == NULL) {
+            chunk = newChunk;
+        } else { // Someone else installed it first
+            pd->fcts.pdFree(pd, newChunk);
+        }
     }
-#undef PD_MSG
-#undef PD_TYPE
-    return 0;
+    return &chunk[offset];
+}
+
+// Returns the node for waiter 'idx' of the event, allocating storage if needed
+static regNode_t * waiterNode(ocrPolicyDomain_t *pd, ocrEventHc_t *event, u32 idx) {
+#if HCEVT_WAITER_STATIC_COUNT
+    if (idx < HCEVT_WAITER_STATIC_COUNT)
+        return &(event->waiters[idx]);
+    idx -= HCEVT_WAITER_STATIC_COUNT;
+#endif
+    hcWaiterDir_t *dir = event->waitersDir;
+    if (dir == NULL) {
+        hcWaiterDir_t *newDir = (hcWaiterDir_t*) pd->fcts.pdMalloc(pd, sizeof(hcWaiterDir_t));
+        u32 k;
+        for (k = 0; k < HCEVT_WAITER_CHUNK_MAX; ++k)
+            newDir->chunks[k] = NULL;
+        dir = (hcWaiterDir_t*) hal_cmpswap64((u64*)&(event->waitersDir), (u64)NULL, (u64)newDir);
+        if (dir == NULL) {
+            dir = newDir;
+        } else {
+            pd->fcts.pdFree(pd, newDir);
+        }
+    }
+    return waitersDirNode(pd, dir, idx);
+}
+
+// Reserves a waiter slot. Returns false if the event has been satisfied.
+static bool waiterReserve(ocrEventHc_t *event, u32 *idx) {
+    u32 count;
+    while (true) {
+        count = event->waitersCount;
+        if (count >= STATE_DESTROY_SEEN) {
+            hal_fence(); // Pairs with waitersClose, the event's data is now readable
+            return false;
+        }
+        if (count & STATE_SATISFY_CLAIMED) {
+            // A satisfier is writing the data; registration closes right after
+            hal_pause();
+            continue;
+        }
+        if (hal_cmpswap32(&(event->waitersCount), count, count + 1) == count)
+            break;
+    }
+    *idx = count;
+    return true;
+}
+
+// Claims the right to satisfy a persistent event and returns the number of
+// waiter slots reserved. Registrations are held off until waitersClose so the
+// event's data can be written without a lock. Returns false if the event is
+// already satisfied (or being satisfied).
+static bool waitersClaim(ocrEventHc_t *event, u32 *count) {
+    u32 cur;
+    do {
+        cur = event->waitersCount;
+        if (cur & STATE_SATISFY_CLAIMED)
+            return false;
+    } while (hal_cmpswap32(&(event->waitersCount), cur, cur | STATE_SATISFY_CLAIMED) != cur);
+    *count = cur;
+    return true;
+}
+
+// Ends a claim taken with waitersClaim: registration is closed for good
+static void waitersClose(ocrEventHc_t *event) {
+    hal_fence(); // Writes done under the claim must be seen by late registrations
+    event->waitersCount = STATE_CHECKED_IN;
+}
+
+// Closes registration and returns the number of waiter slots reserved
+static u32 waitersFreeze(ocrEventHc_t *event) {
+    u32 count;
+    do {
+        count = event->waitersCount;
+        ASSERT(count < STATE_DESTROY_SEEN);
+    } while (hal_cmpswap32(&(event->waitersCount), count, STATE_CHECKED_IN) != count);
+    return count;
 }
 
 //
@@ -142,24 +227,15 @@ u8 destructEventHc(ocrEvent_t *base) {
     statsEVT_DESTROY(pd, getCurrentEDT(), NULL, base->guid, base);
 #endif
 
-    // Destroy datablocks linked with this event
-    if (!(ocrGuidIsUninitialized(event->waitersDb.guid))) {
-#define PD_MSG (&msg)
-#define PD_TYPE PD_MSG_DB_FREE
-        msg.type = PD_MSG_DB_FREE | PD_MSG_REQUEST;
-        PD_MSG_FIELD_I(guid) = event->waitersDb;
-        PD_MSG_FIELD_I(edt.guid) = curTask ? curTask->guid : NULL_GUID;
-        PD_MSG_FIELD_I(edt.metaDataPtr) = curTask;
-        PD_MSG_FIELD_I(properties) = DB_PROP_RT_ACQUIRE | DB_PROP_NO_RELEASE;
-        RESULT_PROPAGATE(pd->fcts.processMessage(pd, &msg, false));
-#undef PD_MSG
-#undef PD_TYPE
+    // Free waiter storage that has not been handed over to a satisfy
+    if (event->waitersDir != NULL) {
+        waitersDirFree(pd, event->waitersDir);
     }
 
     // Now destroy the GUID
 #define PD_MSG (&msg)
 #define PD_TYPE PD_MSG_GUID_DESTROY
-    getCurrentEnv(NULL, NULL, NULL, &msg);
+    PD_MSG_INIT_FROM_PD(pd, &msg);
     msg.type = PD_MSG_GUID_DESTROY | PD_MSG_REQUEST;
     // These next two statements may be not required. Just to be safe.
     PD_MSG_FIELD_I(guid.guid) = base->guid;
@@ -171,10 +247,6 @@ u8 destructEventHc(ocrEvent_t *base) {
     return 0;
 }
 
-#define STATE_CHECKED_IN ((u32)-1)
-#define STATE_CHECKED_OUT ((u32)-2)
-#define STATE_DESTROY_SEEN ((u32)-3)
-
 u8 destructEventHcPersist(ocrEvent_t *base) {
     ocrEventHc_t *event = (ocrEventHc_t*) base;
     // Addresses a race when the EDT that's satisfying the
@@ -232,6 +304,30 @@ ocrFatGuid_t getEventHc(ocrEvent_t *base) {
     return res;
 }
 
+#ifdef ENABLE_EXTENSION_LEGACY
+u8 waitEventHcPersist(ocrEvent_t *base, u64 timeoutNs) {
+    ocrEventHcPersist_t *event = (ocrEventHcPersist_t*)base;
+    if (event->satisfied)
+        return 0;
+    // Announce ourselves before the last check so that a concurrent satisfy
+    // either sees us blocked or we see it (the increment is a full fence)
+    hal_xadd32(&(event->blockedCount), 1);
+    if (!event->satisfied)
+        salFutexWait(&(event->satisfied), 0, timeoutNs);
+    hal_xadd32(&(event->blockedCount), -1);
+    return (event->satisfied) ? 0 : OCR_EBUSY;
+}
+
+// Releases the threads blocked in waitEventHcPersist. Must be called once the
+// event's data is readable and while the satisfier is still checked in.
+static void wakeBlockedEventHcPersist(ocrEventHcPersist_t *event) {
+    event->satisfied = 1;
+    hal_fence(); // Pairs with the increment of 'blockedCount' in waitEventHcPersist
+    if (event->blockedCount != 0)
+        salFutexWake(&(event->satisfied), 0x7FFFFFFF);
+}
+#endif
+
 static u8 commonSatisfyRegNode(ocrPolicyDomain_t * pd, ocrPolicyMsg_t * msg,
                          ocrGuid_t evtGuid,
                          ocrFatGuid_t db, ocrFatGuid_t currentEdt,
@@ -244,7 +340,7 @@ static u8 commonSatisfyRegNode(ocrPolicyDomain_t * pd, ocrPolicyMsg_t * msg,
     DPRINTF(DEBUG_LVL_INFO, "SatisfyFromEvent: src: "GUIDF" dst: "GUIDF" \n", GUIDA(evtGuid), GUIDA(node->guid));
 #define PD_MSG (msg)
 #define PD_TYPE PD_MSG_DEP_SATISFY
-    getCurrentEnv(NULL, NULL, NULL, msg);
+    PD_MSG_INIT_FROM_PD(pd, msg);
     msg->type = PD_MSG_DEP_SATISFY | PD_MSG_REQUEST;
     // Need to refill because out may overwrite some of the in fields
     PD_MSG_FIELD_I(satisfierGuid.guid) = evtGuid;
@@ -263,67 +359,163 @@ static u8 commonSatisfyRegNode(ocrPolicyDomain_t * pd, ocrPolicyMsg_t * msg,
     return 0;
 }
 
+// Satisfies the dynamic waiters [first, last[ of 'dir' that were not unregistered
+static u8 satisfyWaitersRange(ocrPolicyDomain_t *pd, ocrPolicyMsg_t *msg, ocrGuid_t evtGuid,
+                              ocrFatGuid_t db, ocrFatGuid_t currentEdt,
+                              hcWaiterDir_t *dir, u32 first, u32 last) {
+    u32 i;
+    for(i = first; i < last; ++i) {
+        regNode_t *node = waitersDirNode(pd, dir, i);
+        if (hal_cmpswap32(&WAITER_STATE(node), WAITER_READY, WAITER_REMOVED) == WAITER_READY) {
+            RESULT_PROPAGATE(commonSatisfyRegNode(pd, msg, evtGuid, db, currentEdt, node));
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Shared state of a satisfy whose waiters are split across EDTs
+ *
+ * The waiter storage is detached from the event so that the event can
+ * be destroyed (ONCE, LATCH) while the batches are still running. The
+ * last batch to complete frees it.
+ */
+typedef struct _hcSatisfyFanOut_t {
+    hcWaiterDir_t *dir;
+    ocrGuid_t evtGuid;
+    ocrFatGuid_t db;
+    volatile u32 pending;
+} hcSatisfyFanOut_t;
+
+static void satisfyFanOutCheckout(ocrPolicyDomain_t *pd, hcSatisfyFanOut_t *fanOut) {
+    if (hal_xadd32(&(fanOut->pending), -1) == 1) {
+        waitersDirFree(pd, fanOut->dir);
+        pd->fcts.pdFree(pd, fanOut);
+    }
+}
+
+static ocrGuid_t satisfyWaitersBatchEdt(u32 paramc, u64 *paramv, u32 depc, ocrEdtDep_t depv[]) {
+    hcSatisfyFanOut_t *fanOut = (hcSatisfyFanOut_t*) paramv[0];
+    ocrPolicyDomain_t *pd = NULL;
+    ocrTask_t *curTask = NULL;
+    PD_MSG_STACK(msg);
+    getCurrentEnv(&pd, NULL, &curTask, &msg);
+    ocrFatGuid_t currentEdt = {.guid = curTask->guid, .metaDataPtr = curTask};
+    RESULT_ASSERT(satisfyWaitersRange(pd, &msg, fanOut->evtGuid, fanOut->db, currentEdt,
+                                      fanOut->dir, (u32) paramv[1], (u32) paramv[2]), ==, 0);
+    satisfyFanOutCheckout(pd, fanOut);
+    return NULL_GUID;
+}
+
+// Batches are runtime EDTs in the finish scope of the EDT doing the
+// satisfy, if any, so that the scope also covers the waiters they satisfy
+static u8 createSatisfyBatchEdt(ocrPolicyDomain_t *pd, ocrGuid_t templateGuid, u64 *paramv,
+                                ocrGuid_t parentLatch) {
+    PD_MSG_STACK(msg);
+    PD_MSG_INIT_FROM_PD(pd, &msg);
+#define PD_MSG (&msg)
+#define PD_TYPE PD_MSG_WORK_CREATE
+    msg.type = PD_MSG_WORK_CREATE | PD_MSG_REQUEST | PD_MSG_REQ_RESPONSE;
+    PD_MSG_FIELD_IO(guid.guid) = NULL_GUID;
+    PD_MSG_FIELD_IO(guid.metaDataPtr) = NULL;
+    PD_MSG_FIELD_I(templateGuid.guid) = templateGuid;
+    PD_MSG_FIELD_I(templateGuid.metaDataPtr) = NULL;
+    PD_MSG_FIELD_IO(outputEvent.guid) = NULL_GUID;
+    PD_MSG_FIELD_IO(outputEvent.metaDataPtr) = NULL;
+    PD_MSG_FIELD_I(paramv) = paramv;
+    PD_MSG_FIELD_IO(paramc) = 3;
+    PD_MSG_FIELD_IO(depc) = 0;
+    PD_MSG_FIELD_I(depv) = NULL;
+    PD_MSG_FIELD_I(hint) = NULL_HINT;
+    PD_MSG_FIELD_I(properties) = 0;
+    PD_MSG_FIELD_I(workType) = EDT_RT_WORKTYPE;
+    PD_MSG_FIELD_I(currentEdt.guid) = NULL_GUID;
+    PD_MSG_FIELD_I(currentEdt.metaDataPtr) = NULL;
+    PD_MSG_FIELD_I(parentLatch.guid) = parentLatch;
+    PD_MSG_FIELD_I(parentLatch.metaDataPtr) = NULL;
+    RESULT_PROPAGATE(pd->fcts.processMessage(pd, &msg, true));
+#undef PD_MSG
+#undef PD_TYPE
+    return 0;
+}
+
+// Finish latch the batches of a satisfy done by 'curTask' check in, the
+// one EDTs it creates would check in. None once the task has returned:
+// its output event satisfy is how it checks out of that latch, which may
+// then be the event being satisfied.
+static ocrGuid_t satisfyBatchLatch(ocrTask_t *curTask) {
+    if (curTask->state != RUNNING_EDTSTATE)
+        return NULL_GUID;
+    return !(ocrGuidIsNull(curTask->finishLatch)) ? curTask->finishLatch : curTask->parentLatch;
+}
+
 static u8 commonSatisfyWaiters(ocrPolicyDomain_t *pd, ocrEvent_t *base, ocrFatGuid_t db, u32 waitersCount,
                                 ocrFatGuid_t currentEdt, ocrPolicyMsg_t * msg,
                                 bool isPersistentEvent) {
     ocrEventHc_t * event = (ocrEventHc_t *) base;
-    // waitersDb is safe to read because non-persistent event forbids further
-    // registrations and persistent event registration is closed because of
-    // event->waitersCount set to STATE_CHECKED_IN.
-    ocrFatGuid_t dbWaiters = event->waitersDb;
     u32 i;
+    // Registration is closed (waitersCount is frozen) but registrations that
+    // reserved a slot before that may still be filling it in: wait for them.
+    // This always makes progress: between waiterReserve and the READY store
+    // a registration only fills in the node (allocating its chunk at most),
+    // it never waits on a satisfy nor holds a lock one needs. hal_pause
+    // yields the CPU so that a preempted registration gets to finish.
+    for(i = 0; i < waitersCount; ++i) {
+        regNode_t *node = waiterNode(pd, event, i);
+        while (WAITER_STATE(node) == WAITER_EMPTY) {
+            hal_pause();
+        }
+    }
+    hal_fence();
+    // The dynamic waiters now belong to this satisfy
+    hcWaiterDir_t *dir = event->waitersDir;
+    event->waitersDir = NULL;
+
 #if HCEVT_WAITER_STATIC_COUNT
     u32 ub = ((waitersCount < HCEVT_WAITER_STATIC_COUNT) ? waitersCount : HCEVT_WAITER_STATIC_COUNT);
     // Do static waiters first
     for(i = 0; i < ub; ++i) {
-        RESULT_PROPAGATE(commonSatisfyRegNode(pd, msg, base->guid, db, currentEdt, &event->waiters[i]));
+        regNode_t *node = &(event->waiters[i]);
+        if (hal_cmpswap32(&WAITER_STATE(node), WAITER_READY, WAITER_REMOVED) == WAITER_READY) {
+            RESULT_PROPAGATE(commonSatisfyRegNode(pd, msg, base->guid, db, currentEdt, node));
+        }
     }
     waitersCount -= ub;
 #endif
-
-    if(waitersCount > 0) {
-        ASSERT(!(ocrGuidIsUninitialized(dbWaiters.guid)));
-        // First acquire the DB that contains the waiters
-#define PD_MSG (msg)
-#define PD_TYPE PD_MSG_DB_ACQUIRE
-        msg->type = PD_MSG_DB_ACQUIRE | PD_MSG_REQUEST | PD_MSG_REQ_RESPONSE;
-        PD_MSG_FIELD_IO(guid) = dbWaiters;
-        PD_MSG_FIELD_IO(edt) = currentEdt;
-        PD_MSG_FIELD_IO(edtSlot) = EDT_SLOT_NONE;
-        if (isPersistentEvent) {
-            // !! Warning !! RW here (and not RO) works in pair with the lock
-            // being unlocked before DB_RELEASE is called in 'registerWaiterEventHcPersist'
-            PD_MSG_FIELD_IO(properties) = DB_MODE_RW | DB_PROP_RT_ACQUIRE;
-        } else {
-            PD_MSG_FIELD_IO(properties) = DB_MODE_CONST | DB_PROP_RT_ACQUIRE;
-        }
-        u8 res __attribute__((unused)) = pd->fcts.processMessage(pd, msg, true);
-        ASSERT(!res);
-        regNode_t * waiters = (regNode_t*)PD_MSG_FIELD_O(ptr);
-        //BUG #273: related to 273: we should not get an updated deguidification...
-        dbWaiters = PD_MSG_FIELD_IO(guid); //Get updated deguidifcation if needed
-        ASSERT(waiters);
-#undef PD_TYPE
-
-        // Second, call satisfy on all the waiters
-        for(i = 0; i < waitersCount; ++i) {
-            RESULT_PROPAGATE(commonSatisfyRegNode(pd, msg, base->guid, db, currentEdt, &waiters[i]));
+    if (waitersCount == 0) {
+        ASSERT(dir == NULL);
+        return 0;
+    }
+    ASSERT(dir != NULL);
+
+    // Large fan-outs are split in batches other workers can pick up. Only
+    // do so from an EDT so that runtime bring-up and tear-down never do.
+    ocrGuid_t batchTemplate = ((ocrEventFactoryHc_t *) pd->eventFactories[base->fctId])->satisfyBatchTemplate;
+    if ((waitersCount > HCEVT_SATISFY_BATCH) && (currentEdt.metaDataPtr != NULL) && (pd->workerCount > 1) &&
+        !(ocrGuidIsNull(batchTemplate))) {
+        u32 nbBatches = (waitersCount + HCEVT_SATISFY_BATCH - 1) / HCEVT_SATISFY_BATCH;
+        DPRINTF(DEBUG_LVL_VERB, "Satisfy %s: "GUIDF" fans out %"PRIu32" waiters in %"PRIu32" batches\n",
+                eventTypeToString(base), GUIDA(base->guid), waitersCount, nbBatches);
+        hcSatisfyFanOut_t *fanOut = (hcSatisfyFanOut_t*) pd->fcts.pdMalloc(pd, sizeof(hcSatisfyFanOut_t));
+        fanOut->dir = dir;
+        fanOut->evtGuid = base->guid;
+        fanOut->db = db;
+        fanOut->pending = nbBatches;
+        ocrGuid_t batchLatch = satisfyBatchLatch((ocrTask_t *) currentEdt.metaDataPtr);
+        u64 paramv[3];
+        paramv[0] = (u64) fanOut;
+        // The first batch is done inline
+        for(i = 1; i < nbBatches; ++i) {
+            paramv[1] = i * HCEVT_SATISFY_BATCH;
+            paramv[2] = (i == (nbBatches - 1)) ? waitersCount : ((i + 1) * HCEVT_SATISFY_BATCH);
+            RESULT_ASSERT(createSatisfyBatchEdt(pd, batchTemplate, paramv, batchLatch), ==, 0);
         }
-
-        // Release the DB
-#define PD_TYPE PD_MSG_DB_RELEASE
-        getCurrentEnv(NULL, NULL, NULL, msg);
-        msg->type = PD_MSG_DB_RELEASE | PD_MSG_REQUEST | PD_MSG_REQ_RESPONSE;
-        PD_MSG_FIELD_IO(guid) = dbWaiters;
-        PD_MSG_FIELD_I(edt) = currentEdt;
-        PD_MSG_FIELD_I(ptr) = NULL;
-        PD_MSG_FIELD_I(size) = 0;
-        PD_MSG_FIELD_I(properties) = DB_PROP_RT_ACQUIRE;
-        RESULT_PROPAGATE(pd->fcts.processMessage(pd, msg, true));
-#undef PD_MSG
-#undef PD_TYPE
+        RESULT_PROPAGATE(satisfyWaitersRange(pd, msg, base->guid, db, currentEdt, dir, 0, HCEVT_SATISFY_BATCH));
+        satisfyFanOutCheckout(pd, fanOut);
+    } else {
+        RESULT_PROPAGATE(satisfyWaitersRange(pd, msg, base->guid, db, currentEdt, dir, 0, waitersCount));
+        waitersDirFree(pd, dir);
     }
-
     return 0;
 }
 
@@ -342,9 +534,8 @@ u8 satisfyEventHcOnce(ocrEvent_t *base, ocrFatGuid_t db, u32 slot) {
     ocrFatGuid_t currentEdt;
     currentEdt.guid = (curTask == NULL) ? NULL_GUID : curTask->guid;
     currentEdt.metaDataPtr = curTask;
-    u32 waitersCount = event->waitersCount;
-    // This is only to help users find out about wrongful use of events
-    event->waitersCount = STATE_CHECKED_IN; // Indicate that the event is satisfied
+    // Indicate that the event is satisfied; this also helps users find out about wrongful use of events
+    u32 waitersCount = waitersFreeze(event);
 
 #ifdef OCR_ENABLE_STATISTICS
     statsDEP_SATISFYToEvt(pd, currentEdt.guid, NULL, base->guid, base, data, slot);
@@ -400,27 +591,23 @@ static u8 commonSatisfyEventHcPersist(ocrEvent_t *base, ocrFatGuid_t db, u32 slo
 // For counted event
 u8 satisfyEventHcCounted(ocrEvent_t *base, ocrFatGuid_t db, u32 slot) {
     ocrEventHc_t * event = (ocrEventHc_t*) base;
-    bool destroy = false;
-    hal_lock32(&(event->waitersLock));
+    u32 waitersCount;
     //BUG #809 Nanny-mode
-    if ((event->waitersCount == STATE_CHECKED_IN) ||
-        (event->waitersCount == STATE_CHECKED_OUT)) {
+    if (!waitersClaim(event, &waitersCount)) {
         DPRINTF(DEBUG_LVL_WARN, "User-level error detected: try to satisfy a counted event that's already satisfied: "GUIDF"\n", GUIDA(base->guid));
         ASSERT(false);
-        hal_unlock32(&(event->waitersLock));
         return 1; //BUG #603 error codes: Put some error code here.
     }
     ((ocrEventHcPersist_t*)event)->data = db.guid;
-    u32 waitersCount = event->waitersCount;
-    event->waitersCount = STATE_CHECKED_IN; // Indicate the event is satisfied
     ocrEventHcCounted_t * devt = (ocrEventHcCounted_t *) event;
     ASSERT_BLOCK_BEGIN(waitersCount <= devt->nbDeps)
     DPRINTF(DEBUG_LVL_WARN, "User-level error detected: too many registrations on counted-event "GUIDF"\n", GUIDA(base->guid));
     ASSERT_BLOCK_END
-
+    // Late registrations only decrement nbDeps once registration is closed
+    // so this must happen under the claim
     devt->nbDeps -= waitersCount;
-    destroy = ((devt->nbDeps) == 0);
-    hal_unlock32(&(event->waitersLock));
+    bool destroy = ((devt->nbDeps) == 0);
+    waitersClose(event); // Indicate the event is satisfied
     u8 ret = commonSatisfyEventHcPersist(base, db, slot, waitersCount);
     if (destroy) {
         ret = destructEventHc(base);
@@ -433,36 +620,33 @@ u8 satisfyEventHcCounted(ocrEvent_t *base, ocrFatGuid_t db, u32 slot) {
 u8 satisfyEventHcPersistIdem(ocrEvent_t *base, ocrFatGuid_t db, u32 slot) {
     ocrEventHc_t * event = (ocrEventHc_t*) base;
     u32 waitersCount;
-    hal_lock32(&(event->waitersLock));
-    if ((event->waitersCount == STATE_CHECKED_IN) || (event->waitersCount == STATE_CHECKED_OUT)) {
-        hal_unlock32(&(event->waitersLock));
+    if (!waitersClaim(event, &waitersCount)) {
         // Legal for idempotent to ignore subsequent satisfy
         return 1; //BUG #603 error codes: Put some error code here.
-    } else {
-        ((ocrEventHcPersist_t*)event)->data = db.guid;
-        waitersCount = event->waitersCount;
-        event->waitersCount = STATE_CHECKED_IN; // Indicate the event is satisfied
-        hal_unlock32(&(event->waitersLock));
     }
+    ((ocrEventHcPersist_t*)event)->data = db.guid;
+    waitersClose(event); // Indicate the event is satisfied
+#ifdef ENABLE_EXTENSION_LEGACY
+    wakeBlockedEventHcPersist((ocrEventHcPersist_t*)event);
+#endif
     return commonSatisfyEventHcPersist(base, db, slot, waitersCount);
 }
 
 // For sticky event
 u8 satisfyEventHcPersistSticky(ocrEvent_t *base, ocrFatGuid_t db, u32 slot) {
     ocrEventHc_t * event = (ocrEventHc_t*) base;
-    hal_lock32(&(event->waitersLock));
+    u32 waitersCount;
     //BUG #809 Nanny-mode
-    if ((event->waitersCount == STATE_CHECKED_IN) ||
-        (event->waitersCount == STATE_CHECKED_OUT)) {
+    if (!waitersClaim(event, &waitersCount)) {
         DPRINTF(DEBUG_LVL_WARN, "User-level error detected: try to satisfy a sticky event that's already satisfied: "GUIDF"\n", GUIDA(base->guid));
         ASSERT(false);
-        hal_unlock32(&(event->waitersLock));
         return 1; //BUG #603 error codes: Put some error code here.
     }
     ((ocrEventHcPersist_t*)event)->data = db.guid;
-    u32 waitersCount = event->waitersCount;
-    event->waitersCount = STATE_CHECKED_IN; // Indicate the event is satisfied
-    hal_unlock32(&(event->waitersLock));
+    waitersClose(event); // Indicate the event is satisfied
+#ifdef ENABLE_EXTENSION_LEGACY
+    wakeBlockedEventHcPersist((ocrEventHcPersist_t*)event);
+#endif
 
     return commonSatisfyEventHcPersist(base, db, slot, waitersCount);
 }
@@ -474,11 +658,8 @@ u8 satisfyEventHcLatch(ocrEvent_t *base, ocrFatGuid_t db, u32 slot) {
            slot == OCR_EVENT_LATCH_INCR_SLOT);
 
     s32 incr = (slot == OCR_EVENT_LATCH_DECR_SLOT)?-1:1;
-    s32 count;
-    do {
-        count = event->counter;
-        // FIXME: the (u32 *) cast on the line below is because event->counter is an (s32 *)
-    } while(hal_cmpswap32((u32 *)&(event->counter), count, count+incr) != count);
+    // The (u32 *) cast is because event->counter is an (s32 *)
+    s32 count = (s32) hal_xadd32((u32 *)&(event->counter), (u32)incr);
 
     DPRINTF(DEBUG_LVL_INFO, "Satisfy %s: "GUIDF" %s\n", eventTypeToString(base),
             GUIDA(base->guid), ((slot == OCR_EVENT_LATCH_DECR_SLOT) ? "decr":"incr"));
@@ -500,9 +681,8 @@ u8 satisfyEventHcLatch(ocrEvent_t *base, ocrFatGuid_t db, u32 slot) {
     // Here the event is satisfied
     DPRINTF(DEBUG_LVL_INFO, "Satisfy %s: "GUIDF" reached zero\n", eventTypeToString(base), GUIDA(base->guid));
 
-    u32 waitersCount = event->base.waitersCount;
-    // This is only to help users find out about wrongful use of events
-    event->base.waitersCount = STATE_CHECKED_IN; // Indicate that the event is satisfied
+    // Indicate that the event is satisfied; this also helps users find out about wrongful use of events
+    u32 waitersCount = waitersFreeze(&(event->base));
 
     if (waitersCount) {
         RESULT_PROPAGATE(commonSatisfyWaiters(pd, base, db, waitersCount, currentEdt, &msg, false));
@@ -522,151 +702,17 @@ u8 unregisterSignalerHc(ocrEvent_t *self, ocrFatGuid_t signaler, u32 slot,
     return 0; // We do not do anything for signalers
 }
 
-static u8 commonEnqueueWaiter(ocrPolicyDomain_t *pd, ocrEvent_t *base, ocrFatGuid_t waiter,
-                              u32 slot, ocrFatGuid_t currentEdt, ocrPolicyMsg_t * msg) {
-    // Warn: Caller must have acquired the waitersLock
-    ocrEventHc_t *event = (ocrEventHc_t*)base;
-    u32 waitersCount = event->waitersCount;
-
-#if HCEVT_WAITER_STATIC_COUNT
-    if (waitersCount < HCEVT_WAITER_STATIC_COUNT) {
-        event->waiters[waitersCount].guid = waiter.guid;
-        event->waiters[waitersCount].slot = slot;
-        ++event->waitersCount;
-        // We can release the lock now
-        hal_unlock32(&(event->waitersLock));
-    } else {
-#endif
-        ocrFatGuid_t oldDbGuid = {.guid = NULL_GUID, .metaDataPtr = NULL};
-        ocrFatGuid_t dbGuid = {.guid = NULL_GUID, .metaDataPtr = NULL};
-        regNode_t *waiters = NULL;
-        regNode_t *waitersNew = NULL;
-        u8 toReturn = 0;
-        // We're working with the dynamically created waiter list
-        if (waitersCount == HCEVT_WAITER_STATIC_COUNT) {
-            // Initial setup
-            u8 toReturn = createDbRegNode(&(event->waitersDb), HCEVT_WAITER_DYNAMIC_COUNT, false, &waiters);
-            if (toReturn) {
-                ASSERT(false && "Failed allocating db waiter");
-                hal_unlock32(&(event->waitersLock));
-                return toReturn;
-            }
-            dbGuid = event->waitersDb; // for release
-            event->waitersMax += HCEVT_WAITER_DYNAMIC_COUNT;
-            waitersCount=0;
-        } else {
-            // Acquire the DB that contains the waiters
-#define PD_MSG (msg)
-#define PD_TYPE PD_MSG_DB_ACQUIRE
-            getCurrentEnv(NULL, NULL, NULL, msg);
-            msg->type = PD_MSG_DB_ACQUIRE | PD_MSG_REQUEST | PD_MSG_REQ_RESPONSE;
-            PD_MSG_FIELD_IO(guid) = event->waitersDb;
-            PD_MSG_FIELD_IO(edt) = currentEdt;
-            PD_MSG_FIELD_IO(edtSlot) = EDT_SLOT_NONE;
-            PD_MSG_FIELD_IO(properties) = DB_MODE_RW | DB_PROP_RT_ACQUIRE;
-            //Should be a local DB
-            if((toReturn = pd->fcts.processMessage(pd, msg, true))) {
-                // should be the only writer active on the waiter DB since we have the lock
-                ASSERT(false); // debug
-                ASSERT(toReturn != OCR_EBUSY);
-                hal_unlock32(&(event->waitersLock));
-                return toReturn; //BUG #603 error codes
-            }
-            waiters = (regNode_t*)PD_MSG_FIELD_O(ptr);
-            //BUG #273
-            event->waitersDb = PD_MSG_FIELD_IO(guid);
-            ASSERT(waiters);
-#undef PD_TYPE
-            if(waitersCount + 1 == event->waitersMax) {
-                // We need to create a new DB and copy things over
-#define PD_TYPE PD_MSG_DB_CREATE
-                getCurrentEnv(NULL, NULL, NULL, msg);
-                msg->type = PD_MSG_DB_CREATE | PD_MSG_REQUEST | PD_MSG_REQ_RESPONSE;
-                PD_MSG_FIELD_IO(guid) = dbGuid;
-                PD_MSG_FIELD_IO(properties) = DB_PROP_RT_ACQUIRE;
-                PD_MSG_FIELD_IO(size) = sizeof(regNode_t)*event->waitersMax*2;
-                PD_MSG_FIELD_I(edt) = currentEdt;
-                PD_MSG_FIELD_I(hint) = NULL_HINT;
-                PD_MSG_FIELD_I(dbType) = RUNTIME_DBTYPE;
-                PD_MSG_FIELD_I(allocator) = NO_ALLOC;
-                if((toReturn = pd->fcts.processMessage(pd, msg, true))) {
-                    ASSERT(false); // debug
-                    hal_unlock32(&(event->waitersLock));
-                    return toReturn; //BUG #603 error codes
-                }
-                waitersNew = (regNode_t*)PD_MSG_FIELD_O(ptr);
-                oldDbGuid = event->waitersDb;
-                dbGuid = PD_MSG_FIELD_IO(guid);
-                event->waitersDb = dbGuid;
-#undef PD_TYPE
-                // -HCEVT_WAITER_STATIC_COUNT because part of the waiters are in the statically allocated waiter array
-                u32 nbNodes = waitersCount-HCEVT_WAITER_STATIC_COUNT;
-                hal_memCopy(waitersNew, waiters, sizeof(regNode_t)*(nbNodes), false);
-                event->waitersMax *= 2;
-                u32 i;
-                u32 maxNbNodes = event->waitersMax-HCEVT_WAITER_STATIC_COUNT;
-                for(i = nbNodes; i < maxNbNodes; ++i) {
-                    waitersNew[i].guid = NULL_GUID;
-                    waitersNew[i].slot = 0;
-                    waitersNew[i].mode = -1;
-                }
-                waiters = waitersNew;
-            } else {
-                dbGuid = event->waitersDb; // for release
-            }
-            waitersCount=event->waitersCount-HCEVT_WAITER_STATIC_COUNT;
-        }
-
-        waiters[waitersCount].guid = waiter.guid;
-        waiters[waitersCount].slot = slot;
-        ++event->waitersCount;
-
-        // We can release the lock now
-        hal_unlock32(&(event->waitersLock));
-
-        // Release the waiter datablock / free old waiter DB when necessary
-        //
-        // In both cases it is important to release the GUID read from the cached
-        // DB value and not from the event data-structure since we're operating
-        // outside the lock there can be a new db created and assigned before getting here
-#define PD_MSG (msg)
-#define PD_TYPE PD_MSG_DB_RELEASE
-        getCurrentEnv(NULL, NULL, NULL, msg);
-        msg->type = PD_MSG_DB_RELEASE | PD_MSG_REQUEST | PD_MSG_REQ_RESPONSE;
-        PD_MSG_FIELD_IO(guid) = dbGuid;
-        PD_MSG_FIELD_I(edt) = currentEdt;
-        PD_MSG_FIELD_I(ptr) = NULL;
-        PD_MSG_FIELD_I(size) = 0;
-        PD_MSG_FIELD_I(properties) = DB_PROP_RT_ACQUIRE;
-        RESULT_PROPAGATE(pd->fcts.processMessage(pd, msg, true));
-#undef PD_MSG
-#undef PD_TYPE
-
-        if(waitersNew) {
-            // We need to free the old DB (implicitely released as DB_PROP_NO_RELEASE
-            // is not provided here) and release the new one.
-#define PD_MSG (msg)
-#define PD_TYPE PD_MSG_DB_FREE
-            getCurrentEnv(NULL, NULL, NULL, msg);
-            msg->type = PD_MSG_DB_FREE | PD_MSG_REQUEST;
-            PD_MSG_FIELD_I(guid) = oldDbGuid;
-            PD_MSG_FIELD_I(edt) = currentEdt;
-            PD_MSG_FIELD_I(properties) = DB_PROP_RT_ACQUIRE;
-            if((toReturn = pd->fcts.processMessage(pd, msg, false))) {
-                ASSERT(false); // debug
-                return toReturn; //BUG #603 error codes
-            }
-#undef PD_MSG
-#undef PD_TYPE
-        }
-#if HCEVT_WAITER_STATIC_COUNT
-    }
-#endif
-    return 0; //Require registerSignaler invocation
+// Fills in the waiter slot 'idx' reserved with waiterReserve
+static void commonEnqueueWaiter(ocrPolicyDomain_t *pd, ocrEventHc_t *event, u32 idx,
+                                ocrFatGuid_t waiter, u32 slot) {
+    regNode_t *node = waiterNode(pd, event, idx);
+    ASSERT(WAITER_STATE(node) == WAITER_EMPTY);
+    node->guid = waiter.guid;
+    node->slot = slot;
+    hal_fence(); // The node must be complete when it is seen as READY
+    WAITER_STATE(node) = WAITER_READY;
 }
 
-
-
 /**
  * In this call, we do not contend with the satisfy (once and latch events) however,
  * we do contend with multiple registration.
@@ -680,19 +726,17 @@ u8 registerWaiterEventHc(ocrEvent_t *base, ocrFatGuid_t waiter, u32 slot, bool i
             eventTypeToString(base), GUIDA(base->guid), GUIDA(waiter.guid), slot);
 
     ocrPolicyDomain_t *pd = NULL;
-    ocrTask_t *curTask = NULL;
-    PD_MSG_STACK(msg);
-    getCurrentEnv(&pd, NULL, &curTask, &msg);
+    getCurrentEnv(&pd, NULL, NULL, NULL);
+    u32 idx;
     //BUG #809 this should be part of the n
-    if (event->waitersCount == STATE_CHECKED_IN) {
+    if (!waiterReserve(event, &idx)) {
          // This is best effort race check
          DPRINTF(DEBUG_LVL_WARN, "User-level error detected: adding dependence to a non-persistent event that's already satisfied: "GUIDF"\n", GUIDA(base->guid));
          ASSERT(false);
          return 1; //BUG #603 error codes: Put some error code here.
     }
-    ocrFatGuid_t currentEdt = {.guid = curTask!=NULL?curTask->guid:NULL_GUID, .metaDataPtr = curTask};
-    hal_lock32(&(event->waitersLock)); // Lock is released by commonEnqueueWaiter
-    return commonEnqueueWaiter(pd, base, waiter, slot, currentEdt, &msg);
+    commonEnqueueWaiter(pd, event, idx, waiter, slot);
+    return 0; //Require registerSignaler invocation
 }
 
 
@@ -736,11 +780,12 @@ u8 registerWaiterEventHcPersist(ocrEvent_t *base, ocrFatGuid_t waiter, u32 slot,
 
     DPRINTF(DEBUG_LVL_INFO, "Register waiter %s: "GUIDF" with waiter "GUIDF" on slot %"PRId32"\n",
             eventTypeToString(base), GUIDA(base->guid), GUIDA(waiter.guid), slot);
-    // Lock to read the event->data
-    hal_lock32(&(event->base.waitersLock));
-    if (!(ocrGuidIsUninitialized(event->data))) {
+    // Either we get a waiter slot before the satisfy closes registration, or
+    // the data (written before registration is closed) is there to read
+    u32 idx;
+    if (!waiterReserve(&(event->base), &idx)) {
         ocrGuid_t dataGuid = event->data;
-        hal_unlock32(&(event->base.waitersLock));
+        ASSERT(!(ocrGuidIsUninitialized(dataGuid)));
         // We send a message saying that we satisfy whatever tried to wait on us
 #define PD_MSG (&msg)
 #define PD_TYPE PD_MSG_DEP_SATISFY
@@ -760,8 +805,8 @@ u8 registerWaiterEventHcPersist(ocrEvent_t *base, ocrFatGuid_t waiter, u32 slot,
         return 0; //Require registerSignaler invocation
     }
 
-    // Lock is released by commonEnqueueWaiter
-    return commonEnqueueWaiter(pd, base, waiter, slot, currentEdt, &msg);
+    commonEnqueueWaiter(pd, &(event->base), idx, waiter, slot);
+    return 0; //Require registerSignaler invocation
 }
 
 /**
@@ -801,11 +846,11 @@ u8 registerWaiterEventHcCounted(ocrEvent_t *base, ocrFatGuid_t waiter, u32 slot,
 
     DPRINTF(DEBUG_LVL_INFO, "Register waiter %s: "GUIDF" with waiter "GUIDF" on slot %"PRId32"\n",
             eventTypeToString(base), GUIDA(base->guid), GUIDA(waiter.guid), slot);
-    // Lock to read the data field
-    hal_lock32(&(event->base.waitersLock));
-    if(!(ocrGuidIsUninitialized(event->data))) {
+    // See registerWaiterEventHcPersist
+    u32 idx;
+    if (!waiterReserve(&(event->base), &idx)) {
         ocrGuid_t dataGuid = event->data;
-        hal_unlock32(&(event->base.waitersLock));
+        ASSERT(!(ocrGuidIsUninitialized(dataGuid)));
         // We send a message saying that we satisfy whatever tried to wait on us
 #define PD_MSG (&msg)
 #define PD_TYPE PD_MSG_DEP_SATISFY
@@ -825,15 +870,13 @@ u8 registerWaiterEventHcCounted(ocrEvent_t *base, ocrFatGuid_t waiter, u32 slot,
         // Here it is still safe to use the base pointer because the satisfy
         // call cannot trigger the destruction of the event. For counted-events
         // the runtime takes care of it
-        hal_lock32(&(event->base.waitersLock));
         ocrEventHcCounted_t * devt = (ocrEventHcCounted_t *) event;
         // Account for this registration. When it reaches zero the event
         // can be deallocated since it is already satisfied and this call
         // was the last ocrAddDependence.
-        ASSERT(devt->nbDeps > 0);
-        devt->nbDeps--;
-        u64 nbDeps = devt->nbDeps;
-        hal_unlock32(&(event->base.waitersLock));
+        u64 nbDeps = hal_xadd64(&(devt->nbDeps), (u64)-1);
+        ASSERT(nbDeps > 0);
+        --nbDeps;
         // Check if we'll need to destroy the event
         if (nbDeps == 0) {
             // Can move that after satisfy to reduce CPL
@@ -842,71 +885,40 @@ u8 registerWaiterEventHcCounted(ocrEvent_t *base, ocrFatGuid_t waiter, u32 slot,
         return 0; //Require registerSignaler invocation
     }
 
-    // Lock is released by commonEnqueueWaiter
-    return commonEnqueueWaiter(pd, base, waiter, slot, currentEdt, &msg);
+    commonEnqueueWaiter(pd, &(event->base), idx, waiter, slot);
+    return 0; //Require registerSignaler invocation
 }
 #endif
 
 
+// Marks the first READY waiter matching (waiter, slot) among the 'count' first as removed
+static void commonRemoveWaiter(ocrPolicyDomain_t *pd, ocrEventHc_t *event, u32 count,
+                               ocrFatGuid_t waiter, u32 slot) {
+    u32 i;
+    for(i = 0; i < count; ++i) {
+        regNode_t *node = waiterNode(pd, event, i);
+        if((WAITER_STATE(node) == WAITER_READY) &&
+           ocrGuidIsEq(node->guid, waiter.guid) && (node->slot == slot)) {
+            if (hal_cmpswap32(&WAITER_STATE(node), WAITER_READY, WAITER_REMOVED) == WAITER_READY)
+                break;
+        }
+    }
+}
+
 // In this call, we do not contend with satisfy
 u8 unregisterWaiterEventHc(ocrEvent_t *base, ocrFatGuid_t waiter, u32 slot, bool isDepRem) {
     // Always search for the waiter because we don't know if it registered or not so
     // ignore isDepRem
     ocrEventHc_t *event = (ocrEventHc_t*)base;
 
-
     DPRINTF(DEBUG_LVL_INFO, "UnRegister waiter %s: "GUIDF" with waiter "GUIDF" on slot %"PRId32"\n",
             eventTypeToString(base), GUIDA(base->guid), GUIDA(waiter.guid), slot);
 
     ocrPolicyDomain_t *pd = NULL;
-    ocrTask_t *curTask = NULL;
-    PD_MSG_STACK(msg);
-    regNode_t *waiters = NULL;
-    u32 i;
-
-    getCurrentEnv(&pd, NULL, &curTask, &msg);
-    ocrFatGuid_t curEdt = {.guid = curTask!=NULL?curTask->guid:NULL_GUID, .metaDataPtr = curTask};
-
-    // Acquire the DB that contains the waiters
-#define PD_MSG (&msg)
-#define PD_TYPE PD_MSG_DB_ACQUIRE
-    msg.type = PD_MSG_DB_ACQUIRE | PD_MSG_REQUEST | PD_MSG_REQ_RESPONSE;
-    PD_MSG_FIELD_IO(guid) = event->waitersDb;
-    PD_MSG_FIELD_IO(edt) = curEdt;
-    PD_MSG_FIELD_IO(edtSlot) = EDT_SLOT_NONE;
-    PD_MSG_FIELD_IO(properties) = DB_MODE_RW | DB_PROP_RT_ACQUIRE;
-    //Should be a local DB
-    u8 res __attribute__((unused)) = pd->fcts.processMessage(pd, &msg, true);
-    ASSERT(!res); // Possible corruption of waitersDb
-
-    waiters = (regNode_t*)PD_MSG_FIELD_O(ptr);
-    //BUG #273
-    event->waitersDb = PD_MSG_FIELD_IO(guid);
-    ASSERT(waiters);
-#undef PD_TYPE
-    // We search for the waiter that we need and remove it
-    for(i = 0; i < event->waitersCount; ++i) {
-        if(ocrGuidIsEq(waiters[i].guid, waiter.guid) && waiters[i].slot == slot) {
-            // We will copy all the other ones
-            hal_memCopy((void*)&waiters[i], (void*)&waiters[i+1],
-                        sizeof(regNode_t)*(event->waitersCount - i - 1), false);
-            --event->waitersCount;
-            break;
-        }
-    }
-
-    // We always release waitersDb
-#define PD_TYPE PD_MSG_DB_RELEASE
-    getCurrentEnv(NULL, NULL, NULL, &msg);
-    msg.type = PD_MSG_DB_RELEASE | PD_MSG_REQUEST | PD_MSG_REQ_RESPONSE;
-    PD_MSG_FIELD_IO(guid) = event->waitersDb;
-    PD_MSG_FIELD_I(edt) = curEdt;
-    PD_MSG_FIELD_I(ptr) = NULL;
-    PD_MSG_FIELD_I(size) = 0;
-    PD_MSG_FIELD_I(properties) = DB_PROP_RT_ACQUIRE;
-    RESULT_PROPAGATE(pd->fcts.processMessage(pd, &msg, true));
-#undef PD_MSG
-#undef PD_TYPE
+    getCurrentEnv(&pd, NULL, NULL, NULL);
+    u32 count = event->waitersCount;
+    ASSERT(count < STATE_DESTROY_SEEN);
+    commonRemoveWaiter(pd, event, count, waiter, slot);
     return 0;
 }
 
@@ -915,72 +927,19 @@ u8 unregisterWaiterEventHc(ocrEvent_t *base, ocrFatGuid_t waiter, u32 slot, bool
 u8 unregisterWaiterEventHcPersist(ocrEvent_t *base, ocrFatGuid_t waiter, u32 slot) {
     ocrEventHcPersist_t *event = (ocrEventHcPersist_t*)base;
 
-
     DPRINTF(DEBUG_LVL_INFO, "Unregister waiter %s: "GUIDF" with waiter "GUIDF" on slot %"PRId32"\n",
             eventTypeToString(base), GUIDA(base->guid), GUIDA(waiter.guid), slot);
 
     ocrPolicyDomain_t *pd = NULL;
-    ocrTask_t *curTask = NULL;
-    PD_MSG_STACK(msg);
-    regNode_t *waiters = NULL;
-    u32 i;
-    u8 toReturn = 0;
-
-    getCurrentEnv(&pd, NULL, &curTask, &msg);
-    ocrFatGuid_t curEdt = {.guid = curTask!=NULL?curTask->guid:NULL_GUID, .metaDataPtr = curTask};
-    hal_lock32(&(event->base.waitersLock));
-    if(!(ocrGuidIsUninitialized(event->data))) {
+    getCurrentEnv(&pd, NULL, NULL, NULL);
+    u32 count = event->base.waitersCount;
+    if(count & STATE_SATISFY_CLAIMED) {
         // We don't really care at this point so we don't do anything
-        hal_unlock32(&(event->base.waitersLock));
         return 0;
     }
-
-    // Here we need to actually update our waiter list. We still hold the lock
-    // Acquire the DB that contains the waiters
-#define PD_MSG (&msg)
-#define PD_TYPE PD_MSG_DB_ACQUIRE
-    msg.type = PD_MSG_DB_ACQUIRE | PD_MSG_REQUEST | PD_MSG_REQ_RESPONSE;
-    PD_MSG_FIELD_IO(guid) = event->base.waitersDb;
-    PD_MSG_FIELD_IO(edt) = curEdt;
-    PD_MSG_FIELD_IO(edtSlot) = EDT_SLOT_NONE;
-    PD_MSG_FIELD_IO(properties) = DB_MODE_RW | DB_PROP_RT_ACQUIRE;
-    //Should be a local DB
-    if((toReturn = pd->fcts.processMessage(pd, &msg, true))) {
-        ASSERT(!toReturn); // Possible corruption of waitersDb
-        hal_unlock32(&(event->base.waitersLock));
-        return toReturn;
-    }
-    //BUG #273: Guid reading
-    waiters = (regNode_t*)PD_MSG_FIELD_O(ptr);
-    event->base.waitersDb = PD_MSG_FIELD_IO(guid);
-    ASSERT(waiters);
-#undef PD_TYPE
-    // We search for the waiter that we need and remove it
-    for(i = 0; i < event->base.waitersCount; ++i) {
-        if(ocrGuidIsEq(waiters[i].guid, waiter.guid) && waiters[i].slot == slot) {
-            // We will copy all the other ones
-            hal_memCopy((void*)&waiters[i], (void*)&waiters[i+1],
-                        sizeof(regNode_t)*(event->base.waitersCount - i - 1), false);
-            --event->base.waitersCount;
-            break;
-        }
-    }
-
-    // We can release the lock now
-    hal_unlock32(&(event->base.waitersLock));
-
-    // We always release waitersDb
-#define PD_TYPE PD_MSG_DB_RELEASE
-    getCurrentEnv(NULL, NULL, NULL, &msg);
-    msg.type = PD_MSG_DB_RELEASE | PD_MSG_REQUEST | PD_MSG_REQ_RESPONSE;
-    PD_MSG_FIELD_IO(guid) = event->base.waitersDb;
-    PD_MSG_FIELD_I(edt) = curEdt;
-    PD_MSG_FIELD_I(ptr) = NULL;
-    PD_MSG_FIELD_I(size) = 0;
-    PD_MSG_FIELD_I(properties) = DB_PROP_RT_ACQUIRE;
-    RESULT_PROPAGATE(pd->fcts.processMessage(pd, &msg, true));
-#undef PD_MSG
-#undef PD_TYPE
+    // Note: a satisfy starting now hands the waiter storage over to its
+    // fan-out; this cannot happen as long as the PD rejects UNREGWAITER.
+    commonRemoveWaiter(pd, &(event->base), count, waiter, slot);
     return 0;
 }
 
@@ -1106,14 +1065,14 @@ u8 newEventHc(ocrEventFactory_t * factory, ocrFatGuid_t *guid,
 
     // Set-up HC specific structures
     event->waitersCount = 0;
-    event->waitersMax = HCEVT_WAITER_STATIC_COUNT;
+    event->waitersDir = NULL;
     event->waitersLock = 0;
 
     int jj = 0;
     while (jj < HCEVT_WAITER_STATIC_COUNT) {
         event->waiters[jj].guid = NULL_GUID;
         event->waiters[jj].slot = 0;
-        event->waiters[jj].mode = -1;
+        WAITER_STATE(&(event->waiters[jj])) = WAITER_EMPTY;
         jj++;
     }
     if(eventType == OCR_EVENT_LATCH_T) {
@@ -1130,13 +1089,15 @@ u8 newEventHc(ocrEventFactory_t * factory, ocrFatGuid_t *guid,
     }
 #ifdef ENABLE_EXTENSION_COUNTED_EVT
     if(eventType == OCR_EVENT_IDEM_T || eventType == OCR_EVENT_STICKY_T || eventType == OCR_EVENT_COUNTED_T) {
-        ((ocrEventHcPersist_t*)event)->data = UNINITIALIZED_GUID;
-    }
 #else
     if(eventType == OCR_EVENT_IDEM_T || eventType == OCR_EVENT_STICKY_T) {
+#endif
         ((ocrEventHcPersist_t*)event)->data = UNINITIALIZED_GUID;
-    }
+#ifdef ENABLE_EXTENSION_LEGACY
+        ((ocrEventHcPersist_t*)event)->satisfied = 0;
+        ((ocrEventHcPersist_t*)event)->blockedCount = 0;
 #endif
+    }
 
     if (hintc == 0) {
         event->hint.hintMask = 0;
@@ -1146,10 +1107,6 @@ u8 newEventHc(ocrEventFactory_t * factory, ocrFatGuid_t *guid,
         event->hint.hintVal = (u64*)((u64)base + sizeOfGuid);
     }
 
-    // Initialize GUIDs for the waiters data-blocks
-    event->waitersDb.guid = UNINITIALIZED_GUID;
-    event->waitersDb.metaDataPtr = NULL;
-
 #ifdef ENABLE_EXTENSION_COUNTED_EVT
     if(eventType == OCR_EVENT_COUNTED_T) {
         // Initialize the counter for dependencies tracking
@@ -1347,6 +1304,22 @@ u8 unregisterWaiterEventHcChannel(ocrEvent_t *base, ocrFatGuid_t waiter, u32 slo
 
 #endif
 
+u8 hcEventFactoryCreateTemplates(ocrEventFactory_t *factory, ocrPolicyDomain_t *pd) {
+    ocrEventFactoryHc_t *derived = (ocrEventFactoryHc_t *) factory;
+    ASSERT(ocrGuidIsNull(derived->satisfyBatchTemplate));
+    return ocrEdtTemplateCreate(&(derived->satisfyBatchTemplate), satisfyWaitersBatchEdt, 3, 0);
+}
+
+u8 hcEventFactoryDestroyTemplates(ocrEventFactory_t *factory, ocrPolicyDomain_t *pd) {
+    ocrEventFactoryHc_t *derived = (ocrEventFactoryHc_t *) factory;
+    u8 returnCode = 0;
+    if (!(ocrGuidIsNull(derived->satisfyBatchTemplate))) {
+        returnCode = ocrEdtTemplateDestroy(derived->satisfyBatchTemplate);
+        derived->satisfyBatchTemplate = NULL_GUID;
+    }
+    return returnCode;
+}
+
 void destructEventFactoryHc(ocrEventFactory_t * factory) {
     runtimeChunkFree((u64)factory->hintPropMap, PERSISTENT_CHUNK);
     runtimeChunkFree((u64)factory, PERSISTENT_CHUNK);
@@ -1359,6 +1332,7 @@ ocrEventFactory_t * newEventFactoryHc(ocrParamList_t *perType, u32 factoryId) {
     base->instantiate = FUNC_ADDR(u8 (*)(ocrEventFactory_t*, ocrFatGuid_t*,
                                   ocrEventTypes_t, u32, ocrParamList_t*), newEventHc);
     base->destruct =  FUNC_ADDR(void (*)(ocrEventFactory_t*), destructEventFactoryHc);
+    ((ocrEventFactoryHc_t *) base)->satisfyBatchTemplate = NULL_GUID;
     // Initialize the function pointers
 
     // Setup common functions
@@ -1373,6 +1347,7 @@ ocrEventFactory_t * newEventFactoryHc(ocrParamList_t *perType, u32 factoryId) {
         base->fcts[i].get = FUNC_ADDR(ocrFatGuid_t (*)(ocrEvent_t*), getEventHc);
         base->fcts[i].registerSignaler = FUNC_ADDR(u8 (*)(ocrEvent_t*, ocrFatGuid_t, u32, ocrDbAccessMode_t, bool), registerSignalerHc);
         base->fcts[i].unregisterSignaler = FUNC_ADDR(u8 (*)(ocrEvent_t*, ocrFatGuid_t, u32, bool), unregisterSignalerHc);
+        base->fcts[i].wait = NULL;
     }
     base->fcts[OCR_EVENT_STICKY_T].destruct =
     base->fcts[OCR_EVENT_IDEM_T].destruct = FUNC_ADDR(u8 (*)(ocrEvent_t*), destructEventHcPersist);
@@ -1424,6 +1399,13 @@ ocrEventFactory_t * newEventFactoryHc(ocrParamList_t *perType, u32 factoryId) {
         FUNC_ADDR(u8 (*)(ocrEvent_t*, ocrFatGuid_t, u32, bool), unregisterWaiterEventHcChannel);
 #endif
 
+    // Counted events are not waited on: they may be destroyed when satisfied
+#ifdef ENABLE_EXTENSION_LEGACY
+    base->fcts[OCR_EVENT_IDEM_T].wait =
+    base->fcts[OCR_EVENT_STICKY_T].wait =
+        FUNC_ADDR(u8 (*)(ocrEvent_t*, u64), waitEventHcPersist);
+#endif
+
     base->factoryId = factoryId;
 
     //Setup hint framework
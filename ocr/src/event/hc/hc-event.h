@@ -27,35 +27,61 @@
 #define HCEVT_WAITER_STATIC_COUNT 4
 #endif
 
-// Size for the dynamically allocated waiter array
+// Size of the first dynamically allocated waiter chunk. Each following
+// chunk is twice as large as the previous one.
 #ifndef HCEVT_WAITER_DYNAMIC_COUNT
 #define HCEVT_WAITER_DYNAMIC_COUNT 4
 #endif
 
+// Maximum number of dynamically allocated waiter chunks
+#define HCEVT_WAITER_CHUNK_MAX 24
+
+// Number of waiters satisfied per EDT when a satisfy is fanned-out
+// across workers (only lists with more waiters than that are split)
+#ifndef HCEVT_SATISFY_BATCH
+#define HCEVT_SATISFY_BATCH 256
+#endif
+
+/**
+ * @brief Directory of the dynamically allocated waiter chunks
+ *
+ * Chunk 'k' holds HCEVT_WAITER_DYNAMIC_COUNT << k waiters. Chunks are
+ * installed with a CAS by the first registration that needs them and are
+ * never moved, so registrations don't need to hold a lock.
+ */
+typedef struct _hcWaiterDir_t {
+    regNode_t * volatile chunks[HCEVT_WAITER_CHUNK_MAX];
+} hcWaiterDir_t;
+
 typedef struct {
     ocrEventFactory_t base;
+    ocrGuid_t satisfyBatchTemplate; /**< Template of the EDTs a fanned-out satisfy
+                                     * creates, NULL_GUID while the PD can't run EDTs */
 } ocrEventFactoryHc_t;
 
 typedef struct ocrEventHc_t {
     ocrEvent_t base;
-    regNode_t waiters[HCEVT_WAITER_STATIC_COUNT]; /**< hold waiters. If overflows a dynamically
-                                              allocated waiter list is stored in waitersDb */
-    ocrFatGuid_t waitersDb; /**< DB containing an array of regNode_t listing the
-                             * events/EDTs depending on this event */
-    volatile u32 waitersCount; /**< Number of waiters in waitersDb */
-    u32 waitersMax; /**< Maximum number of waiters in waitersDb */
-    volatile u32 waitersLock;
+    regNode_t waiters[HCEVT_WAITER_STATIC_COUNT]; /**< hold waiters. If overflows, the
+                                              following waiters go to waitersDir */
+    hcWaiterDir_t * volatile waitersDir; /**< Chunks holding the waiters that do not fit
+                                          * in 'waiters' (NULL until needed) */
+    volatile u32 waitersCount; /**< Number of waiter slots reserved */
+    volatile u32 waitersLock; /**< Only used by channel events */
     ocrRuntimeHint_t hint;
 } ocrEventHc_t;
 
 typedef struct _ocrEventHcPersist_t {
     ocrEventHc_t base;
     ocrGuid_t data;
+#ifdef ENABLE_EXTENSION_LEGACY
+    volatile u32 satisfied;    /**< Set once 'data' is readable, blocked threads wait on it */
+    volatile u32 blockedCount; /**< Number of threads blocked in the event's wait */
+#endif
 } ocrEventHcPersist_t;
 
 typedef struct _ocrEventHcCounted_t {
     ocrEventHcPersist_t base;
-    u64 nbDeps; // this is only updated inside a lock
+    volatile u64 nbDeps; // atomically decremented by registrations after the satisfy
 } ocrEventHcCounted_t;
 
 typedef struct _ocrEventHcLatch_t {
@@ -83,5 +109,13 @@ typedef struct _ocrEventHcChannel_t {
 
 ocrEventFactory_t* newEventFactoryHc(ocrParamList_t *perType, u32 factoryId);
 
+struct _ocrPolicyDomain_t;
+
+/* Creates and destroys the runtime EDT template of the satisfy batches.
+ * Called by the PD when it brings up and tears down RL_COMPUTE_OK. Until
+ * then satisfies are never fanned out. */
+u8 hcEventFactoryCreateTemplates(ocrEventFactory_t *factory, struct _ocrPolicyDomain_t *pd);
+u8 hcEventFactoryDestroyTemplates(ocrEventFactory_t *factory, struct _ocrPolicyDomain_t *pd);
+
 #endif /* ENABLE_EVENT_HC */
 #endif /* __HC_EVENT_H__ */
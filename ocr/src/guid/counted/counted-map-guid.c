@@ -64,12 +64,13 @@
 #ifdef GUID_PROVIDER_CUSTOM_MAP
 // Set -DGUID_PROVIDER_CUSTOM_MAP and put other #ifdef for alternate implementation here
 #else
-#define GP_RESOLVE_HASHTABLE(hashtable, key) hashtable
-#define GP_HASHTABLE_CREATE_MODULO newHashtableBucketLocked
-#define GP_HASHTABLE_DESTRUCT(hashtable, key, entryDealloc, deallocParam) destructHashtableBucketLocked(hashtable, entryDealloc, deallocParam)
-#define GP_HASHTABLE_GET(hashtable, key) hashtableConcBucketLockedGet(GP_RESOLVE_HASHTABLE(hashtable,key), key)
-#define GP_HASHTABLE_PUT(hashtable, key, value) hashtableConcBucketLockedPut(GP_RESOLVE_HASHTABLE(hashtable,key), key, value)
-#define GP_HASHTABLE_DEL(hashtable, key, valueBack) hashtableConcBucketLockedRemove(GP_RESOLVE_HASHTABLE(hashtable,key), key, valueBack)
+#define GP_RESOLVE_HASHTABLE(provider, key) (provider)->guidImplTable
+#define GP_HASHTABLE_CREATE_MODULO(provider, pd, nbBuckets, hashing) (provider)->mapFcts.create(pd, nbBuckets, hashing)
+#define GP_HASHTABLE_DESTRUCT(provider, key, entryDealloc, deallocParam) (provider)->mapFcts.destruct(GP_RESOLVE_HASHTABLE(provider,key), entryDealloc, deallocParam)
+#define GP_HASHTABLE_GET(provider, key) (provider)->mapFcts.get(GP_RESOLVE_HASHTABLE(provider,key), key)
+#define GP_HASHTABLE_PUT(provider, key, value) (provider)->mapFcts.put(GP_RESOLVE_HASHTABLE(provider,key), key, value)
+#define GP_HASHTABLE_TRYPUT(provider, key, value) (provider)->mapFcts.tryPut(GP_RESOLVE_HASHTABLE(provider,key), key, value)
+#define GP_HASHTABLE_DEL(provider, key, valueBack) (provider)->mapFcts.remove(GP_RESOLVE_HASHTABLE(provider,key), key, valueBack)
 #endif
 
 #ifdef GUID_PROVIDER_WID_INGUID
@@ -165,7 +166,7 @@ u8 countedMapSwitchRunlevel(ocrGuidProvider_t *self, ocrPolicyDomain_t *PD, ocrR
             deallocFct entryDeallocator = NULL;
             void * deallocParam = NULL;
 #endif
-            GP_HASHTABLE_DESTRUCT(((ocrGuidProviderCountedMap_t *) self)->guidImplTable, NULL, entryDeallocator, deallocParam);
+            GP_HASHTABLE_DESTRUCT((ocrGuidProviderCountedMap_t *) self, NULL, entryDeallocator, deallocParam);
 #ifdef GUID_PROVIDER_DESTRUCT_CHECK
             PRINTF("=========================\n");
             PRINTF("Remnant GUIDs summary:\n");
@@ -183,7 +184,7 @@ u8 countedMapSwitchRunlevel(ocrGuidProvider_t *self, ocrPolicyDomain_t *PD, ocrR
         if((properties & RL_BRING_UP) && RL_IS_LAST_PHASE_UP(PD, RL_GUID_OK, phase)) {
             //Initialize the map now that we have an assigned policy domain
             ocrGuidProviderCountedMap_t * derived = (ocrGuidProviderCountedMap_t *) self;
-            derived->guidImplTable = GP_HASHTABLE_CREATE_MODULO(PD, GUID_PROVIDER_NB_BUCKETS, hashGuidCounterModulo);
+            derived->guidImplTable = GP_HASHTABLE_CREATE_MODULO(derived, PD, GUID_PROVIDER_NB_BUCKETS, hashGuidCounterModulo);
 #ifdef GUID_PROVIDER_WID_INGUID
             ASSERT(((PD->workerCount-1) < ((u64)1 << GUID_WID_SIZE)) && "GUID worker count overflows");
 #endif
@@ -294,7 +295,7 @@ static u8 countedMapGetGuid(ocrGuidProvider_t* self, ocrGuid_t* guid, u64 val, o
     // Here no need to allocate
     u64 newGuid = generateNextGuid(self, kind);
 
-    GP_HASHTABLE_PUT(((ocrGuidProviderCountedMap_t *) self)->guidImplTable, (void *) newGuid, (void *) val);
+    GP_HASHTABLE_PUT((ocrGuidProviderCountedMap_t *) self, (void *) newGuid, (void *) val);
     // See BUG #928 on GUID issues
 
 #if GUID_BIT_COUNT == 64
@@ -350,9 +351,9 @@ u8 countedMapCreateGuid(ocrGuidProvider_t* self, ocrFatGuid_t *fguid, u64 size,
 static u8 countedMapGetVal(ocrGuidProvider_t* self, ocrGuid_t guid, u64* val, ocrGuidKind* kind) {
     // See BUG #928 on GUID issues
 #if GUID_BIT_COUNT == 64
-    *val = (u64) GP_HASHTABLE_GET(((ocrGuidProviderCountedMap_t *) self)->guidImplTable, (void *) guid.guid);
+    *val = (u64) GP_HASHTABLE_GET((ocrGuidProviderCountedMap_t *) self, (void *) guid.guid);
 #elif GUID_BIT_COUNT == 128
-    *val = (u64) GP_HASHTABLE_GET(((ocrGuidProviderCountedMap_t *) self)->guidImplTable, (void *) guid.lower);
+    *val = (u64) GP_HASHTABLE_GET((ocrGuidProviderCountedMap_t *) self, (void *) guid.lower);
 #else
 #error Unknown type of GUID
 #endif
@@ -388,9 +389,9 @@ u8 countedMapGetLocation(ocrGuidProvider_t* self, ocrGuid_t guid, ocrLocation_t*
 u8 countedMapRegisterGuid(ocrGuidProvider_t* self, ocrGuid_t guid, u64 val) {
     // See BUG #928 on GUID issues
 #if GUID_BIT_COUNT == 64
-    GP_HASHTABLE_PUT(((ocrGuidProviderCountedMap_t *) self)->guidImplTable, (void *) guid.guid, (void *) val);
+    GP_HASHTABLE_PUT((ocrGuidProviderCountedMap_t *) self, (void *) guid.guid, (void *) val);
 #elif GUID_BIT_COUNT == 128
-    GP_HASHTABLE_PUT(((ocrGuidProviderCountedMap_t *) self)->guidImplTable, (void *) guid.lower, (void *) val);
+    GP_HASHTABLE_PUT((ocrGuidProviderCountedMap_t *) self, (void *) guid.lower, (void *) val);
 #else
 #error Unknown type of GUID
 #endif
@@ -403,9 +404,9 @@ u8 countedMapRegisterGuid(ocrGuidProvider_t* self, ocrGuid_t guid, u64 val) {
 u8 countedMapUnregisterGuid(ocrGuidProvider_t* self, ocrGuid_t guid, u64 ** val) {
     // See BUG #928 on GUID issues
 #if GUID_BIT_COUNT == 64
-    GP_HASHTABLE_DEL(((ocrGuidProviderCountedMap_t *) self)->guidImplTable, (void *) guid.guid, (void **) val);
+    GP_HASHTABLE_DEL((ocrGuidProviderCountedMap_t *) self, (void *) guid.guid, (void **) val);
 #elif GUID_BIT_COUNT == 128
-    GP_HASHTABLE_DEL(((ocrGuidProviderCountedMap_t *) self)->guidImplTable, (void *) guid.lower, (void **) val);
+    GP_HASHTABLE_DEL((ocrGuidProviderCountedMap_t *) self, (void *) guid.lower, (void **) val);
 #else
 #error Unknown type of GUID
 #endif
@@ -437,9 +438,9 @@ u8 countedMapReleaseGuid(ocrGuidProvider_t *self, ocrFatGuid_t fatGuid, bool rel
     ocrGuidProviderCountedMap_t * derived = (ocrGuidProviderCountedMap_t *) self;
     // See BUG #928 on GUID issues
 #if GUID_BIT_COUNT == 64
-    GP_HASHTABLE_DEL(derived->guidImplTable, (void *)guid.guid, NULL);
+    GP_HASHTABLE_DEL(derived, (void *)guid.guid, NULL);
 #elif GUID_BIT_COUNT == 128
-    GP_HASHTABLE_DEL(derived->guidImplTable, (void *) guid.lower, NULL);
+    GP_HASHTABLE_DEL(derived, (void *) guid.lower, NULL);
 #else
 #error Unknown type of GUID
 #endif
@@ -452,6 +453,8 @@ static ocrGuidProvider_t* newGuidProviderCountedMap(ocrGuidProviderFactory_t *fa
     base->fcts = factory->providerFcts;
     base->pd = NULL;
     base->id = factory->factoryId;
+    ocrGuidProviderCountedMap_t * derived = (ocrGuidProviderCountedMap_t *) base;
+    hashtableFctsInit(&derived->mapFcts, ((paramListGuidProviderCountedMap_t *) perInstance)->mapType);
     return base;
 }
 
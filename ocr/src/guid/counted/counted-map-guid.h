@@ -21,12 +21,19 @@
  * !! Performance Warning !!
  * - Hashtable implementation is backed by a simplistic hash function.
  * - The number of hashtable's buckets can be customize through 'GUID_PROVIDER_NB_BUCKETS'.
+ *   It is the initial size of the table when 'maptype' is set to RESIZABLE in the configuration file.
  * - GUID generation relies on an atomic incr shared by ALL the workers of the PD.
  */
 
+typedef struct {
+    paramListGuidProviderInst_t base;
+    hashtableType_t mapType;
+} paramListGuidProviderCountedMap_t;
+
 typedef struct {
     ocrGuidProvider_t base;
     hashtable_t * guidImplTable;
+    hashtableFcts_t mapFcts;
 } ocrGuidProviderCountedMap_t;
 
 typedef struct {
@@ -16,6 +16,9 @@ const char * guid_types[] = {
 #endif
 #ifdef ENABLE_GUID_LABELED
     "LABELED",
+#endif
+#ifdef ENABLE_GUID_HYBRID
+    "HYBRID",
 #endif
     NULL
 };
@@ -33,6 +36,10 @@ ocrGuidProviderFactory_t *newGuidProviderFactory(guidType_t type, ocrParamList_t
 #ifdef ENABLE_GUID_LABELED
     case guidLabeled_id:
         return newGuidProviderFactoryLabeled(typeArg, (u32)type);
+#endif
+#ifdef ENABLE_GUID_HYBRID
+    case guidHybrid_id:
+        return newGuidProviderFactoryHybrid(typeArg, (u32)type);
 #endif
     default:
         ASSERT(0);
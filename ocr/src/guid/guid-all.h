@@ -21,6 +21,9 @@ typedef enum _guidType_t {
 #endif
 #ifdef ENABLE_GUID_LABELED
     guidLabeled_id,
+#endif
+#ifdef ENABLE_GUID_HYBRID
+    guidHybrid_id,
 #endif
     guidMax_id
 } guidType_t;
@@ -34,6 +37,9 @@ typedef enum _guidType_t {
 #ifdef ENABLE_GUID_LABELED
 #include "guid/labeled/labeled-guid.h"
 #endif
+#ifdef ENABLE_GUID_HYBRID
+#include "guid/hybrid/hybrid-guid.h"
+#endif
 
 extern const char * guid_types[];
 
@@ -0,0 +1,768 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#include "ocr-config.h"
+#ifdef ENABLE_GUID_HYBRID
+
+#include "debug.h"
+#include "guid/hybrid/hybrid-guid.h"
+#include "ocr-errors.h"
+#include "ocr-policy-domain.h"
+#include "ocr-sysboot.h"
+#include "ocr-worker.h"
+
+#define DEBUG_TYPE GUID
+
+// Default hashtable's number of buckets
+// Only remote and reserved GUIDs go in the hashtable
+#ifndef GUID_PROVIDER_NB_BUCKETS
+#define GUID_PROVIDER_NB_BUCKETS 10000
+#endif
+
+// Guid is composed of : (1/0 LOCID KIND COUNTER)
+// The 1 at the top is if this is a "reserved" GUID (for checking purposes)
+// For the other GUIDs generated by this PD, COUNTER is (GEN INDEX)
+#define GUID_BIT_SIZE 64
+#ifndef GUID_PROVIDER_LOCID_SIZE
+#define GUID_LOCID_SIZE 7 // Warning! 2^7 locId max, bump that up for more.
+#else
+#define GUID_LOCID_SIZE GUID_PROVIDER_LOCID_SIZE
+#endif
+#define GUID_KIND_SIZE 5 // Warning! check ocrGuidKind struct definition for correct size
+
+#define GUID_COUNTER_SIZE (GUID_BIT_SIZE-(GUID_KIND_SIZE+GUID_LOCID_SIZE+1))
+#define GUID_COUNTER_MASK ((((u64)1)<<(GUID_COUNTER_SIZE))-1)
+#define GUID_LOCID_MASK (((((u64)1)<<GUID_LOCID_SIZE)-1)<<(GUID_COUNTER_SIZE+GUID_KIND_SIZE))
+#define GUID_LOCID_SHIFT_RIGHT (GUID_BIT_SIZE-GUID_LOCID_SIZE-1)
+#define GUID_KIND_MASK (((((u64)1)<<GUID_KIND_SIZE)-1)<<GUID_COUNTER_SIZE)
+#define GUID_KIND_SHIFT_RIGHT (GUID_LOCID_SHIFT_RIGHT-GUID_KIND_SIZE)
+#define KIND_LOCATION (0)
+#define LOCID_LOCATION (GUID_KIND_SIZE)
+
+// Number of bits of the counter holding the slot index. 2^GUID_INDEX_SIZE
+// GUIDs generated by a PD can be alive at the same time.
+#ifndef GUID_PROVIDER_INDEX_SIZE
+#define GUID_INDEX_SIZE 26
+#else
+#define GUID_INDEX_SIZE GUID_PROVIDER_INDEX_SIZE
+#endif
+#define GUID_INDEX_MASK ((((u64)1)<<GUID_INDEX_SIZE)-1)
+// The rest of the counter holds the slot's generation
+#define GUID_GEN_SIZE (GUID_COUNTER_SIZE-GUID_INDEX_SIZE)
+#define GUID_GEN_MASK ((((u64)1)<<GUID_GEN_SIZE)-1)
+
+#if GUID_GEN_SIZE < 8
+#error Not enough GUID bits left for the slot generation, reduce GUID_PROVIDER_INDEX_SIZE
+#endif
+
+// Slots are allocated by chunks of 2^GUID_SLOT_CHUNK_LOG2
+#ifndef GUID_PROVIDER_SLOT_CHUNK_LOG2
+#define GUID_SLOT_CHUNK_LOG2 12
+#else
+#define GUID_SLOT_CHUNK_LOG2 GUID_PROVIDER_SLOT_CHUNK_LOG2
+#endif
+#define GUID_SLOT_CHUNK_SIZE (((u64)1)<<GUID_SLOT_CHUNK_LOG2)
+#define GUID_SLOT_CHUNK_COUNT (((u64)1)<<(GUID_INDEX_SIZE-GUID_SLOT_CHUNK_LOG2))
+
+// Number of free slots moved at once between a worker's free list and the shared one
+#ifndef GUID_PROVIDER_SLOT_BATCH
+#define GUID_SLOT_BATCH 64
+#else
+#define GUID_SLOT_BATCH GUID_PROVIDER_SLOT_BATCH
+#endif
+
+// See BUG #928 on GUID issues
+#if GUID_BIT_COUNT == 64
+#define GUID_VALUE(guidVal) ((guidVal).guid)
+#elif GUID_BIT_COUNT == 128
+#define GUID_VALUE(guidVal) ((guidVal).lower)
+#else
+#error Unknown GUID type
+#endif
+
+#define IS_RESERVED_GUID(guidVal) ((GUID_VALUE(guidVal) & 0x8000000000000000ULL) != 0ULL)
+
+#ifdef GUID_PROVIDER_CUSTOM_MAP
+// Set -DGUID_PROVIDER_CUSTOM_MAP and put other #ifdef for alternate implementation here
+#else
+#define GP_RESOLVE_HASHTABLE(provider, key) (provider)->guidImplTable
+#define GP_HASHTABLE_CREATE_MODULO(provider, pd, nbBuckets, hashing) (provider)->mapFcts.create(pd, nbBuckets, hashing)
+#define GP_HASHTABLE_DESTRUCT(provider, key, entryDealloc, deallocParam) (provider)->mapFcts.destruct(GP_RESOLVE_HASHTABLE(provider,key), entryDealloc, deallocParam)
+#define GP_HASHTABLE_GET(provider, key) (provider)->mapFcts.get(GP_RESOLVE_HASHTABLE(provider,key), key)
+#define GP_HASHTABLE_PUT(provider, key, value) (provider)->mapFcts.put(GP_RESOLVE_HASHTABLE(provider,key), key, value)
+#define GP_HASHTABLE_TRYPUT(provider, key, value) (provider)->mapFcts.tryPut(GP_RESOLVE_HASHTABLE(provider,key), key, value)
+#define GP_HASHTABLE_DEL(provider, key, valueBack) (provider)->mapFcts.remove(GP_RESOLVE_HASHTABLE(provider,key), key, valueBack)
+#endif
+
+#ifdef GUID_PROVIDER_DESTRUCT_CHECK
+// Fwd declaration
+static ocrGuidKind getKindFromGuid(ocrGuid_t guid);
+
+void hybridGuidHashmapEntryDestructChecker(void * key, void * value, void * deallocParam) {
+    ocrGuid_t guid;
+#if GUID_BIT_COUNT == 64
+    guid.guid = (u64) key;
+#elif GUID_BIT_COUNT == 128
+    guid.upper = 0x0;
+    guid.lower = (u64) key;
+#endif
+    ((u32*)deallocParam)[getKindFromGuid(guid)]++;
+#ifdef GUID_PROVIDER_DESTRUCT_CHECK_VERBOSE
+    DPRINTF(DEBUG_LVL_WARN, "Remnant GUID "GUIDF" of kind %s still registered on GUID provider\n", GUIDA(guid), ocrGuidKindToChar(getKindFromGuid(guid)));
+#endif
+}
+#endif
+
+void hybridGuidDestruct(ocrGuidProvider_t* self) {
+    runtimeChunkFree((u64)self, PERSISTENT_CHUNK);
+}
+
+static u32 hashGuidCounterModulo(void * ptr, u32 nbBuckets) {
+    u64 guid = (u64) ptr;
+    return ((guid & GUID_COUNTER_MASK) % nbBuckets);
+}
+
+/**
+ * @brief Allocates the slot directory and the free lists
+ */
+static void slotTableCreate(ocrGuidProviderHybrid_t *derived, ocrPolicyDomain_t *pd) {
+    u64 i;
+    derived->slotChunks = (hybridGuidSlot_t **) pd->fcts.pdMalloc(pd, GUID_SLOT_CHUNK_COUNT*sizeof(hybridGuidSlot_t*));
+    for(i = 0; i < GUID_SLOT_CHUNK_COUNT; ++i) {
+        derived->slotChunks[i] = NULL;
+    }
+    // Slot 0 is never used: it terminates the free lists and keeps GUIDs non-null
+    derived->nextIndex = 1;
+    derived->workerCount = pd->workerCount;
+    derived->workerFree = (hybridGuidFreeList_t *) pd->fcts.pdMalloc(pd, pd->workerCount*sizeof(hybridGuidFreeList_t));
+    for(i = 0; i < pd->workerCount; ++i) {
+        derived->workerFree[i].head = 0;
+        derived->workerFree[i].count = 0;
+    }
+    derived->sharedFree.head = 0;
+    derived->sharedFree.count = 0;
+    derived->chunkLock = 0;
+    derived->sharedLock = 0;
+}
+
+static void slotTableDestruct(ocrGuidProviderHybrid_t *derived, ocrPolicyDomain_t *pd, u32 *guidTypeCounters) {
+    u64 i;
+    for(i = 0; i < GUID_SLOT_CHUNK_COUNT; ++i) {
+        hybridGuidSlot_t *chunk = derived->slotChunks[i];
+        if(chunk == NULL) {
+            break; // Chunks are allocated in order
+        }
+#ifdef GUID_PROVIDER_DESTRUCT_CHECK
+        u64 j;
+        for(j = 0; j < GUID_SLOT_CHUNK_SIZE; ++j) {
+            if(chunk[j].kind != OCR_GUID_MAX) {
+                guidTypeCounters[chunk[j].kind]++;
+            }
+        }
+#endif
+        pd->fcts.pdFree(pd, chunk);
+    }
+    pd->fcts.pdFree(pd, derived->slotChunks);
+    pd->fcts.pdFree(pd, derived->workerFree);
+    derived->slotChunks = NULL;
+    derived->workerFree = NULL;
+}
+
+u8 hybridGuidSwitchRunlevel(ocrGuidProvider_t *self, ocrPolicyDomain_t *PD, ocrRunlevel_t runlevel,
+                            phase_t phase, u32 properties, void (*callback)(ocrPolicyDomain_t*, u64), u64 val) {
+
+    u8 toReturn = 0;
+
+    // This is an inert module, we do not handle callbacks (caller needs to wait on us)
+    ASSERT(callback == NULL);
+
+    // Verify properties for this call
+    ASSERT((properties & RL_REQUEST) && !(properties & RL_RESPONSE)
+           && !(properties & RL_RELEASE));
+    ASSERT(!(properties & RL_FROM_MSG));
+
+    switch(runlevel) {
+    case RL_CONFIG_PARSE:
+        // On bring-up: Update PD->phasesPerRunlevel on phase 0
+        // and check compatibility on phase 1
+        break;
+    case RL_NETWORK_OK:
+        // Nothing
+        break;
+    case RL_PD_OK:
+        if ((properties & RL_BRING_UP) && RL_IS_FIRST_PHASE_UP(PD, RL_PD_OK, phase)) {
+            self->pd = PD;
+        }
+        break;
+    case RL_MEMORY_OK:
+        // Nothing to do
+        if ((properties & RL_TEAR_DOWN) && RL_IS_FIRST_PHASE_DOWN(PD, RL_GUID_OK, phase)) {
+            // Same as for the labeled provider: whatever is left in the map
+            // and in the slots are either leaked user objects or runtime GUIDs
+            // nobody can access anymore.
+            u32 guidTypeCounters[OCR_GUID_MAX];
+#ifdef GUID_PROVIDER_DESTRUCT_CHECK
+            deallocFct entryDeallocator = hybridGuidHashmapEntryDestructChecker;
+            u32 i;
+            for(i=0; i < OCR_GUID_MAX; i++) {
+                guidTypeCounters[i] = 0;
+            }
+            void * deallocParam = (void *) guidTypeCounters;
+#else
+            deallocFct entryDeallocator = NULL;
+            void * deallocParam = NULL;
+#endif
+            ocrGuidProviderHybrid_t * derived = (ocrGuidProviderHybrid_t *) self;
+            GP_HASHTABLE_DESTRUCT(derived, NULL, entryDeallocator, deallocParam);
+            slotTableDestruct(derived, PD, guidTypeCounters);
+#ifdef GUID_PROVIDER_DESTRUCT_CHECK
+            PRINTF("=========================\n");
+            PRINTF("Remnant GUIDs summary:\n");
+            for(i=0; i < OCR_GUID_MAX; i++) {
+                if (guidTypeCounters[i] != 0) {
+                    PRINTF("%s => %"PRIu32" instances\n", ocrGuidKindToChar(i), guidTypeCounters[i]);
+                }
+            }
+            PRINTF("=========================\n");
+#endif
+        }
+        break;
+    case RL_GUID_OK:
+        ASSERT(self->pd == PD);
+        if((properties & RL_BRING_UP) && RL_IS_LAST_PHASE_UP(PD, RL_GUID_OK, phase)) {
+            //Initialize the map and the slots now that we have an assigned policy domain
+            ocrGuidProviderHybrid_t * derived = (ocrGuidProviderHybrid_t *) self;
+            derived->guidImplTable = GP_HASHTABLE_CREATE_MODULO(derived, PD, GUID_PROVIDER_NB_BUCKETS, hashGuidCounterModulo);
+            slotTableCreate(derived, PD);
+        }
+        break;
+    case RL_COMPUTE_OK:
+        break;
+    case RL_USER_OK:
+        break;
+    default:
+        // Unknown runlevel
+        ASSERT(0);
+    }
+    return toReturn;
+}
+
+/**
+ * @brief Utility function to extract a kind from a GUID.
+ */
+static ocrGuidKind getKindFromGuid(ocrGuid_t guid) {
+    return (ocrGuidKind) ((GUID_VALUE(guid) & GUID_KIND_MASK) >> GUID_KIND_SHIFT_RIGHT);
+}
+
+/**
+ * @brief Utility function to extract a location id from a GUID.
+ */
+static u64 extractLocIdFromGuid(ocrGuid_t guid) {
+    return (u64) ((GUID_VALUE(guid) & GUID_LOCID_MASK) >> GUID_LOCID_SHIFT_RIGHT);
+}
+
+static ocrLocation_t locIdtoLocation(u64 locId) {
+    //BUG #605 Locations spec: We assume there will be a mapping
+    //between a location and an 'id' stored in the guid. For now identity.
+    return (ocrLocation_t) (locId);
+}
+
+static u64 locationToLocId(ocrLocation_t location) {
+    //BUG #605 Locations spec: We assume there will be a mapping
+    //between a location and an 'id' stored in the guid. For now identity.
+    u64 locId = (u64)(location);
+    // Make sure we're not overflowing location size
+    ASSERT((locId < (1<<GUID_LOCID_SIZE)) && "GUID location ID overflows");
+    return locId;
+}
+
+/**
+ * @brief Tells whether 'guid' is backed by a slot, that is, it was
+ * generated by this PD and is not reserved
+ */
+static inline bool isSlotGuid(ocrGuidProvider_t *self, ocrGuid_t guid) {
+    return !IS_RESERVED_GUID(guid) &&
+        (extractLocIdFromGuid(guid) == locationToLocId(self->pd->myLocation));
+}
+
+static inline hybridGuidSlot_t * getSlot(ocrGuidProviderHybrid_t *derived, u64 index) {
+    hybridGuidSlot_t *chunk = hal_loadAcquire(&(derived->slotChunks[index >> GUID_SLOT_CHUNK_LOG2]));
+    return (chunk == NULL) ? NULL : &(chunk[index & (GUID_SLOT_CHUNK_SIZE-1)]);
+}
+
+/**
+ * @brief Returns the free list of the calling worker, NULL if the caller
+ * is not one of this PD's workers
+ */
+static hybridGuidFreeList_t * getFreeList(ocrGuidProviderHybrid_t *derived) {
+    ocrWorker_t *worker = NULL;
+    getCurrentEnv(NULL, &worker, NULL, NULL);
+    // GUIDs are generated before the current worker is setup
+    if((worker != NULL) && (worker->pd == derived->base.pd) && (worker->id < derived->workerCount)) {
+        return &(derived->workerFree[worker->id]);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Moves the first GUID_SLOT_BATCH slots of 'list' to the shared free list
+ */
+static void spillFreeSlots(ocrGuidProviderHybrid_t *derived, hybridGuidFreeList_t *list) {
+    u64 first = list->head;
+    u64 last = first;
+    u32 i;
+    for(i = 1; i < GUID_SLOT_BATCH; ++i) {
+        last = getSlot(derived, last)->val;
+    }
+    hybridGuidSlot_t *lastSlot = getSlot(derived, last);
+    list->head = lastSlot->val;
+    list->count -= GUID_SLOT_BATCH;
+    hal_lock32(&(derived->sharedLock));
+    lastSlot->val = derived->sharedFree.head;
+    derived->sharedFree.head = first;
+    derived->sharedFree.count += GUID_SLOT_BATCH;
+    hal_unlock32(&(derived->sharedLock));
+}
+
+/**
+ * @brief Moves up to GUID_SLOT_BATCH slots of the shared free list to 'list', which is empty
+ */
+static void refillFreeSlots(ocrGuidProviderHybrid_t *derived, hybridGuidFreeList_t *list) {
+    if(derived->sharedFree.count == 0) {
+        return; // Racy check, good enough to avoid the lock most of the time
+    }
+    hal_lock32(&(derived->sharedLock));
+    u64 count = derived->sharedFree.count;
+    if(count == 0) {
+        hal_unlock32(&(derived->sharedLock));
+        return;
+    }
+    if(count > GUID_SLOT_BATCH) {
+        count = GUID_SLOT_BATCH;
+    }
+    u64 first = derived->sharedFree.head;
+    u64 last = first;
+    u32 i;
+    for(i = 1; i < count; ++i) {
+        last = getSlot(derived, last)->val;
+    }
+    hybridGuidSlot_t *lastSlot = getSlot(derived, last);
+    derived->sharedFree.head = lastSlot->val;
+    derived->sharedFree.count -= count;
+    hal_unlock32(&(derived->sharedLock));
+    lastSlot->val = 0;
+    list->head = first;
+    list->count = count;
+}
+
+/**
+ * @brief Returns the index of a slot that has never been used, allocating its chunk if needed
+ */
+static u64 newSlotIndex(ocrGuidProviderHybrid_t *derived) {
+    u64 index = hal_xadd64(&(derived->nextIndex), 1);
+    ASSERT((index < (((u64)1)<<GUID_INDEX_SIZE)) && "GUID slot index overflows");
+    hybridGuidSlot_t ** chunkPtr = &(derived->slotChunks[index >> GUID_SLOT_CHUNK_LOG2]);
+    if(hal_loadAcquire(chunkPtr) == NULL) {
+        hal_lock32(&(derived->chunkLock));
+        if(*chunkPtr == NULL) {
+            ocrPolicyDomain_t *pd = derived->base.pd;
+            hybridGuidSlot_t *chunk = (hybridGuidSlot_t *) pd->fcts.pdMalloc(pd, GUID_SLOT_CHUNK_SIZE*sizeof(hybridGuidSlot_t));
+            u64 i;
+            for(i = 0; i < GUID_SLOT_CHUNK_SIZE; ++i) {
+                chunk[i].val = 0;
+                chunk[i].gen = 0;
+                chunk[i].kind = OCR_GUID_MAX;
+            }
+            hal_storeRelease(chunkPtr, chunk);
+        }
+        hal_unlock32(&(derived->chunkLock));
+    }
+    return index;
+}
+
+/**
+ * @brief Associates a new slot to 'val' and returns the GUID designating it
+ */
+static u64 slotAcquire(ocrGuidProvider_t *self, u64 val, ocrGuidKind kind) {
+    ocrGuidProviderHybrid_t *derived = (ocrGuidProviderHybrid_t *) self;
+    hybridGuidFreeList_t *list = getFreeList(derived);
+    u64 index = 0;
+    if(list == NULL) {
+        hal_lock32(&(derived->sharedLock));
+        index = derived->sharedFree.head;
+        if(index != 0) {
+            derived->sharedFree.head = getSlot(derived, index)->val;
+            derived->sharedFree.count--;
+        }
+        hal_unlock32(&(derived->sharedLock));
+    } else {
+        if(list->head == 0) {
+            refillFreeSlots(derived, list);
+        }
+        index = list->head;
+        if(index != 0) {
+            list->head = getSlot(derived, index)->val;
+            list->count--;
+        }
+    }
+    if(index == 0) {
+        index = newSlotIndex(derived);
+    }
+    hybridGuidSlot_t *slot = getSlot(derived, index);
+    slot->kind = kind;
+    slot->val = val;
+
+    u64 locId = (u64) locationToLocId(self->pd->myLocation);
+    u64 guid = ((locId << LOCID_LOCATION) | (kind << KIND_LOCATION)) << GUID_COUNTER_SIZE;
+    guid |= (((u64)slot->gen) << GUID_INDEX_SIZE) | index;
+    DPRINTF(DEBUG_LVL_VVERB, "HybridGUID generated GUID %"PRIx64"\n", guid);
+    return guid;
+}
+
+/**
+ * @brief Returns the slot of a GUID generated by this PD. The slot
+ * must currently be associated to the GUID.
+ */
+static hybridGuidSlot_t * getLiveSlot(ocrGuidProviderHybrid_t *derived, ocrGuid_t guid) {
+    u64 guidVal = GUID_VALUE(guid);
+    hybridGuidSlot_t *slot = getSlot(derived, guidVal & GUID_INDEX_MASK);
+    ASSERT((slot != NULL) && "GUID was never generated");
+    ASSERT((slot->gen == ((guidVal & GUID_COUNTER_MASK) >> GUID_INDEX_SIZE)) && "GUID used after being released");
+    return slot;
+}
+
+/**
+ * @brief Dissociates a slot from its GUID and makes it available again
+ */
+static void slotRelease(ocrGuidProviderHybrid_t *derived, hybridGuidSlot_t *slot, u64 index) {
+    hybridGuidFreeList_t *list = getFreeList(derived);
+    slot->kind = OCR_GUID_MAX;
+    // Bump the generation before the value is overwritten so that
+    // a concurrent resolve can't return the list link as the value
+    slot->gen = (slot->gen + 1) & GUID_GEN_MASK;
+    if(list == NULL) {
+        hal_lock32(&(derived->sharedLock));
+        hal_storeRelease(&(slot->val), derived->sharedFree.head);
+        derived->sharedFree.head = index;
+        derived->sharedFree.count++;
+        hal_unlock32(&(derived->sharedLock));
+    } else {
+        hal_storeRelease(&(slot->val), list->head);
+        list->head = index;
+        list->count++;
+        if(list->count >= (2*GUID_SLOT_BATCH)) {
+            spillFreeSlots(derived, list);
+        }
+    }
+}
+
+u8 hybridGuidReserve(ocrGuidProvider_t *self, ocrGuid_t *startGuid, u64* skipGuid,
+                     u64 numberGuids, ocrGuidKind guidType) {
+    // Same as for the labeled provider. Reserved GUIDs are not backed
+    // by slots since they are created (and recreated) by label
+    ocrGuidProviderHybrid_t *derived = (ocrGuidProviderHybrid_t *) self;
+    u64 locId = (u64) locationToLocId(self->pd->myLocation);
+    u64 locIdShifted = locId << LOCID_LOCATION;
+    u64 kindShifted = guidType << KIND_LOCATION;
+    u64 firstCount = hal_xadd64(&(derived->reservedCounter), numberGuids);
+    ASSERT(firstCount  + numberGuids < (u64)1<<GUID_COUNTER_SIZE);
+    // See BUG #928 on GUID issues
+#if GUID_BIT_COUNT == 64
+    (*(startGuid)).guid = (((1 << (GUID_LOCID_SIZE + LOCID_LOCATION)) | locIdShifted | kindShifted) <<
+        GUID_COUNTER_SIZE) | firstCount;
+#elif GUID_BIT_COUNT == 128
+    (*(startGuid)).lower = (((1 << (GUID_LOCID_SIZE + LOCID_LOCATION)) | locIdShifted | kindShifted) <<
+        GUID_COUNTER_SIZE) | firstCount;
+    (*(startGuid)).upper = 0x0;
+#endif
+    *skipGuid = 1; // Each GUID will just increment by 1
+
+    DPRINTF(DEBUG_LVL_VVERB, "HybridGUID reserved a range for %"PRIu64" GUIDs starting at "GUIDF"\n",
+            numberGuids, GUIDA(*startGuid));
+    return 0;
+}
+
+u8 hybridGuidUnreserve(ocrGuidProvider_t *self, ocrGuid_t startGuid, u64 skipGuid,
+                       u64 numberGuids) {
+    // We do not do anything (we don't reclaim right now)
+    return 0;
+}
+
+/**
+ * @brief Generate a guid for 'val' backed by a slot
+ */
+u8 hybridGuidGetGuid(ocrGuidProvider_t* self, ocrGuid_t* guid, u64 val, ocrGuidKind kind) {
+    u64 newGuid = slotAcquire(self, val, kind);
+    DPRINTF(DEBUG_LVL_VERB, "HybridGUID: slot GUID 0x%"PRIx64" -> 0x%"PRIx64"\n", newGuid, val);
+    // See BUG #928 on GUID issues
+#if GUID_BIT_COUNT == 64
+    (*(guid)).guid =  newGuid;
+#elif GUID_BIT_COUNT == 128
+    (*(guid)).lower = newGuid;
+    (*(guid)).upper = 0x0;
+#endif
+    return 0;
+}
+
+u8 hybridGuidCreateGuid(ocrGuidProvider_t* self, ocrFatGuid_t *fguid, u64 size, ocrGuidKind kind, u32 properties) {
+    ocrGuidProviderHybrid_t *derived = (ocrGuidProviderHybrid_t *) self;
+    if(properties & GUID_PROP_IS_LABELED) {
+        // We need to use the GUID provided; make sure it is non null and reserved
+        ASSERT((!(ocrGuidIsNull(fguid->guid))) && (IS_RESERVED_GUID(fguid->guid)));
+        // Related to BUG #535 and to BUG #536
+        ASSERT(extractLocIdFromGuid(fguid->guid) == locationToLocId(self->pd->myLocation));
+        ASSERT(getKindFromGuid(fguid->guid) == kind); // Kind properly encoded
+        ASSERT((GUID_VALUE(fguid->guid) & GUID_COUNTER_MASK) < derived->reservedCounter); // Range actually reserved
+    }
+    ocrPolicyDomain_t *policy = NULL;
+    PD_MSG_STACK(msg);
+    getCurrentEnv(&policy, NULL, NULL, &msg);
+#define PD_MSG (&msg)
+#define PD_TYPE PD_MSG_MEM_ALLOC
+    msg.type = PD_MSG_MEM_ALLOC | PD_MSG_REQUEST | PD_MSG_REQ_RESPONSE;
+    PD_MSG_FIELD_I(size) = size; // allocate 'size' payload as metadata
+    PD_MSG_FIELD_I(properties) = 0;
+    PD_MSG_FIELD_I(type) = GUID_MEMTYPE;
+
+    RESULT_PROPAGATE(policy->fcts.processMessage (policy, &msg, true));
+    void * ptr = (void *)PD_MSG_FIELD_O(ptr);
+
+    // Update the fat GUID's metaDataPtr
+    fguid->metaDataPtr = ptr;
+    ASSERT(ptr);
+#undef PD_TYPE
+    (*(ocrGuid_t*)ptr) = NULL_GUID; // The first field is always the GUID, either directly as ocrGuid_t or a ocrFatGuid_t
+                                    // This is used to determine if a GUID metadata is "ready". See bug #627
+    hal_fence(); // Make sure the ptr update is visible before we update the hash table
+    if(properties & GUID_PROP_IS_LABELED) {
+        // Bug #865: Warning if ordering is important, first GUID_PROP_CHECK then GUID_PROP_BLOCK
+        // because we want the first branch to intercept (GUID_PROP_CHECK | GUID_PROP_BLOCK)
+        if((properties & GUID_PROP_CHECK) == GUID_PROP_CHECK) {
+            // We need to actually check things
+            DPRINTF(DEBUG_LVL_VERB, "HybridGUID: try insert into hash table "GUIDF" -> %p\n", GUIDA(fguid->guid), ptr);
+            void *value = GP_HASHTABLE_TRYPUT(derived, (void*)GUID_VALUE(fguid->guid), ptr);
+            if(value != ptr) {
+                DPRINTF(DEBUG_LVL_VVERB, "HybridGUID: FAILED to insert (got %p instead of %p)\n",
+                        value, ptr);
+                // Fail; already exists
+                fguid->metaDataPtr = value;
+                // We now need to free the memory we allocated
+                getCurrentEnv(NULL, NULL, NULL, &msg);
+#define PD_TYPE PD_MSG_MEM_UNALLOC
+                msg.type = PD_MSG_MEM_UNALLOC | PD_MSG_REQUEST;
+                PD_MSG_FIELD_I(allocatingPD.guid) = NULL_GUID;
+                PD_MSG_FIELD_I(allocator.guid) = NULL_GUID;
+                PD_MSG_FIELD_I(ptr) = ptr;
+                PD_MSG_FIELD_I(type) = GUID_MEMTYPE;
+                PD_MSG_FIELD_I(properties) = 0;
+                RESULT_PROPAGATE(policy->fcts.processMessage(policy, &msg, true));
+#undef PD_TYPE
+                // See the labeled provider for bug #627 and bug #865
+                if ((properties & GUID_PROP_BLOCK) != GUID_PROP_BLOCK) {
+                    while((*(volatile u64*)value) != GUID_VALUE(fguid->guid));
+                }
+                hal_fence();
+                return OCR_EGUIDEXISTS;
+            }
+        } else if((properties & GUID_PROP_BLOCK) == GUID_PROP_BLOCK) {
+            void* value = NULL;
+            DPRINTF(DEBUG_LVL_VERB, "HybridGUID: force insert into hash table "GUIDF" -> %p\n", GUIDA(fguid->guid), ptr);
+            do {
+                value = GP_HASHTABLE_TRYPUT(derived, (void*)GUID_VALUE(fguid->guid), ptr);
+            } while(value != ptr);
+        } else {
+            // "Trust me" mode. We insert into the hashtable
+            DPRINTF(DEBUG_LVL_VERB, "HybridGUID: trust insert into hash table "GUIDF" -> %p\n", GUIDA(fguid->guid), ptr);
+            GP_HASHTABLE_PUT(derived, (void*)GUID_VALUE(fguid->guid), ptr);
+        }
+    } else {
+        hybridGuidGetGuid(self, &(fguid->guid), (u64)(fguid->metaDataPtr), kind);
+    }
+#undef PD_MSG
+    DPRINTF(DEBUG_LVL_VERB, "HybridGUID: create GUID: "GUIDF" -> 0x%p\n", GUIDA(fguid->guid), fguid->metaDataPtr);
+    return 0;
+}
+
+/**
+ * @brief Returns the value associated with a guid and its kind if requested.
+ */
+u8 hybridGuidGetVal(ocrGuidProvider_t* self, ocrGuid_t guid, u64* val, ocrGuidKind* kind) {
+    if(kind) {
+        *kind = getKindFromGuid(guid);
+    }
+    if(isSlotGuid(self, guid)) {
+        u64 guidVal = GUID_VALUE(guid);
+        hybridGuidSlot_t *slot = getSlot((ocrGuidProviderHybrid_t *) self, guidVal & GUID_INDEX_MASK);
+        *val = 0;
+        if(slot != NULL) {
+            // Read the value first: if the generation still matches
+            // afterwards, the value was the GUID's
+            u64 slotVal = hal_loadAcquire(&(slot->val));
+            if(slot->gen == ((guidVal & GUID_COUNTER_MASK) >> GUID_INDEX_SIZE)) {
+                *val = slotVal;
+            } else {
+                DPRINTF(DEBUG_LVL_VERB, "HybridGUID: stale GUID "GUIDF" (slot generation %"PRIu32")\n",
+                        GUIDA(guid), slot->gen);
+            }
+        }
+        DPRINTF(DEBUG_LVL_VERB, "HybridGUID: got val for slot GUID "GUIDF": 0x%"PRIx64"\n", GUIDA(guid), *val);
+        return (*val == 0) ? OCR_EPERM : 0;
+    }
+    *val = (u64) GP_HASHTABLE_GET((ocrGuidProviderHybrid_t *) self, (void *) GUID_VALUE(guid));
+    DPRINTF(DEBUG_LVL_VERB, "HybridGUID: got val for GUID "GUIDF": 0x%"PRIx64"\n", GUIDA(guid), *val);
+    if(*val == (u64)NULL) {
+        // Does not exist in the hashtable
+        return OCR_EPERM;
+    }
+    // Bug #627: We do not return until the GUID is valid. We test this
+    // by looking at the first field of ptr and waiting for it to be the GUID value (meaning the
+    // object has been initialized
+    if(IS_RESERVED_GUID(guid)) {
+        while((*(volatile u64*)(*val)) != GUID_VALUE(guid));
+        hal_fence();
+    }
+    return 0;
+}
+
+/**
+ * @brief Get the 'kind' of the guid pointed object.
+ */
+u8 hybridGuidGetKind(ocrGuidProvider_t* self, ocrGuid_t guid, ocrGuidKind* kind) {
+    *kind = getKindFromGuid(guid);
+    return 0;
+}
+
+/**
+ * @brief Resolve location of a GUID
+ */
+u8 hybridGuidGetLocation(ocrGuidProvider_t* self, ocrGuid_t guid, ocrLocation_t* location) {
+    //Resolve the actual location of the GUID
+    *location = (ocrLocation_t) locIdtoLocation(extractLocIdFromGuid(guid));
+    return 0;
+}
+
+/**
+ * @brief Associate an already existing GUID to a value.
+ * This is useful in the context of distributed-OCR to register
+ * a local metadata represent for a foreign GUID.
+ */
+u8 hybridGuidRegisterGuid(ocrGuidProvider_t* self, ocrGuid_t guid, u64 val) {
+    DPRINTF(DEBUG_LVL_VERB, "HybridGUID: register GUID "GUIDF" -> 0x%"PRIx64"\n", GUIDA(guid), val);
+    if(isSlotGuid(self, guid)) {
+        getLiveSlot((ocrGuidProviderHybrid_t *) self, guid)->val = val;
+    } else {
+        GP_HASHTABLE_PUT((ocrGuidProviderHybrid_t *) self, (void *) GUID_VALUE(guid), (void *) val);
+    }
+    return 0;
+}
+
+/**
+ * @brief Remove an already existing GUID and its associated value from the provider
+ */
+u8 hybridGuidUnregisterGuid(ocrGuidProvider_t* self, ocrGuid_t guid, u64 ** val) {
+    ocrGuidProviderHybrid_t *derived = (ocrGuidProviderHybrid_t *) self;
+    if(isSlotGuid(self, guid)) {
+        hybridGuidSlot_t *slot = getLiveSlot(derived, guid);
+        if(val != NULL) {
+            *val = (u64 *) slot->val;
+        }
+        slotRelease(derived, slot, GUID_VALUE(guid) & GUID_INDEX_MASK);
+    } else {
+        GP_HASHTABLE_DEL(derived, (void *) GUID_VALUE(guid), (void **) val);
+    }
+    return 0;
+}
+
+u8 hybridGuidReleaseGuid(ocrGuidProvider_t *self, ocrFatGuid_t fatGuid, bool releaseVal) {
+    // We can only destroy GUIDs that we created
+    ASSERT(extractLocIdFromGuid(fatGuid.guid) == locationToLocId(self->pd->myLocation));
+    DPRINTF(DEBUG_LVL_VERB, "HybridGUID: release GUID "GUIDF"\n", GUIDA(fatGuid.guid));
+    ocrGuid_t guid = fatGuid.guid;
+    ocrGuidProviderHybrid_t * derived = (ocrGuidProviderHybrid_t *) self;
+    // As for the labeled provider, the GUID is *first* dissociated from
+    // its value and the metadata freed afterwards
+    if(IS_RESERVED_GUID(guid)) {
+        RESULT_ASSERT(GP_HASHTABLE_DEL(derived, (void *) GUID_VALUE(guid), NULL), ==, true);
+    } else {
+        slotRelease(derived, getLiveSlot(derived, guid), GUID_VALUE(guid) & GUID_INDEX_MASK);
+    }
+    // If there's metaData associated with guid we need to deallocate memory
+    if(releaseVal && (fatGuid.metaDataPtr != NULL)) {
+        PD_MSG_STACK(msg);
+        ocrPolicyDomain_t *policy = NULL;
+        getCurrentEnv(&policy, NULL, NULL, &msg);
+#define PD_MSG (&msg)
+#define PD_TYPE PD_MSG_MEM_UNALLOC
+        msg.type = PD_MSG_MEM_UNALLOC | PD_MSG_REQUEST | PD_MSG_REQ_RESPONSE;
+        PD_MSG_FIELD_I(allocatingPD.guid) = NULL_GUID;
+        PD_MSG_FIELD_I(allocatingPD.metaDataPtr) = NULL;
+        PD_MSG_FIELD_I(allocator.guid) = NULL_GUID;
+        PD_MSG_FIELD_I(allocator.metaDataPtr) = NULL;
+        PD_MSG_FIELD_I(ptr) = fatGuid.metaDataPtr;
+        PD_MSG_FIELD_I(type) = GUID_MEMTYPE;
+        PD_MSG_FIELD_I(properties) = 0;
+        RESULT_PROPAGATE(policy->fcts.processMessage (policy, &msg, true));
+#undef PD_MSG
+#undef PD_TYPE
+    }
+    return 0;
+}
+
+static ocrGuidProvider_t* newGuidProviderHybrid(ocrGuidProviderFactory_t *factory,
+                                                ocrParamList_t *perInstance) {
+    ocrGuidProvider_t *base = (ocrGuidProvider_t*) runtimeChunkAlloc(sizeof(ocrGuidProviderHybrid_t), PERSISTENT_CHUNK);
+    base->fcts = factory->providerFcts;
+    base->pd = NULL;
+    base->id = factory->factoryId;
+    ocrGuidProviderHybrid_t * derived = (ocrGuidProviderHybrid_t *) base;
+    hashtableFctsInit(&derived->mapFcts, ((paramListGuidProviderHybrid_t *) perInstance)->mapType);
+    derived->guidImplTable = NULL;
+    derived->slotChunks = NULL;
+    derived->nextIndex = 1;
+    derived->reservedCounter = 0;
+    derived->workerFree = NULL;
+    derived->workerCount = 0;
+    derived->chunkLock = 0;
+    derived->sharedLock = 0;
+    derived->sharedFree.head = 0;
+    derived->sharedFree.count = 0;
+    return base;
+}
+
+/****************************************************/
+/* OCR GUID PROVIDER HYBRID FACTORY                 */
+/****************************************************/
+
+static void destructGuidProviderFactoryHybrid(ocrGuidProviderFactory_t *factory) {
+    runtimeChunkFree((u64)factory, NONPERSISTENT_CHUNK);
+}
+
+ocrGuidProviderFactory_t *newGuidProviderFactoryHybrid(ocrParamList_t *typeArg, u32 factoryId) {
+    ocrGuidProviderFactory_t *base = (ocrGuidProviderFactory_t*)
+                                     runtimeChunkAlloc(sizeof(ocrGuidProviderFactoryHybrid_t), NONPERSISTENT_CHUNK);
+
+    base->instantiate = &newGuidProviderHybrid;
+    base->destruct = &destructGuidProviderFactoryHybrid;
+    base->factoryId = factoryId;
+    base->providerFcts.destruct = FUNC_ADDR(void (*)(ocrGuidProvider_t*), hybridGuidDestruct);
+    base->providerFcts.switchRunlevel = FUNC_ADDR(u8 (*)(ocrGuidProvider_t*, ocrPolicyDomain_t*, ocrRunlevel_t,
+                                                         phase_t, u32, void (*)(ocrPolicyDomain_t*, u64), u64),
+        hybridGuidSwitchRunlevel);
+    base->providerFcts.guidReserve = FUNC_ADDR(u8 (*)(ocrGuidProvider_t*, ocrGuid_t*, u64*, u64, ocrGuidKind), hybridGuidReserve);
+    base->providerFcts.guidUnreserve = FUNC_ADDR(u8 (*)(ocrGuidProvider_t*, ocrGuid_t, u64, u64), hybridGuidUnreserve);
+    base->providerFcts.getGuid = FUNC_ADDR(u8 (*)(ocrGuidProvider_t*, ocrGuid_t*, u64, ocrGuidKind), hybridGuidGetGuid);
+    base->providerFcts.createGuid = FUNC_ADDR(u8 (*)(ocrGuidProvider_t*, ocrFatGuid_t*, u64, ocrGuidKind, u32), hybridGuidCreateGuid);
+    base->providerFcts.getVal = FUNC_ADDR(u8 (*)(ocrGuidProvider_t*, ocrGuid_t, u64*, ocrGuidKind*), hybridGuidGetVal);
+    base->providerFcts.getKind = FUNC_ADDR(u8 (*)(ocrGuidProvider_t*, ocrGuid_t, ocrGuidKind*), hybridGuidGetKind);
+    base->providerFcts.getLocation = FUNC_ADDR(u8 (*)(ocrGuidProvider_t*, ocrGuid_t, ocrLocation_t*), hybridGuidGetLocation);
+    base->providerFcts.registerGuid = FUNC_ADDR(u8 (*)(ocrGuidProvider_t*, ocrGuid_t, u64), hybridGuidRegisterGuid);
+    base->providerFcts.unregisterGuid = FUNC_ADDR(u8 (*)(ocrGuidProvider_t*, ocrGuid_t, u64**), hybridGuidUnregisterGuid);
+    base->providerFcts.releaseGuid = FUNC_ADDR(u8 (*)(ocrGuidProvider_t*, ocrFatGuid_t, bool), hybridGuidReleaseGuid);
+
+    return base;
+}
+
+#endif /* ENABLE_GUID_HYBRID */
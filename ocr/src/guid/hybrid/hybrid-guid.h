@@ -0,0 +1,86 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+
+#ifndef __OCR_GUIDPROVIDER_HYBRID_H__
+#define __OCR_GUIDPROVIDER_HYBRID_H__
+
+#include "ocr-config.h"
+#ifdef ENABLE_GUID_HYBRID
+
+#include "ocr-types.h"
+#include "ocr-guid.h"
+#include "utils/hashtable.h"
+
+/**
+ * @brief GUID provider resolving the GUIDs it generates without a map lookup.
+ *
+ * GUIDs are laid out like the labeled provider's: (1/0 LOCID KIND COUNTER).
+ * For GUIDs generated by this PD, the counter holds the index of a slot
+ * of a table owned by the provider and the generation of that slot. The
+ * slot stores the value (metadata pointer) associated with the GUID so
+ * that resolving a local GUID only decodes the index and reads the slot.
+ * The generation is bumped when the GUID is released and GUIDs carrying
+ * an older generation are rejected, which catches uses after destroy
+ * (until the generation wraps around).
+ *
+ * Reserved (labeled) GUIDs and GUIDs generated by other PDs are not backed
+ * by a slot and go through a hashtable, like for the labeled provider.
+ *
+ * Slots are recycled through per-worker free lists. Workers hand batches of
+ * slots to a shared, locked, free list when theirs grows too long and take
+ * them back from it before using slots never used before.
+ */
+
+/**
+ * @brief Slot backing one locally generated GUID
+ */
+typedef struct {
+    volatile u64 val;       /**< Value of the GUID, or index of the next free slot */
+    volatile u32 gen;       /**< Generation of the GUID using, or about to use, the slot */
+    u32 kind;               /**< Kind of the GUID, OCR_GUID_MAX when the slot is free */
+} hybridGuidSlot_t;
+
+/**
+ * @brief List of free slots, linked through their 'val' field
+ */
+typedef struct {
+    u64 head;               /**< First free slot, 0 if the list is empty */
+    u64 count;
+    u64 padding[6];         /**< Keep the lists of different workers on different cache lines */
+} hybridGuidFreeList_t;
+
+typedef struct {
+    paramListGuidProviderInst_t base;
+    hashtableType_t mapType;
+} paramListGuidProviderHybrid_t;
+
+typedef struct {
+    ocrGuidProvider_t base;
+    hashtable_t * guidImplTable;
+    hashtableFcts_t mapFcts;
+    hybridGuidSlot_t ** slotChunks;     /**< Slots, allocated by chunks as they get used */
+    volatile u64 nextIndex;             /**< First slot that has never been used */
+    u64 reservedCounter;                /**< Counter for the reserved (labeled) GUIDs */
+    hybridGuidFreeList_t * workerFree;  /**< Free slots of each worker */
+    u64 workerCount;
+    u32 chunkLock;
+    u32 sharedLock;
+    hybridGuidFreeList_t sharedFree;    /**< Free slots of no worker in particular */
+} ocrGuidProviderHybrid_t;
+
+typedef struct {
+    ocrGuidProviderFactory_t base;
+} ocrGuidProviderFactoryHybrid_t;
+
+ocrGuidProviderFactory_t *newGuidProviderFactoryHybrid(ocrParamList_t *typeArg, u32 factoryId);
+
+#define __GUID_END_MARKER__
+#include "ocr-guid-end.h"
+#undef __GUID_END_MARKER__
+
+#endif /* ENABLE_GUID_HYBRID */
+#endif /* __OCR_GUIDPROVIDER_HYBRID_H__ */
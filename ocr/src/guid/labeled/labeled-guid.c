@@ -70,12 +70,13 @@
 #ifdef GUID_PROVIDER_CUSTOM_MAP
 // Set -DGUID_PROVIDER_CUSTOM_MAP and put other #ifdef for alternate implementation here
 #else
-#define GP_RESOLVE_HASHTABLE(hashtable, key) hashtable
-#define GP_HASHTABLE_CREATE_MODULO newHashtableBucketLocked
-#define GP_HASHTABLE_DESTRUCT(hashtable, key, entryDealloc, deallocParam) destructHashtableBucketLocked(hashtable, entryDealloc, deallocParam)
-#define GP_HASHTABLE_GET(hashtable, key) hashtableConcBucketLockedGet(GP_RESOLVE_HASHTABLE(hashtable,key), key)
-#define GP_HASHTABLE_PUT(hashtable, key, value) hashtableConcBucketLockedPut(GP_RESOLVE_HASHTABLE(hashtable,key), key, value)
-#define GP_HASHTABLE_DEL(hashtable, key, valueBack) hashtableConcBucketLockedRemove(GP_RESOLVE_HASHTABLE(hashtable,key), key, valueBack)
+#define GP_RESOLVE_HASHTABLE(provider, key) (provider)->guidImplTable
+#define GP_HASHTABLE_CREATE_MODULO(provider, pd, nbBuckets, hashing) (provider)->mapFcts.create(pd, nbBuckets, hashing)
+#define GP_HASHTABLE_DESTRUCT(provider, key, entryDealloc, deallocParam) (provider)->mapFcts.destruct(GP_RESOLVE_HASHTABLE(provider,key), entryDealloc, deallocParam)
+#define GP_HASHTABLE_GET(provider, key) (provider)->mapFcts.get(GP_RESOLVE_HASHTABLE(provider,key), key)
+#define GP_HASHTABLE_PUT(provider, key, value) (provider)->mapFcts.put(GP_RESOLVE_HASHTABLE(provider,key), key, value)
+#define GP_HASHTABLE_TRYPUT(provider, key, value) (provider)->mapFcts.tryPut(GP_RESOLVE_HASHTABLE(provider,key), key, value)
+#define GP_HASHTABLE_DEL(provider, key, valueBack) (provider)->mapFcts.remove(GP_RESOLVE_HASHTABLE(provider,key), key, valueBack)
 #endif
 
 #ifdef GUID_PROVIDER_WID_INGUID
@@ -178,7 +179,7 @@ u8 labeledGuidSwitchRunlevel(ocrGuidProvider_t *self, ocrPolicyDomain_t *PD, ocr
             deallocFct entryDeallocator = NULL;
             void * deallocParam = NULL;
 #endif
-            GP_HASHTABLE_DESTRUCT(((ocrGuidProviderLabeled_t *) self)->guidImplTable, NULL, entryDeallocator, deallocParam);
+            GP_HASHTABLE_DESTRUCT((ocrGuidProviderLabeled_t *) self, NULL, entryDeallocator, deallocParam);
 #ifdef GUID_PROVIDER_DESTRUCT_CHECK
             PRINTF("=========================\n");
             PRINTF("Remnant GUIDs summary:\n");
@@ -196,7 +197,7 @@ u8 labeledGuidSwitchRunlevel(ocrGuidProvider_t *self, ocrPolicyDomain_t *PD, ocr
         if((properties & RL_BRING_UP) && RL_IS_LAST_PHASE_UP(PD, RL_GUID_OK, phase)) {
             //Initialize the map now that we have an assigned policy domain
             ocrGuidProviderLabeled_t * derived = (ocrGuidProviderLabeled_t *) self;
-            derived->guidImplTable = GP_HASHTABLE_CREATE_MODULO(PD, GUID_PROVIDER_NB_BUCKETS, hashGuidCounterModulo);
+            derived->guidImplTable = GP_HASHTABLE_CREATE_MODULO(derived, PD, GUID_PROVIDER_NB_BUCKETS, hashGuidCounterModulo);
 #ifdef GUID_PROVIDER_WID_INGUID
             ASSERT(((PD->workerCount-1) < ((u64)1 << GUID_WID_SIZE)) && "GUID worker count overflows");
 #endif
@@ -332,7 +333,7 @@ u8 labeledGuidGetGuid(ocrGuidProvider_t* self, ocrGuid_t* guid, u64 val, ocrGuid
     DPRINTF(DEBUG_LVL_VERB, "LabeledGUID: insert into hash table 0x%"PRIx64" -> 0x%"PRIx64"\n", newGuid, val);
     // See BUG #928 on GUID issues
 
-    GP_HASHTABLE_PUT(((ocrGuidProviderLabeled_t *) self)->guidImplTable, (void *) newGuid, (void *) val);
+    GP_HASHTABLE_PUT((ocrGuidProviderLabeled_t *) self, (void *) newGuid, (void *) val);
 #if GUID_BIT_COUNT == 64
     (*(guid)).guid =  newGuid;
 #elif GUID_BIT_COUNT == 128
@@ -395,12 +396,12 @@ u8 labeledGuidCreateGuid(ocrGuidProvider_t* self, ocrFatGuid_t *fguid, u64 size,
             DPRINTF(DEBUG_LVL_VERB, "LabeledGUID: try insert into hash table "GUIDF" -> %p\n", GUIDA(fguid->guid), ptr);
             // See BUG #928 on GUID issues
 #if GUID_BIT_COUNT == 64
-            void *value = hashtableConcBucketLockedTryPut(
-                ((ocrGuidProviderLabeled_t*)self)->guidImplTable,
+            void *value = GP_HASHTABLE_TRYPUT(
+                (ocrGuidProviderLabeled_t*)self,
                 (void*)(fguid->guid.guid), ptr);
 #elif GUID_BIT_COUNT == 128
-            void *value = hashtableConcBucketLockedTryPut(
-                ((ocrGuidProviderLabeled_t*)self)->guidImplTable,
+            void *value = GP_HASHTABLE_TRYPUT(
+                (ocrGuidProviderLabeled_t*)self,
                 (void*)(fguid->guid.lower), ptr);
 #endif
             if(value != ptr) {
@@ -445,12 +446,12 @@ u8 labeledGuidCreateGuid(ocrGuidProvider_t* self, ocrFatGuid_t *fguid, u64 size,
 
 // See BUG #928 on GUID issues
 #if GUID_BIT_COUNT == 64
-                value = hashtableConcBucketLockedTryPut(
-                    ((ocrGuidProviderLabeled_t*)self)->guidImplTable,
+                value = GP_HASHTABLE_TRYPUT(
+                    (ocrGuidProviderLabeled_t*)self,
                     (void*)(fguid->guid.guid), ptr);
 #elif GUID_BIT_COUNT == 128
-                value = hashtableConcBucketLockedTryPut(
-                    ((ocrGuidProviderLabeled_t*)self)->guidImplTable,
+                value = GP_HASHTABLE_TRYPUT(
+                    (ocrGuidProviderLabeled_t*)self,
                     (void*)(fguid->guid.lower), ptr);
 #endif
 
@@ -461,10 +462,10 @@ u8 labeledGuidCreateGuid(ocrGuidProvider_t* self, ocrFatGuid_t *fguid, u64 size,
 
             // See BUG #928 on GUID issues
 #if GUID_BIT_COUNT == 64
-            GP_HASHTABLE_PUT(((ocrGuidProviderLabeled_t*)self)->guidImplTable,
+            GP_HASHTABLE_PUT((ocrGuidProviderLabeled_t*)self,
                              (void*)(fguid->guid.guid), ptr);
 #elif GUID_BIT_COUNT == 128
-            GP_HASHTABLE_PUT(((ocrGuidProviderLabeled_t*)self)->guidImplTable,
+            GP_HASHTABLE_PUT((ocrGuidProviderLabeled_t*)self,
                              (void*)(fguid->guid.lower), ptr);
 #else
 #error Unknown GUID type
@@ -484,9 +485,9 @@ u8 labeledGuidCreateGuid(ocrGuidProvider_t* self, ocrFatGuid_t *fguid, u64 size,
 u8 labeledGuidGetVal(ocrGuidProvider_t* self, ocrGuid_t guid, u64* val, ocrGuidKind* kind) {
     // See BUG #928 on GUID issues
 #if GUID_BIT_COUNT == 64
-    *val = (u64) GP_HASHTABLE_GET(((ocrGuidProviderLabeled_t *) self)->guidImplTable, (void *) guid.guid);
+    *val = (u64) GP_HASHTABLE_GET((ocrGuidProviderLabeled_t *) self, (void *) guid.guid);
 #elif GUID_BIT_COUNT == 128
-    *val = (u64) GP_HASHTABLE_GET(((ocrGuidProviderLabeled_t *) self)->guidImplTable, (void *) guid.lower);
+    *val = (u64) GP_HASHTABLE_GET((ocrGuidProviderLabeled_t *) self, (void *) guid.lower);
 #else
 #error Unknown GUID type
 #endif
@@ -545,9 +546,9 @@ u8 labeledGuidRegisterGuid(ocrGuidProvider_t* self, ocrGuid_t guid, u64 val) {
     DPRINTF(DEBUG_LVL_VERB, "LabeledGUID: register GUID "GUIDF" -> 0x%"PRIx64"\n", GUIDA(guid), val);
     // See BUG #928 on GUID issues
 #if GUID_BIT_COUNT == 64
-    GP_HASHTABLE_PUT(((ocrGuidProviderLabeled_t *) self)->guidImplTable, (void *) guid.guid, (void *) val);
+    GP_HASHTABLE_PUT((ocrGuidProviderLabeled_t *) self, (void *) guid.guid, (void *) val);
 #elif GUID_BIT_COUNT == 128
-    GP_HASHTABLE_PUT(((ocrGuidProviderLabeled_t *) self)->guidImplTable, (void *) guid.lower, (void *) val);
+    GP_HASHTABLE_PUT((ocrGuidProviderLabeled_t *) self, (void *) guid.lower, (void *) val);
 #else
 #error Unknown GUID type
 #endif
@@ -560,9 +561,9 @@ u8 labeledGuidRegisterGuid(ocrGuidProvider_t* self, ocrGuid_t guid, u64 val) {
 u8 labeledGuidUnregisterGuid(ocrGuidProvider_t* self, ocrGuid_t guid, u64 ** val) {
     // See BUG #928 on GUID issues
 #if GUID_BIT_COUNT == 64
-    GP_HASHTABLE_DEL(((ocrGuidProviderLabeled_t *) self)->guidImplTable, (void *) guid.guid, (void **) val);
+    GP_HASHTABLE_DEL((ocrGuidProviderLabeled_t *) self, (void *) guid.guid, (void **) val);
 #elif GUID_BIT_COUNT == 128
-    GP_HASHTABLE_DEL(((ocrGuidProviderLabeled_t *) self)->guidImplTable, (void *) guid.lower, (void **) val);
+    GP_HASHTABLE_DEL((ocrGuidProviderLabeled_t *) self, (void *) guid.lower, (void **) val);
 #else
 #error Unknown GUID type
 #endif
@@ -585,9 +586,9 @@ u8 labeledGuidReleaseGuid(ocrGuidProvider_t *self, ocrFatGuid_t fatGuid, bool re
     ocrGuidProviderLabeled_t * derived = (ocrGuidProviderLabeled_t *) self;
     // See BUG #928 on GUID issues
 #if GUID_BIT_COUNT == 64
-    RESULT_ASSERT(GP_HASHTABLE_DEL(derived->guidImplTable, (void *)guid.guid, NULL), ==, true);
+    RESULT_ASSERT(GP_HASHTABLE_DEL(derived, (void *)guid.guid, NULL), ==, true);
 #elif GUID_BIT_COUNT == 128
-    RESULT_ASSERT(GP_HASHTABLE_DEL(derived->guidImplTable, (void *)guid.lower, NULL), ==, true);
+    RESULT_ASSERT(GP_HASHTABLE_DEL(derived, (void *)guid.lower, NULL), ==, true);
 #else
 #error Unknown GUID type
 #endif
@@ -619,6 +620,8 @@ static ocrGuidProvider_t* newGuidProviderLabeled(ocrGuidProviderFactory_t *facto
     base->fcts = factory->providerFcts;
     base->pd = NULL;
     base->id = factory->factoryId;
+    ocrGuidProviderLabeled_t * derived = (ocrGuidProviderLabeled_t *) base;
+    hashtableFctsInit(&derived->mapFcts, ((paramListGuidProviderLabeled_t *) perInstance)->mapType);
     return base;
 }
 
@@ -36,6 +36,35 @@
  */
 #define hal_fence() tg_fence_fbm()
 
+/**
+ * @brief Load with acquire semantics
+ *
+ * Conservatively implemented with a full fence
+ *
+ * @param atomic    Pointer to the location to read
+ * @return Value read at location
+ */
+#define hal_loadAcquire(atomic)                                         \
+    ({                                                                  \
+        __typeof__(*(atomic)) __tmp = *(atomic);                        \
+        hal_fence();                                                    \
+        __tmp;                                                          \
+    })
+
+/**
+ * @brief Store with release semantics
+ *
+ * Conservatively implemented with a full fence
+ *
+ * @param atomic    Pointer to the location to write
+ * @param value     Value to write
+ */
+#define hal_storeRelease(atomic, value)                                 \
+    do {                                                                \
+        hal_fence();                                                    \
+        *(atomic) = (value);                                            \
+    } while(0)
+
 /**
  * @brief Memory copy from source to destination
  *
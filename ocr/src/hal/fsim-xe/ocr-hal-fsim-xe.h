@@ -33,6 +33,35 @@
 #define hal_fence()                                     \
     do { __asm__ __volatile__("fence 0xF, B\n\t"); } while(0)
 
+/**
+ * @brief Load with acquire semantics
+ *
+ * Conservatively implemented with a full fence
+ *
+ * @param atomic    Pointer to the location to read
+ * @return Value read at location
+ */
+#define hal_loadAcquire(atomic)                                         \
+    ({                                                                  \
+        __typeof__(*(atomic)) __tmp = *(atomic);                        \
+        hal_fence();                                                    \
+        __tmp;                                                          \
+    })
+
+/**
+ * @brief Store with release semantics
+ *
+ * Conservatively implemented with a full fence
+ *
+ * @param atomic    Pointer to the location to write
+ * @param value     Value to write
+ */
+#define hal_storeRelease(atomic, value)                                 \
+    do {                                                                \
+        hal_fence();                                                    \
+        *(atomic) = (value);                                            \
+    } while(0)
+
 
 /**
  * @brief Memory copy from source to destination
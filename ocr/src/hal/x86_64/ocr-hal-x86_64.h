@@ -38,6 +38,30 @@
 #define hal_fence() \
     do { __sync_synchronize(); } while(0);
 
+/**
+ * @brief Load with acquire semantics
+ *
+ * No memory operation following the load in program order
+ * can be performed before it. Works on naturally aligned
+ * 32 and 64 bit locations (including pointers).
+ *
+ * @param atomic    Pointer to the location to read
+ * @return Value read at location
+ */
+#define hal_loadAcquire(atomic) __atomic_load_n(atomic, __ATOMIC_ACQUIRE)
+
+/**
+ * @brief Store with release semantics
+ *
+ * No memory operation preceding the store in program order
+ * can be performed after it. Works on naturally aligned
+ * 32 and 64 bit locations (including pointers).
+ *
+ * @param atomic    Pointer to the location to write
+ * @param value     Value to write
+ */
+#define hal_storeRelease(atomic, value) __atomic_store_n(atomic, value, __ATOMIC_RELEASE)
+
 /**
  * @brief Memory move from source to destination
  *
@@ -50,7 +74,9 @@
  *                           return only once the copy is fully complete and a
  *                           non-zero value indicates the copy may proceed
  *                           in the background. A fence will then be
- *                           required to ensure completion of the copy
+ *                           required to ensure completion of the copy.
+ *                           Large background copies bypass the caches
+ *                           (see HAL_MEMCOPY_NT_MIN)
  * @todo Define what behavior we want for overlapping
  * source and destination
  */
@@ -58,6 +84,48 @@
     do { memmove((void*)(destination), (const void*)(source), (size)); } while(0)
 
 
+/**
+ * @brief Background copies of at least this many bytes use
+ * non-temporal stores so that they do not evict the working set
+ * of the workers from the caches
+ */
+#ifndef HAL_MEMCOPY_NT_MIN
+#define HAL_MEMCOPY_NT_MIN (256 * 1024)
+#endif
+
+typedef long long halVec128_t __attribute__((vector_size(16)));
+
+/**
+ * @brief Copies 'size' bytes with streaming (movntdq) stores
+ *
+ * The bulk of the destination is written 16-byte aligned; the unaligned
+ * head and tail go through memcpy. The sfence makes the streamed stores
+ * globally visible before returning.
+ */
+static inline void hal_memCopyNonTemporal(void *destination, const void *source, u64 size) {
+    char *dst = (char*)destination;
+    const char *src = (const char*)source;
+    u64 head = (16 - ((u64)dst & 15)) & 15;
+    if (head > size)
+        head = size;
+    __builtin_memcpy(dst, src, head);
+    dst += head; src += head; size -= head;
+    while (size >= 64) {
+        halVec128_t v0, v1, v2, v3;
+        __builtin_memcpy(&v0, src, 16);
+        __builtin_memcpy(&v1, src + 16, 16);
+        __builtin_memcpy(&v2, src + 32, 16);
+        __builtin_memcpy(&v3, src + 48, 16);
+        __asm__ __volatile__("movntdq %1, %0" : "=m"(*(halVec128_t*)dst) : "x"(v0));
+        __asm__ __volatile__("movntdq %1, %0" : "=m"(*(halVec128_t*)(dst + 16)) : "x"(v1));
+        __asm__ __volatile__("movntdq %1, %0" : "=m"(*(halVec128_t*)(dst + 32)) : "x"(v2));
+        __asm__ __volatile__("movntdq %1, %0" : "=m"(*(halVec128_t*)(dst + 48)) : "x"(v3));
+        dst += 64; src += 64; size -= 64;
+    }
+    __builtin_memcpy(dst, src, size);
+    __asm__ __volatile__("sfence" ::: "memory");
+}
+
 /**
  * @brief Memory copy from source to destination
  *
@@ -70,12 +138,19 @@
  *                           return only once the copy is fully complete and a
  *                           non-zero value indicates the copy may proceed
  *                           in the background. A fence will then be
- *                           required to ensure completion of the copy
+ *                           required to ensure completion of the copy.
+ *                           Large background copies bypass the caches
+ *                           (see HAL_MEMCOPY_NT_MIN)
  * @todo Define what behavior we want for overlapping
  * source and destination
  */
 #define hal_memCopy(destination, source, size, isBackground) \
-    do { __builtin_memcpy((void*)(destination), (const void*)(source), (size)); } while(0)
+    do {                                                                 \
+        if ((isBackground) && ((size) >= HAL_MEMCOPY_NT_MIN))            \
+            hal_memCopyNonTemporal((void*)(destination), (const void*)(source), (size)); \
+        else                                                             \
+            __builtin_memcpy((void*)(destination), (const void*)(source), (size)); \
+    } while(0)
 
 
 /**
@@ -98,6 +173,22 @@
         __tmp;                                                               \
     })
 
+/**
+ * @brief Atomic swap (64 bit)
+ *
+ * Atomically swap:
+ *
+ * @param atomic        u64*: Pointer to the atomic value (location)
+ * @param newValue      u64: New value to set
+ *
+ * @return Old value of the atomic
+ */
+#define hal_swap64(atomic, newValue)                                    \
+    ({                                                                  \
+        u64 __tmp = __atomic_exchange_n(atomic, newValue, __ATOMIC_SEQ_CST); \
+        __tmp;                                                          \
+    })
+
 /**
  * @brief Atomic add (64 bit)
  *
@@ -242,9 +242,24 @@ typedef struct _ocrCommPlatformFcts_t {
 typedef struct _ocrCommPlatform_t {
     struct _ocrPolicyDomain_t *pd;  /**< Policy domain this comm-platform is used by */
     ocrLocation_t location;
+    u32 laneId;    /**< Index of this instance when the PD drives several of them */
+    u32 laneCount; /**< Number of instances the PD drives (see commPlatformLaneOf) */
     ocrCommPlatformFcts_t fcts; /**< Functions for this instance */
 } ocrCommPlatform_t;
 
+/**
+ * @brief Returns the lane carrying the traffic between two locations
+ *
+ * A PD with several communication workers gives each its own comm-platform
+ * instance (a lane). All traffic between two PDs goes through a single lane
+ * chosen from the pair so that both ends agree on it without exchanging
+ * anything, and responses travel on the lane of their request. All PDs
+ * must be configured with the same number of lanes.
+ */
+static inline u32 commPlatformLaneOf(ocrLocation_t a, ocrLocation_t b, u32 laneCount) {
+    return (u32) (((u64) a + (u64) b) % laneCount);
+}
+
 
 /****************************************************/
 /* OCR COMPUTE PLATFORM FACTORY                     */
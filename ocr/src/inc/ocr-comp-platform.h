@@ -104,6 +104,16 @@ typedef struct _ocrCompPlatformFcts_t {
      */
     u8 (*setThrottle)(struct _ocrCompPlatform_t* self, u64 value);
 
+    /**
+     * @brief Gets the CPU this compute node is bound to
+     *
+     * @param[in] self        Pointer to this comp-platform
+     * @param[out] cpu        Identifier of the CPU (as known by the OS)
+     * @return 0 on success or the following error code:
+     *     - 1 if the comp-platform is not bound or binding is not supported
+     */
+    u8 (*getBinding)(struct _ocrCompPlatform_t* self, u32 *cpu);
+
     /**
      * @brief Function called from the worker when it starts "running" on the comp-platform
      *
@@ -215,6 +215,9 @@ typedef struct _ocrDataBlock_t {
 
 #define DB_FLAG_RT_FETCH            0x1000000
 #define DB_FLAG_RT_WRITE_BACK       0x2000000
+#define DB_FLAG_RT_SHARED_PTR       0x4000000 // Acquire response ptr is the DB itself, mapped by both PDs
+#define DB_FLAG_RT_RDV_PTR          0x8000000 // Acquire/release ptr was received out of the message, in a buffer the receiver owns
+#define DB_FLAG_RT_CACHE            0x10000000 // Acquire: the copy may be kept after release until recalled. Release: gives such a copy back
 
 /****************************************************/
 /* OCR DATABLOCK FACTORY                            */
@@ -138,6 +138,21 @@ typedef struct _ocrEventFcts_t {
      */
     u8 (*unregisterWaiter)(struct _ocrEvent_t *self, ocrFatGuid_t waiter, u32 slot,
                            bool isDepRem);
+
+    /**
+     * @brief Blocks the calling thread until the event is satisfied
+     *
+     * The thread does not consume CPU while blocked. This is meant for
+     * threads waiting on the runtime from the outside (legacy code) and
+     * is only available for events that stay valid once satisfied; it is
+     * NULL for the other types of events.
+     *
+     * @param[in] self          Pointer to this event
+     * @param[in] timeoutNs     Maximum time to block for (0 for no limit)
+     * @return 0 if the event is satisfied, OCR_EBUSY if it is not yet
+     * (timeout or spurious wake-up)
+     */
+    u8 (*wait)(struct _ocrEvent_t *self, u64 timeoutNs);
 } ocrEventFcts_t;
 
 typedef struct _ocrEventCommonFcts_t {
@@ -19,6 +19,9 @@
 // 64KB to zero before initialization
 #define MEM_PLATFORM_ZEROED_AREA_SIZE    (64*1024)
 
+// Memory not bound to a NUMA node
+#define MEM_PLATFORM_NUMA_NODE_NONE      ((u32)-1)
+
 struct _ocrPolicyDomain_t;
 
 /****************************************************/
@@ -38,7 +41,7 @@ typedef struct _paramListMemPlatformFact_t {
 typedef struct _paramListMemPlatformInst_t {
     ocrParamList_t base;
     u64 size;
-    u32 numa_node;
+    u32 numa_node;      /**< 'numa_node' in the config, MEM_PLATFORM_NUMA_NODE_NONE if not set */
 } paramListMemPlatformInst_t;
 
 
@@ -188,6 +191,7 @@ typedef struct _ocrMemPlatformFcts_t {
 typedef struct _ocrMemPlatform_t {
     struct _ocrPolicyDomain_t *pd; /**< Policy domain that uses this mem-platform */
     u64 size, startAddr, endAddr;  /**< Size, start and end address for this instance */
+    u32 numaNode;                  /**< NUMA node the memory is bound to (MEM_PLATFORM_NUMA_NODE_NONE if not bound) */
     ocrMemPlatformFcts_t fcts; /**< Functions for this instance */
 } ocrMemPlatform_t;
 
@@ -106,6 +106,8 @@ typedef struct _paramListPolicyDomainInst_t {
 #define PD_MSG_DB_RELEASE       0x00054001
 /**< Frees a DB (the last free may trigger a destroy) */
 #define PD_MSG_DB_FREE          0x00085001
+/**< Recalls a copy of a DB cached by another PD */
+#define PD_MSG_DB_INVALIDATE    0x00046001
 
 /**< AND with this and if the result non-null, memory chunks
  * related operation (goes directly to allocators) */
@@ -363,6 +365,20 @@ struct _ocrPolicyDomain_t;
     name.usefulSize = 0; name.bufferSize = sizeof(ocrPolicyMsg_t); \
     name.srcLocation = name.destLocation = INVALID_LOCATION;
 
+/**
+ * @brief Sets up a message for the current policy domain 'pd'
+ *
+ * Has the same effect on 'msgPtr' as getCurrentEnv(NULL, NULL, NULL, msgPtr)
+ * when 'pd' is the current policy domain. Use it when building several
+ * messages in a function that already looked up 'pd' to avoid going
+ * through the thread-local storage again for each message.
+ */
+#define PD_MSG_INIT_FROM_PD(pd, msgPtr) do {                            \
+        (msgPtr)->srcLocation = (pd)->myLocation;                       \
+        (msgPtr)->destLocation = (msgPtr)->srcLocation;                 \
+        (msgPtr)->usefulSize = 0;                                       \
+    } while(0)
+
 /**
  * @brief Structure describing a "message" that is used to communicate between
  * policy domains in an asynchronous manner
@@ -495,6 +511,18 @@ typedef struct _ocrPolicyMsg_t {
             } inOrOut __attribute__ (( aligned(8) ));
         } PD_MSG_STRUCT_NAME(PD_MSG_DB_FREE);
 
+        struct {
+            union {
+                struct {
+                    ocrFatGuid_t guid;         /**< In: GUID of the DB whose cached copy is recalled */
+                    u32 properties;            /**< In: Properties of the recall (unused) */
+                } in;
+                struct {
+                    u32 returnDetail;          /**< Out: Success or error code */
+                } out;
+            } inOrOut __attribute__ (( aligned(8) ));
+        } PD_MSG_STRUCT_NAME(PD_MSG_DB_INVALIDATE);
+
         struct {
             union {
                 struct {
@@ -12,6 +12,7 @@ PER_TYPE(PD_MSG_DB_DESTROY)
 PER_TYPE(PD_MSG_DB_ACQUIRE)
 PER_TYPE(PD_MSG_DB_RELEASE)
 PER_TYPE(PD_MSG_DB_FREE)
+PER_TYPE(PD_MSG_DB_INVALIDATE)
 
 PER_TYPE(PD_MSG_MEM_ALLOC)
 PER_TYPE(PD_MSG_MEM_UNALLOC)
@@ -124,6 +124,7 @@ typedef enum {
     OCR_SCHEDULER_OBJECT_WST                               =0x520,
     OCR_SCHEDULER_OBJECT_PR_WSH                            =0x620,
     OCR_SCHEDULER_OBJECT_BIN_HEAP                          =0x720,
+    OCR_SCHEDULER_OBJECT_PR_MQ                             =0x820,
 
     //specialized schedulerObjects:
     //    These schedulerObjects can hold other schedulerObjects, both singleton and aggregate.
@@ -348,6 +348,10 @@ typedef struct _ocrTask_t {
     u32 paramc, depc;       /**< Number of parameters and dependences */
     u32 flags;              /**< Bit flags for the task */
     u32 fctId;
+#ifdef ENABLE_EDT_STATS
+    u64 readyTime;          /**< When the last dependence got satisfied */
+    u64 dbBytes;            /**< Size of the DBs acquired for the execution */
+#endif
 } ocrTask_t;
 
 #define OCR_TASK_FLAG_USES_HINTS            0x1 /* Identifies if the task has user hints set */
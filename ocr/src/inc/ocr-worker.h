@@ -119,6 +119,12 @@ typedef struct _ocrWorker_t {
 #ifdef OCR_ENABLE_STATISTICS
     ocrStatsProcess_t *statProcess;
 #endif
+#ifdef ENABLE_EDT_STATS
+    struct _edtStatsTable_t *edtStats; /**< Statistics of the EDTs this worker executed */
+#endif
+#ifdef ENABLE_SLAB_CACHE
+    struct _slabCache_t *slabCache; /**< Cache of the small runtime objects this worker allocates */
+#endif
 
     ocrCompTarget_t **computes; /**< Compute node(s) associated with this worker */
     u64 computeCount;           /**< Number of compute node(s) associated */
@@ -12,12 +12,9 @@
 #include "ocr-policy-domain.h"
 
 #ifndef INIT_BIN_HEAP_CAPACITY
-// Set by configure
-#   ifdef INIT_DEQUE_CAPACITY
-#   define INIT_BIN_HEAP_CAPACITY (INIT_DEQUE_CAPACITY*16)
-#   else
-#   define INIT_BIN_HEAP_CAPACITY 32768
-#   endif
+// Set by configure. Initial (and minimal) capacity of binary heaps,
+// which grow and shrink on demand.
+#define INIT_BIN_HEAP_CAPACITY 256
 #endif
 
 /****************************************************/
@@ -54,7 +51,9 @@ typedef struct _ocrBinHeap_t {
     /* The fields don't need to be volatile because we only
        have non-concurrent and locking implementations. */
     u32 count;
+    u32 capacity;
     ocrBinHeapEntry_t *data;
+    ocrPolicyDomain_t *pd;          /* Allocates data when the heap is resized */
 
     /** @brief Destruct binHeap
      */
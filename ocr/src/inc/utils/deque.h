@@ -16,6 +16,12 @@
 #define INIT_DEQUE_CAPACITY 32768
 #endif
 
+#ifndef INIT_WST_DEQUE_CAPACITY
+// Set by configure. Initial (and minimal) capacity of work-stealing
+// deques, which grow and shrink on demand. Must be a power of two.
+#define INIT_WST_DEQUE_CAPACITY 256
+#endif
+
 /****************************************************/
 /* DEQUE TYPES                                      */
 /****************************************************/
@@ -50,6 +56,7 @@ typedef struct _ocrDeque_t {
     volatile s32 head;
     volatile s32 tail;
     volatile void ** data;
+    u32 capacity;
 
     /** @brief Size of the deque
      */
@@ -97,6 +104,38 @@ typedef struct _ocrDequeDualLocked_t {
     volatile u32 lockT;
 } dequeDualLocked_t;
 
+/****************************************************/
+/* WORK-STEALING DEQUE                              */
+/****************************************************/
+
+/**
+ * @brief Circular array backing a work-stealing deque
+ *
+ * Arrays are replaced (never resized in place) when the deque
+ * grows or shrinks. Thieves may still be reading from a replaced
+ * array so it is only freed once no steal is in flight.
+ */
+typedef struct _ocrDequeWstBuffer_t {
+    u32 capacity;                           /**< Always a power of two */
+    struct _ocrDequeWstBuffer_t * next;     /**< Chains retired arrays */
+    volatile void * slots[];
+} dequeWstBuffer_t;
+
+/**
+ * @brief Growable Chase-Lev work-stealing deque
+ *
+ * Only the owner pushes and pops at the tail; any other worker
+ * may steal from the head. 'base.data' and 'base.capacity' mirror
+ * the current array for the owner and non-concurrent inspection.
+ */
+typedef struct _ocrDequeWst_t {
+    deque_t base;
+    ocrPolicyDomain_t * pd;
+    dequeWstBuffer_t * volatile buffer;
+    dequeWstBuffer_t * retired;     /**< Replaced arrays not yet freed (owner only) */
+    volatile u32 thieves;           /**< Number of steals in flight */
+} dequeWst_t;
+
 /****************************************************/
 /* DEQUE API                                        */
 /****************************************************/
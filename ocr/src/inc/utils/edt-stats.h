@@ -0,0 +1,81 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#ifndef EDT_STATS_H_
+#define EDT_STATS_H_
+
+#include "ocr-config.h"
+#ifdef ENABLE_EDT_STATS
+
+#include "ocr-types.h"
+
+struct _ocrPolicyDomain_t;
+
+/****************************************************/
+/* EDT STATISTICS API                               */
+/****************************************************/
+
+/**
+ * @brief Per worker execution statistics of EDTs, keyed by EDT function
+ *
+ * Templates are commonly destroyed before the EDTs created from them run,
+ * so statistics are attached to the function the EDTs execute instead.
+ * Each worker only updates its own table, with plain stores; tables are
+ * merged when queried and when the PD shuts down.
+ */
+
+// Number of distinct EDT functions each worker keeps statistics for
+// (must be a power of 2)
+#ifndef EDT_STATS_TABLE_SIZE
+#define EDT_STATS_TABLE_SIZE 256
+#endif
+
+typedef struct _edtStatsTable_t {
+    u32 count;          /**< Entries in use */
+    u64 overflow;       /**< Executions not recorded because the table was full */
+    ocrEdtStats_t entries[EDT_STATS_TABLE_SIZE]; /**< Open addressing on funcPtr, NULL if free */
+} edtStatsTable_t;
+
+edtStatsTable_t * edtStatsCreate(struct _ocrPolicyDomain_t *pd);
+
+void edtStatsDestroy(struct _ocrPolicyDomain_t *pd, edtStatsTable_t *table);
+
+/**
+ * @brief Accounts for one execution of 'funcPtr'. Only called by the table's worker.
+ *
+ * @param[in] execTime   Execution time in ns
+ * @param[in] readyTime  Time from the last dependence satisfied to the start in ns
+ * @param[in] dbBytes    Size of the DBs the EDT acquired
+ */
+void edtStatsRecord(edtStatsTable_t *table, ocrEdt_t funcPtr, u64 execTime, u64 readyTime, u64 dbBytes);
+
+/**
+ * @brief Merges the tables of all the workers of 'pd'
+ *
+ * Entries are sorted by decreasing total execution time. The returned
+ * table is the caller's to destroy.
+ */
+edtStatsTable_t * edtStatsMerge(struct _ocrPolicyDomain_t *pd);
+
+/**
+ * @brief Writes the merged statistics of 'pd' out if requested
+ *
+ * The OCR_EDT_STATS environment variable selects the format, "csv" or
+ * "json". The file is edtStats.<PD location>.<format> in the current
+ * directory. Nothing is written if the variable is not set.
+ */
+void edtStatsDump(struct _ocrPolicyDomain_t *pd);
+
+/**
+ * @brief Answers OCR_QUERY_EDT_STATS
+ *
+ * Creates a DB holding the merged ocrEdtStats_t entries of the current PD.
+ * @return the GUID of the DB, its address in 'result' and its size in bytes in 'size'
+ */
+ocrGuid_t edtStatsQuery(void **result, u32 *size);
+
+#endif /* ENABLE_EDT_STATS */
+#endif /* EDT_STATS_H_ */
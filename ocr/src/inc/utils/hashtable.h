@@ -59,6 +59,48 @@ void destructHashtable(hashtable_t * hashtable, deallocFct entryDeallocator, voi
 hashtable_t * newHashtableBucketLocked(ocrPolicyDomain_t * pd, u32 nbBuckets, hashFct hashing);
 void destructHashtableBucketLocked(hashtable_t * hashtable, deallocFct entryDeallocator, void * deallocatorParam);
 
+/**
+ * @brief Open-addressing hashtable with lock-free reads that resizes incrementally.
+ *
+ * 'nbBuckets' is the initial (and minimal) number of slots, rounded up to a
+ * power of two. Writers serialize per key on a striped lock and migrate
+ * a chunk of the previous table on each operation while a resize is in progress.
+ * A migrated table is freed once the operations that started before the end
+ * of its migration are done. Tombstones are cleared in place when a table
+ * fills up with them rather than migrating to a table of the same size.
+ * Keys 0x0, ~0x1 and ~0x0 and values in the [~0x3, ~0x0] range are reserved.
+ */
+void * hashtableConcResizableGet(hashtable_t * hashtable, void * key);
+bool hashtableConcResizablePut(hashtable_t * hashtable, void * key, void * value);
+void * hashtableConcResizableTryPut(hashtable_t * hashtable, void * key, void * value);
+bool hashtableConcResizableRemove(hashtable_t * hashtable, void * key, void ** value);
+
+hashtable_t * newHashtableResizable(ocrPolicyDomain_t * pd, u32 nbBuckets, hashFct hashing);
+void destructHashtableResizable(hashtable_t * hashtable, deallocFct entryDeallocator, void * deallocatorParam);
+
+//
+// Runtime selection of a concurrent hashtable implementation
+//
+
+typedef enum _hashtableType_t {
+    HASHTABLE_BUCKET_LOCKED,
+    HASHTABLE_RESIZABLE,
+} hashtableType_t;
+
+typedef struct _hashtableFcts_t {
+    hashtable_t * (*create)(ocrPolicyDomain_t * pd, u32 nbBuckets, hashFct hashing);
+    void (*destruct)(hashtable_t * hashtable, deallocFct entryDeallocator, void * deallocatorParam);
+    void * (*get)(hashtable_t * hashtable, void * key);
+    bool (*put)(hashtable_t * hashtable, void * key, void * value);
+    void * (*tryPut)(hashtable_t * hashtable, void * key, void * value);
+    bool (*remove)(hashtable_t * hashtable, void * key, void ** value);
+} hashtableFcts_t;
+
+/**
+ * @brief Fill in 'fcts' with the concurrent functions of the 'type' implementation
+ */
+void hashtableFctsInit(hashtableFcts_t * fcts, hashtableType_t type);
+
 
 //
 // Exposed hashtable implementations
@@ -74,5 +116,10 @@ hashtable_t * newHashtableModulo(ocrPolicyDomain_t * pd, u32 nbBuckets);
  */
 hashtable_t * newHashtableBucketLockedModulo(ocrPolicyDomain_t * pd, u32 nbBuckets);
 
+/*
+ * @brief A resizable hashtable implementation relying on a simple modulo for hashing
+ */
+hashtable_t * newHashtableResizableModulo(ocrPolicyDomain_t * pd, u32 nbBuckets);
+
 
 #endif /* HASHTABLE_H_ */
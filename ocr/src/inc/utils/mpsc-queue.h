@@ -0,0 +1,58 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#ifndef MPSC_QUEUE_H_
+#define MPSC_QUEUE_H_
+
+#include "ocr-config.h"
+#include "ocr-types.h"
+
+/****************************************************/
+/* MPSC QUEUE API                                   */
+/****************************************************/
+
+/**
+ * @brief Intrusive multiple-producer/single-consumer FIFO
+ *
+ * Any number of threads may push concurrently; a single thread pops.
+ * Push is wait-free (one atomic swap) and pop never locks. Elements embed
+ * a mpscQueueNode_t and are recovered from it by the caller. The queue
+ * does not allocate: a node belongs to the queue from the push until the
+ * pop that returns it.
+ */
+typedef struct _mpscQueueNode_t {
+    struct _mpscQueueNode_t * volatile next;
+} mpscQueueNode_t;
+
+typedef struct _mpscQueue_t {
+    mpscQueueNode_t * volatile head; // Last pushed node, producers side
+    mpscQueueNode_t * tail;          // Next node to pop, consumer side
+    mpscQueueNode_t stub;
+} mpscQueue_t;
+
+void mpscQueueInit(mpscQueue_t * queue);
+
+/**
+ * @brief Appends 'node' to the queue. Callable from any thread.
+ */
+void mpscQueuePush(mpscQueue_t * queue, mpscQueueNode_t * node);
+
+/**
+ * @brief Removes the oldest node. Must only be called by the consumer.
+ *
+ * @return The node or NULL when the queue is empty. NULL is also returned
+ * when the oldest node's producer has not completed its push yet; the
+ * node is returned by a later call.
+ */
+mpscQueueNode_t * mpscQueuePop(mpscQueue_t * queue);
+
+/**
+ * @brief Returns true if no node has been pushed and not popped yet.
+ * Only exact when called by the consumer with no concurrent push.
+ */
+bool mpscQueueIsEmpty(mpscQueue_t * queue);
+
+#endif /* MPSC_QUEUE_H_ */
@@ -0,0 +1,157 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#ifndef SLAB_CACHE_H_
+#define SLAB_CACHE_H_
+
+#include "ocr-config.h"
+#ifdef ENABLE_SLAB_CACHE
+
+#include "ocr-types.h"
+#include "allocator/allocator-all.h"
+
+struct _ocrPolicyDomain_t;
+
+/****************************************************/
+/* SLAB CACHE API                                   */
+/****************************************************/
+
+/**
+ * @brief Per worker caches of small runtime objects
+ *
+ * Sits in front of the PD's allocator for the objects the runtime keeps
+ * creating and destroying (tasks, events, dependence arrays, messages...).
+ * Requests are rounded up to a size class and carved out of pages taken
+ * from the PD's first allocator. Each page belongs to one class and keeps
+ * its own free list, so that a page whose objects are all free can be
+ * given back to the allocator. A worker allocates from, and frees to, its
+ * own pages without any locking. Objects freed by another thread are
+ * pushed on a lock-free list of the class that allocated them, which the
+ * owning worker drains between two work shifts (see slabCacheDrain) or
+ * when it runs out of free objects in that class.
+ *
+ * Like blocks of the other allocators, objects have an 8 byte header
+ * before their payload whose low bits identify them as slab objects.
+ */
+
+// Size of the pages objects are carved from
+#ifndef SLAB_CACHE_PAGE_SIZE
+#define SLAB_CACHE_PAGE_SIZE 32768
+#endif
+
+// Objects up to 2^SLAB_CACHE_MAX_SIZE_LOG2 bytes are cached (at least 7)
+#ifndef SLAB_CACHE_MAX_SIZE_LOG2
+#define SLAB_CACHE_MAX_SIZE_LOG2 11
+#endif
+
+#define SLAB_CACHE_MAX_SIZE (1ULL << SLAB_CACHE_MAX_SIZE_LOG2)
+
+// Empty pages a class keeps for itself, the next ones are given back to
+// the allocator as soon as they become empty
+#ifndef SLAB_CACHE_CLASS_MAX_EMPTY_PAGES
+#define SLAB_CACHE_CLASS_MAX_EMPTY_PAGES 2
+#endif
+
+// Four classes of 16 bytes up to 64 bytes, then four classes per power of 2
+#define SLAB_CACHE_CLASS_COUNT (4 + 4 * (SLAB_CACHE_MAX_SIZE_LOG2 - 6))
+
+// Allocator type found in the header of slab objects: the first one
+// no allocator uses
+#define SLAB_CACHE_TYPE_ID ((u64) allocatorMax_id)
+
+/**
+ * @brief Header of a page objects of one class are carved from
+ *
+ * The header of the objects points to it.
+ */
+typedef struct _slabPage_t {
+    struct _slabPage_t *next;       /**< Next page in the class' partial or full list */
+    struct _slabPage_t *prev;       /**< Previous page in that list */
+    struct _slabClassCache_t *cls;  /**< Class the page belongs to */
+    void *freeList;                 /**< Free objects, linked through their first word */
+    u8 *carve;                      /**< Start of the part of the page not carved yet */
+    u64 used;                       /**< Objects handed out and not freed to the page yet */
+} slabPage_t;
+
+/**
+ * @brief Objects of one size class cached by one worker
+ */
+typedef struct _slabClassCache_t {
+    slabPage_t *partial;            /**< Pages with objects left, the first one is allocated from */
+    slabPage_t *full;               /**< Pages all the objects of which are handed out */
+    struct _slabCache_t *cache;     /**< Worker cache this class belongs to */
+    u64 size;                       /**< Payload size of the objects */
+    u64 emptyPages;                 /**< Pages of the partial list with no object in use */
+    void * volatile remoteFree;     /**< Objects freed by other threads, pushed with a CAS */
+    // Statistics, only updated by the owning worker
+    u64 allocCount;                 /**< Objects allocated */
+    u64 freeCount;                  /**< Objects freed by the owning worker */
+    u64 requestedBytes;             /**< Sum of the sizes requested */
+    u64 pageCount;                  /**< Pages currently held */
+    u64 pageAllocCount;             /**< Pages taken from the allocator */
+    u64 pageReleaseCount;           /**< Pages given back before the PD tears down */
+} slabClassCache_t;
+
+typedef struct _slabCache_t {
+    struct _ocrPolicyDomain_t *pd;
+    volatile u32 remotePending;     /**< Set when some class may have remote frees to drain */
+    u64 fallbackCount;              /**< Requests handed to the allocator (too large or out of pages) */
+    slabClassCache_t classes[SLAB_CACHE_CLASS_COUNT];
+} slabCache_t;
+
+slabCache_t * slabCacheCreate(struct _ocrPolicyDomain_t *pd);
+
+/**
+ * @brief Gives the cache's pages back to the PD's allocator
+ *
+ * Objects allocated from the cache must not be used anymore, whichever
+ * worker they were freed to.
+ */
+void slabCacheDestroy(struct _ocrPolicyDomain_t *pd, slabCache_t *cache);
+
+/**
+ * @brief Allocates 'size' bytes. Only called by the cache's worker.
+ *
+ * @return NULL if 'size' is not cached or no page could be allocated,
+ * in which case the caller should use the allocator directly
+ */
+void * slabCacheAlloc(slabCache_t *cache, u64 size);
+
+/**
+ * @brief Frees an object allocated from a slab cache
+ *
+ * @param[in] cache   Cache of the calling worker, NULL if the caller is not a worker
+ * @param[in] addr    Object to free (slabCacheOwns(addr) must be true)
+ */
+void slabCacheFree(slabCache_t *cache, void *addr);
+
+/**
+ * @brief Takes back the objects other threads freed to the cache
+ *
+ * Only called by the cache's worker, between two work shifts. Cheap when
+ * nothing was freed remotely. Pages that become empty may be given back
+ * to the allocator.
+ */
+void slabCacheDrain(slabCache_t *cache);
+
+/**
+ * @brief Tells whether 'addr', a block returned by the PD's allocation
+ * functions, comes from a slab cache
+ */
+static inline bool slabCacheOwns(void *addr) {
+    return ((((u64*) addr)[-1]) & POOL_HEADER_TYPE_MASK) == SLAB_CACHE_TYPE_ID;
+}
+
+/**
+ * @brief Prints the merged statistics of the caches of 'pd' if requested
+ *
+ * Enabled by setting the OCR_SLAB_STATS environment variable. Must be
+ * called once the workers stopped allocating.
+ */
+void slabCacheDump(struct _ocrPolicyDomain_t *pd);
+
+#endif /* ENABLE_SLAB_CACHE */
+#endif /* SLAB_CACHE_H_ */
@@ -637,7 +637,44 @@ s32 populate_inst(ocrParamList_t **inst_param, int inst_param_size, void **insta
     switch (index) {
     case guid_type:
         for (j = low; j<=high; j++) {
-            ALLOC_PARAM_LIST(inst_param[j], paramListGuidProviderInst_t);
+            guidType_t mytype = guidMax_id;
+            TO_ENUM (mytype, inststr, guidType_t, guid_types, guidMax_id);
+#if defined(ENABLE_GUID_COUNTED_MAP) || defined(ENABLE_GUID_LABELED) || defined(ENABLE_GUID_HYBRID)
+            hashtableType_t mapType = HASHTABLE_BUCKET_LOCKED;
+            if (key_exists(dict, secname, "maptype")) {
+                char *valuestr = NULL;
+                snprintf(key, MAX_KEY_SZ, "%s:%s", secname, "maptype");
+                INI_GET_STR (key, valuestr, "");
+                if (strcmp("RESIZABLE", valuestr) == 0) {
+                    mapType = HASHTABLE_RESIZABLE;
+                } else if (strcmp("BUCKET_LOCKED", valuestr) != 0) {
+                    DPRINTF(DEBUG_LVL_WARN, "Error: Unsupported maptype %s\n", valuestr);
+                }
+            }
+#endif
+            switch (mytype) {
+#ifdef ENABLE_GUID_COUNTED_MAP
+            case guidCountedMap_id:
+                ALLOC_PARAM_LIST(inst_param[j], paramListGuidProviderCountedMap_t);
+                ((paramListGuidProviderCountedMap_t *)inst_param[j])->mapType = mapType;
+                break;
+#endif
+#ifdef ENABLE_GUID_LABELED
+            case guidLabeled_id:
+                ALLOC_PARAM_LIST(inst_param[j], paramListGuidProviderLabeled_t);
+                ((paramListGuidProviderLabeled_t *)inst_param[j])->mapType = mapType;
+                break;
+#endif
+#ifdef ENABLE_GUID_HYBRID
+            case guidHybrid_id:
+                ALLOC_PARAM_LIST(inst_param[j], paramListGuidProviderHybrid_t);
+                ((paramListGuidProviderHybrid_t *)inst_param[j])->mapType = mapType;
+                break;
+#endif
+            default:
+                ALLOC_PARAM_LIST(inst_param[j], paramListGuidProviderInst_t);
+                break;
+            }
             instance[j] = (void *)((ocrGuidProviderFactory_t *)factory)->instantiate(factory, inst_param[j]);
             if (instance[j])
                 DPRINTF(DEBUG_LVL_INFO, "Created guid provider of type %s, index %"PRId32"\n", inststr, j);
@@ -662,6 +699,12 @@ s32 populate_inst(ocrParamList_t **inst_param, int inst_param_size, void **insta
 
             snprintf(key, MAX_KEY_SZ, "%s:%s", secname, "size");
             ((paramListMemPlatformInst_t *)inst_param[j])->size = (u64)iniparser_getlonglong(dict, key, 0);
+            if (key_exists(dict, secname, "numa_node")) {
+                value = get_key_value(dict, secname, "numa_node", j-low);
+                ((paramListMemPlatformInst_t *)inst_param[j])->numa_node = value;
+            } else {
+                ((paramListMemPlatformInst_t *)inst_param[j])->numa_node = MEM_PLATFORM_NUMA_NODE_NONE;
+            }
 
 #ifdef ENABLE_MEM_PLATFORM_FSIM
             // Adjust the start and size according to size of ELF binary
@@ -827,12 +870,27 @@ s32 populate_inst(ocrParamList_t **inst_param, int inst_param_size, void **insta
         break;
     case schedulerObject_type:
         for (j = low; j<=high; j++) {
-            ALLOC_PARAM_LIST(inst_param[j], paramListSchedulerObject_t);
-            ((paramListSchedulerObject_t*)inst_param[j])->config = true;
-            ((paramListSchedulerObject_t*)inst_param[j])->guidRequired = false;
             schedulerObjectType_t mytype = schedulerObjectMax_id;
             TO_ENUM (mytype, inststr, schedulerObjectType_t, schedulerObject_types, schedulerObjectMax_id);
             switch(mytype) {
+#ifdef ENABLE_SCHEDULER_OBJECT_WST
+            case schedulerObjectWst_id:
+                ALLOC_PARAM_LIST(inst_param[j], paramListSchedulerObjectWst_t);
+                ((paramListSchedulerObjectWst_t*)inst_param[j])->config = SCHEDULER_OBJECT_WST_CONFIG_REGULAR;
+                break;
+#endif
+#ifdef ENABLE_SCHEDULER_OBJECT_PR_MQ
+            case schedulerObjectPrMq_id:
+                ALLOC_PARAM_LIST(inst_param[j], paramListSchedulerObjectPrMq_t);
+                break;
+#endif
+            default:
+                ALLOC_PARAM_LIST(inst_param[j], paramListSchedulerObject_t);
+                break;
+            }
+            ((paramListSchedulerObject_t*)inst_param[j])->config = true;
+            ((paramListSchedulerObject_t*)inst_param[j])->guidRequired = false;
+            switch(mytype) {
 #ifdef ENABLE_SCHEDULER_OBJECT_WST
             case schedulerObjectWst_id:
                 {
@@ -842,12 +900,27 @@ s32 populate_inst(ocrParamList_t **inst_param, int inst_param_size, void **insta
                         INI_GET_STR (key, valuestr, "");
                         if (strcmp(valuestr, "STATIC") == 0) {
                             ((paramListSchedulerObjectWst_t*)inst_param[j])->config = SCHEDULER_OBJECT_WST_CONFIG_STATIC;
+                        } else if (strcmp(valuestr, "LOCKED") == 0) {
+                            ((paramListSchedulerObjectWst_t*)inst_param[j])->config = SCHEDULER_OBJECT_WST_CONFIG_LOCKED;
                         } else {
                             ((paramListSchedulerObjectWst_t*)inst_param[j])->config = SCHEDULER_OBJECT_WST_CONFIG_REGULAR;
                         }
                     }
                 }
                 break;
+#endif
+#ifdef ENABLE_SCHEDULER_OBJECT_PR_MQ
+            case schedulerObjectPrMq_id:
+                {
+                    // Heaps per worker; bounds how far a pop may stray from the highest priority
+                    s32 value = -1;
+                    if (key_exists(dict, secname, "relax")) {
+                        snprintf(key, MAX_KEY_SZ, "%s:%s", secname, "relax");
+                        INI_GET_INT (key, value, -1);
+                    }
+                    ((paramListSchedulerObjectPrMq_t*)inst_param[j])->relax = (value < 0) ? PR_MQ_RELAX_FACTOR : (u32)value;
+                }
+                break;
 #endif
             case schedulerObjectMax_id:
                 ASSERT (0); // Unimplemented scheduler object type
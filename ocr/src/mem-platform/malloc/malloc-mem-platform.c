@@ -20,6 +20,9 @@
 #include "ocr-mem-platform.h"
 #include "ocr-policy-domain.h"
 #include "mem-platform/malloc/malloc-mem-platform.h"
+#ifdef ENABLE_COMM_PLATFORM_SHM
+#include "comm-platform/shm/shm-comm-platform.h"
+#endif
 
 #include <stdlib.h>
 #include <string.h>
@@ -67,6 +70,11 @@ u8 mallocSwitchRunlevel(ocrMemPlatform_t *self, ocrPolicyDomain_t *PD, ocrRunlev
                 break; // We break out early since we are already initialized
             // This is where we need to update the memory
             // using the sysboot functions
+#ifdef ENABLE_COMM_PLATFORM_SHM
+            // Memory other PDs of the host can map (DBs are shared, not copied)
+            self->startAddr = (u64)shmCommHeapAlloc(self->size);
+            if(self->startAddr == 0ULL)
+#endif
             self->startAddr = (u64)malloc(self->size);
             // Check that the mem-platform size in config file is reasonable
             ASSERT(self->startAddr);
@@ -89,6 +97,10 @@ u8 mallocSwitchRunlevel(ocrMemPlatform_t *self, ocrPolicyDomain_t *PD, ocrRunlev
                 if(rself->pRangeTracker)    // in case of mallocproxy, pRangeTracker==0
                     destroyRange(rself->pRangeTracker);
                 // Here we can free the memory we allocated
+#ifdef ENABLE_COMM_PLATFORM_SHM
+                // The shared heap goes away with the segment
+                if(!shmCommIsSharedPtr((void*)(self->startAddr)))
+#endif
                 free((void*)(self->startAddr));
                 self->startAddr = 0ULL;
             }
@@ -70,9 +70,14 @@ u8 numaAllocSwitchRunlevel(ocrMemPlatform_t *self, ocrPolicyDomain_t *PD, ocrRun
             ocrMemPlatformNumaAlloc_t *rself = (ocrMemPlatformNumaAlloc_t*)self;
             // 1. Check if NUMA is available
             ASSERT(numa_available() != -1);
-            // 2. Check if the node number is reasonable
-            ASSERT(rself->numa_node <= numa_max_node());
-            self->startAddr = (u64)numa_alloc_onnode(self->size, rself->numa_node);
+            if(self->numaNode == MEM_PLATFORM_NUMA_NODE_NONE) {
+                // No node configured: the memory is local to the thread bringing the PD up
+                self->startAddr = (u64)numa_alloc_local(self->size);
+            } else {
+                // 2. Check if the node number is reasonable
+                ASSERT(self->numaNode <= numa_max_node());
+                self->startAddr = (u64)numa_alloc_onnode(self->size, self->numaNode);
+            }
             // Check that the mem-platform size in config file is reasonable
             ASSERT(self->startAddr);
             self->endAddr = self->startAddr + self->size;
@@ -224,7 +229,7 @@ ocrMemPlatform_t* newMemPlatformNumaAlloc(ocrMemPlatformFactory_t * factory,
 void initializeMemPlatformNumaAlloc(ocrMemPlatformFactory_t * factory, ocrMemPlatform_t * result, ocrParamList_t * perInstance) {
     initializeMemPlatformOcr(factory, result, perInstance);
     ocrMemPlatformNumaAlloc_t *rself = (ocrMemPlatformNumaAlloc_t*)result;
-    rself->numa_node = ((paramListMemPlatformInst_t *)perInstance)->numa_node;
+    result->numaNode = ((paramListMemPlatformInst_t *)perInstance)->numa_node;
     INIT_LOCK(&(rself->lock));
 }
 
@@ -28,7 +28,6 @@ typedef struct {
 typedef struct {
     ocrMemPlatform_t base;
     rangeTracker_t *pRangeTracker;
-    u32 numa_node;
     u32 lock;
 } ocrMemPlatformNumaAlloc_t;
 
@@ -14,6 +14,7 @@
 #include "ocr-policy-domain.h"
 #include "ocr-policy-domain-tasks.h"
 #include "ocr-sysboot.h"
+#include "ocr-comm-platform.h"
 #include "experimental/ocr-placer.h"
 #include "experimental/ocr-platform-model.h"
 #include "utils/hashtable.h"
@@ -34,6 +35,8 @@
 #include "task/hc/hc-task.h"
 #include "event/hc/hc-event.h"
 
+#include <stdlib.h>
+
 #define DEBUG_TYPE POLICY
 
 // This is in place of using the general purpose 'guidLocation' implementation that relies
@@ -150,6 +153,15 @@ static void setReturnDetail(ocrPolicyMsg_t * msg, u8 returnDetail) {
 #define PD_TYPE PD_MSG_DB_FREE
         PD_MSG_FIELD_O(returnDetail) = returnDetail;
 #undef PD_MSG
+#undef PD_TYPE
+    break;
+    }
+    case PD_MSG_DB_INVALIDATE:
+    {
+#define PD_MSG (msg)
+#define PD_TYPE PD_MSG_DB_INVALIDATE
+        PD_MSG_FIELD_O(returnDetail) = returnDetail;
+#undef PD_MSG
 #undef PD_TYPE
     break;
     }
@@ -405,10 +417,11 @@ static u8 resolveRemoteMetaData(ocrPolicyDomain_t * pd, ocrFatGuid_t * tplFatGui
  * @brief State of a Proxy for a DataBlock
  */
 typedef enum {
-    PROXY_DB_CREATED,   /**< The proxy DB has been created and is registered in GUID provider */
+    PROXY_DB_CREATED,   /**< The proxy DB has been created and is registered in the proxy table */
     PROXY_DB_FETCH,     /**< The DB ptr is being fetch */
     PROXY_DB_RUN,       /**< The DB ptr is being used */
-    PROXY_DB_RELINQUISH /**< The DB ptr is being released (possibly incuring Write-Back) */
+    PROXY_DB_RELINQUISH, /**< The DB ptr is being released (possibly incuring Write-Back) */
+    PROXY_DB_CACHED     /**< The DB ptr is unused but kept acquired, until the owner PD recalls it */
 } ProxyDbState_t;
 
 //Default proxy DB internal queue size
@@ -417,23 +430,42 @@ typedef enum {
 /**
  * @brief Data-structure to store foreign DB information
  */
-typedef struct {
+typedef struct _ProxyDb_t {
     ProxyDbState_t state;
     u32 nbUsers;
-    u32 refCount;
+    volatile u32 refCount; // Incremented under the key's table lock, decremented lock-free
     u32 lock;
     Queue_t * acquireQueue;
     u16 mode;
     u64 size;
     void * volatile ptr;
     u32 flags;
+    bool sharedPtr; // 'ptr' is the original DB mapped from the owner PD, not a copy
+    bool retained;  // In the LRU list of unused proxies (protected by lockProxyDbLru)
+    bool cacheable; // The owner PD lets the ptr be cached after the last release
+    bool recalled;  // The owner PD wants the DB back, do not cache
     ocrDataBlock_t *db;
+    ocrGuid_t guid;
+    struct _ProxyDb_t * lruPrev;
+    struct _ProxyDb_t * lruNext;
 } ProxyDb_t;
 
+#if GUID_BIT_COUNT == 64
+#define PROXY_DB_KEY(dbGuid) ((void *) (dbGuid).guid)
+#elif GUID_BIT_COUNT == 128
+#define PROXY_DB_KEY(dbGuid) ((void *) (dbGuid).lower)
+#else
+#error Unknown type of GUID
+#endif
+
+static u32 * proxyDbLock(ocrPolicyDomainHcDist_t * dself, ocrGuid_t dbGuid) {
+    return &(dself->proxyDbLock[((u64) PROXY_DB_KEY(dbGuid)) % HCDIST_PROXY_DB_NB_LOCKS]);
+}
+
 /**
  * @brief Allocate a proxy DB
  */
-static ProxyDb_t * createProxyDb(ocrPolicyDomain_t * pd) {
+static ProxyDb_t * createProxyDb(ocrPolicyDomain_t * pd, ocrGuid_t dbGuid) {
     ProxyDb_t * proxyDb = pd->fcts.pdMalloc(pd, sizeof(ProxyDb_t));
     proxyDb->state = PROXY_DB_CREATED;
     proxyDb->nbUsers = 0;
@@ -445,10 +477,37 @@ static ProxyDb_t * createProxyDb(ocrPolicyDomain_t * pd) {
     proxyDb->size = 0;
     proxyDb->ptr = NULL;
     proxyDb->flags = 0;
+    proxyDb->sharedPtr = false;
+    proxyDb->retained = false;
+    proxyDb->cacheable = false;
+    proxyDb->recalled = false;
     proxyDb->db = NULL;
+    proxyDb->guid = dbGuid;
+    proxyDb->lruPrev = NULL;
+    proxyDb->lruNext = NULL;
     return proxyDb;
 }
 
+/**
+ * @brief Deallocate a proxy DB that is not in the proxy table anymore
+ */
+static void destructProxyDb(ocrPolicyDomain_t * pd, ProxyDb_t * proxyDb) {
+    if (proxyDb->db != NULL) {
+        pd->dbFactories[0]->fcts.destruct(proxyDb->db);
+    }
+    if ((proxyDb->ptr != NULL) && !proxyDb->sharedPtr) {
+        pd->fcts.pdFree(pd, proxyDb->ptr);
+    }
+    if (proxyDb->acquireQueue != NULL) {
+        pd->fcts.pdFree(pd, proxyDb->acquireQueue);
+    }
+    pd->fcts.pdFree(pd, proxyDb);
+}
+
+static void proxyDbDealloc(void * key, void * value, void * deallocParam) {
+    destructProxyDb((ocrPolicyDomain_t *) deallocParam, (ProxyDb_t *) value);
+}
+
 /**
  * @brief Reset a proxy DB.
  * Warning: This call does NOT reinitialize all of the proxy members !
@@ -458,34 +517,89 @@ static void resetProxyDb(ProxyDb_t * proxyDb) {
     proxyDb->mode = 0;
     proxyDb->flags = 0;
     proxyDb->nbUsers = 0;
+    proxyDb->cacheable = false;
+    proxyDb->recalled = false;
     // DBs are not supposed to be resizable hence, do NOT reset
     // size and ptr so they can be reused in the subsequent fetch.
 }
 
+// Both lockProxyDbLru and the proxy's table lock must be held
+static void proxyDbLruUnlink(ocrPolicyDomainHcDist_t * dself, ProxyDb_t * proxyDb) {
+    if (proxyDb->lruPrev != NULL) {
+        proxyDb->lruPrev->lruNext = proxyDb->lruNext;
+    } else {
+        dself->proxyDbLruHead = proxyDb->lruNext;
+    }
+    if (proxyDb->lruNext != NULL) {
+        proxyDb->lruNext->lruPrev = proxyDb->lruPrev;
+    } else {
+        dself->proxyDbLruTail = proxyDb->lruPrev;
+    }
+    proxyDb->lruPrev = NULL;
+    proxyDb->lruNext = NULL;
+    proxyDb->retained = false;
+    dself->proxyDbLruCount--;
+}
+
+/**
+ * @brief Evict the least recently retained proxies until the LRU list is
+ * back within HCDIST_PROXY_DB_RETAIN entries.
+ *
+ * The table lock is only tried while holding the LRU lock (the other order
+ * is used when a retained proxy is looked up). Eviction stops on contention,
+ * the next release does the remaining work.
+ */
+static void proxyDbLruEvict(ocrPolicyDomain_t * pd) {
+    ocrPolicyDomainHcDist_t * dself = (ocrPolicyDomainHcDist_t *) pd;
+    while (true) {
+        hal_lock32(&(dself->lockProxyDbLru));
+        ProxyDb_t * proxyDb = dself->proxyDbLruTail;
+        if ((dself->proxyDbLruCount <= HCDIST_PROXY_DB_RETAIN) || (proxyDb == NULL)) {
+            hal_unlock32(&(dself->lockProxyDbLru));
+            return;
+        }
+        u32 * lock = proxyDbLock(dself, proxyDb->guid);
+        if (hal_trylock32(lock) != 0) {
+            hal_unlock32(&(dself->lockProxyDbLru));
+            return;
+        }
+        // Retained proxies are only referenced after being looked up under the table lock
+        ASSERT(proxyDb->refCount == 0);
+        proxyDbLruUnlink(dself, proxyDb);
+        hal_unlock32(&(dself->lockProxyDbLru));
+        RESULT_ASSERT(hashtableConcResizableRemove(dself->proxyDbMap, PROXY_DB_KEY(proxyDb->guid), NULL), ==, true);
+        hal_unlock32(lock);
+        DPRINTF(DEBUG_LVL_VVERB,"Evict retained proxy for DB GUID "GUIDF"\n", GUIDA(proxyDb->guid));
+        destructProxyDb(pd, proxyDb);
+    }
+}
+
 /**
- * @brief Lookup a proxy DB in the GUID provider.
+ * @brief Lookup a proxy DB in the proxy table.
  *        Increments the proxy's refCount by one.
  * @param dbGuid            The GUID of the datablock to look for
  * @param createIfAbsent    Create the proxy DB if not found.
  */
 static ProxyDb_t * getProxyDb(ocrPolicyDomain_t * pd, ocrGuid_t dbGuid, bool createIfAbsent) {
-    hal_lock32(&((ocrPolicyDomainHcDist_t *) pd)->lockDbLookup);
-    ProxyDb_t * proxyDb = NULL;
-    u64 val;
-    pd->guidProviders[0]->fcts.getVal(pd->guidProviders[0], dbGuid, &val, NULL);
-    if (val == 0) {
-        if (createIfAbsent) {
-            proxyDb = createProxyDb(pd);
-            pd->guidProviders[0]->fcts.registerGuid(pd->guidProviders[0], dbGuid, (u64) proxyDb);
-        } else {
-            hal_unlock32(&((ocrPolicyDomainHcDist_t *) pd)->lockDbLookup);
+    ocrPolicyDomainHcDist_t * dself = (ocrPolicyDomainHcDist_t *) pd;
+    u32 * lock = proxyDbLock(dself, dbGuid);
+    hal_lock32(lock);
+    ProxyDb_t * proxyDb = (ProxyDb_t *) hashtableConcResizableGet(dself->proxyDbMap, PROXY_DB_KEY(dbGuid));
+    if (proxyDb == NULL) {
+        if (!createIfAbsent) {
+            hal_unlock32(lock);
             return NULL;
         }
-    } else {
-        proxyDb = (ProxyDb_t *) val;
+        proxyDb = createProxyDb(pd, dbGuid);
+        RESULT_ASSERT(hashtableConcResizablePut(dself->proxyDbMap, PROXY_DB_KEY(dbGuid), proxyDb), ==, true);
+    } else if (proxyDb->retained) {
+        // 'retained' only changes under the table lock. Back in use, take it off the LRU list
+        hal_lock32(&(dself->lockProxyDbLru));
+        proxyDbLruUnlink(dself, proxyDb);
+        hal_unlock32(&(dself->lockProxyDbLru));
     }
-    proxyDb->refCount++;
-    hal_unlock32(&((ocrPolicyDomainHcDist_t *) pd)->lockDbLookup);
+    hal_xadd32(&(proxyDb->refCount), 1);
+    hal_unlock32(lock);
     return proxyDb;
 }
 
@@ -494,9 +608,7 @@ static ProxyDb_t * getProxyDb(ocrPolicyDomain_t * pd, ocrGuid_t dbGuid, bool cre
  * Warning: This is different from releasing a datablock.
  */
 static void relProxyDb(ocrPolicyDomain_t * pd, ProxyDb_t * proxyDb) {
-    hal_lock32(&((ocrPolicyDomainHcDist_t *) pd)->lockDbLookup);
-    proxyDb->refCount--;
-    hal_unlock32(&((ocrPolicyDomainHcDist_t *) pd)->lockDbLookup);
+    hal_xadd32(&(proxyDb->refCount), -1);
 }
 
 /**
@@ -584,6 +696,311 @@ static void updateAcquireMessage(ocrPolicyMsg_t * msg, ProxyDb_t * proxyDb) {
 #undef PD_TYPE
 }
 
+/****************************************************/
+/* READ-ONLY DB CACHING                             */
+/****************************************************/
+
+// A PD fetching a remote DB for reading asks the owner PD for a lease
+// (DB_FLAG_RT_CACHE). When granted, the proxy keeps its acquire at the owner
+// after the last local release and serves the next compatible acquires from
+// its copy. The owner records which PDs hold a lease on each of its DBs and
+// recalls them (PD_MSG_DB_INVALIDATE) before a writer can get the DB or
+// before the DB is freed. Since a lease is a regular acquire at the owner,
+// the DB itself guarantees writers wait for the recalled copies to be released.
+
+#define DB_SHARERS_SIZE_DEFAULT 4
+
+/**
+ * @brief PDs holding a lease on a local DB
+ *
+ * The entry also lives as long as writers wait for the recalled leases to
+ * be released, so that new leases on this DB only are refused meanwhile.
+ */
+typedef struct {
+    u32 nbSharers;
+    u32 maxSharers;
+    u32 pendingWriters;         /**< Writers waiting on a recall, see dbSharersRecall */
+    ocrLocation_t * sharers;    /**< Allocated with the first sharer */
+} DbSharers_t;
+
+static u32 dbSharersIdx(ocrGuid_t dbGuid) {
+    return (u32) (((u64) PROXY_DB_KEY(dbGuid)) % HCDIST_PROXY_DB_NB_LOCKS);
+}
+
+static void dbSharersDealloc(void * key, void * value, void * deallocParam) {
+    ocrPolicyDomain_t * pd = (ocrPolicyDomain_t *) deallocParam;
+    DbSharers_t * sharers = (DbSharers_t *) value;
+    if (sharers->sharers != NULL) {
+        pd->fcts.pdFree(pd, sharers->sharers);
+    }
+    pd->fcts.pdFree(pd, sharers);
+}
+
+/**
+ * @brief Get the entry of a local DB, creating it if needed.
+ * Called with the DB's sharers lock held.
+ */
+static DbSharers_t * dbSharersGet(ocrPolicyDomain_t * pd, ocrGuid_t dbGuid) {
+    ocrPolicyDomainHcDist_t * dself = (ocrPolicyDomainHcDist_t *) pd;
+    DbSharers_t * sharers = (DbSharers_t *) hashtableConcResizableGet(dself->dbSharersMap, PROXY_DB_KEY(dbGuid));
+    if (sharers == NULL) {
+        sharers = (DbSharers_t *) pd->fcts.pdMalloc(pd, sizeof(DbSharers_t));
+        sharers->nbSharers = 0;
+        sharers->maxSharers = 0;
+        sharers->pendingWriters = 0;
+        sharers->sharers = NULL;
+        RESULT_ASSERT(hashtableConcResizablePut(dself->dbSharersMap, PROXY_DB_KEY(dbGuid), sharers), ==, true);
+    }
+    return sharers;
+}
+
+/**
+ * @brief Remove the entry of a local DB if it has no sharer nor pending writer.
+ * Called with the DB's sharers lock held. Returns the entry to deallocate, if any.
+ */
+static DbSharers_t * dbSharersTryRemove(ocrPolicyDomain_t * pd, ocrGuid_t dbGuid, DbSharers_t * sharers) {
+    ocrPolicyDomainHcDist_t * dself = (ocrPolicyDomainHcDist_t *) pd;
+    if ((sharers->nbSharers != 0) || (sharers->pendingWriters != 0)) {
+        return NULL;
+    }
+    RESULT_ASSERT(hashtableConcResizableRemove(dself->dbSharersMap, PROXY_DB_KEY(dbGuid), NULL), ==, true);
+    return sharers;
+}
+
+/**
+ * @brief Grant 'sharer' a lease on a local DB
+ * Returns false when a writer is waiting for the DB's leases to be recalled.
+ * The requester then gets a regular acquire.
+ */
+static bool dbSharersAdd(ocrPolicyDomain_t * pd, ocrGuid_t dbGuid, ocrLocation_t sharer) {
+    ocrPolicyDomainHcDist_t * dself = (ocrPolicyDomainHcDist_t *) pd;
+    u32 idx = dbSharersIdx(dbGuid);
+    bool granted = false;
+    hal_lock32(&(dself->dbSharersLock[idx]));
+    DbSharers_t * sharers = dbSharersGet(pd, dbGuid);
+    if (sharers->pendingWriters == 0) {
+        u32 i = 0;
+        while ((i < sharers->nbSharers) && (sharers->sharers[i] != sharer)) {
+            i++;
+        }
+        if (i == sharers->nbSharers) {
+            if (sharers->nbSharers == sharers->maxSharers) {
+                u32 maxSharers = (sharers->maxSharers == 0) ? DB_SHARERS_SIZE_DEFAULT : (sharers->maxSharers * 2);
+                ocrLocation_t * newSharers = (ocrLocation_t *) pd->fcts.pdMalloc(pd, sizeof(ocrLocation_t) * maxSharers);
+                if (sharers->sharers != NULL) {
+                    hal_memCopy(newSharers, sharers->sharers, sizeof(ocrLocation_t) * sharers->nbSharers, false);
+                    pd->fcts.pdFree(pd, sharers->sharers);
+                }
+                sharers->sharers = newSharers;
+                sharers->maxSharers = maxSharers;
+            }
+            sharers->sharers[sharers->nbSharers++] = sharer;
+        }
+        granted = true;
+    }
+    hal_unlock32(&(dself->dbSharersLock[idx]));
+    return granted;
+}
+
+/**
+ * @brief 'sharer' gave its lease on a local DB back
+ */
+static void dbSharersRemove(ocrPolicyDomain_t * pd, ocrGuid_t dbGuid, ocrLocation_t sharer) {
+    ocrPolicyDomainHcDist_t * dself = (ocrPolicyDomainHcDist_t *) pd;
+    u32 idx = dbSharersIdx(dbGuid);
+    DbSharers_t * sharers = NULL;
+    hal_lock32(&(dself->dbSharersLock[idx]));
+    sharers = (DbSharers_t *) hashtableConcResizableGet(dself->dbSharersMap, PROXY_DB_KEY(dbGuid));
+    // The lease may have been recalled already
+    if (sharers != NULL) {
+        u32 i = 0;
+        while ((i < sharers->nbSharers) && (sharers->sharers[i] != sharer)) {
+            i++;
+        }
+        if (i < sharers->nbSharers) {
+            sharers->sharers[i] = sharers->sharers[--sharers->nbSharers];
+        }
+        sharers = dbSharersTryRemove(pd, dbGuid, sharers);
+    }
+    hal_unlock32(&(dself->dbSharersLock[idx]));
+    if (sharers != NULL) {
+        dbSharersDealloc(NULL, sharers, pd);
+    }
+}
+
+/**
+ * @brief Recall all the leases on a local DB
+ * When 'writer' is set, new leases on the DB are refused until
+ * dbSharersWriterDone is called.
+ */
+static void dbSharersRecall(ocrPolicyDomain_t * pd, ocrGuid_t dbGuid, bool writer) {
+    ocrPolicyDomainHcDist_t * dself = (ocrPolicyDomainHcDist_t *) pd;
+    u32 idx = dbSharersIdx(dbGuid);
+    DbSharers_t * sharers = NULL;
+    ocrLocation_t * recalled = NULL;
+    u32 nbRecalled = 0;
+    hal_lock32(&(dself->dbSharersLock[idx]));
+    if (writer) {
+        sharers = dbSharersGet(pd, dbGuid);
+        sharers->pendingWriters++;
+    } else {
+        sharers = (DbSharers_t *) hashtableConcResizableGet(dself->dbSharersMap, PROXY_DB_KEY(dbGuid));
+    }
+    if (sharers != NULL) {
+        // Take the sharers out, the messages are sent without the lock
+        recalled = sharers->sharers;
+        nbRecalled = sharers->nbSharers;
+        sharers->sharers = NULL;
+        sharers->nbSharers = 0;
+        sharers->maxSharers = 0;
+        sharers = dbSharersTryRemove(pd, dbGuid, sharers);
+    }
+    hal_unlock32(&(dself->dbSharersLock[idx]));
+    u32 i;
+    for (i = 0; i < nbRecalled; i++) {
+        DPRINTF(DEBUG_LVL_VVERB,"DB_INVALIDATE: recall DB GUID "GUIDF" from %"PRIu64"\n", GUIDA(dbGuid), (u64) recalled[i]);
+        PD_MSG_STACK(msg);
+        getCurrentEnv(NULL, NULL, NULL, &msg);
+#define PD_MSG (&msg)
+#define PD_TYPE PD_MSG_DB_INVALIDATE
+        msg.type = PD_MSG_DB_INVALIDATE | PD_MSG_REQUEST;
+        msg.destLocation = recalled[i];
+        PD_MSG_FIELD_I(guid.guid) = dbGuid;
+        PD_MSG_FIELD_I(guid.metaDataPtr) = NULL;
+        PD_MSG_FIELD_I(properties) = 0;
+        RESULT_ASSERT(pd->fcts.processMessage(pd, &msg, false), ==, 0);
+#undef PD_MSG
+#undef PD_TYPE
+    }
+    if (recalled != NULL) {
+        pd->fcts.pdFree(pd, recalled);
+    }
+    if (sharers != NULL) {
+        dbSharersDealloc(NULL, sharers, pd);
+    }
+}
+
+/**
+ * @brief A writer recalling leases with dbSharersRecall got the DB
+ */
+static void dbSharersWriterDone(ocrPolicyDomain_t * pd, ocrGuid_t dbGuid) {
+    ocrPolicyDomainHcDist_t * dself = (ocrPolicyDomainHcDist_t *) pd;
+    u32 idx = dbSharersIdx(dbGuid);
+    hal_lock32(&(dself->dbSharersLock[idx]));
+    DbSharers_t * sharers = (DbSharers_t *) hashtableConcResizableGet(dself->dbSharersMap, PROXY_DB_KEY(dbGuid));
+    ASSERT((sharers != NULL) && (sharers->pendingWriters != 0));
+    sharers->pendingWriters--;
+    sharers = dbSharersTryRemove(pd, dbGuid, sharers);
+    hal_unlock32(&(dself->dbSharersLock[idx]));
+    if (sharers != NULL) {
+        dbSharersDealloc(NULL, sharers, pd);
+    }
+}
+
+// Prints the read-only DB cache statistics if the OCR_DIST_STATS environment variable is set
+static void proxyDbCacheDump(ocrPolicyDomain_t * pd) {
+    ocrPolicyDomainHcDist_t * dself = (ocrPolicyDomainHcDist_t *) pd;
+    char * enabled = getenv("OCR_DIST_STATS");
+    if ((enabled == NULL) || (enabled[0] == '\0')) {
+        return;
+    }
+    PRINTF("Read-only DB cache for PD %"PRIu64": %"PRIu64" hits, %"PRIu64" misses, %"PRIu64" invalidations\n",
+           (u64) pd->myLocation, dself->proxyDbCacheHits, dself->proxyDbCacheMisses, dself->proxyDbCacheInvalidations);
+}
+
+/**
+ * @brief Check if an acquire of a local DB needs the leases to be recalled
+ */
+static bool isWriterAcquire(u32 properties) {
+    ocrDbAccessMode_t mode = (properties & DB_ACCESS_MODE_MASK);
+    return (((mode == DB_MODE_RW) || (mode == DB_MODE_EW)) && !(properties & DB_PROP_RT_OBLIVIOUS));
+}
+
+/**
+ * @brief Check if a proxy fetch may ask for a lease
+ */
+static bool isAcquireCacheable(u32 properties, u32 edtSlot) {
+    ocrDbAccessMode_t mode = (properties & DB_ACCESS_MODE_MASK);
+    //BUG #190: blocking acquires are kept out of it
+    return (HCDIST_PROXY_DB_CACHE > 0) && ((mode == DB_MODE_RO) || (mode == DB_MODE_CONST)) &&
+           !(properties & (DB_PROP_RT_ACQUIRE | DB_PROP_RT_OBLIVIOUS)) && (edtSlot != EDT_SLOT_NONE);
+}
+
+/**
+ * @brief Give the lease on a remote DB back, in a runtime EDT where the release can block
+ */
+static void proxyDbRecallLease(ocrPolicyDomain_t * pd, ocrGuid_t dbGuid) {
+    ocrPolicyMsg_t * msg = (ocrPolicyMsg_t *) pd->fcts.pdMalloc(pd, sizeof(ocrPolicyMsg_t));
+    initializePolicyMessage(msg, sizeof(ocrPolicyMsg_t));
+    getCurrentEnv(NULL, NULL, NULL, msg);
+#define PD_MSG (msg)
+#define PD_TYPE PD_MSG_DB_INVALIDATE
+    msg->type = PD_MSG_DB_INVALIDATE | PD_MSG_REQUEST;
+    PD_MSG_FIELD_I(guid.guid) = dbGuid;
+    PD_MSG_FIELD_I(guid.metaDataPtr) = NULL;
+    PD_MSG_FIELD_I(properties) = 0;
+#undef PD_MSG
+#undef PD_TYPE
+    ocrGuid_t processRequestTemplateGuid;
+    ocrEdtTemplateCreate(&processRequestTemplateGuid, &processRequestEdt, 1, 0);
+    u64 paramv = (u64) msg;
+    createProcessRequestEdtDistPolicy(pd, processRequestTemplateGuid, &paramv);
+    ocrEdtTemplateDestroy(processRequestTemplateGuid);
+}
+
+/**
+ * @brief Process a recall of the lease on a remote DB
+ * A cached copy is released right away, one in use is not cached by its last user.
+ */
+static void proxyDbInvalidate(ocrPolicyDomain_t * pd, ocrGuid_t dbGuid) {
+    ocrPolicyDomainHcDist_t * dself = (ocrPolicyDomainHcDist_t *) pd;
+    ProxyDb_t * proxyDb = getProxyDb(pd, dbGuid, false);
+    if (proxyDb == NULL) {
+        // The lease was given back already
+        return;
+    }
+    bool doRelease = false;
+    hal_lock32(&(proxyDb->lock));
+    switch(proxyDb->state) {
+        case PROXY_DB_CACHED:
+            // Check in as the user giving the lease back
+            proxyDb->state = PROXY_DB_RUN;
+            proxyDb->nbUsers = 1;
+            proxyDb->recalled = true;
+            hal_xadd32(&(dself->proxyDbCachedCount), -1);
+            doRelease = true;
+        break;
+        case PROXY_DB_FETCH:
+        case PROXY_DB_RUN:
+            proxyDb->recalled = true;
+        break;
+        default:
+            // The lease was given back already
+        break;
+    }
+    hal_unlock32(&(proxyDb->lock));
+    relProxyDb(pd, proxyDb);
+    if (doRelease) {
+        DPRINTF(DEBUG_LVL_VVERB,"DB_INVALIDATE: release cached DB GUID "GUIDF"\n", GUIDA(dbGuid));
+        hal_xadd64(&(dself->proxyDbCacheInvalidations), 1);
+        PD_MSG_STACK(msg);
+        getCurrentEnv(NULL, NULL, NULL, &msg);
+#define PD_MSG (&msg)
+#define PD_TYPE PD_MSG_DB_RELEASE
+        msg.type = PD_MSG_DB_RELEASE | PD_MSG_REQUEST | PD_MSG_REQ_RESPONSE;
+        PD_MSG_FIELD_IO(guid.guid) = dbGuid;
+        PD_MSG_FIELD_IO(guid.metaDataPtr) = NULL;
+        PD_MSG_FIELD_I(edt.guid) = NULL_GUID;
+        PD_MSG_FIELD_I(edt.metaDataPtr) = NULL;
+        PD_MSG_FIELD_I(ptr) = NULL;
+        PD_MSG_FIELD_I(size) = 0;
+        PD_MSG_FIELD_I(properties) = 0;
+        RESULT_ASSERT(pd->fcts.processMessage(pd, &msg, true), ==, 0);
+#undef PD_MSG
+#undef PD_TYPE
+    }
+}
+
 void getTemplateParamcDepc(ocrPolicyDomain_t * self, ocrFatGuid_t * fatGuid, u32 * paramc, u32 * depc) {
     // Need to deguidify the edtTemplate to know how many elements we're really expecting
     self->guidProviders[0]->fcts.getVal(self->guidProviders[0], fatGuid->guid,
@@ -689,6 +1106,9 @@ u8 hcDistProcessMessage(ocrPolicyDomain_t *self, ocrPolicyMsg_t *msg, u8 isBlock
     //hint, it is then used to potentially decide on a different destination.
     ocrLocation_t curLoc = self->myLocation;
     u32 properties = 0;
+    // Set for an acquire of a local DB that recalled the leases on it
+    bool writerAcquire = false;
+    ocrGuid_t writerDbGuid = NULL_GUID;
 
 #ifdef PLACER_LEGACY //BUG #476 - This code is being deprecated
     // Try to automatically place datablocks and edts. Only support naive PD-based placement for now.
@@ -931,6 +1351,23 @@ u8 hcDistProcessMessage(ocrPolicyDomain_t *self, ocrPolicyMsg_t *msg, u8 isBlock
         RETRIEVE_LOCATION_FROM_GUID_MSG(self, msg->destLocation, I);
         DPRINTF(DEBUG_LVL_VVERB, "DB_DESTROY: target is %"PRId32"\n", (u32)msg->destLocation);
 #undef PD_MSG
+#undef PD_TYPE
+        break;
+    }
+    case PD_MSG_DB_INVALIDATE:
+    {
+#define PD_MSG (msg)
+#define PD_TYPE PD_MSG_DB_INVALIDATE
+        // The destination is set by the owner PD recalling a lease
+        if (msg->destLocation == curLoc) {
+            DPRINTF(DEBUG_LVL_VVERB, "DB_INVALIDATE: recall of DB GUID "GUIDF"\n", GUIDA(PD_MSG_FIELD_I(guid.guid)));
+            proxyDbInvalidate(self, PD_MSG_FIELD_I(guid.guid));
+            msg->type &= ~PD_MSG_REQUEST;
+            msg->type |= PD_MSG_RESPONSE;
+            PD_MSG_FIELD_O(returnDetail) = 0;
+            PROCESS_MESSAGE_RETURN_NOW(self, 0);
+        }
+#undef PD_MSG
 #undef PD_TYPE
         break;
     }
@@ -940,6 +1377,10 @@ u8 hcDistProcessMessage(ocrPolicyDomain_t *self, ocrPolicyMsg_t *msg, u8 isBlock
 #define PD_TYPE PD_MSG_DB_FREE
         RETRIEVE_LOCATION_FROM_GUID_MSG(self, msg->destLocation, I);
         DPRINTF(DEBUG_LVL_VVERB, "DB_FREE: target is %"PRId32"\n", (u32)msg->destLocation);
+        if (msg->destLocation == curLoc) {
+            // Copies cached by other PDs hold the DB, recall them so that it can be destroyed
+            dbSharersRecall(self, PD_MSG_FIELD_I(guid.guid), false);
+        }
 #undef PD_MSG
 #undef PD_TYPE
         break;
@@ -1152,6 +1593,20 @@ u8 hcDistProcessMessage(ocrPolicyDomain_t *self, ocrPolicyMsg_t *msg, u8 isBlock
                         GUIDA(PD_MSG_FIELD_IO(guid.guid)), PD_MSG_FIELD_IO(properties));
                 // Fall-through to local processing
             }
+            if (msg->destLocation == curLoc) {
+                // Acquire of a local DB
+                if (isWriterAcquire(PD_MSG_FIELD_IO(properties))) {
+                    // Copies cached by other PDs hold the DB, recall them for the writer to get in
+                    writerAcquire = true;
+                    writerDbGuid = PD_MSG_FIELD_IO(guid.guid);
+                    dbSharersRecall(self, writerDbGuid, true);
+                } else if ((PD_MSG_FIELD_IO(properties) & DB_FLAG_RT_CACHE) &&
+                           !dbSharersAdd(self, PD_MSG_FIELD_IO(guid.guid), msg->srcLocation)) {
+                    DPRINTF(DEBUG_LVL_VVERB,"DB_ACQUIRE: lease refused for DB GUID "GUIDF", writer pending\n",
+                            GUIDA(PD_MSG_FIELD_IO(guid.guid)));
+                    PD_MSG_FIELD_IO(properties) &= ~DB_FLAG_RT_CACHE;
+                }
+            }
             if ((msg->srcLocation == curLoc) && (msg->destLocation != curLoc)) {
                 if (msg->type & PD_MSG_LOCAL_PROCESS) { //BUG #162 - This is a workaround until metadata cloning
                     DPRINTF(DEBUG_LVL_VVERB,"DB_ACQUIRE local processing: DB GUID "GUIDF"\n", GUIDA(PD_MSG_FIELD_IO(guid.guid)));
@@ -1166,8 +1621,36 @@ u8 hcDistProcessMessage(ocrPolicyDomain_t *self, ocrPolicyMsg_t *msg, u8 isBlock
                                 GUIDA(PD_MSG_FIELD_IO(guid.guid)), PD_MSG_FIELD_IO(properties));
                         // The proxy has just been created, need to fetch the DataBlock
                         PD_MSG_FIELD_IO(properties) |= DB_FLAG_RT_FETCH;
+                        if (isAcquireCacheable(PD_MSG_FIELD_IO(properties), PD_MSG_FIELD_IO(edtSlot))) {
+                            // Ask for the copy to be kept after the last local release
+                            PD_MSG_FIELD_IO(properties) |= DB_FLAG_RT_CACHE;
+                            hal_xadd64(&(((ocrPolicyDomainHcDist_t *) self)->proxyDbCacheMisses), 1);
+                        }
                         proxyDb->state = PROXY_DB_FETCH;
                     break;
+                    case PROXY_DB_CACHED:
+                        if (!proxyDb->recalled && isAcquireEligibleForProxy(proxyDb->mode, (PD_MSG_FIELD_IO(properties) & DB_ACCESS_MODE_MASK))) {
+                            // The lease is still valid, use the cached copy
+                            ocrPolicyDomainHcDist_t * dself = (ocrPolicyDomainHcDist_t *) self;
+                            proxyDb->state = PROXY_DB_RUN;
+                            hal_xadd32(&(dself->proxyDbCachedCount), -1);
+                            hal_xadd64(&(dself->proxyDbCacheHits), 1);
+                            //WARN: fall-through is intentional, 'PROXY_DB_RUN' grants the acquire
+                        } else {
+                            // The lease must be given back before the DB can be fetched again
+                            DPRINTF(DEBUG_LVL_VVERB,"DB_ACQUIRE: Outgoing request for DB GUID "GUIDF" with properties=0x%"PRIx32", recall cached copy\n",
+                                    GUIDA(PD_MSG_FIELD_IO(guid.guid)), PD_MSG_FIELD_IO(properties));
+                            bool doRecall = !proxyDb->recalled;
+                            proxyDb->recalled = true;
+                            enqueueAcquireMessageInProxy(self, proxyDb, msg);
+                            hal_unlock32(&(proxyDb->lock));
+                            relProxyDb(self, proxyDb);
+                            if (doRecall) {
+                                proxyDbRecallLease(self, PD_MSG_FIELD_IO(guid.guid));
+                            }
+                            PD_MSG_FIELD_O(returnDetail) = OCR_EBUSY;
+                            PROCESS_MESSAGE_RETURN_NOW(self, OCR_EPEND);
+                        }
                     case PROXY_DB_RUN:
                         // The DB is already in use locally
                         // Check if the acquire is compatible with the current usage
@@ -1213,6 +1696,14 @@ u8 hcDistProcessMessage(ocrPolicyDomain_t *self, ocrPolicyMsg_t *msg, u8 isBlock
             }
         } else { // DB_ACQUIRE response
             ASSERT(msg->type & PD_MSG_RESPONSE);
+            if ((msg->srcLocation == curLoc) && isWriterAcquire(PD_MSG_FIELD_IO(properties))) {
+                ocrLocation_t dbLoc;
+                RETRIEVE_LOCATION_FROM_GUID_MSG(self, dbLoc, IO)
+                if (dbLoc == curLoc) {
+                    // A writer that waited for a local DB got it
+                    dbSharersWriterDone(self, PD_MSG_FIELD_IO(guid.guid));
+                }
+            }
             if (!ocrGuidIsNull(PD_MSG_FIELD_IO(edt.guid))) {
                 RETRIEVE_LOCATION_FROM_MSG(self, edt, msg->destLocation, IO)
             } else {
@@ -1234,14 +1725,34 @@ u8 hcDistProcessMessage(ocrPolicyDomain_t *self, ocrPolicyMsg_t *msg, u8 isBlock
                         // Processing an acquire response issued in the fetch state
                         // Update message properties
                         PD_MSG_FIELD_IO(properties) &= ~DB_FLAG_RT_FETCH;
+                        // The owner PD granted a lease on the DB
+                        proxyDb->cacheable = !!(PD_MSG_FIELD_IO(properties) & DB_FLAG_RT_CACHE);
+                        PD_MSG_FIELD_IO(properties) &= ~DB_FLAG_RT_CACHE;
+                        // The comm-platform may hand over the DB's own pages when both PDs map them
+                        bool sharedPtr = !!(PD_MSG_FIELD_IO(properties) & DB_FLAG_RT_SHARED_PTR);
+                        PD_MSG_FIELD_IO(properties) &= ~DB_FLAG_RT_SHARED_PTR;
+                        // or a buffer it received the payload into, that becomes the proxy's copy
+                        bool ownedPtr = !!(PD_MSG_FIELD_IO(properties) & DB_FLAG_RT_RDV_PTR);
+                        PD_MSG_FIELD_IO(properties) &= ~DB_FLAG_RT_RDV_PTR;
                         //BUG #587 double check but I think we don't need the WB flag anymore since we have the mode
-                        bool doWriteBack = !((PD_MSG_FIELD_IO(properties) & DB_MODE_RO) || (PD_MSG_FIELD_IO(properties) & DB_MODE_CONST) ||
+                        bool doWriteBack = !sharedPtr &&
+                                           !((PD_MSG_FIELD_IO(properties) & DB_MODE_RO) || (PD_MSG_FIELD_IO(properties) & DB_MODE_CONST) ||
                                              (PD_MSG_FIELD_IO(properties) & DB_PROP_SINGLE_ASSIGNMENT));
                         if (doWriteBack) {
                             PD_MSG_FIELD_IO(properties) |= DB_FLAG_RT_WRITE_BACK;
                         }
-                        // Try to double check that across acquires the DB size do not change
-                        ASSERT((proxyDb->size != 0) ? (proxyDb->size == PD_MSG_FIELD_O(size)) : true);
+                        // DBs are not resizable but a retained proxy may outlive its DB and
+                        // the GUID be reused for another one (labeled GUIDs)
+                        if ((proxyDb->size != PD_MSG_FIELD_O(size)) && (proxyDb->ptr != NULL)) {
+                            if (!proxyDb->sharedPtr) {
+                                self->fcts.pdFree(self, proxyDb->ptr);
+                            }
+                            proxyDb->ptr = NULL;
+                            if (proxyDb->db != NULL) {
+                                self->dbFactories[0]->fcts.destruct(proxyDb->db);
+                                proxyDb->db = NULL;
+                            }
+                        }
 
                         DPRINTF(DEBUG_LVL_VVERB,"DB_ACQUIRE: caching data copy for DB GUID "GUIDF" size=%"PRIu64" \n",
                             GUIDA(PD_MSG_FIELD_IO(guid.guid)), PD_MSG_FIELD_O(size));
@@ -1253,22 +1764,37 @@ u8 hcDistProcessMessage(ocrPolicyDomain_t *self, ocrPolicyMsg_t *msg, u8 isBlock
                         proxyDb->mode = (PD_MSG_FIELD_IO(properties) & DB_ACCESS_MODE_MASK);
                         proxyDb->size = PD_MSG_FIELD_O(size);
                         proxyDb->flags = PD_MSG_FIELD_IO(properties);
-                        // Deserialize the data pointer from the message
-                        // The message ptr is set to the message payload but we need
-                        // to make a copy since the message will be deallocated later on.
                         void * newPtr = proxyDb->ptr; // See if we can reuse the old pointer
-                        if (newPtr == NULL) {
-                            newPtr = self->fcts.pdMalloc(self, proxyDb->size);
+                        if (sharedPtr || ownedPtr) {
+                            // Use the pointer in place, a private copy made by an earlier fetch is not needed anymore
+                            if ((newPtr != NULL) && !proxyDb->sharedPtr) {
+                                self->fcts.pdFree(self, newPtr);
+                            }
+                            newPtr = PD_MSG_FIELD_O(ptr);
+                        } else {
+                            // Deserialize the data pointer from the message
+                            // The message ptr is set to the message payload but we need
+                            // to make a copy since the message will be deallocated later on.
+                            if (proxyDb->sharedPtr) {
+                                newPtr = NULL; // Not ours to write into
+                            }
+                            if (newPtr == NULL) {
+                                newPtr = self->fcts.pdMalloc(self, proxyDb->size);
+                            }
+                            void * msgPayloadPtr = PD_MSG_FIELD_O(ptr);
+                            hal_memCopy(newPtr, msgPayloadPtr, proxyDb->size, false);
                         }
-                        void * msgPayloadPtr = PD_MSG_FIELD_O(ptr);
-                        hal_memCopy(newPtr, msgPayloadPtr, proxyDb->size, false);
                         proxyDb->ptr = newPtr;
+                        proxyDb->sharedPtr = sharedPtr;
                         // Update message to be consistent, but no calling context should need to read it.
                         PD_MSG_FIELD_O(ptr) = proxyDb->ptr;
                         if (proxyDb->db != NULL && !ocrGuidIsEq(proxyDb->db->guid, dbGuid)) {
                             self->dbFactories[0]->fcts.destruct(proxyDb->db);
                             proxyDb->db = NULL;
                         }
+                        if (proxyDb->db != NULL) {
+                            proxyDb->db->ptr = proxyDb->ptr;
+                        }
                         if (proxyDb->db == NULL) {
                             ocrFatGuid_t tGuid;
                             RESULT_ASSERT(self->dbFactories[0]->instantiate(
@@ -1380,6 +1906,15 @@ u8 hcDistProcessMessage(ocrPolicyDomain_t *self, ocrPolicyMsg_t *msg, u8 isBlock
             DPRINTF(DEBUG_LVL_VVERB,"DB_RELEASE outgoing request send for DB GUID "GUIDF"\n", GUIDA(PD_MSG_FIELD_IO(guid.guid)));
             // Outgoing release request
             ProxyDb_t * proxyDb = getProxyDb(self, PD_MSG_FIELD_IO(guid.guid), false);
+            if (proxyDb != NULL) {
+                hal_lock32(&(proxyDb->lock)); // lock the db
+                if ((proxyDb->state == PROXY_DB_CREATED) || (proxyDb->state == PROXY_DB_CACHED)) {
+                    // Retained, reset or cached proxy, the DB is not used in this PD
+                    hal_unlock32(&(proxyDb->lock));
+                    relProxyDb(self, proxyDb);
+                    proxyDb = NULL;
+                }
+            }
             if (proxyDb == NULL) {
                 // This is VERY likely an error in the user-code where the DB is released twice by the same EDT.
                 DPRINTF(DEBUG_LVL_WARN,"Detected multiple release for DB "GUIDF" by EDT "GUIDF"\n", GUIDA(PD_MSG_FIELD_IO(guid.guid)), GUIDA(PD_MSG_FIELD_I(edt.guid)));
@@ -1391,12 +1926,34 @@ u8 hcDistProcessMessage(ocrPolicyDomain_t *self, ocrPolicyMsg_t *msg, u8 isBlock
                 PD_MSG_FIELD_O(returnDetail) = 0;
                 PROCESS_MESSAGE_RETURN_NOW(self, OCR_EACCES);
             }
-            hal_lock32(&(proxyDb->lock)); // lock the db
             switch(proxyDb->state) {
                 case PROXY_DB_RUN:
+                    if ((proxyDb->nbUsers == 1) && proxyDb->cacheable && !proxyDb->recalled && queueIsEmpty(proxyDb->acquireQueue) &&
+                        ((((ocrPolicyDomainHcDist_t *) self)->proxyDbCachedCount + 1) <= HCDIST_PROXY_DB_CACHE)) {
+                        // Last checked-in user of the proxy DB in this PD, keep the lease
+                        DPRINTF(DEBUG_LVL_VVERB,"DB_RELEASE outgoing request for DB GUID "GUIDF" intercepted, caching proxy DB\n",
+                            GUIDA(PD_MSG_FIELD_IO(guid.guid)));
+                        proxyDb->state = PROXY_DB_CACHED;
+                        proxyDb->nbUsers = 0;
+                        hal_xadd32(&(((ocrPolicyDomainHcDist_t *) self)->proxyDbCachedCount), 1);
+                        // fill in response message
+                        msg->type &= ~PD_MSG_REQUEST;
+                        msg->type &= ~PD_MSG_REQ_RESPONSE;
+                        msg->type |= PD_MSG_RESPONSE;
+                        msg->srcLocation = curLoc;
+                        msg->destLocation = curLoc;
+                        PD_MSG_FIELD_O(returnDetail) = 0;
+                        hal_unlock32(&(proxyDb->lock));
+                        relProxyDb(self, proxyDb);
+                        PROCESS_MESSAGE_RETURN_NOW(self, 0); // bypass local processing
+                    }
                     if (proxyDb->nbUsers == 1) {
                         // Last checked-in user of the proxy DB in this PD
                         proxyDb->state = PROXY_DB_RELINQUISH;
+                        if (proxyDb->cacheable) {
+                            // Let the owner PD know the lease is given back
+                            PD_MSG_FIELD_I(properties) |= DB_FLAG_RT_CACHE;
+                        }
                         DPRINTF(DEBUG_LVL_VVERB,"DB_RELEASE outgoing request send for DB GUID "GUIDF" with WB=%"PRId32"\n",
                             GUIDA(PD_MSG_FIELD_IO(guid.guid)), !!(proxyDb->flags & DB_FLAG_RT_WRITE_BACK));
                         if (proxyDb->flags & DB_FLAG_RT_WRITE_BACK) {
@@ -1466,6 +2023,10 @@ u8 hcDistProcessMessage(ocrPolicyDomain_t *self, ocrPolicyMsg_t *msg, u8 isBlock
             PD_MSG_FIELD_IO(guid.metaDataPtr) = (void *) val;
             DPRINTF(DEBUG_LVL_VVERB,"DB_RELEASE incoming request received for DB GUID "GUIDF" WB=%"PRId32"\n",
                     GUIDA(PD_MSG_FIELD_IO(guid.guid)), !!(PD_MSG_FIELD_I(properties) & DB_FLAG_RT_WRITE_BACK));
+            if (PD_MSG_FIELD_I(properties) & DB_FLAG_RT_CACHE) {
+                dbSharersRemove(self, PD_MSG_FIELD_IO(guid.guid), msg->srcLocation);
+                PD_MSG_FIELD_I(properties) &= ~DB_FLAG_RT_CACHE;
+            }
             //BUG #587 db: We may want to double check this writeback (first one) is legal wrt single assignment
             if (PD_MSG_FIELD_I(properties) & DB_FLAG_RT_WRITE_BACK) {
                 // Unmarshall and write back
@@ -1476,6 +2037,12 @@ u8 hcDistProcessMessage(ocrPolicyDomain_t *self, ocrPolicyMsg_t *msg, u8 isBlock
                 void * localData = acquireLocalDbOblivious(self, PD_MSG_FIELD_IO(guid.guid));
                 ASSERT(localData != NULL);
                 hal_memCopy(localData, data, size, false);
+                if (PD_MSG_FIELD_I(properties) & DB_FLAG_RT_RDV_PTR) {
+                    // The comm-platform received the data out of the message
+                    PD_MSG_FIELD_I(properties) &= ~DB_FLAG_RT_RDV_PTR;
+                    self->fcts.pdFree(self, data);
+                    PD_MSG_FIELD_I(ptr) = NULL;
+                }
                 //BUG #607 DB RO mode: We do not release here because we've been using this
                 // special mode to do the write back. the release happens in the fall-through
             } // else fall-through and do the regular release
@@ -1666,7 +2233,7 @@ u8 hcDistProcessMessage(ocrPolicyDomain_t *self, ocrPolicyMsg_t *msg, u8 isBlock
 #define PD_MSG (response)
 #define PD_TYPE PD_MSG_DB_CREATE
                 ocrGuid_t dbGuid = PD_MSG_FIELD_IO(guid.guid);
-                ProxyDb_t * proxyDb = createProxyDb(self);
+                ProxyDb_t * proxyDb = createProxyDb(self, dbGuid);
                 proxyDb->state = PROXY_DB_RUN;
                 proxyDb->nbUsers = 1; // self
                 proxyDb->refCount = 0; // ref hasn't been shared yet so '0' is fine.
@@ -1682,12 +2249,9 @@ u8 hcDistProcessMessage(ocrPolicyDomain_t *self, ocrPolicyMsg_t *msg, u8 isBlock
                 proxyDb->ptr =  self->fcts.pdMalloc(self, PD_MSG_FIELD_IO(size)); //BUG #273
                 // Preset the writeback flag: even single assignment needs to be written back the first time.
                 proxyDb->flags = (PD_MSG_FIELD_IO(properties) | DB_FLAG_RT_WRITE_BACK); //BUG #273
-                // double check there's no proxy registered for the same DB
-                u64 val;
-                self->guidProviders[0]->fcts.getVal(self->guidProviders[0], dbGuid, &val, NULL);
-                ASSERT(val == 0);
-                // Do the actual registration
-                self->guidProviders[0]->fcts.registerGuid(self->guidProviders[0], dbGuid, (u64) proxyDb);
+                // Do the actual registration, there must not be a proxy for the same DB
+                RESULT_ASSERT(hashtableConcResizableTryPut(((ocrPolicyDomainHcDist_t *) self)->proxyDbMap,
+                                                           PROXY_DB_KEY(dbGuid), proxyDb), ==, proxyDb);
                 // Update message with proxy DB ptr
                 PD_MSG_FIELD_O(ptr) = proxyDb->ptr;
                 ASSERT(proxyDb->db == NULL);
@@ -1718,27 +2282,45 @@ u8 hcDistProcessMessage(ocrPolicyDomain_t *self, ocrPolicyMsg_t *msg, u8 isBlock
                     // The release having occurred, the proxy's metadata is invalid.
                     if (queueIsEmpty(proxyDb->acquireQueue)) {
                         // There are no pending acquire for this DB, try to deallocate the proxy.
-                        hal_lock32(&((ocrPolicyDomainHcDist_t *) self)->lockDbLookup);
+                        ocrPolicyDomainHcDist_t * dself = (ocrPolicyDomainHcDist_t *) self;
+                        u32 * lock = proxyDbLock(dself, dbGuid);
+                        hal_lock32(lock);
                         // Here nobody else can acquire a reference on the proxy
-                        if (proxyDb->refCount == 1) {
+                        if ((proxyDb->refCount == 1) && (HCDIST_PROXY_DB_RETAIN == 0)) {
                             DPRINTF(DEBUG_LVL_VVERB,"DB_RELEASE response received for DB GUID "GUIDF", destroy proxy\n", GUIDA(dbGuid));
-                            // Removes the entry for the proxy DB in the GUID provider
-                            self->guidProviders[0]->fcts.unregisterGuid(self->guidProviders[0], dbGuid, (u64) 0);
+                            // Removes the entry for the proxy DB in the proxy table
+                            RESULT_ASSERT(hashtableConcResizableRemove(dself->proxyDbMap, PROXY_DB_KEY(dbGuid), NULL), ==, true);
                             // Nobody else can get a reference on the proxy's lock now
-                            hal_unlock32(&((ocrPolicyDomainHcDist_t *) self)->lockDbLookup);
+                            hal_unlock32(lock);
                             // Deallocate the proxy DB and the cached ptr
                             // NOTE: we do not unlock proxyDb->lock not call relProxyDb
                             // since we're destroying the whole proxy and we're the last user.
                             ASSERT(proxyDb->db != NULL);
-                            self->dbFactories[0]->fcts.destruct(proxyDb->db);
-                            self->fcts.pdFree(self, proxyDb->ptr);
-                            if (proxyDb->acquireQueue != NULL) {
-                                self->fcts.pdFree(self, proxyDb->acquireQueue);
+                            destructProxyDb(self, proxyDb);
+                        } else if (proxyDb->refCount == 1) {
+                            // Keep the unused proxy, its buffer and metadata are reused if the
+                            // DB is acquired again before the proxy gets evicted.
+                            DPRINTF(DEBUG_LVL_VVERB,"DB_RELEASE response received for DB GUID "GUIDF", retain proxy\n", GUIDA(dbGuid));
+                            resetProxyDb(proxyDb);
+                            hal_lock32(&(dself->lockProxyDbLru));
+                            proxyDb->retained = true;
+                            proxyDb->lruPrev = NULL;
+                            proxyDb->lruNext = dself->proxyDbLruHead;
+                            if (dself->proxyDbLruHead != NULL) {
+                                dself->proxyDbLruHead->lruPrev = proxyDb;
+                            } else {
+                                dself->proxyDbLruTail = proxyDb;
                             }
-                            self->fcts.pdFree(self, proxyDb);
+                            dself->proxyDbLruHead = proxyDb;
+                            dself->proxyDbLruCount++;
+                            hal_unlock32(&(dself->lockProxyDbLru));
+                            hal_unlock32(&(proxyDb->lock));
+                            relProxyDb(self, proxyDb);
+                            hal_unlock32(lock);
+                            proxyDbLruEvict(self);
                         } else {
                             // Not deallocating the proxy then allow others to grab a reference
-                            hal_unlock32(&((ocrPolicyDomainHcDist_t *) self)->lockDbLookup);
+                            hal_unlock32(lock);
                             // Else no pending acquire enqueued but someone already got a reference
                             // to the proxyDb, repurpose the proxy for a new fetch
                             // Resetting the state to created means the any concurrent acquire
@@ -1945,6 +2527,11 @@ u8 hcDistProcessMessage(ocrPolicyDomain_t *self, ocrPolicyMsg_t *msg, u8 isBlock
         // store any pointers read from the request message
         ret = pdSelfDist->baseProcessMessage(self, msg, isBlocking);
 
+        if (writerAcquire && (ret != OCR_EPEND)) {
+            // The writer got the DB without waiting
+            dbSharersWriterDone(self, writerDbGuid);
+        }
+
         // Here, 'msg' content has potentially changed if a response was required
         // If msg's destination is not the current location anymore, it means we were
         // processing an incoming request from another PD. Send the response now.
@@ -2066,6 +2653,8 @@ u8 hcDistPdSwitchRunlevel(ocrPolicyDomain_t *self, ocrRunlevel_t runlevel, u32 p
         if (properties & RL_BRING_UP) {
             if (runlevel == RL_GUID_OK) {
                 dself->proxyTplMap = newHashtableModulo(self, 10);
+                dself->proxyDbMap = newHashtableResizableModulo(self, 64);
+                dself->dbSharersMap = newHashtableResizableModulo(self, 64);
             }
             if (runlevel == RL_CONFIG_PARSE) {
                 // In distributed the shutdown protocol requires three phases
@@ -2075,6 +2664,20 @@ u8 hcDistPdSwitchRunlevel(ocrPolicyDomain_t *self, ocrRunlevel_t runlevel, u32 p
                 // Because we want to keep the computation worker implementation more generic
                 // we request phases directly from here through the coalesced number of phases at slot 0.
                 RL_ENSURE_PHASE_DOWN(self, RL_USER_OK, 0, 3);
+                // Each comm-worker drives its own comm-platform instance (lane).
+                // They come first and use the commApi of the same index.
+                u32 laneCount = 0;
+                while ((laneCount < self->workerCount) &&
+                       (((ocrWorkerHc_t *) self->workers[laneCount])->hcType == HC_WORKER_COMM)) {
+                    laneCount++;
+                }
+                ASSERT((laneCount > 0) && (laneCount < self->workerCount) && (laneCount <= self->commApiCount));
+                u32 i;
+                for (i = 0; i < laneCount; ++i) {
+                    self->commApis[i]->commPlatform->laneId = i;
+                    self->commApis[i]->commPlatform->laneCount = laneCount;
+                }
+                dself->commWorkerCount = laneCount;
             }
         } else {
             ASSERT(properties & RL_TEAR_DOWN);
@@ -2082,6 +2685,14 @@ u8 hcDistPdSwitchRunlevel(ocrPolicyDomain_t *self, ocrRunlevel_t runlevel, u32 p
                 // The template map should be empty. Do not check, because this
                 // data-structure should go away with #536 GUID metadata
                 destructHashtable(dself->proxyTplMap, NULL, NULL);
+                proxyDbCacheDump(self);
+                // Only retained and cached proxies should be left at this point
+                dself->proxyDbLruHead = NULL;
+                dself->proxyDbLruTail = NULL;
+                dself->proxyDbLruCount = 0;
+                destructHashtableResizable(dself->proxyDbMap, proxyDbDealloc, self);
+                // Leases on DBs that were never destroyed
+                destructHashtableResizable(dself->dbSharersMap, dbSharersDealloc, self);
             }
 
         }
@@ -2097,6 +2708,15 @@ u8 hcDistPdSendMessage(ocrPolicyDomain_t* self, ocrLocation_t target, ocrPolicyM
     ASSERT(message->srcLocation == self->myLocation);
     ASSERT(message->destLocation != self->myLocation);
     u32 id = worker->id;
+    ocrPolicyDomainHcDist_t * dself = (ocrPolicyDomainHcDist_t *) self;
+    if ((id < dself->commWorkerCount) &&
+        (commPlatformLaneOf(self->myLocation, target, dself->commWorkerCount) != id)) {
+        // A comm-worker processing a message (e.g. shutdown notifications) talks
+        // to a PD another lane is in charge of: hand it over through the scheduler
+        // as a comp-worker would. Nobody would poll for a response on that lane.
+        ASSERT(handle == NULL);
+        id = dself->commWorkerCount;
+    }
     u8 ret = self->commApis[id]->fcts.sendMessage(self->commApis[id], target, message, handle, properties);
     return ret;
 }
@@ -2149,9 +2769,26 @@ void initializePolicyDomainHcDist(ocrPolicyDomainFactory_t * factory,
     ocrPolicyDomainHcDist_t * hcDistPd = (ocrPolicyDomainHcDist_t *) self;
     hcDistPd->baseProcessMessage = derivedFactory->baseProcessMessage;
     hcDistPd->baseSwitchRunlevel = derivedFactory->baseSwitchRunlevel;
-    hcDistPd->lockDbLookup = 0;
+    hcDistPd->proxyDbMap = NULL;
+    u32 i;
+    for (i = 0; i < HCDIST_PROXY_DB_NB_LOCKS; i++) {
+        hcDistPd->proxyDbLock[i] = 0;
+    }
+    hcDistPd->lockProxyDbLru = 0;
+    hcDistPd->proxyDbLruCount = 0;
+    hcDistPd->proxyDbLruHead = NULL;
+    hcDistPd->proxyDbLruTail = NULL;
+    hcDistPd->proxyDbCachedCount = 0;
+    hcDistPd->proxyDbCacheHits = 0;
+    hcDistPd->proxyDbCacheMisses = 0;
+    hcDistPd->proxyDbCacheInvalidations = 0;
+    hcDistPd->dbSharersMap = NULL;
+    for (i = 0; i < HCDIST_PROXY_DB_NB_LOCKS; i++) {
+        hcDistPd->dbSharersLock[i] = 0;
+    }
     hcDistPd->lockTplLookup = 0;
     hcDistPd->shutdownAckCount = 0;
+    hcDistPd->commWorkerCount = 1;
 }
 
 static void destructPolicyDomainFactoryHcDist(ocrPolicyDomainFactory_t * factory) {
@@ -19,13 +19,45 @@
 /* OCR-HC DISTRIBUTED POLICY DOMAIN                   */
 /******************************************************/
 
+// Number of locks serializing lookups and removals of proxies for remote DBs
+#ifndef HCDIST_PROXY_DB_NB_LOCKS
+#define HCDIST_PROXY_DB_NB_LOCKS 64
+#endif
+
+// Number of unused proxies for remote DBs kept around (along with their
+// data buffer) for subsequent acquires of the same DBs. 0 disables retention.
+#ifndef HCDIST_PROXY_DB_RETAIN
+#define HCDIST_PROXY_DB_RETAIN 128
+#endif
+
+// Number of remote DBs a PD may keep a read-only copy of once their last
+// local user is done with them. The owner PD recalls the copy before letting
+// a writer in or destroying the DB. 0 disables caching.
+#ifndef HCDIST_PROXY_DB_CACHE
+#define HCDIST_PROXY_DB_CACHE 64
+#endif
+
+struct _ProxyDb_t;
+
 typedef struct {
     ocrPolicyDomainHc_t base;
     u8 (*baseProcessMessage)(struct _ocrPolicyDomain_t *self, struct _ocrPolicyMsg_t *msg,
                              u8 isBlocking);
     u8 (*baseSwitchRunlevel)(struct _ocrPolicyDomain_t *self, ocrRunlevel_t, u32);
     u64 shutdownAckCount;
-    u32 lockDbLookup;  /**< Lock for querying proxies for remote DB */
+    u32 commWorkerCount; /**< Workers 0 to commWorkerCount-1 are comm-workers, one per lane */
+    hashtable_t * proxyDbMap; /**< Proxies for remote DB, keyed by DB GUID */
+    u32 proxyDbLock[HCDIST_PROXY_DB_NB_LOCKS]; /**< Serialize proxy creation and removal per key */
+    u32 lockProxyDbLru;  /**< Lock for the list of retained proxies */
+    u32 proxyDbLruCount;
+    struct _ProxyDb_t * proxyDbLruHead; /**< Most recently retained */
+    struct _ProxyDb_t * proxyDbLruTail; /**< Least recently retained, next to be evicted */
+    volatile u32 proxyDbCachedCount; /**< Proxies holding a read-only copy nobody uses */
+    u64 proxyDbCacheHits;          /**< Read-only acquires served by a cached copy */
+    u64 proxyDbCacheMisses;        /**< Read-only acquires that fetched the DB */
+    u64 proxyDbCacheInvalidations; /**< Cached copies given back */
+    hashtable_t * dbSharersMap; /**< PDs caching a local DB, keyed by DB GUID */
+    u32 dbSharersLock[HCDIST_PROXY_DB_NB_LOCKS]; /**< Serialize sharers updates per key */
     u32 lockTplLookup; /**< Lock for querying proxies for remote template */
     hashtable_t * proxyTplMap;
 } ocrPolicyDomainHcDist_t;
@@ -12,8 +12,11 @@
 #include "ocr-errors.h"
 #include "ocr-db.h"
 #include "extensions/ocr-hints.h"
+#include "ocr-mem-platform.h"
+#include "ocr-mem-target.h"
 #include "ocr-policy-domain.h"
 #include "ocr-policy-domain-tasks.h"
+#include "ocr-sal.h"
 #include "ocr-sysboot.h"
 #include "ocr-runtime-hints.h"
 
@@ -27,6 +30,14 @@
 
 #include "utils/profiler/profiler.h"
 
+#ifdef ENABLE_EDT_STATS
+#include "utils/edt-stats.h"
+#endif
+
+#ifdef ENABLE_SLAB_CACHE
+#include "utils/slab-cache.h"
+#endif
+
 #include "policy-domain/hc/hc-policy.h"
 #include "allocator/allocator-all.h"
 
@@ -38,8 +49,13 @@
 // Currently required to find out if self is the blessed PD
 #include "extensions/ocr-affinity.h"
 
+#include <stdlib.h>
+
 #define DEBUG_TYPE POLICY
 
+static void hcDbNumaInit(ocrPolicyDomain_t *self);
+static void hcDbNumaDump(ocrPolicyDomain_t *self);
+
 static u8 helperSwitchInert(ocrPolicyDomain_t *policy, ocrRunlevel_t runlevel, phase_t phase, u32 properties) {
     u64 i = 0;
     u64 maxCount = 0;
@@ -282,6 +298,35 @@ u8 hcPdSwitchRunlevel(ocrPolicyDomain_t *policy, ocrRunlevel_t runlevel, u32 pro
                     policy->workers[j], policy, runlevel, curPhase, j==0?masterWorkerProperties:properties, NULL, 0);
             }
         }
+        if(!toReturn && (properties & RL_BRING_UP)) {
+            hcDbNumaInit(policy);
+        }
+        if(properties & RL_TEAR_DOWN) {
+            hcDbNumaDump(policy);
+        }
+#ifdef ENABLE_SLAB_CACHE
+        if(!toReturn && (properties & RL_BRING_UP)) {
+            for(j = 0; j < maxCount; ++j) {
+                policy->workers[j]->slabCache = slabCacheCreate(policy);
+            }
+        }
+        if(properties & RL_TEAR_DOWN) {
+            // Modules free their objects while going down (the GUID providers
+            // empty their maps for instance) so the pages are only given back
+            // now. The allocators' memory is still there until RL_NETWORK_OK.
+            slabCacheDump(policy);
+            slabCache_t *caches[maxCount];
+            for(j = 0; j < maxCount; ++j) {
+                caches[j] = policy->workers[j]->slabCache;
+                policy->workers[j]->slabCache = NULL;
+            }
+            for(j = 0; j < maxCount; ++j) {
+                if(caches[j] != NULL) {
+                    slabCacheDestroy(policy, caches[j]);
+                }
+            }
+        }
+#endif
         if(toReturn) {
             DPRINTF(DEBUG_LVL_WARN, "RL_MEMORY_OK(%"PRId32") phase %"PRId32" failed: %"PRId32"\n", origProperties, curPhase, toReturn);
         }
@@ -332,6 +377,11 @@ u8 hcPdSwitchRunlevel(ocrPolicyDomain_t *policy, ocrRunlevel_t runlevel, u32 pro
                         policy->strandTables[PDSTT_COMM-1]);
                 toReturn |= pdInitializeStrandTable(policy, policy->strandTables[PDSTT_COMM-1], 0);
             }
+#ifdef ENABLE_EDT_STATS
+            for(j = 0; j < maxCount; ++j) {
+                policy->workers[j]->edtStats = edtStatsCreate(policy);
+            }
+#endif
 
             for(i = 0; i < phaseCount; ++i) {
                 if(toReturn) break;
@@ -353,6 +403,14 @@ u8 hcPdSwitchRunlevel(ocrPolicyDomain_t *policy, ocrRunlevel_t runlevel, u32 pro
                         policy->workers[j], policy, runlevel, i, j==0?masterWorkerProperties:properties, NULL, 0);
                 }
             }
+#ifdef ENABLE_EDT_STATS
+            // Workers are all done executing EDTs
+            edtStatsDump(policy);
+            for(j = 0; j < maxCount; ++j) {
+                edtStatsDestroy(policy, policy->workers[j]->edtStats);
+                policy->workers[j]->edtStats = NULL;
+            }
+#endif
             // At the end, we clear out the strand tables and free them.
             DPRINTF(DEBUG_LVL_VERB, "Emptying strand tables\n");
             RESULT_ASSERT(pdProcessStrands(policy, PDSTT_EMPTYTABLES), ==, 0);
@@ -386,6 +444,7 @@ u8 hcPdSwitchRunlevel(ocrPolicyDomain_t *policy, ocrRunlevel_t runlevel, u32 pro
                     policy->placer = createLocationPlacer(policy);
                     // Create and initialize the platform model (work in progress)
                     policy->platformModel = createPlatformModelAffinity(policy);
+                    toReturn |= hcEventFactoryCreateTemplates(policy->eventFactories[0], policy);
                 }
                 toReturn |= helperSwitchInert(policy, runlevel, i, masterWorkerProperties);
 
@@ -449,6 +508,8 @@ u8 hcPdSwitchRunlevel(ocrPolicyDomain_t *policy, ocrRunlevel_t runlevel, u32 pro
                         policy->workers[j], policy, runlevel, rself->rlSwitch.nextPhase, properties, NULL, 0);
                 }
 
+                toReturn |= hcEventFactoryDestroyTemplates(policy->eventFactories[0], policy);
+
                 //to be deprecated
                 destroyLocationPlacer(policy);
                 destroyPlatformModelAffinity(policy);
@@ -747,6 +808,100 @@ static void* allocateDatablock (ocrPolicyDomain_t *self,
     return NULL;
 }
 
+// Finds the NUMA node of each allocator's memory. Called once the allocators are up.
+static void hcDbNumaInit(ocrPolicyDomain_t *self) {
+    hcDbNumaPlacement_t *numa = &(((ocrPolicyDomainHc_t*)self)->dbNuma);
+    u64 i;
+    numa->nodeCount = 0;
+    numa->unboundAllocator = -1;
+    numa->nextNode = 0;
+    numa->missCount = 0;
+    for(i = 0; i < HC_DB_NUMA_MAX_NODES; ++i) {
+        numa->nodeAllocator[i] = -1;
+        numa->dbCount[i] = 0;
+        numa->dbBytes[i] = 0;
+    }
+    numa->unboundDbCount = 0;
+    numa->unboundDbBytes = 0;
+    for(i = 0; i < HC_DB_NUMA_MAX_ALLOCATORS; ++i) {
+        u32 node = MEM_PLATFORM_NUMA_NODE_NONE;
+        if(i < self->allocatorCount) {
+            ocrAllocator_t *allocator = self->allocators[i];
+            if((allocator->memoryCount != 0) && (allocator->memories[0]->memoryCount != 0)) {
+                node = allocator->memories[0]->memories[0]->numaNode;
+            }
+            if(node == MEM_PLATFORM_NUMA_NODE_NONE) {
+                if(numa->unboundAllocator == -1) {
+                    numa->unboundAllocator = (s8)i;
+                }
+            } else if(node >= HC_DB_NUMA_MAX_NODES) {
+                DPRINTF(DEBUG_LVL_WARN, "NUMA node %"PRIu32" of allocator %"PRIu64" is not supported, ignored\n", node, i);
+                node = MEM_PLATFORM_NUMA_NODE_NONE;
+            } else if(numa->nodeAllocator[node] == -1) {
+                numa->nodeAllocator[node] = (s8)i;
+                numa->nodes[numa->nodeCount++] = (u8)node;
+            }
+        }
+        numa->allocatorNode[i] = node;
+    }
+    DPRINTF(DEBUG_LVL_INFO, "Datablocks can be placed on %"PRIu32" NUMA nodes\n", numa->nodeCount);
+}
+
+// Returns the allocator to place a new DB with, -1 to follow the prescription
+static s32 hcDbNumaAllocator(ocrPolicyDomain_t *self, ocrHint_t *hint) {
+    hcDbNumaPlacement_t *numa = &(((ocrPolicyDomainHc_t*)self)->dbNuma);
+    if(numa->nodeCount == 0) {
+        return -1;
+    }
+    u64 node;
+    if((hint != NULL_HINT) && (ocrGetHintValue(hint, OCR_HINT_DB_NUMA_NODE, &node) == 0)) {
+        return (node < HC_DB_NUMA_MAX_NODES) ? numa->nodeAllocator[node] : -1;
+    }
+#if HC_DB_NUMA_PLACEMENT == HC_DB_NUMA_INTERLEAVE
+    node = numa->nodes[hal_xadd64(&(numa->nextNode), 1) % numa->nodeCount];
+    return numa->nodeAllocator[node];
+#elif HC_DB_NUMA_PLACEMENT == HC_DB_NUMA_FIRST_TOUCH
+    return numa->unboundAllocator;
+#else
+    u32 current;
+    if(!salGetCurrentNumaNode(&current) || (current >= HC_DB_NUMA_MAX_NODES)) {
+        return -1;
+    }
+    return numa->nodeAllocator[current];
+#endif
+}
+
+// Accounts for a DB of 'size' bytes allocated by allocator 'idx'
+static void hcDbNumaCount(ocrPolicyDomain_t *self, u64 idx, u64 size) {
+    hcDbNumaPlacement_t *numa = &(((ocrPolicyDomainHc_t*)self)->dbNuma);
+    u32 node = (idx < HC_DB_NUMA_MAX_ALLOCATORS) ? numa->allocatorNode[idx] : MEM_PLATFORM_NUMA_NODE_NONE;
+    if(node == MEM_PLATFORM_NUMA_NODE_NONE) {
+        hal_xadd64(&(numa->unboundDbCount), 1);
+        hal_xadd64(&(numa->unboundDbBytes), size);
+    } else {
+        hal_xadd64(&(numa->dbCount[node]), 1);
+        hal_xadd64(&(numa->dbBytes[node]), size);
+    }
+}
+
+// Prints the DBs allocated on each node if the OCR_NUMA_STATS environment variable is set
+static void hcDbNumaDump(ocrPolicyDomain_t *self) {
+    hcDbNumaPlacement_t *numa = &(((ocrPolicyDomainHc_t*)self)->dbNuma);
+    char *enabled = getenv("OCR_NUMA_STATS");
+    if((numa->nodeCount == 0) || (enabled == NULL) || (enabled[0] == '\0')) {
+        return;
+    }
+    u32 i;
+    PRINTF("Datablock NUMA placement for PD %"PRIu64"\n", (u64) self->myLocation);
+    PRINTF("node\tDBs\tKB\n");
+    for(i = 0; i < numa->nodeCount; ++i) {
+        u32 node = numa->nodes[i];
+        PRINTF("%"PRIu32"\t%"PRIu64"\t%"PRIu64"\n", node, numa->dbCount[node], numa->dbBytes[node] >> 10);
+    }
+    PRINTF("unbound\t%"PRIu64"\t%"PRIu64"\n", numa->unboundDbCount, numa->unboundDbBytes >> 10);
+    PRINTF("DBs not allocated on the node chosen: %"PRIu64"\n", numa->missCount);
+}
+
 static u8 hcMemUnAlloc(ocrPolicyDomain_t *self, ocrFatGuid_t* allocator,
                        void* ptr, ocrMemType_t memType);
 
@@ -762,8 +917,26 @@ static u8 hcAllocateDb(ocrPolicyDomain_t *self, ocrFatGuid_t *guid, void** ptr,
     // variable, which has been added to this argument list.  The prescription indicates an order in
     // which to attempt to allocate the block to a pool.
     u64 idx;
-    void *result = allocateDatablock (self, size, prescription, &idx);
+    void *result = NULL;
+    s32 numaIdx = hcDbNumaAllocator(self, hint);
+    if (numaIdx != -1) {
+        // Same attempts as the default prescription: slices first, then the whole pool
+        idx = (u64)numaIdx;
+        result = self->allocators[idx]->fcts.allocate(self->allocators[idx], size, OCR_ALLOC_HINT_REDUCE_CONTENTION);
+        if (result == NULL) {
+            result = self->allocators[idx]->fcts.allocate(self->allocators[idx], size, OCR_ALLOC_HINT_NONE);
+        }
+        if (result == NULL) {
+            hal_xadd64(&(((ocrPolicyDomainHc_t*)self)->dbNuma.missCount), 1);
+        }
+    }
+    if (result == NULL) {
+        result = allocateDatablock (self, size, prescription, &idx);
+    }
     if (result) {
+        if (((ocrPolicyDomainHc_t*)self)->dbNuma.nodeCount != 0) {
+            hcDbNumaCount(self, idx, size);
+        }
         u8 returnValue = 0;
         returnValue = self->dbFactories[0]->instantiate(
             self->dbFactories[0], guid, self->allocators[idx]->fguid, self->fguid,
@@ -781,6 +954,33 @@ static u8 hcAllocateDb(ocrPolicyDomain_t *self, ocrFatGuid_t *guid, void** ptr,
     }
 }
 
+#ifdef ENABLE_SLAB_CACHE
+// Returns the slab cache of the calling worker if it belongs to 'self'
+static inline slabCache_t * hcSlabCache(ocrPolicyDomain_t *self) {
+    ocrWorker_t *worker = NULL;
+    getCurrentEnv(NULL, &worker, NULL, NULL);
+    if((worker == NULL) || (worker->pd != self)) {
+        return NULL;
+    }
+    return worker->slabCache;
+}
+
+// Allocates from the calling worker's slab cache, NULL if the allocator must be used
+static inline void * hcSlabAlloc(ocrPolicyDomain_t *self, u64 size) {
+    slabCache_t *cache = hcSlabCache(self);
+    return (cache == NULL) ? NULL : slabCacheAlloc(cache, size);
+}
+
+// Frees 'addr' if it comes from a slab cache, returns false otherwise
+static inline bool hcSlabFree(ocrPolicyDomain_t *self, void *addr) {
+    if(!slabCacheOwns(addr)) {
+        return false;
+    }
+    slabCacheFree(hcSlabCache(self), addr);
+    return true;
+}
+#endif
+
 static u8 hcMemAlloc(ocrPolicyDomain_t *self, ocrFatGuid_t* allocator, u64 size,
                      ocrMemType_t memType, void** ptr, u64 prescription) {
     // Like hcAllocateDb, this function also allocates a data block.  But it does NOT guidify
@@ -792,6 +992,17 @@ static u8 hcMemAlloc(ocrPolicyDomain_t *self, ocrFatGuid_t* allocator, u64 size,
     void* result;
     u64 idx;
     ASSERT (memType == GUID_MEMTYPE || memType == DB_MEMTYPE);
+#ifdef ENABLE_SLAB_CACHE
+    // Runtime metadata (tasks, events...) comes from the worker's cache
+    if(memType == GUID_MEMTYPE) {
+        result = hcSlabAlloc(self, size);
+        if(result) {
+            *ptr = result;
+            *allocator = self->allocators[0]->fguid;
+            return 0;
+        }
+    }
+#endif
     result = allocateDatablock (self, size, prescription, &idx);
     if (result) {
         *ptr = result;
@@ -806,6 +1017,11 @@ static u8 hcMemAlloc(ocrPolicyDomain_t *self, ocrFatGuid_t* allocator, u64 size,
 static u8 hcMemUnAlloc(ocrPolicyDomain_t *self, ocrFatGuid_t* allocator,
                        void* ptr, ocrMemType_t memType) {
 #if 1
+#ifdef ENABLE_SLAB_CACHE
+    if(hcSlabFree(self, ptr)) {
+        return 0;
+    }
+#endif
     allocatorFreeFunction(ptr);
     return 0;
 #else
@@ -1115,6 +1331,9 @@ u8 hcPolicyDomainProcessMessage(ocrPolicyDomain_t *self, ocrPolicyMsg_t *msg, u8
             localDeguidify(self, &edtFGuid);
             // At this point the edt MUST be local as well as the acquire's message DB ptr
             ocrTask_t* task = (ocrTask_t*) edtFGuid.metaDataPtr;
+#ifdef ENABLE_EDT_STATS
+            task->dbBytes += PD_MSG_FIELD_O(size);
+#endif
             PD_MSG_FIELD_O(returnDetail) = self->taskFactories[0]->fcts.dependenceResolved(task, dbFGuid.guid, PD_MSG_FIELD_O(ptr), edtSlot);
         #undef PD_MSG
         #undef PD_TYPE
@@ -2297,6 +2516,11 @@ void* hcPdMalloc(ocrPolicyDomain_t *self, u64 size) {
 #else
     // Just try in the first allocator
     void* toReturn = NULL;
+#ifdef ENABLE_SLAB_CACHE
+    toReturn = hcSlabAlloc(self, size);
+    if(toReturn != NULL)
+        RETURN_PROFILE(toReturn);
+#endif
     toReturn = self->allocators[0]->fcts.allocate(self->allocators[0], size, 0);
     if(toReturn == NULL)
         DPRINTF(DEBUG_LVL_WARN, "Failed PDMalloc for size %"PRIx64"\n", size);
@@ -2311,6 +2535,10 @@ void hcPdFree(ocrPolicyDomain_t *self, void* addr) {
     // Just try in the first allocator
     free(addr);
 #else
+#ifdef ENABLE_SLAB_CACHE
+    if(hcSlabFree(self, addr))
+        RETURN_PROFILE();
+#endif
     // May result in leaks but better than the alternative...
     allocatorFreeFunction(addr);
 #endif
@@ -2348,6 +2576,8 @@ void initializePolicyDomainHc(ocrPolicyDomainFactory_t * factory, ocrPolicyDomai
 
     ocrPolicyDomainHc_t* derived = (ocrPolicyDomainHc_t*) self;
     derived->rlSwitch.legacySecondStart = false;
+    // Set up once the allocators are known (RL_MEMORY_OK)
+    derived->dbNuma.nodeCount = 0;
 }
 
 static void destructPolicyDomainFactoryHc(ocrPolicyDomainFactory_t * factory) {
@@ -37,10 +37,41 @@ typedef struct {
     volatile ocrGuid_t prevDb; //Previous DB used for sat.
 } hcPqrFlags;
 
+// NUMA placement of datablocks. It applies when some of the PD's allocators
+// sit on memory bound to a NUMA node (numa_alloc mem-platforms with a
+// 'numa_node'). OCR_HINT_DB_NUMA_NODE takes precedence over the policy.
+#define HC_DB_NUMA_LOCAL        0  // Node of the CPU the creating thread runs on
+#define HC_DB_NUMA_INTERLEAVE   1  // Round robin over the nodes
+#define HC_DB_NUMA_FIRST_TOUCH  2  // Memory not bound to a node: pages are placed where first written
+
+#ifndef HC_DB_NUMA_PLACEMENT
+#define HC_DB_NUMA_PLACEMENT HC_DB_NUMA_LOCAL
+#endif
+
+// Nodes and allocators considered (allocator indices are limited by the prescription)
+#define HC_DB_NUMA_MAX_NODES      64
+#define HC_DB_NUMA_MAX_ALLOCATORS 8
+
+typedef struct {
+    u32 nodeCount;                                  // Nodes with an allocator
+    u8 nodes[HC_DB_NUMA_MAX_NODES];                 // Those nodes
+    s8 nodeAllocator[HC_DB_NUMA_MAX_NODES];         // Allocator of each node, -1 if none
+    s8 unboundAllocator;                            // First allocator not bound to a node, -1 if none
+    u32 allocatorNode[HC_DB_NUMA_MAX_ALLOCATORS];   // Node of each allocator
+    volatile u64 nextNode;                          // Interleave position
+    // Statistics
+    volatile u64 dbCount[HC_DB_NUMA_MAX_NODES];     // DBs allocated on each node
+    volatile u64 dbBytes[HC_DB_NUMA_MAX_NODES];     // Bytes of DBs allocated on each node
+    volatile u64 unboundDbCount;                    // DBs allocated on memory not bound to a node
+    volatile u64 unboundDbBytes;
+    volatile u64 missCount;                         // DBs not allocated on the node chosen
+} hcDbNumaPlacement_t;
+
 typedef struct {
     ocrPolicyDomain_t base;
     pdHcResumeSwitchRL_t rlSwitch; // Used for asynchronous RL switch
     hcPqrFlags pqrFlags;
+    hcDbNumaPlacement_t dbNuma;
 } ocrPolicyDomainHc_t;
 
 typedef struct {
@@ -22,6 +22,14 @@ extern void salResume(u32 flag);
 
 extern void registerSignalHandler();
 
+extern void salFutexWait(volatile u32 * addr, u32 expected, u64 timeoutNs);
+
+extern void salFutexWake(volatile u32 * addr, u32 count);
+
+extern bool salGetCpuTopology(u32 cpu, u32 *coreId, u32 *llcId, u32 *packageId);
+
+extern bool salGetCurrentNumaNode(u32 *node);
+
 #define sal_abort()   hal_abort()
 
 #define sal_exit(x)   hal_exit(x)
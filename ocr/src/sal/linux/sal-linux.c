@@ -38,11 +38,102 @@ u64 salGetTime(){
 }
 #endif /*__MACH__*/
 
+#ifdef __linux__
+#include <linux/futex.h>
+#include <stdio.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/* Block while *addr == expected, at most timeoutNs (0 for no timeout).
+ * May return spuriously; callers must re-check their condition. */
+void salFutexWait(volatile u32 * addr, u32 expected, u64 timeoutNs) {
+    struct timespec ts;
+    ts.tv_sec = timeoutNs / 1000000000UL;
+    ts.tv_nsec = timeoutNs % 1000000000UL;
+    syscall(SYS_futex, (u32*)addr, FUTEX_WAIT_PRIVATE, expected,
+            (timeoutNs == 0) ? NULL : &ts, NULL, 0);
+}
+
+/* Wake up at most count threads blocked on addr */
+void salFutexWake(volatile u32 * addr, u32 count) {
+    syscall(SYS_futex, (u32*)addr, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+}
+
+/* Reads the first number in a sysfs file (an id, or the first CPU of a CPU list) */
+static bool readSysfsFirstU32(const char *path, u32 *value) {
+    FILE *f = fopen(path, "r");
+    if (f == NULL)
+        return false;
+    unsigned int v;
+    bool found = (fscanf(f, "%u", &v) == 1);
+    fclose(f);
+    *value = (u32)v;
+    return found;
+}
+
+/* Topology of 'cpu' as described in /sys/devices/system/cpu. Cores and
+ * last level caches are identified by the first CPU sharing them.
+ * Returns false if the information is not available. */
+bool salGetCpuTopology(u32 cpu, u32 *coreId, u32 *llcId, u32 *packageId) {
+    char path[128];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%"PRIu32"/topology/thread_siblings_list", cpu);
+    if (!readSysfsFirstU32(path, coreId))
+        return false;
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%"PRIu32"/topology/physical_package_id", cpu);
+    if (!readSysfsFirstU32(path, packageId))
+        return false;
+    // The last level cache is the one with the highest level
+    u32 i, level, maxLevel = 0;
+    *llcId = *coreId;
+    for (i = 0; ; ++i) {
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%"PRIu32"/cache/index%"PRIu32"/level", cpu, i);
+        if (!readSysfsFirstU32(path, &level))
+            break;
+        if (level > maxLevel) {
+            snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%"PRIu32"/cache/index%"PRIu32"/shared_cpu_list", cpu, i);
+            if (readSysfsFirstU32(path, llcId))
+                maxLevel = level;
+        }
+    }
+    return true;
+}
+
+/* NUMA node of the CPU the calling thread currently runs on */
+bool salGetCurrentNumaNode(u32 *node) {
+    unsigned int cpu, n;
+    if (syscall(SYS_getcpu, &cpu, &n, NULL) != 0)
+        return false;
+    *node = (u32)n;
+    return true;
+}
+
+#else
+#include "ocr-hal.h"
+
+void salFutexWait(volatile u32 * addr, u32 expected, u64 timeoutNs) {
+    hal_pause();
+}
+
+void salFutexWake(volatile u32 * addr, u32 count) {
+}
+
+bool salGetCpuTopology(u32 cpu, u32 *coreId, u32 *llcId, u32 *packageId) {
+    return false;
+}
+
+bool salGetCurrentNumaNode(u32 *node) {
+    return false;
+}
+#endif /*__linux__*/
+
 
 #ifdef ENABLE_EXTENSION_PAUSE
 
 #include <signal.h>
 #include "utils/pqr-utils.h"
+#ifdef ENABLE_EDT_STATS
+#include "utils/edt-stats.h"
+#endif
 
 /* NOTE: Below is an optional interface allowing users to
  *       send SIGUSR1 and SIGUSR2 to control pause/query/resume
@@ -125,6 +216,12 @@ ocrGuid_t salQuery(ocrQueryType_t query, ocrGuid_t guid, void **result, u32 *siz
     ocrPolicyDomainHc_t *self = (ocrPolicyDomainHc_t *) pd;
     ocrGuid_t dataDb = NULL_GUID;
 
+#ifdef ENABLE_EDT_STATS
+    // Statistics are merged on demand, no need to pause the workers
+    if(query == OCR_QUERY_EDT_STATS)
+        return edtStatsQuery(result, size);
+#endif
+
     if(self->pqrFlags.runtimePause == false)
         return NULL_GUID;
 
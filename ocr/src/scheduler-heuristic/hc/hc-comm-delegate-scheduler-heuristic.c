@@ -15,9 +15,13 @@
 #include "ocr-policy-domain.h"
 #include "ocr-runtime-types.h"
 #include "ocr-sysboot.h"
+#include "ocr-comm-platform.h"
 #include "ocr-workpile.h"
 #include "ocr-scheduler-object.h"
 #include "scheduler-heuristic/hc/hc-comm-delegate-scheduler-heuristic.h"
+#ifdef ENABLE_SCHEDULER_HEURISTIC_HC
+#include "scheduler-heuristic/hc/hc-scheduler-heuristic.h"
+#endif
 
 // To know about the type of handlers from delegate comm api
 #include "comm-api/delegate/delegate-comm-api.h"
@@ -40,6 +44,7 @@ static ocrSchedulerHeuristic_t* newSchedulerHeuristicHcCommDelegate(ocrScheduler
     dself->outboxes = NULL;
     dself->inboxesCount = 0;
     dself->inboxes = NULL;
+    dself->idleHeuristic = NULL;
     return self;
 }
 
@@ -52,6 +57,7 @@ static void initializeContextHcCommDelegate(ocrSchedulerHeuristicContext_t *cont
     ocrSchedulerHeuristicContextHcCommDelegate_t *hcContext = (ocrSchedulerHeuristicContextHcCommDelegate_t*)context;
     hcContext->stealSchedulerObjectIndex = ((u64)-1);
     hcContext->mySchedulerObject = NULL;
+    hcContext->stash = NULL;
     return;
 }
 
@@ -101,31 +107,41 @@ static u8 hcCommDelegateSchedulerHeuristicSwitchRunlevel(ocrSchedulerHeuristic_t
                 ocrSchedulerHeuristicContextHcCommDelegate_t *hcContext = (ocrSchedulerHeuristicContextHcCommDelegate_t*)context;
                 hcContext->stealSchedulerObjectIndex = ((u64)-1);
                 hcContext->mySchedulerObject = NULL;
+                hcContext->stash = NULL;
             }
             //Note: pd should have been set in base implementation
-            //Create outbox queues for each worker
-            u64 boxCount = PD->workerCount;
-            dself->outboxesCount = boxCount;
-            dself->outboxes = PD->fcts.pdMalloc(PD, sizeof(deque_t *) * boxCount);
-            for(i = 0; i < boxCount; ++i) {
-                dself->outboxes[i] = newDeque(PD, NULL, WORK_STEALING_DEQUE);
+            //Create an outbox per comm-worker. They come first among workers.
+            u64 laneCount = 0;
+            while ((laneCount < PD->workerCount) &&
+                   (((ocrWorkerHc_t *) PD->workers[laneCount])->hcType == HC_WORKER_COMM)) {
+                laneCount++;
+            }
+            ASSERT(laneCount > 0);
+            dself->outboxesCount = laneCount;
+            dself->outboxes = PD->fcts.pdMalloc(PD, sizeof(mpscQueue_t) * laneCount);
+            for(i = 0; i < laneCount; ++i) {
+                mpscQueueInit(&(dself->outboxes[i]));
             }
             //Create inbox queues for each worker
+            u64 boxCount = PD->workerCount;
             dself->inboxesCount = boxCount;
-            dself->inboxes = PD->fcts.pdMalloc(PD, sizeof(deque_t *) * boxCount);
+            dself->inboxes = PD->fcts.pdMalloc(PD, sizeof(mpscQueue_t) * boxCount);
             for(i = 0; i < boxCount; ++i) {
-                dself->inboxes[i] = newDeque(PD, NULL, SEMI_CONCURRENT_DEQUE);
+                mpscQueueInit(&(dself->inboxes[i]));
             }
         }
         if((properties & RL_TEAR_DOWN) && RL_IS_LAST_PHASE_DOWN(PD, RL_MEMORY_OK, phase)) {
             // deallocate all pdMalloc-ed structures
+#ifdef OCR_ASSERT
             u64 i;
             for(i = 0; i < dself->outboxesCount; ++i) {
-                dself->outboxes[i]->destruct(PD, dself->outboxes[i]);
+                ASSERT(mpscQueueIsEmpty(&(dself->outboxes[i])));
             }
             for(i = 0; i < dself->inboxesCount; ++i) {
-                dself->inboxes[i]->destruct(PD, dself->inboxes[i]);
+                ASSERT(mpscQueueIsEmpty(&(dself->inboxes[i])));
+                ASSERT(((ocrSchedulerHeuristicContextHcCommDelegate_t *) self->contexts[i])->stash == NULL);
             }
+#endif
             PD->fcts.pdFree(PD, dself->outboxes);
             PD->fcts.pdFree(PD, dself->inboxes);
             PD->fcts.pdFree(PD, self->contexts[0]);
@@ -137,7 +153,23 @@ static u8 hcCommDelegateSchedulerHeuristicSwitchRunlevel(ocrSchedulerHeuristic_t
         break;
     case RL_COMPUTE_OK:
     {
-        // Nothing to do
+#ifdef ENABLE_SCHEDULER_HEURISTIC_HC
+        if((properties & RL_BRING_UP) && RL_IS_FIRST_PHASE_UP(PD, RL_COMPUTE_OK, phase)) {
+            // Workers blocked on a response may be parked by the HC heuristic
+            // (or one built on it): find it to wake them up when it comes in
+            ocrSchedulerHeuristicHcCommDelegate_t * dself = (ocrSchedulerHeuristicHcCommDelegate_t *) self;
+            ocrScheduler_t * scheduler = self->scheduler;
+            u32 i;
+            for (i = 0; i < scheduler->schedulerHeuristicCount; i++) {
+                ocrSchedulerHeuristic_t * heuristic = scheduler->schedulerHeuristics[i];
+                if ((heuristic->fcts.getContext == hcSchedulerHeuristicGetContext) &&
+                    (heuristic->contextCount == self->contextCount)) {
+                    dself->idleHeuristic = heuristic;
+                    break;
+                }
+            }
+        }
+#endif
         break;
     }
     case RL_USER_OK:
@@ -183,90 +215,63 @@ static inline u8 hcCommDelegateWorkEdtUserInvoke(ocrSchedulerHeuristic_t *self,
     ocrFatGuid_t * fatHandlers = taskArgs->OCR_SCHED_ARG_FIELD(OCR_SCHED_WORK_COMM).guids;
     u32 count = taskArgs->OCR_SCHED_ARG_FIELD(OCR_SCHED_WORK_COMM).guidCount;
 
-    //TODO use context here
     if (((ocrWorkerHc_t *) worker)->hcType == HC_WORKER_COMM) {
-        // Steal from other worker's outbox
-        //PERF: use real randomized iterator here
-        // Try a round of stealing on other worker's outbox
-        //NOTE: If we don't care about wasting a steal on self, we wouldn't need
-        //      the whole worker ID business
-        //NOTE: It's debatable whether we should steal a bunch from each outbox
-        //      or go over all outboxes
-        deque_t ** outboxes = commSched->outboxes;
-        u64 outboxesCount = commSched->outboxesCount;
+        // Drain the outbox of the lane this comm-worker is in charge of.
+        // Any worker may be pushing to it concurrently.
+        ASSERT(wid < commSched->outboxesCount);
+        mpscQueue_t * outbox = &(commSched->outboxes[wid]);
         u32 success = 0;
-
-#ifdef HYBRID_COMM_COMP_WORKER // Experimental see documentation
-        // Try to pop from own outbox first (support HYBRID_COMM_COMP_WORKER mode)
-        ocrMsgHandle_t* handle = outboxes[wid]->popFromTail(outboxes[wid], 1);
-        if (handle != NULL) {
-            fatHandlers[success].metaDataPtr = handle;
-            success++;
-        }
-#endif
-        u64 i = (wid+1); // skip over 'self' outbox
-        while ((i < (wid+outboxesCount)) && (success < count)) {
-            deque_t * deque = outboxes[i%outboxesCount];
-            ocrMsgHandle_t* handle = deque->popFromHead(deque, 1);
-            if (handle != NULL) {
-                fatHandlers[success].metaDataPtr = handle;
-                success++;
+        while (success < count) {
+            mpscQueueNode_t * node = mpscQueuePop(outbox);
+            if (node == NULL) {
+                break;
             }
-            i++;
+            fatHandlers[success].metaDataPtr = DELEGATE_HANDLE_OF_NODE(node);
+            success++;
         }
         count = success;
     } else {
-        //BUG #586 Should really revisit this implementation. It sounds awfully slow.
         ASSERT(((ocrWorkerHc_t *) worker)->hcType == HC_WORKER_COMP);
-        deque_t * inbox = commSched->inboxes[wid];
+        ocrSchedulerHeuristicContextHcCommDelegate_t * hcContext = (ocrSchedulerHeuristicContextHcCommDelegate_t *) context;
+        mpscQueue_t * inbox = &(commSched->inboxes[wid]);
         u32 curIdx = 0;
-        linkedlist_t * candidateList = NULL;
         while(curIdx < count) {
             ocrMsgHandle_t ** target = (ocrMsgHandle_t **) fatHandlers[curIdx].metaDataPtr;
             bool isSpecificTarget = ((target != NULL) && (*target != NULL));
+            // Don't think we go through this but double check
+            ASSERT(isSpecificTarget && "comp-worker poll for any");
             ocrMsgHandle_t * candidate = NULL;
-            if (isSpecificTarget && (candidateList != NULL)) {
-                //Look through previous steals
-                iterator_t * iterator = candidateList->iterator(candidateList);
-                while (iterator->hasNext(iterator)) {
-                    ocrMsgHandle_t * handle = (ocrMsgHandle_t *) iterator->next(iterator);
-                    if (handle == *target) {
-                        // found a candidate in the previous steals
-                        candidate = handle;
-                        iterator->removeCurrent(iterator);
-                        fatHandlers[curIdx].metaDataPtr = candidate;
-                        curIdx++;
-                        break;
-                    }
+            // Look through handles previous takes came across. The stash is private
+            // to this worker: the inbox only ever holds responses to its own requests.
+            mpscQueueNode_t * volatile * prev = &(hcContext->stash);
+            while (*prev != NULL) {
+                if (!isSpecificTarget || ((ocrMsgHandle_t *) DELEGATE_HANDLE_OF_NODE(*prev) == *target)) {
+                    candidate = (ocrMsgHandle_t *) DELEGATE_HANDLE_OF_NODE(*prev);
+                    *prev = (*prev)->next;
+                    break;
                 }
-                iterator->destruct(iterator);
+                prev = &((*prev)->next);
             }
-            if (candidate == NULL) {
-                // 'steal' from own inbox, comm-worker pushes to it
-                candidate = (ocrMsgHandle_t *) inbox->popFromHead(inbox, 0);
-                if (candidate == NULL) {
-                    // No message available
+            // Pop from own inbox, comm-workers push to it
+            while (candidate == NULL) {
+                mpscQueueNode_t * node = mpscQueuePop(inbox);
+                if (node == NULL) {
                     break;
                 }
-                if (isSpecificTarget) {
-                    if (candidate != *target) {
-                        if (candidateList == NULL) {
-                            ocrPolicyDomain_t * pd = self->scheduler->pd;
-                            candidateList = newLinkedList(pd);
-                        }
-                        candidateList->pushFront(candidateList, candidate);
-                    } else {
-                        fatHandlers[curIdx].metaDataPtr = candidate;
-                        curIdx++;
-                    }
+                ocrMsgHandle_t * handle = (ocrMsgHandle_t *) DELEGATE_HANDLE_OF_NODE(node);
+                if (!isSpecificTarget || (handle == *target)) {
+                    candidate = handle;
                 } else {
-                    // Found a handle and none specific was required.
-                    // Don't think we go through this but double check
-                    ASSERT(false && "comp-worker poll for any");
-                    fatHandlers[curIdx].metaDataPtr = candidate;
-                    curIdx++;
+                    node->next = hcContext->stash;
+                    hcContext->stash = node;
                 }
             }
+            if (candidate == NULL) {
+                // No message available
+                break;
+            }
+            fatHandlers[curIdx].metaDataPtr = candidate;
+            curIdx++;
         }
         u32 i = curIdx;
         while (i < count) { // nullify remaining handlers
@@ -274,18 +279,6 @@ static inline u8 hcCommDelegateWorkEdtUserInvoke(ocrSchedulerHeuristic_t *self,
             i++;
         }
         count = curIdx;
-        if (candidateList != NULL) {
-            // Put stolen handles for which there's no interest back
-            iterator_t * iterator = candidateList->iterator(candidateList);
-            while (iterator->hasNext(iterator)) {
-                ocrMsgHandle_t * handle = (ocrMsgHandle_t *) iterator->next(iterator);
-                // Push is concurrent with comm-worker populating the inbox
-                inbox->pushAtTail(inbox, handle, 0);
-                iterator->removeCurrent(iterator);
-            }
-            iterator->destruct(iterator);
-            candidateList->destruct(candidateList);
-        }
     }
     taskArgs->OCR_SCHED_ARG_FIELD(OCR_SCHED_WORK_COMM).guidCount = count;
 
@@ -325,65 +318,39 @@ static inline u8 hcCommDelegateNotifyCommReadyInvoke(ocrSchedulerHeuristic_t *se
     ocrFatGuid_t * fatHandlers = &(notifyArgs->OCR_SCHED_ARG_FIELD(OCR_SCHED_NOTIFY_COMM_READY).guid);
     u32 count = 1;
 
-    ocrPolicyDomain_t * pd __attribute__((unused)) = self->scheduler->pd;
+    ocrPolicyDomain_t * pd = self->scheduler->pd;
     ocrSchedulerHeuristicHcCommDelegate_t * commSched = (ocrSchedulerHeuristicHcCommDelegate_t *) self;
     ocrWorker_t *worker = NULL;
     getCurrentEnv(NULL, &worker, NULL, NULL);
-    //BUG #204 sep-concern: Do we need a way to register worker types somehow ?
-    if (((ocrWorkerHc_t *) worker)->hcType == HC_WORKER_COMM) {
-        u32 i=0;
-        while (i < count) {
-            delegateMsgHandle_t* handle = (delegateMsgHandle_t *) fatHandlers[i].metaDataPtr;
-        #ifdef HYBRID_COMM_COMP_WORKER // Experimental see documentation
-            ocrPolicyMsg_t * message = (handle->handle.status == HDL_RESPONSE_OK) ? handle->handle.response : handle->handle.msg;
-            bool outgoingComm = (message->destLocation != pd->myLocation);
-            if (outgoingComm) {
-                // (support HYBRID_COMM_COMP_WORKER mode)
-                // The communication worker can process simple messages that
-                // are known to be short lived and are 'sterile' (i.e. do not generate
-                // new communication) beside responding to the message.
-                // In that case, the comm-worker should only be able to give outgoing responses to the scheduler
-                ASSERT(message->type & PD_MSG_RESPONSE);
-                // Push to the comm worker outbox
-                DPRINTF(DEBUG_LVL_VVERB,"[%"PRId32"] hc-comm-delegate-scheduler:: Comm-worker pushes outgoing to own outbox %"PRId32"\n",
-                    (int) pd->myLocation, worker->id);
-                deque_t * outbox = commSched->outboxes[worker->id];
-                outbox->pushAtTail(outbox, handle, 0);
-            } else {
-        #endif
-                // Comm-worker giving back to a worker's inbox
-                DPRINTF(DEBUG_LVL_VVERB,"[%"PRIu64"] hc-comm-delegate-scheduler:: Comm-worker pushes at tail of box %"PRIu64"\n",
-                    pd->myLocation, handle->boxId);
-                // Push is concurrent because the comp-worker may pushing/poping from inbox in parallel
-                deque_t * inbox = commSched->inboxes[handle->boxId];
-                inbox->pushAtTail(inbox, (ocrMsgHandle_t *) handle, 0);
-        #ifdef HYBRID_COMM_COMP_WORKER
-            }
-        #endif
-            i++;
-        }
-        count = i;
-    } else {
-        // Comp-worker giving a message to send
-        u32 i=0;
-        while (i < count) {
-            // Set delegate handle's box id.
-            delegateMsgHandle_t* delHandle = (delegateMsgHandle_t *) fatHandlers[i].metaDataPtr;
-#ifdef OCR_ASSERT
-            ocrPolicyMsg_t * message = (delHandle->handle.status == HDL_RESPONSE_OK) ? delHandle->handle.response : delHandle->handle.msg;
-            ASSERT((message->srcLocation == pd->myLocation) && (message->destLocation != pd->myLocation));
-#endif
+    u32 i=0;
+    while (i < count) {
+        delegateMsgHandle_t* delHandle = (delegateMsgHandle_t *) fatHandlers[i].metaDataPtr;
+        ocrPolicyMsg_t * message = (delHandle->handle.status == HDL_RESPONSE_OK) ? delHandle->handle.response : delHandle->handle.msg;
+        if (message->destLocation != pd->myLocation) {
+            // Message to send. Usually given by a comp-worker, although a comm-worker
+            // processing a message may also send to a PD another lane is in charge of.
+            ASSERT(message->srcLocation == pd->myLocation);
             //BUG #587: boxId is defined in del-handle however only the scheduler is using it
             delHandle->boxId = worker->id;
-            DPRINTF(DEBUG_LVL_VVERB,"[%"PRIu64"] hc-comm-delegate-scheduler:: Comp-worker pushes at tail of box %"PRIu64"\n",
+            u32 lane = commPlatformLaneOf(pd->myLocation, message->destLocation, commSched->outboxesCount);
+            DPRINTF(DEBUG_LVL_VVERB,"[%"PRIu64"] hc-comm-delegate-scheduler:: Worker %"PRIu64" pushes to outbox %"PRIu32"\n",
+                pd->myLocation, delHandle->boxId, lane);
+            mpscQueuePush(&(commSched->outboxes[lane]), &(delHandle->queueNode));
+        } else {
+            //BUG #204 sep-concern: Do we need a way to register worker types somehow ?
+            ASSERT(((ocrWorkerHc_t *) worker)->hcType == HC_WORKER_COMM);
+            // Comm-worker giving back to a worker's inbox
+            DPRINTF(DEBUG_LVL_VVERB,"[%"PRIu64"] hc-comm-delegate-scheduler:: Comm-worker pushes to inbox %"PRIu64"\n",
                 pd->myLocation, delHandle->boxId);
-            ASSERT((delHandle->boxId >= 0) && (delHandle->boxId < pd->workerCount));
-            // Put handle to worker's outbox
-            deque_t * outbox = commSched->outboxes[delHandle->boxId];
-            outbox->pushAtTail(outbox, (ocrMsgHandle_t *) delHandle, 0);
-            i++;
+            ASSERT(delHandle->boxId < commSched->inboxesCount);
+            mpscQueuePush(&(commSched->inboxes[delHandle->boxId]), &(delHandle->queueNode));
+#ifdef ENABLE_SCHEDULER_HEURISTIC_HC
+            // The worker may have parked while waiting for this response
+            if (commSched->idleHeuristic != NULL)
+                hcSchedulerHeuristicWakeWorker(commSched->idleHeuristic, delHandle->boxId);
+#endif
         }
-        count = i;
+        i++;
     }
 
     return 0;
@@ -14,8 +14,7 @@
 #include "ocr-types.h"
 #include "utils/ocr-utils.h"
 #include "ocr-scheduler-object.h"
-#include "utils/deque.h"
-#include "utils/list.h"
+#include "utils/mpsc-queue.h"
 
 /****************************************************/
 /* HC COMM DELEGATE SCHEDULER_HEURISTIC             */
@@ -26,6 +25,7 @@ typedef struct _ocrSchedulerHeuristicContextHcCommDelegate_t {
     ocrSchedulerHeuristicContext_t base;
     ocrSchedulerObject_t *mySchedulerObject;    // The deque owned by a specific worker (context)
     u64 stealSchedulerObjectIndex;              // Cached index of the deque lasted visited during steal attempts
+    mpscQueueNode_t * stash;                    // Handles popped from the inbox while looking for another one
 } ocrSchedulerHeuristicContextHcCommDelegate_t;
 
 typedef struct _hcCommDelWorkpileIterator_t {
@@ -35,10 +35,11 @@ typedef struct _hcCommDelWorkpileIterator_t {
 
 typedef struct _ocrSchedulerHeuristicHcCommDelegate_t {
     ocrSchedulerHeuristic_t base;
-    u64 outboxesCount;
-    deque_t ** outboxes;
-    u64 inboxesCount;
-    deque_t ** inboxes;
+    u64 outboxesCount;      // One per comm-worker (lane)
+    mpscQueue_t * outboxes; // Messages to send, drained by the lane's comm-worker
+    u64 inboxesCount;       // One per worker
+    mpscQueue_t * inboxes;  // Responses, filled by comm-workers
+    ocrSchedulerHeuristic_t * idleHeuristic; // HC heuristic parking idle workers, NULL if none
 } ocrSchedulerHeuristicHcCommDelegate_t;
 
 /****************************************************/
@@ -0,0 +1,234 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ *
+ * - A locality-aware scheduler heuristic for WST root schedulerObjects
+ *
+ */
+
+#include "ocr-config.h"
+#ifdef ENABLE_SCHEDULER_HEURISTIC_HC_LOCALITY
+
+#include "debug.h"
+#include "ocr-errors.h"
+#include "ocr-policy-domain.h"
+#include "ocr-runtime-types.h"
+#include "ocr-sysboot.h"
+#include "ocr-task.h"
+#include "ocr-workpile.h"
+#include "ocr-scheduler-object.h"
+#include "extensions/ocr-hints.h"
+#include "scheduler-heuristic/hc/hc-locality-scheduler-heuristic.h"
+#include "task/hc/hc-task.h"
+
+#define DEBUG_TYPE SCHEDULER_HEURISTIC
+
+COMPILE_ASSERT((HC_LOCALITY_WRITER_TABLE_SIZE & (HC_LOCALITY_WRITER_TABLE_SIZE - 1)) == 0);
+
+#define HC_LOCALITY_WORKER_BITS 16
+#define HC_LOCALITY_WORKER_MASK ((1ULL << HC_LOCALITY_WORKER_BITS) - 1)
+
+#if GUID_BIT_COUNT == 64
+#define HC_LOCALITY_KEY(dbGuid) ((u64) (dbGuid).guid)
+#elif GUID_BIT_COUNT == 128
+#define HC_LOCALITY_KEY(dbGuid) ((u64) (dbGuid).lower)
+#else
+#error Unknown type of GUID
+#endif
+
+/******************************************************/
+/* OCR-HC-LOCALITY SCHEDULER_HEURISTIC                */
+/******************************************************/
+
+ocrSchedulerHeuristic_t* newSchedulerHeuristicHcLocality(ocrSchedulerHeuristicFactory_t * factory, ocrParamList_t *perInstance) {
+    ocrSchedulerHeuristic_t* self = (ocrSchedulerHeuristic_t*) runtimeChunkAlloc(sizeof(ocrSchedulerHeuristicHcLocality_t), PERSISTENT_CHUNK);
+    initializeSchedulerHeuristicOcr(factory, self, perInstance);
+    ocrSchedulerHeuristicHcLocality_t *derived = (ocrSchedulerHeuristicHcLocality_t*)self;
+    derived->base.parkedCount = 0;
+    derived->base.wakeCursor = 0;
+    derived->writers = NULL;
+#ifdef OCR_DEBUG
+    derived->readyCount = 0;
+    derived->movedCount = 0;
+#endif
+    return self;
+}
+
+u8 hcLocalitySchedulerHeuristicSwitchRunlevel(ocrSchedulerHeuristic_t *self, ocrPolicyDomain_t *PD, ocrRunlevel_t runlevel,
+                                              phase_t phase, u32 properties, void (*callback)(ocrPolicyDomain_t*, u64), u64 val) {
+    u8 toReturn = hcSchedulerHeuristicSwitchRunlevel(self, PD, runlevel, phase, properties, callback, val);
+    ocrSchedulerHeuristicHcLocality_t *derived = (ocrSchedulerHeuristicHcLocality_t*)self;
+    if (runlevel == RL_PD_OK) {
+        // Worker ids must fit next to the tags in the writer table
+        ASSERT(self->contextCount < HC_LOCALITY_WORKER_MASK);
+    }
+    if (runlevel == RL_MEMORY_OK) {
+        if((properties & RL_BRING_UP) && RL_IS_FIRST_PHASE_UP(PD, RL_MEMORY_OK, phase)) {
+            u32 i;
+            derived->writers = (volatile u64 *)PD->fcts.pdMalloc(PD, HC_LOCALITY_WRITER_TABLE_SIZE * sizeof(u64));
+            for (i = 0; i < HC_LOCALITY_WRITER_TABLE_SIZE; i++) {
+                derived->writers[i] = 0;
+            }
+        }
+        if((properties & RL_TEAR_DOWN) && RL_IS_LAST_PHASE_DOWN(PD, RL_MEMORY_OK, phase)) {
+#ifdef OCR_DEBUG
+            DPRINTF(DEBUG_LVL_INFO, "%"PRIu64" of %"PRIu64" ready EDTs pushed to the last writer of their DB\n",
+                    derived->movedCount, derived->readyCount);
+#endif
+            PD->fcts.pdFree(PD, (void *)derived->writers);
+            derived->writers = NULL;
+        }
+    }
+    return toReturn;
+}
+
+static inline u32 writerIndex(u64 key) {
+    u64 hash = key * 0x9E3779B97F4A7C15ULL;
+    return (u32) (hash ^ (hash >> 32)) & (HC_LOCALITY_WRITER_TABLE_SIZE - 1);
+}
+
+/* Entries are single words so that racing updates cannot tear them */
+static void recordWriter(ocrSchedulerHeuristicHcLocality_t *derived, ocrGuid_t dbGuid, u64 workerId) {
+    u64 key = HC_LOCALITY_KEY(dbGuid);
+    derived->writers[writerIndex(key)] = (key << HC_LOCALITY_WORKER_BITS) | (workerId + 1);
+}
+
+/* Returns the last worker known to have written the DB or -1 */
+static u64 lookupWriter(ocrSchedulerHeuristicHcLocality_t *derived, ocrGuid_t dbGuid) {
+    u64 key = HC_LOCALITY_KEY(dbGuid);
+    u64 entry = derived->writers[writerIndex(key)];
+    if (((entry & ~HC_LOCALITY_WORKER_MASK) != (key << HC_LOCALITY_WORKER_BITS)) || ((entry & HC_LOCALITY_WORKER_MASK) == 0))
+        return ((u64)-1);
+    return (entry & HC_LOCALITY_WORKER_MASK) - 1;
+}
+
+/* Get work as HC does, then remember that the worker is about to write the
+ * DBs the EDT acquires in a writable mode */
+u8 hcLocalitySchedulerHeuristicGetWorkInvoke(ocrSchedulerHeuristic_t *self, ocrSchedulerOpArgs_t *opArgs, ocrRuntimeHint_t *hints) {
+    u8 retVal = hcSchedulerHeuristicGetWorkInvoke(self, opArgs, hints);
+    ocrSchedulerOpWorkArgs_t *taskArgs = (ocrSchedulerOpWorkArgs_t*)opArgs;
+    ocrFatGuid_t *fguid = &(taskArgs->OCR_SCHED_ARG_FIELD(OCR_SCHED_WORK_EDT_USER).edt);
+    if (ocrGuidIsNull(fguid->guid))
+        return retVal;
+    ocrPolicyDomain_t *pd = self->scheduler->pd;
+    if (fguid->metaDataPtr == NULL) {
+        pd->guidProviders[0]->fcts.getVal(pd->guidProviders[0], fguid->guid, (u64*)(&(fguid->metaDataPtr)), NULL);
+    }
+    ocrTask_t *task = (ocrTask_t*)fguid->metaDataPtr;
+    ASSERT(task);
+    ocrSchedulerHeuristicContext_t *context = self->fcts.getContext(self, opArgs->location);
+    ocrSchedulerHeuristicHcLocality_t *derived = (ocrSchedulerHeuristicHcLocality_t*)self;
+    ocrTaskHc_t *hcTask = (ocrTaskHc_t*)task; //BUG #926:This is temporary until we get proper introspection support
+    ocrEdtDep_t *depv = hcTask->resolvedDeps;
+    u32 i;
+    for (i = 0; i < task->depc; i++) {
+        if ((depv[i].mode & (DB_MODE_RW | DB_MODE_EW)) && !(ocrGuidIsNull(depv[i].guid))) {
+            recordWriter(derived, depv[i].guid, context->id);
+        }
+    }
+    return retVal;
+}
+
+/* Push the EDT to the deque of the worker that last wrote its
+ * OCR_HINT_EDT_SLOT_MAX_ACCESS DB, to the current worker's otherwise */
+static u8 hcLocalitySchedulerHeuristicNotifyEdtReadyInvoke(ocrSchedulerHeuristic_t *self, ocrSchedulerHeuristicContext_t *context, ocrSchedulerOpArgs_t *opArgs, ocrRuntimeHint_t *hints) {
+    ocrSchedulerOpNotifyArgs_t *notifyArgs = (ocrSchedulerOpNotifyArgs_t*)opArgs;
+    ocrSchedulerHeuristicHcLocality_t *derived = (ocrSchedulerHeuristicHcLocality_t*)self;
+    ocrPolicyDomain_t *pd = self->scheduler->pd;
+    ocrFatGuid_t fguid = notifyArgs->OCR_SCHED_ARG_FIELD(OCR_SCHED_NOTIFY_EDT_READY).guid;
+    ocrTask_t *task = (ocrTask_t*)fguid.metaDataPtr;
+    ASSERT(task);
+
+    ocrSchedulerHeuristicContext_t *insertContext = context;
+    u64 affinitySlot = ((u64)-1);
+    ocrHint_t edtHint;
+    ocrHintInit(&edtHint, OCR_HINT_EDT_T);
+    RESULT_ASSERT(pd->taskFactories[task->fctId]->fcts.getHint(task, &edtHint), ==, 0);
+    if (ocrGetHintValue(&edtHint, OCR_HINT_EDT_SLOT_MAX_ACCESS, &affinitySlot) == 0) {
+        ASSERT(affinitySlot < task->depc);
+        ocrTaskHc_t *hcTask = (ocrTaskHc_t*)task; //BUG #926:This is temporary until we get proper introspection support
+        ocrGuid_t dbGuid = hcTask->resolvedDeps[affinitySlot].guid;
+        if (!(ocrGuidIsNull(dbGuid))) {
+            u64 writer = lookupWriter(derived, dbGuid);
+            if (writer < self->contextCount) {
+                insertContext = self->contexts[writer];
+            }
+        }
+    }
+
+    ocrSchedulerHeuristicContextHc_t *hcInsertContext = (ocrSchedulerHeuristicContextHc_t*)insertContext;
+    ocrSchedulerObject_t *schedObj = hcInsertContext->mySchedulerObject;
+    ASSERT(schedObj);
+    ocrSchedulerObject_t edtObj;
+    edtObj.guid = fguid;
+    edtObj.kind = OCR_SCHEDULER_OBJECT_EDT;
+    ocrSchedulerObjectFactory_t *fact = pd->schedulerObjectFactories[schedObj->fctId];
+    u8 retVal = fact->fcts.insert(fact, schedObj, &edtObj, NULL, (SCHEDULER_OBJECT_INSERT_AFTER | SCHEDULER_OBJECT_INSERT_POSITION_TAIL));
+    DPRINTF(DEBUG_LVL_VVERB, "EDT "GUIDF" ready on worker %"PRIu64" pushed to worker %"PRIu64"\n",
+            GUIDA(fguid.guid), context->id, insertContext->id);
+#ifdef OCR_DEBUG
+    hal_xadd64(&derived->readyCount, 1);
+    if (insertContext != context)
+        hal_xadd64(&derived->movedCount, 1);
+#endif
+    hcSchedulerHeuristicWakeIdle(self);
+    return retVal;
+}
+
+u8 hcLocalitySchedulerHeuristicNotifyInvoke(ocrSchedulerHeuristic_t *self, ocrSchedulerOpArgs_t *opArgs, ocrRuntimeHint_t *hints) {
+    ocrSchedulerOpNotifyArgs_t *notifyArgs = (ocrSchedulerOpNotifyArgs_t*)opArgs;
+    if (notifyArgs->kind == OCR_SCHED_NOTIFY_EDT_READY) {
+        ocrSchedulerHeuristicContext_t *context = self->fcts.getContext(self, opArgs->location);
+        return hcLocalitySchedulerHeuristicNotifyEdtReadyInvoke(self, context, opArgs, hints);
+    }
+    return hcSchedulerHeuristicNotifyInvoke(self, opArgs, hints);
+}
+
+u8 hcLocalitySchedulerHeuristicInvokeNotSupported(ocrSchedulerHeuristic_t *self, ocrSchedulerOpArgs_t *opArgs, ocrRuntimeHint_t *hints) {
+    ASSERT(0);
+    return OCR_ENOTSUP;
+}
+
+u8 hcLocalitySchedulerHeuristicSimulateNotSupported(ocrSchedulerHeuristic_t *self, ocrSchedulerHeuristicContext_t *context, ocrSchedulerOpArgs_t *opArgs, ocrRuntimeHint_t *hints) {
+    ASSERT(0);
+    return OCR_ENOTSUP;
+}
+
+/******************************************************/
+/* OCR-HC-LOCALITY SCHEDULER_HEURISTIC FACTORY        */
+/******************************************************/
+
+void destructSchedulerHeuristicFactoryHcLocality(ocrSchedulerHeuristicFactory_t * factory) {
+    runtimeChunkFree((u64)factory, NONPERSISTENT_CHUNK);
+}
+
+ocrSchedulerHeuristicFactory_t * newOcrSchedulerHeuristicFactoryHcLocality(ocrParamList_t *perType, u32 factoryId) {
+    ocrSchedulerHeuristicFactory_t* base = (ocrSchedulerHeuristicFactory_t*) runtimeChunkAlloc(
+                                      sizeof(ocrSchedulerHeuristicFactoryHcLocality_t), NONPERSISTENT_CHUNK);
+    base->factoryId = factoryId;
+    base->instantiate = &newSchedulerHeuristicHcLocality;
+    base->destruct = &destructSchedulerHeuristicFactoryHcLocality;
+    base->fcts.switchRunlevel = FUNC_ADDR(u8 (*)(ocrSchedulerHeuristic_t*, ocrPolicyDomain_t*, ocrRunlevel_t,
+                                                 phase_t, u32, void (*)(ocrPolicyDomain_t*, u64), u64), hcLocalitySchedulerHeuristicSwitchRunlevel);
+    base->fcts.destruct = FUNC_ADDR(void (*)(ocrSchedulerHeuristic_t*), hcSchedulerHeuristicDestruct);
+
+    base->fcts.update = FUNC_ADDR(u8 (*)(ocrSchedulerHeuristic_t*, u32), hcSchedulerHeuristicUpdate);
+    base->fcts.getContext = FUNC_ADDR(ocrSchedulerHeuristicContext_t* (*)(ocrSchedulerHeuristic_t*, ocrLocation_t), hcSchedulerHeuristicGetContext);
+
+    base->fcts.op[OCR_SCHEDULER_HEURISTIC_OP_GET_WORK].invoke = FUNC_ADDR(u8 (*)(ocrSchedulerHeuristic_t*, ocrSchedulerOpArgs_t*, ocrRuntimeHint_t*), hcLocalitySchedulerHeuristicGetWorkInvoke);
+    base->fcts.op[OCR_SCHEDULER_HEURISTIC_OP_GET_WORK].simulate = FUNC_ADDR(u8 (*)(ocrSchedulerHeuristic_t*, ocrSchedulerHeuristicContext_t*, ocrSchedulerOpArgs_t*, ocrRuntimeHint_t*), hcLocalitySchedulerHeuristicSimulateNotSupported);
+
+    base->fcts.op[OCR_SCHEDULER_HEURISTIC_OP_NOTIFY].invoke = FUNC_ADDR(u8 (*)(ocrSchedulerHeuristic_t*, ocrSchedulerOpArgs_t*, ocrRuntimeHint_t*), hcLocalitySchedulerHeuristicNotifyInvoke);
+    base->fcts.op[OCR_SCHEDULER_HEURISTIC_OP_NOTIFY].simulate = FUNC_ADDR(u8 (*)(ocrSchedulerHeuristic_t*, ocrSchedulerHeuristicContext_t*, ocrSchedulerOpArgs_t*, ocrRuntimeHint_t*), hcLocalitySchedulerHeuristicSimulateNotSupported);
+
+    base->fcts.op[OCR_SCHEDULER_HEURISTIC_OP_TRANSACT].invoke = FUNC_ADDR(u8 (*)(ocrSchedulerHeuristic_t*, ocrSchedulerOpArgs_t*, ocrRuntimeHint_t*), hcLocalitySchedulerHeuristicInvokeNotSupported);
+    base->fcts.op[OCR_SCHEDULER_HEURISTIC_OP_TRANSACT].simulate = FUNC_ADDR(u8 (*)(ocrSchedulerHeuristic_t*, ocrSchedulerHeuristicContext_t*, ocrSchedulerOpArgs_t*, ocrRuntimeHint_t*), hcLocalitySchedulerHeuristicSimulateNotSupported);
+
+    base->fcts.op[OCR_SCHEDULER_HEURISTIC_OP_ANALYZE].invoke = FUNC_ADDR(u8 (*)(ocrSchedulerHeuristic_t*, ocrSchedulerOpArgs_t*, ocrRuntimeHint_t*), hcLocalitySchedulerHeuristicInvokeNotSupported);
+    base->fcts.op[OCR_SCHEDULER_HEURISTIC_OP_ANALYZE].simulate = FUNC_ADDR(u8 (*)(ocrSchedulerHeuristic_t*, ocrSchedulerHeuristicContext_t*, ocrSchedulerOpArgs_t*, ocrRuntimeHint_t*), hcLocalitySchedulerHeuristicSimulateNotSupported);
+
+    return base;
+}
+
+#endif /* ENABLE_SCHEDULER_HEURISTIC_HC_LOCALITY */
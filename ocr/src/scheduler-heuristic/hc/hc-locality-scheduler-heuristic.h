@@ -0,0 +1,66 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#ifndef __HC_LOCALITY_SCHEDULER_HEURISTIC_H__
+#define __HC_LOCALITY_SCHEDULER_HEURISTIC_H__
+
+#include "ocr-config.h"
+#ifdef ENABLE_SCHEDULER_HEURISTIC_HC_LOCALITY
+
+#ifndef ENABLE_SCHEDULER_HEURISTIC_HC
+#error "The HC_LOCALITY scheduler heuristic builds on the HC one (ENABLE_SCHEDULER_HEURISTIC_HC)"
+#endif
+
+#include "ocr-scheduler-heuristic.h"
+#include "ocr-types.h"
+#include "utils/ocr-utils.h"
+#include "ocr-scheduler-object.h"
+#include "scheduler-heuristic/hc/hc-scheduler-heuristic.h"
+
+/****************************************************/
+/* HC LOCALITY SCHEDULER_HEURISTIC                  */
+/****************************************************/
+
+// Work-stealing like HC, except that an EDT becoming ready is pushed to
+// the deque of the worker that last wrote the DB on its
+// OCR_HINT_EDT_SLOT_MAX_ACCESS slot, where that DB is likely still cached.
+// EDTs without the hint, or whose DB has no known writer, stay local.
+// Any worker may push to any deque: the root WST object must be
+// configured with locked deques ('config = LOCKED').
+
+#ifndef HC_LOCALITY_WRITER_TABLE_SIZE
+// Number of DBs whose last writer is remembered (must be a power of 2).
+// Entries are overwritten on collisions; a lost entry only costs locality.
+#define HC_LOCALITY_WRITER_TABLE_SIZE 4096
+#endif
+
+typedef struct _ocrSchedulerHeuristicHcLocality_t {
+    ocrSchedulerHeuristicHc_t base;
+    // Last writer of DBs: tag of the DB GUID in the upper bits, worker
+    // id + 1 in the lower HC_LOCALITY_WORKER_BITS, 0 if the entry is free
+    volatile u64 *writers;
+#ifdef OCR_DEBUG
+    u64 readyCount;                       // EDTs that became ready
+    u64 movedCount;                       // Ready EDTs pushed to another worker
+#endif
+} ocrSchedulerHeuristicHcLocality_t;
+
+/****************************************************/
+/* HC LOCALITY SCHEDULER_HEURISTIC FACTORY          */
+/****************************************************/
+
+typedef struct _paramListSchedulerHeuristicHcLocality_t {
+    paramListSchedulerHeuristic_t base;
+} paramListSchedulerHeuristicHcLocality_t;
+
+typedef struct _ocrSchedulerHeuristicFactoryHcLocality_t {
+    ocrSchedulerHeuristicFactory_t base;
+} ocrSchedulerHeuristicFactoryHcLocality_t;
+
+ocrSchedulerHeuristicFactory_t * newOcrSchedulerHeuristicFactoryHcLocality(ocrParamList_t *perType, u32 factoryId);
+
+#endif /* ENABLE_SCHEDULER_HEURISTIC_HC_LOCALITY */
+#endif /* __HC_LOCALITY_SCHEDULER_HEURISTIC_H__ */
@@ -11,13 +11,24 @@
 #ifdef ENABLE_SCHEDULER_HEURISTIC_HC
 
 #include "debug.h"
+#include "ocr-comp-platform.h"
+#include "ocr-comp-target.h"
 #include "ocr-errors.h"
 #include "ocr-policy-domain.h"
 #include "ocr-runtime-types.h"
+#include "ocr-sal.h"
 #include "ocr-sysboot.h"
+#include "ocr-worker.h"
 #include "ocr-workpile.h"
 #include "ocr-scheduler-object.h"
 #include "scheduler-heuristic/hc/hc-scheduler-heuristic.h"
+#ifdef ENABLE_WORKER_HC_FIBER
+#include "worker/hc/hc-worker.h"
+#endif
+
+#include <stdlib.h>
+
+#define DEBUG_TYPE SCHEDULER_HEURISTIC
 
 /******************************************************/
 /* OCR-HC SCHEDULER_HEURISTIC                         */
@@ -26,6 +37,9 @@
 ocrSchedulerHeuristic_t* newSchedulerHeuristicHc(ocrSchedulerHeuristicFactory_t * factory, ocrParamList_t *perInstance) {
     ocrSchedulerHeuristic_t* self = (ocrSchedulerHeuristic_t*) runtimeChunkAlloc(sizeof(ocrSchedulerHeuristicHc_t), PERSISTENT_CHUNK);
     initializeSchedulerHeuristicOcr(factory, self, perInstance);
+    ocrSchedulerHeuristicHc_t *derived = (ocrSchedulerHeuristicHc_t*)self;
+    derived->parkedCount = 0;
+    derived->wakeCursor = 0;
     return self;
 }
 
@@ -37,10 +51,96 @@ static void initializeContextHc(ocrSchedulerHeuristicContext_t *context, u64 con
 
     ocrSchedulerHeuristicContextHc_t *hcContext = (ocrSchedulerHeuristicContextHc_t*)context;
     hcContext->stealSchedulerObjectIndex = ((u64)-1);
+    hcContext->stealLevel = HC_STEAL_LEVEL_REMOTE;
+    hcContext->victims = NULL;
     hcContext->mySchedulerObject = NULL;
+    hcContext->idleCount = 0;
+    hcContext->parkSeq = 0;
+    hcContext->parked = 0;
+    hcContext->wakePending = 0;
+    hcContext->stealTime = 0;
+    hcContext->parkTime = 0;
+    hcContext->parkCount = 0;
     return;
 }
 
+/* Steal level between two workers given their core, LLC and package ids.
+ * Without topology, all workers are on one level. */
+static u32 hcStealLevelOf(u32 *topology, u32 a, u32 b) {
+    if (topology == NULL)
+        return HC_STEAL_LEVEL_SOCKET;
+    if (topology[3*a] == topology[3*b])
+        return HC_STEAL_LEVEL_SMT;
+    if (topology[3*a+1] == topology[3*b+1])
+        return HC_STEAL_LEVEL_LLC;
+    if (topology[3*a+2] == topology[3*b+2])
+        return HC_STEAL_LEVEL_SOCKET;
+    return HC_STEAL_LEVEL_REMOTE;
+}
+
+/* Orders the victims of each context from the closest to the farthest. Within
+ * a level, victims are visited round robin starting after the context's id. */
+static void hcSchedulerHeuristicBuildVictims(ocrSchedulerHeuristic_t *self, ocrPolicyDomain_t *PD) {
+    u32 i, k, level;
+    u32 count = self->contextCount;
+    // Core, last level cache and package ids of the CPU each worker is bound to
+    u32 *topology = (u32*)PD->fcts.pdMalloc(PD, 3 * count * sizeof(u32));
+    for (i = 0; i < count; i++) {
+        ocrWorker_t *worker = PD->workers[i];
+        ocrCompPlatform_t *platform = worker->computes[0]->platforms[0];
+        u32 cpu;
+        ASSERT(worker->id < count);
+        if ((platform->fcts.getBinding(platform, &cpu) != 0) ||
+            !salGetCpuTopology(cpu, &topology[3*worker->id], &topology[3*worker->id+1], &topology[3*worker->id+2])) {
+            DPRINTF(DEBUG_LVL_INFO, "No topology for worker %"PRIu64", stealing ignores the topology\n", worker->id);
+            PD->fcts.pdFree(PD, topology);
+            topology = NULL;
+            break;
+        }
+    }
+    u32 *victims = (u32*)PD->fcts.pdMalloc(PD, count * count * sizeof(u32));
+    for (i = 0; i < count; i++) {
+        ocrSchedulerHeuristicContextHc_t *hcContext = (ocrSchedulerHeuristicContextHc_t*)self->contexts[i];
+        u32 nbVictims = 0;
+        hcContext->victims = &victims[i * count];
+        for (level = 0; level < HC_STEAL_LEVEL_COUNT; level++) {
+            for (k = 1; k < count; k++) {
+                u32 victim = (i + k) % count;
+                if (hcStealLevelOf(topology, i, victim) == level)
+                    hcContext->victims[nbVictims++] = victim;
+            }
+            hcContext->levelEnd[level] = nbVictims;
+        }
+        if (nbVictims != 0) {
+            hcContext->stealSchedulerObjectIndex = hcContext->victims[0];
+            hcContext->stealLevel = hcStealLevelOf(topology, i, hcContext->victims[0]);
+        }
+        DPRINTF(DEBUG_LVL_VERB, "Worker %"PRIu32" victims: %"PRIu32" SMT, %"PRIu32" LLC, %"PRIu32" socket, %"PRIu32" remote\n",
+                i, hcContext->levelEnd[HC_STEAL_LEVEL_SMT],
+                hcContext->levelEnd[HC_STEAL_LEVEL_LLC] - hcContext->levelEnd[HC_STEAL_LEVEL_SMT],
+                hcContext->levelEnd[HC_STEAL_LEVEL_SOCKET] - hcContext->levelEnd[HC_STEAL_LEVEL_LLC],
+                hcContext->levelEnd[HC_STEAL_LEVEL_REMOTE] - hcContext->levelEnd[HC_STEAL_LEVEL_SOCKET]);
+    }
+    if (topology != NULL)
+        PD->fcts.pdFree(PD, topology);
+}
+
+// Prints how long each worker spent idle if the OCR_SCHED_STATS environment variable is set
+static void hcSchedulerHeuristicStatsDump(ocrSchedulerHeuristic_t *self, ocrPolicyDomain_t *PD) {
+    char *enabled = getenv("OCR_SCHED_STATS");
+    if((enabled == NULL) || (enabled[0] == '\0')) {
+        return;
+    }
+    u32 i;
+    PRINTF("Scheduler idle statistics for PD %"PRIu64"\n", (u64) PD->myLocation);
+    PRINTF("worker\tstealUs\tparkUs\tparks\n");
+    for (i = 0; i < self->contextCount; i++) {
+        ocrSchedulerHeuristicContextHc_t *hcContext = (ocrSchedulerHeuristicContextHc_t*)self->contexts[i];
+        PRINTF("%"PRIu32"\t%"PRIu64"\t%"PRIu64"\t%"PRIu64"\n",
+               i, hcContext->stealTime / 1000, hcContext->parkTime / 1000, hcContext->parkCount);
+    }
+}
+
 u8 hcSchedulerHeuristicSwitchRunlevel(ocrSchedulerHeuristic_t *self, ocrPolicyDomain_t *PD, ocrRunlevel_t runlevel,
                                       phase_t phase, u32 properties, void (*callback)(ocrPolicyDomain_t*, u64), u64 val) {
 
@@ -89,6 +189,10 @@ u8 hcSchedulerHeuristicSwitchRunlevel(ocrSchedulerHeuristic_t *self, ocrPolicyDo
             }
         }
         if((properties & RL_TEAR_DOWN) && RL_IS_LAST_PHASE_DOWN(PD, RL_MEMORY_OK, phase)) {
+            hcSchedulerHeuristicStatsDump(self, PD);
+            ocrSchedulerHeuristicContextHc_t *hcContext = (ocrSchedulerHeuristicContextHc_t*)self->contexts[0];
+            if (hcContext->victims != NULL)
+                PD->fcts.pdFree(PD, hcContext->victims);
             PD->fcts.pdFree(PD, self->contexts[0]);
             PD->fcts.pdFree(PD, self->contexts);
         }
@@ -108,6 +212,7 @@ u8 hcSchedulerHeuristicSwitchRunlevel(ocrSchedulerHeuristic_t *self, ocrPolicyDo
                 ASSERT(hcContext->mySchedulerObject);
                 hcContext->stealSchedulerObjectIndex = (i + 1) % self->contextCount;
             }
+            hcSchedulerHeuristicBuildVictims(self, PD);
         }
         break;
     }
@@ -135,7 +240,125 @@ ocrSchedulerHeuristicContext_t* hcSchedulerHeuristicGetContext(ocrSchedulerHeuri
     return self->contexts[worker->id];
 }
 
-/* Find EDT for the worker to execute - This uses random workstealing to find work if no work is found owned deque */
+/* Called when a worker could not find any work. Depending on how long the
+ * worker has been idle, return right away to spin, back off, or park until
+ * a ready EDT is notified (see hcSchedulerHeuristicWakeIdle) or the worker
+ * is woken up specifically (see hcSchedulerHeuristicWakeWorker) */
+static void hcSchedulerHeuristicIdle(ocrSchedulerHeuristic_t *self, ocrSchedulerHeuristicContextHc_t *hcContext) {
+    ocrSchedulerHeuristicHc_t *derived = (ocrSchedulerHeuristicHc_t*)self;
+    u32 idleCount = ++hcContext->idleCount;
+    if (idleCount <= HC_SCHED_IDLE_SPIN_COUNT)
+        return;
+    if ((HC_SCHED_IDLE_PARK_TIMEOUT_US == 0) || (idleCount <= (HC_SCHED_IDLE_SPIN_COUNT + HC_SCHED_IDLE_BACKOFF_COUNT))) {
+        hal_pause();
+        return;
+    }
+#ifdef ENABLE_WORKER_HC_FIBER
+    // Blocked EDTs nothing would wake us up for are polled on every shift
+    ocrWorker_t * worker = NULL;
+    getCurrentEnv(NULL, &worker, NULL, NULL);
+    if (((ocrWorkerHc_t *) worker)->parkedPolling != 0) {
+        hal_pause();
+        return;
+    }
+#endif
+    // Announce ourselves before the last checks so that a concurrent
+    // waker either sees us parking or we see its EDT or its wake-up
+    // request (the increment is a full fence)
+    u32 seq = hcContext->parkSeq;
+    hcContext->parked = 1;
+    hal_xadd32(&derived->parkedCount, 1);
+    ocrSchedulerObject_t *rootObj = self->scheduler->rootObj;
+    ocrSchedulerObjectFactory_t *sFact = self->scheduler->pd->schedulerObjectFactories[rootObj->fctId];
+    if ((hcContext->wakePending == 0) &&
+        (sFact->fcts.count(sFact, rootObj, (SCHEDULER_OBJECT_COUNT_EDT | SCHEDULER_OBJECT_COUNT_RECURSIVE)) == 0)) {
+        u64 startTime = salGetTime();
+        salFutexWait(&hcContext->parkSeq, seq, HC_SCHED_IDLE_PARK_TIMEOUT_US * 1000ULL);
+        hcContext->parkTime += salGetTime() - startTime;
+        hcContext->parkCount++;
+    }
+    hcContext->parked = 0;
+    hal_xadd32(&derived->parkedCount, -1);
+    // Whatever we were woken up for is checked by the caller once we return
+    hcContext->wakePending = 0;
+}
+
+/* Wake up a bounded number of parked workers, if any */
+void hcSchedulerHeuristicWakeIdle(ocrSchedulerHeuristic_t *self) {
+    ocrSchedulerHeuristicHc_t *derived = (ocrSchedulerHeuristicHc_t*)self;
+    // The EDT insertion must be visible before checking for parked workers
+    hal_fence();
+    if (derived->parkedCount == 0)
+        return;
+    u32 woken = 0;
+    u64 i, start = derived->wakeCursor;
+    for (i = 0; (i < self->contextCount) && (woken < HC_SCHED_IDLE_WAKE_COUNT); i++) {
+        ocrSchedulerHeuristicContextHc_t *hcContext = (ocrSchedulerHeuristicContextHc_t*)self->contexts[(start + i) % self->contextCount];
+        // Only one waker gets to wake a given parked worker up
+        if ((hcContext->parked != 0) && (hal_cmpswap32(&hcContext->parked, 1, 0) == 1)) {
+            hal_xadd32(&hcContext->parkSeq, 1);
+            salFutexWake(&hcContext->parkSeq, 1);
+            woken++;
+        }
+    }
+    derived->wakeCursor = (start + i) % self->contextCount;
+}
+
+void hcSchedulerHeuristicWakeWorker(ocrSchedulerHeuristic_t *self, u64 contextId) {
+    ASSERT(contextId < self->contextCount);
+    ocrSchedulerHeuristicContextHc_t *hcContext = (ocrSchedulerHeuristicContextHc_t*)self->contexts[contextId];
+    hcContext->wakePending = 1;
+    // The wake-up request must be visible before checking whether the worker parked
+    hal_fence();
+    if ((hcContext->parked != 0) && (hal_cmpswap32(&hcContext->parked, 1, 0) == 1)) {
+        hal_xadd32(&hcContext->parkSeq, 1);
+        salFutexWake(&hcContext->parkSeq, 1);
+    }
+}
+
+static const u32 hcStealSize[HC_STEAL_LEVEL_COUNT] = {
+    HC_SCHED_STEAL_SIZE_SMT, HC_SCHED_STEAL_SIZE_LLC, HC_SCHED_STEAL_SIZE_SOCKET, HC_SCHED_STEAL_SIZE_REMOTE
+};
+
+/* Steal from the deque of context 'victim', at 'level' from us. The first EDT
+ * taken is returned in edtObj, the other ones are moved to our own deque */
+static u8 hcSchedulerHeuristicSteal(ocrSchedulerHeuristic_t *self, ocrSchedulerHeuristicContextHc_t *hcContext,
+                                    u64 victim, u32 level, ocrSchedulerObject_t *edtObj) {
+    ocrSchedulerObject_t *stealSchedulerObject = ((ocrSchedulerHeuristicContextHc_t*)self->contexts[victim])->mySchedulerObject;
+    if (stealSchedulerObject == NULL)
+        return 1;
+    ocrSchedulerObjectFactory_t *fact = self->scheduler->pd->schedulerObjectFactories[stealSchedulerObject->fctId];
+    u8 retVal = fact->fcts.remove(fact, stealSchedulerObject, OCR_SCHEDULER_OBJECT_EDT, 1, edtObj, NULL, SCHEDULER_OBJECT_REMOVE_HEAD);
+    if (ocrGuidIsNull(edtObj->guid.guid) || (hcStealSize[level] == 1))
+        return retVal;
+
+    u64 extra = hcStealSize[level] - 1;
+    if (hcStealSize[level] == 0) {
+        // Half of what the victim had, including the EDT already taken
+        u64 total = (fact->fcts.count(fact, stealSchedulerObject, SCHEDULER_OBJECT_COUNT_EDT) + 1) / 2;
+        extra = (total > 1) ? (total - 1) : 0;
+    }
+    ocrSchedulerObject_t *schedObj = hcContext->mySchedulerObject;
+    ocrSchedulerObjectFactory_t *myFact = self->scheduler->pd->schedulerObjectFactories[schedObj->fctId];
+    u64 moved = 0;
+    while (moved < extra) {
+        ocrSchedulerObject_t taken;
+        taken.guid.guid = NULL_GUID;
+        taken.guid.metaDataPtr = NULL;
+        taken.kind = OCR_SCHEDULER_OBJECT_EDT;
+        fact->fcts.remove(fact, stealSchedulerObject, OCR_SCHEDULER_OBJECT_EDT, 1, &taken, NULL, SCHEDULER_OBJECT_REMOVE_HEAD);
+        if (ocrGuidIsNull(taken.guid.guid))
+            break;
+        myFact->fcts.insert(myFact, schedObj, &taken, NULL, (SCHEDULER_OBJECT_INSERT_AFTER | SCHEDULER_OBJECT_INSERT_POSITION_TAIL));
+        moved++;
+    }
+    // Others may now steal what we took
+    if (moved != 0)
+        hcSchedulerHeuristicWakeIdle(self);
+    return retVal;
+}
+
+/* Find EDT for the worker to execute - This uses hierarchical workstealing to find work if no work is found owned deque */
 static u8 hcSchedulerHeuristicWorkEdtUserInvoke(ocrSchedulerHeuristic_t *self, ocrSchedulerHeuristicContext_t *context, ocrSchedulerOpArgs_t *opArgs, ocrRuntimeHint_t *hints) {
     ocrSchedulerOpWorkArgs_t *taskArgs = (ocrSchedulerOpWorkArgs_t*)opArgs;
     ocrSchedulerObject_t edtObj;
@@ -152,27 +375,32 @@ static u8 hcSchedulerHeuristicWorkEdtUserInvoke(ocrSchedulerHeuristic_t *self, o
 
     //If pop fails, then try to steal from other deques
     if (ocrGuidIsNull(edtObj.guid.guid)) {
+        u64 startTime = salGetTime();
         //First try to steal from the last deque that was visited (probably had a successful steal)
-        ocrSchedulerObject_t *stealSchedulerObject = ((ocrSchedulerHeuristicContextHc_t*)self->contexts[hcContext->stealSchedulerObjectIndex])->mySchedulerObject;
-        ASSERT(stealSchedulerObject);
-        retVal = fact->fcts.remove(fact, stealSchedulerObject, OCR_SCHEDULER_OBJECT_EDT, 1, &edtObj, NULL, SCHEDULER_OBJECT_REMOVE_HEAD); //try cached deque first
+        retVal = hcSchedulerHeuristicSteal(self, hcContext, hcContext->stealSchedulerObjectIndex, hcContext->stealLevel, &edtObj);
 
-        //If cached steal failed, then restart steal loop from starting index
+        //If cached steal failed, then go through the victims from the closest to the farthest
         ocrSchedulerObject_t *rootObj = self->scheduler->rootObj;
         ocrSchedulerObjectFactory_t *sFact = self->scheduler->pd->schedulerObjectFactories[rootObj->fctId];
         while (ocrGuidIsNull(edtObj.guid.guid) && sFact->fcts.count(sFact, rootObj, (SCHEDULER_OBJECT_COUNT_EDT | SCHEDULER_OBJECT_COUNT_RECURSIVE) ) != 0) {
-            u32 i;
-            for (i = 1; ocrGuidIsNull(edtObj.guid.guid) && i < self->contextCount; i++) {
-                hcContext->stealSchedulerObjectIndex = (context->id + i) % self->contextCount; //simple round robin stealing
-                stealSchedulerObject = ((ocrSchedulerHeuristicContextHc_t*)self->contexts[hcContext->stealSchedulerObjectIndex])->mySchedulerObject;
-                if (stealSchedulerObject)
-                    retVal = fact->fcts.remove(fact, stealSchedulerObject, OCR_SCHEDULER_OBJECT_EDT, 1, &edtObj, NULL, SCHEDULER_OBJECT_REMOVE_HEAD);
+            u32 i = 0, level;
+            for (level = 0; ocrGuidIsNull(edtObj.guid.guid) && level < HC_STEAL_LEVEL_COUNT; level++) {
+                for (; ocrGuidIsNull(edtObj.guid.guid) && i < hcContext->levelEnd[level]; i++) {
+                    hcContext->stealSchedulerObjectIndex = hcContext->victims[i];
+                    hcContext->stealLevel = level;
+                    retVal = hcSchedulerHeuristicSteal(self, hcContext, hcContext->victims[i], level, &edtObj);
+                }
             }
         }
+        hcContext->stealTime += salGetTime() - startTime;
     }
 
-    if (!(ocrGuidIsNull(edtObj.guid.guid)))
+    if (!(ocrGuidIsNull(edtObj.guid.guid))) {
         taskArgs->OCR_SCHED_ARG_FIELD(OCR_SCHED_WORK_EDT_USER).edt = edtObj.guid;
+        hcContext->idleCount = 0;
+    } else {
+        hcSchedulerHeuristicIdle(self, hcContext);
+    }
 
     return retVal;
 }
@@ -205,7 +433,9 @@ static u8 hcSchedulerHeuristicNotifyEdtReadyInvoke(ocrSchedulerHeuristic_t *self
     edtObj.guid = notifyArgs->OCR_SCHED_ARG_FIELD(OCR_SCHED_NOTIFY_EDT_READY).guid;
     edtObj.kind = OCR_SCHEDULER_OBJECT_EDT;
     ocrSchedulerObjectFactory_t *fact = self->scheduler->pd->schedulerObjectFactories[schedObj->fctId];
-    return fact->fcts.insert(fact, schedObj, &edtObj, NULL, (SCHEDULER_OBJECT_INSERT_AFTER | SCHEDULER_OBJECT_INSERT_POSITION_TAIL));
+    u8 retVal = fact->fcts.insert(fact, schedObj, &edtObj, NULL, (SCHEDULER_OBJECT_INSERT_AFTER | SCHEDULER_OBJECT_INSERT_POSITION_TAIL));
+    hcSchedulerHeuristicWakeIdle(self);
+    return retVal;
 }
 
 u8 hcSchedulerHeuristicNotifyInvoke(ocrSchedulerHeuristic_t *self, ocrSchedulerOpArgs_t *opArgs, ocrRuntimeHint_t *hints) {
@@ -19,11 +19,81 @@
 /* HC SCHEDULER_HEURISTIC                           */
 /****************************************************/
 
+// Idle policy: when a worker finds no work it first keeps spinning
+// through the steal loop, then backs off (cpu pause) between attempts and
+// eventually parks on a futex of its own until an EDT becomes ready or
+// something else it waits on (a response to one of its messages for
+// instance) wakes it up specifically.
+
+#ifndef HC_SCHED_IDLE_SPIN_COUNT
+// Number of consecutive failed GET_WORK before backing off
+#define HC_SCHED_IDLE_SPIN_COUNT 64
+#endif
+
+#ifndef HC_SCHED_IDLE_BACKOFF_COUNT
+// Number of consecutive failed GET_WORK with back-off before parking
+#define HC_SCHED_IDLE_BACKOFF_COUNT 64
+#endif
+
+#ifndef HC_SCHED_IDLE_PARK_TIMEOUT_US
+// Maximum time a worker stays parked before checking for work again.
+// Bounds the latency of runlevel changes. Zero disables parking.
+#define HC_SCHED_IDLE_PARK_TIMEOUT_US 1000
+#endif
+
+#ifndef HC_SCHED_IDLE_WAKE_COUNT
+// Maximum number of parked workers woken up per ready EDT
+#define HC_SCHED_IDLE_WAKE_COUNT 1
+#endif
+
+// Steal policy: victims are tried from the closest to the farthest worker,
+// level by level. The topology is read from sysfs for the CPUs the
+// workers are bound to ('binding' in the config). If some worker is not
+// bound, all the other workers are considered on the same socket, which
+// is the plain round robin stealing of one EDT at a time.
+
+typedef enum {
+    HC_STEAL_LEVEL_SMT,                   // Same core
+    HC_STEAL_LEVEL_LLC,                   // Same last level cache
+    HC_STEAL_LEVEL_SOCKET,                // Same package
+    HC_STEAL_LEVEL_REMOTE,                // Anywhere else
+    HC_STEAL_LEVEL_COUNT
+} hcStealLevel_t;
+
+// Number of EDTs taken by a successful steal at each level. The first one
+// is executed, the others are moved to the thief's deque. 0 takes half of
+// the EDTs the victim had.
+#ifndef HC_SCHED_STEAL_SIZE_SMT
+#define HC_SCHED_STEAL_SIZE_SMT 1
+#endif
+
+#ifndef HC_SCHED_STEAL_SIZE_LLC
+#define HC_SCHED_STEAL_SIZE_LLC 1
+#endif
+
+#ifndef HC_SCHED_STEAL_SIZE_SOCKET
+#define HC_SCHED_STEAL_SIZE_SOCKET 1
+#endif
+
+#ifndef HC_SCHED_STEAL_SIZE_REMOTE
+#define HC_SCHED_STEAL_SIZE_REMOTE 0
+#endif
+
 // Cached information about context
 typedef struct _ocrSchedulerHeuristicContextHc_t {
     ocrSchedulerHeuristicContext_t base;
     ocrSchedulerObject_t *mySchedulerObject;    // The deque owned by a specific worker (context)
     u64 stealSchedulerObjectIndex;        // Cached index of the deque lasted visited during steal attempts
+    u32 stealLevel;                       // Level of the cached deque
+    u32 *victims;                         // Other contexts, closest first
+    u32 levelEnd[HC_STEAL_LEVEL_COUNT];   // End in 'victims' of each level
+    u32 idleCount;                        // Consecutive GET_WORK that found no work
+    volatile u32 parkSeq;                 // Futex word the worker parks on
+    volatile u32 parked;                  // Set while the worker is parked or about to park
+    volatile u32 wakePending;             // Set by a wake-up the worker has not seen yet
+    u64 stealTime;                        // Time (ns) spent looking for work in other deques
+    u64 parkTime;                         // Time (ns) spent parked
+    u64 parkCount;                        // Number of times the worker parked
 #if 0 // Example fields for simulation mode
     ocrSchedulerObjectActionSet_t singleActionSet;
     ocrSchedulerObjectAction_t insertAction;
@@ -33,6 +103,8 @@ typedef struct _ocrSchedulerHeuristicContextHc_t {
 
 typedef struct _ocrSchedulerHeuristicHc_t {
     ocrSchedulerHeuristic_t base;
+    volatile u32 parkedCount;             // Number of workers parked or about to park
+    volatile u32 wakeCursor;              // Context to start from when looking for a worker to wake
 } ocrSchedulerHeuristicHc_t;
 
 /****************************************************/
@@ -49,6 +121,21 @@ typedef struct _ocrSchedulerHeuristicFactoryHc_t {
 
 ocrSchedulerHeuristicFactory_t * newOcrSchedulerHeuristicFactoryHc(ocrParamList_t *perType, u32 factoryId);
 
+/* Shared with the heuristics building on the HC one (hc-locality) */
+u8 hcSchedulerHeuristicSwitchRunlevel(ocrSchedulerHeuristic_t *self, struct _ocrPolicyDomain_t *PD, ocrRunlevel_t runlevel,
+                                      phase_t phase, u32 properties, void (*callback)(struct _ocrPolicyDomain_t*, u64), u64 val);
+void hcSchedulerHeuristicDestruct(ocrSchedulerHeuristic_t * self);
+u8 hcSchedulerHeuristicUpdate(ocrSchedulerHeuristic_t *self, u32 properties);
+ocrSchedulerHeuristicContext_t* hcSchedulerHeuristicGetContext(ocrSchedulerHeuristic_t *self, ocrLocation_t loc);
+u8 hcSchedulerHeuristicGetWorkInvoke(ocrSchedulerHeuristic_t *self, ocrSchedulerOpArgs_t *opArgs, ocrRuntimeHint_t *hints);
+u8 hcSchedulerHeuristicNotifyInvoke(ocrSchedulerHeuristic_t *self, ocrSchedulerOpArgs_t *opArgs, ocrRuntimeHint_t *hints);
+void hcSchedulerHeuristicWakeIdle(ocrSchedulerHeuristic_t *self);
+
+/* Wakes up the worker of context 'contextId' if it is parked, or keeps it
+ * from parking on its next idle period otherwise. 'self' is any heuristic
+ * built on the HC one. */
+void hcSchedulerHeuristicWakeWorker(ocrSchedulerHeuristic_t *self, u64 contextId);
+
 #endif /* ENABLE_SCHEDULER_HEURISTIC_HC */
 #endif /* __HC_SCHEDULER_HEURISTIC_H__ */
 
@@ -3,7 +3,7 @@
  * and cannot be distributed without it. This notice cannot be
  * removed or modified.
  *
- * - A scheduler heuristic for PR_WSH root schedulerObjects
+ * - A scheduler heuristic for PR_WSH or PR_MQ root schedulerObjects
  *
  */
 
@@ -129,6 +129,7 @@ ocrSchedulerHeuristicContext_t* prioritySchedulerHeuristicGetContext(ocrSchedule
     ASSERT(loc == self->scheduler->pd->myLocation);
     ocrWorker_t * worker = NULL;
     getCurrentEnv(NULL, &worker, NULL, NULL);
+    if (worker == NULL) return NULL;
     return self->contexts[worker->id];
 }
 
@@ -210,6 +211,7 @@ u8 prioritySchedulerHeuristicNotifyInvoke(ocrSchedulerHeuristic_t *self, ocrSche
     // Notifies ignored by this heuristic
     case OCR_SCHED_NOTIFY_EDT_SATISFIED:
     case OCR_SCHED_NOTIFY_DB_CREATE:
+    case OCR_SCHED_NOTIFY_PRE_PROCESS_MSG:
         return OCR_ENOP;
     // Unknown ops
     default:
@@ -17,6 +17,9 @@ const char * schedulerHeuristic_types[] = {
 #ifdef ENABLE_SCHEDULER_HEURISTIC_HC_COMM_DELEGATE
     "HC_COMM_DELEGATE",
 #endif
+#ifdef ENABLE_SCHEDULER_HEURISTIC_HC_LOCALITY
+    "HC_LOCALITY",
+#endif
 #ifdef ENABLE_SCHEDULER_HEURISTIC_PLACEMENT_AFFINITY
     "PLACEMENT_AFFINITY",
 #endif
@@ -49,6 +52,10 @@ ocrSchedulerHeuristicFactory_t * newSchedulerHeuristicFactory(schedulerHeuristic
     case schedulerHeuristicHcCommDelegate_id:
         return newOcrSchedulerHeuristicFactoryHcCommDelegate(perType, type);
 #endif
+#ifdef ENABLE_SCHEDULER_HEURISTIC_HC_LOCALITY
+    case schedulerHeuristicHcLocality_id:
+        return newOcrSchedulerHeuristicFactoryHcLocality(perType, type);
+#endif
 #ifdef ENABLE_SCHEDULER_HEURISTIC_PLACEMENT_AFFINITY
     case schedulerHeuristicPlacementAffinity_id:
         return newOcrSchedulerHeuristicFactoryPlacementAffinity(perType, type);
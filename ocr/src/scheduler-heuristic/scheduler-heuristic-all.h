@@ -20,6 +20,9 @@
 #ifdef ENABLE_SCHEDULER_HEURISTIC_HC_COMM_DELEGATE
 #include "scheduler-heuristic/hc/hc-comm-delegate-scheduler-heuristic.h"
 #endif
+#ifdef ENABLE_SCHEDULER_HEURISTIC_HC_LOCALITY
+#include "scheduler-heuristic/hc/hc-locality-scheduler-heuristic.h"
+#endif
 #ifdef ENABLE_SCHEDULER_HEURISTIC_PLACEMENT_AFFINITY
 #include "scheduler-heuristic/placement/placement-affinity-scheduler-heuristic.h"
 #endif
@@ -46,6 +49,9 @@ typedef enum _schedulerHeuristicType_t {
 #ifdef ENABLE_SCHEDULER_HEURISTIC_HC_COMM_DELEGATE
     schedulerHeuristicHcCommDelegate_id,
 #endif
+#ifdef ENABLE_SCHEDULER_HEURISTIC_HC_LOCALITY
+    schedulerHeuristicHcLocality_id,
+#endif
 #ifdef ENABLE_SCHEDULER_HEURISTIC_PLACEMENT_AFFINITY
      schedulerHeuristicPlacementAffinity_id,
 #endif
@@ -113,6 +113,7 @@ u8 deqSchedulerObjectRemove(ocrSchedulerObjectFactory_t *fact, ocrSchedulerObjec
 
     for (i = 0; i < count; i++) {
         ocrGuid_t retGuid = NULL_GUID;
+        ocrTask_t *popTask = NULL;
         switch(properties) {
         case SCHEDULER_OBJECT_REMOVE_TAIL:
             {
@@ -120,7 +121,7 @@ u8 deqSchedulerObjectRemove(ocrSchedulerObjectFactory_t *fact, ocrSchedulerObjec
 
                 void *popVal = deq->popFromTail(deq, 0);
                 if(popVal != NULL){
-                    ocrTask_t *popTask = (ocrTask_t *)popVal;
+                    popTask = (ocrTask_t *)popVal;
                     retGuid = popTask->guid;
                 }
 
@@ -133,7 +134,7 @@ u8 deqSchedulerObjectRemove(ocrSchedulerObjectFactory_t *fact, ocrSchedulerObjec
 
                 void *popVal = deq->popFromHead(deq, 1);
                 if(popVal != NULL){
-                    ocrTask_t *popTask = (ocrTask_t *)popVal;
+                    popTask = (ocrTask_t *)popVal;
                     retGuid = popTask->guid;
                 }
 
@@ -151,6 +152,8 @@ u8 deqSchedulerObjectRemove(ocrSchedulerObjectFactory_t *fact, ocrSchedulerObjec
         if (IS_SCHEDULER_OBJECT_TYPE_SINGLETON(dst->kind)) {
             ASSERT((ocrGuidIsNull(dst->guid.guid)) && count == 1);
             dst->guid.guid = retGuid;
+            // Deques only hold local tasks, spare the caller a GUID lookup
+            dst->guid.metaDataPtr = popTask;
         } else {
             ocrSchedulerObject_t taken;
             taken.guid.guid = retGuid;
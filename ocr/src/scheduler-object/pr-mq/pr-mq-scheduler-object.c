@@ -0,0 +1,457 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ *
+ * Relaxed concurrent priority queue based on the MultiQueue design:
+ * "MultiQueues: Simple Relaxed Concurrent Priority Queues" (Rihani,
+ * Sanders, Dementiev - SPAA'15).
+ *
+ * Elements are pushed to a randomly chosen heap. A pop samples two
+ * random heaps and takes the top of the one with the higher priority.
+ * Each heap has its own lock so that concurrent operations mostly hit
+ * different heaps instead of serializing on a single one.
+ */
+
+#include "ocr-config.h"
+#include "extensions/ocr-hints.h"
+#ifdef ENABLE_SCHEDULER_OBJECT_PR_MQ
+
+#include "debug.h"
+#include "ocr-errors.h"
+#include "ocr-hal.h"
+#include "ocr-policy-domain.h"
+#include "ocr-runtime-types.h"
+#include "ocr-sysboot.h"
+#include "ocr-task.h"
+#include "ocr-worker.h"
+#include "scheduler-object/pr-mq/pr-mq-scheduler-object.h"
+#include "scheduler-object/scheduler-object-all.h"
+
+#define DEBUG_TYPE SCHEDULER_OBJECT
+
+// Number of random two-choice attempts before a pop falls back
+// to a full sweep of the heaps
+#define PR_MQ_POP_ATTEMPTS 4
+
+/*********************************************************/
+/* OCR PR-MQ SCHEDULER_OBJECT FUNCTIONS                  */
+/*********************************************************/
+
+static inline u32 prMqRandom(ocrSchedulerObjectPrMq_t *mq) {
+    ocrWorker_t *worker = NULL;
+    getCurrentEnv(NULL, &worker, NULL, NULL);
+    // Threads without a worker share the first seed; the race
+    // only costs some randomness.
+    u32 idx = ((worker != NULL) && (worker->id < mq->seedCount)) ? worker->id : 0;
+    u64 x = mq->seeds[idx].state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    mq->seeds[idx].state = x;
+    return (u32)(x >> 32);
+}
+
+// Racy read of a heap's top priority, only used to pick between candidates.
+// Reads the copies kept in 'h' since the heap's array moves when it is resized.
+static inline bool prMqPeek(prMqHeap_t *h, s64 *priority) {
+    if (h->count == 0)
+        return false;
+    *priority = h->top;
+    return true;
+}
+
+// Refresh the copies read by prMqPeek; the lock must be held
+static inline void prMqPublishTop(prMqHeap_t *h) {
+    binHeap_t *heap = h->heap;
+    if (heap->count != 0)
+        h->top = heap->data[0].priority;
+    h->count = heap->count;
+}
+
+static void prMqSchedulerObjectStart(ocrSchedulerObject_t *self, ocrPolicyDomain_t *PD) {
+    ocrPolicyDomain_t *pd = NULL;
+    getCurrentEnv(&pd, NULL, NULL, NULL);
+    self->loc = pd->myLocation;
+    self->mapping = OCR_SCHEDULER_OBJECT_MAPPING_PINNED;
+    ocrSchedulerObjectPrMq_t *mq = (ocrSchedulerObjectPrMq_t*)self;
+    u32 workerCount = (PD->workerCount == 0) ? 1 : (u32)PD->workerCount;
+    mq->heapCount = (mq->relax == 0) ? 1 : (mq->relax * workerCount);
+    mq->heaps = (prMqHeap_t*)PD->fcts.pdMalloc(PD, sizeof(prMqHeap_t) * mq->heapCount);
+    u32 i;
+    for (i = 0; i < mq->heapCount; i++) {
+        mq->heaps[i].lock = 0;
+        mq->heaps[i].count = 0;
+        mq->heaps[i].top = 0;
+        mq->heaps[i].heap = newBinHeap(PD, NON_CONCURRENT_BIN_HEAP);
+    }
+    mq->seedCount = workerCount;
+    mq->seeds = (prMqSeed_t*)PD->fcts.pdMalloc(PD, sizeof(prMqSeed_t) * mq->seedCount);
+    for (i = 0; i < mq->seedCount; i++) {
+        // Any non-zero distinct value will do
+        mq->seeds[i].state = 0x9E3779B97F4A7C15ULL * (u64)(i + 1);
+    }
+    DPRINTF(DEBUG_LVL_VERB, "PR_MQ started with %"PRIu32" heaps (relax=%"PRIu32")\n", mq->heapCount, mq->relax);
+}
+
+static void prMqSchedulerObjectFinish(ocrSchedulerObject_t *self, ocrPolicyDomain_t *PD) {
+    ocrSchedulerObjectPrMq_t *mq = (ocrSchedulerObjectPrMq_t*)self;
+    u32 i;
+    for (i = 0; i < mq->heapCount; i++) {
+        binHeap_t *heap = mq->heaps[i].heap;
+        heap->destruct(PD, heap);
+    }
+    PD->fcts.pdFree(PD, mq->heaps);
+    PD->fcts.pdFree(PD, mq->seeds);
+    mq->heaps = NULL;
+    mq->seeds = NULL;
+    mq->heapCount = 0;
+    mq->seedCount = 0;
+}
+
+static void prMqSchedulerObjectInitialize(ocrSchedulerObjectFactory_t *fact, ocrSchedulerObject_t *self, u32 relax) {
+    self->guid.guid = NULL_GUID;
+    self->guid.metaDataPtr = self;
+    self->kind = OCR_SCHEDULER_OBJECT_PR_MQ;
+    self->fctId = fact->factoryId;
+    self->loc = INVALID_LOCATION;
+    self->mapping = OCR_SCHEDULER_OBJECT_MAPPING_UNDEFINED;
+    ocrSchedulerObjectPrMq_t* mq = (ocrSchedulerObjectPrMq_t*)self;
+    mq->relax = relax;
+    mq->heapCount = 0;
+    mq->heaps = NULL;
+    mq->seedCount = 0;
+    mq->seeds = NULL;
+}
+
+ocrSchedulerObject_t* newSchedulerObjectPrMq(ocrSchedulerObjectFactory_t *factory, ocrParamList_t *perInstance) {
+    paramListSchedulerObject_t *paramSchedObj __attribute__((unused)) = (paramListSchedulerObject_t*)perInstance;
+    ASSERT(paramSchedObj->config);
+    ASSERT(!paramSchedObj->guidRequired);
+    ASSERT(perInstance->size == sizeof(paramListSchedulerObjectPrMq_t));
+    ocrSchedulerObject_t* schedObj = (ocrSchedulerObject_t*)runtimeChunkAlloc(sizeof(ocrSchedulerObjectPrMq_t), PERSISTENT_CHUNK);
+    prMqSchedulerObjectInitialize(factory, schedObj, ((paramListSchedulerObjectPrMq_t*)perInstance)->relax);
+    schedObj->kind |= OCR_SCHEDULER_OBJECT_ALLOC_CONFIG;
+    return schedObj;
+}
+
+ocrSchedulerObject_t* prMqSchedulerObjectCreate(ocrSchedulerObjectFactory_t *factory, ocrParamList_t *perInstance) {
+    paramListSchedulerObject_t *paramSchedObj __attribute__((unused)) = (paramListSchedulerObject_t*)perInstance;
+    ASSERT(!paramSchedObj->config);
+    ASSERT(!paramSchedObj->guidRequired);
+    ocrPolicyDomain_t *pd = NULL;
+    getCurrentEnv(&pd, NULL, NULL, NULL);
+    ocrSchedulerObject_t* schedObj = (ocrSchedulerObject_t*)pd->fcts.pdMalloc(pd, sizeof(ocrSchedulerObjectPrMq_t));
+    prMqSchedulerObjectInitialize(factory, schedObj, ((paramListSchedulerObjectPrMq_t*)perInstance)->relax);
+    prMqSchedulerObjectStart(schedObj, pd);
+    schedObj->kind |= OCR_SCHEDULER_OBJECT_ALLOC_PD;
+    return schedObj;
+}
+
+u8 prMqSchedulerObjectDestroy(ocrSchedulerObjectFactory_t *fact, ocrSchedulerObject_t *self) {
+    if (IS_SCHEDULER_OBJECT_CONFIG_ALLOCATED(self->kind)) {
+        runtimeChunkFree((u64)self, PERSISTENT_CHUNK);
+    } else {
+        ASSERT(IS_SCHEDULER_OBJECT_PD_ALLOCATED(self->kind));
+        ocrPolicyDomain_t *pd = NULL;
+        getCurrentEnv(&pd, NULL, NULL, NULL);
+        prMqSchedulerObjectFinish(self, pd);
+        pd->fcts.pdFree(pd, self);
+    }
+    return 0;
+}
+
+u8 prMqSchedulerObjectInsert(ocrSchedulerObjectFactory_t *fact, ocrSchedulerObject_t *self, ocrSchedulerObject_t *element, ocrSchedulerObjectIterator_t *iterator, u32 properties) {
+    ocrSchedulerObjectPrMq_t *mq = (ocrSchedulerObjectPrMq_t*)self;
+    ASSERT(IS_SCHEDULER_OBJECT_TYPE_SINGLETON(element->kind));
+    ocrGuid_t edtGuid = element->guid.guid;
+    s64 priority = 0;
+    { // read EDT hint
+        ASSERT(element->kind == OCR_SCHEDULER_OBJECT_EDT);
+        ocrHint_t edtHints;
+        ocrHintInit(&edtHints, OCR_HINT_EDT_T);
+        ocrGetHint(edtGuid, &edtHints);
+        ocrGetHintValue(&edtHints, OCR_HINT_EDT_PRIORITY, (u64*)&priority);
+    }
+
+    // Start at a random heap; move on to the next one if it is busy
+    // so that a push never waits on a contended lock.
+    const u32 n = mq->heapCount;
+    u32 idx = (n == 1) ? 0 : (prMqRandom(mq) % n);
+    u32 tries = 0;
+    prMqHeap_t *h = &mq->heaps[idx];
+    while (hal_trylock32(&h->lock) != 0) {
+        // After a full round of failed trylocks, block on the lock
+        if (++tries >= n) {
+            hal_lock32(&h->lock);
+            break;
+        }
+        idx = (idx + 1) % n;
+        h = &mq->heaps[idx];
+    }
+    // See BUG #928 on GUID issues
+#if GUID_BIT_COUNT == 64
+    h->heap->push(h->heap, (void *)edtGuid.guid, priority, 0);
+#elif GUID_BIT_COUNT == 128
+    h->heap->push(h->heap, (void *)edtGuid.lower, priority, 0);
+#endif
+    prMqPublishTop(h);
+    hal_unlock32(&h->lock);
+    return 0;
+}
+
+// Pop from heap 'h' if it is not empty; the lock must be held
+static inline ocrGuid_t prMqPopLocked(prMqHeap_t *h) {
+    ocrGuid_t retGuid = NULL_GUID;
+    // See BUG #928 on GUID issues
+    void *data = h->heap->pop(h->heap, 0);
+    prMqPublishTop(h);
+#if GUID_BIT_COUNT == 64
+    if (data) retGuid.guid = (intptr_t)data;
+#elif GUID_BIT_COUNT == 128
+    if (data) retGuid.lower = (intptr_t)data;
+#endif
+    return retGuid;
+}
+
+static ocrGuid_t prMqPop(ocrSchedulerObjectPrMq_t *mq) {
+    const u32 n = mq->heapCount;
+    ocrGuid_t retGuid = NULL_GUID;
+    u32 attempt;
+    if (n > 1) {
+        for (attempt = 0; attempt < PR_MQ_POP_ATTEMPTS; attempt++) {
+            u32 r = prMqRandom(mq);
+            u32 i = r % n;
+            u32 j = (r >> 16) % n;
+            s64 pi = 0, pj = 0;
+            bool hi = prMqPeek(&mq->heaps[i], &pi);
+            bool hj = prMqPeek(&mq->heaps[j], &pj);
+            if (!hi && !hj)
+                continue;
+            prMqHeap_t *h = (!hj || (hi && (pi >= pj))) ? &mq->heaps[i] : &mq->heaps[j];
+            if (hal_trylock32(&h->lock) != 0)
+                continue;
+            retGuid = prMqPopLocked(h);
+            hal_unlock32(&h->lock);
+            if (!ocrGuidIsNull(retGuid))
+                return retGuid;
+        }
+    }
+    // Random sampling came up empty: sweep all heaps so that we never
+    // report an empty queue while some heap still holds work.
+    u32 start = (n == 1) ? 0 : (prMqRandom(mq) % n);
+    for (attempt = 0; attempt < n; attempt++) {
+        prMqHeap_t *h = &mq->heaps[(start + attempt) % n];
+        if (h->count == 0)
+            continue;
+        hal_lock32(&h->lock);
+        retGuid = prMqPopLocked(h);
+        hal_unlock32(&h->lock);
+        if (!ocrGuidIsNull(retGuid))
+            break;
+    }
+    return retGuid;
+}
+
+u8 prMqSchedulerObjectRemove(ocrSchedulerObjectFactory_t *fact, ocrSchedulerObject_t *self, ocrSchedulerObjectKind kind, u32 count, ocrSchedulerObject_t *dst, ocrSchedulerObjectIterator_t *iterator, u32 properties) {
+    u32 i;
+    ocrSchedulerObjectPrMq_t *mq = (ocrSchedulerObjectPrMq_t*)self;
+    ASSERT(IS_SCHEDULER_OBJECT_TYPE_SINGLETON(kind));
+    if (mq->heaps == NULL) return count;
+
+    for (i = 0; i < count; i++) {
+        ocrGuid_t retGuid = NULL_GUID;
+        switch(properties) {
+        case SCHEDULER_OBJECT_REMOVE_TAIL:
+        case SCHEDULER_OBJECT_REMOVE_HEAD:
+            {
+                // There is no owner/thief distinction: all pops are relaxed
+                START_PROFILE(sched_prMq_Pop);
+                retGuid = prMqPop(mq);
+                EXIT_PROFILE;
+            }
+            break;
+        default:
+            ASSERT(0);
+            return OCR_ENOTSUP;
+        }
+
+        if(ocrGuidIsNull(retGuid))
+            break;
+
+        if (IS_SCHEDULER_OBJECT_TYPE_SINGLETON(dst->kind)) {
+            ASSERT(ocrGuidIsNull(dst->guid.guid) && count == 1);
+            dst->guid.guid = retGuid;
+        } else {
+            ocrSchedulerObject_t taken;
+            taken.guid.guid = retGuid;
+            taken.kind = kind;
+            ocrSchedulerObjectFactory_t *dstFactory = fact->pd->schedulerObjectFactories[dst->fctId];
+            dstFactory->fcts.insert(dstFactory, dst, &taken, NULL, 0);
+        }
+    }
+
+    // Success (0) if at least one element has been removed
+    return (i == 0);
+}
+
+u64 prMqSchedulerObjectCount(ocrSchedulerObjectFactory_t *fact, ocrSchedulerObject_t *self, u32 properties) {
+    ocrSchedulerObjectPrMq_t *mq = (ocrSchedulerObjectPrMq_t*)self;
+    u64 count = 0;
+    u32 i;
+    // This may be racy but ok for approx count
+    for (i = 0; i < mq->heapCount; i++) {
+        count += mq->heaps[i].count;
+    }
+    return count;
+}
+
+ocrSchedulerObjectIterator_t* prMqSchedulerObjectCreateIterator(ocrSchedulerObjectFactory_t *fact, ocrSchedulerObject_t *self, u32 properties) {
+    ASSERT(0);
+    return NULL;
+}
+
+u8 prMqSchedulerObjectDestroyIterator(ocrSchedulerObjectFactory_t * fact, ocrSchedulerObjectIterator_t *iterator) {
+    ASSERT(0);
+    return OCR_ENOTSUP;
+}
+
+u8 prMqSchedulerObjectIterate(ocrSchedulerObjectFactory_t *fact, ocrSchedulerObjectIterator_t *iterator, u32 properties) {
+    ASSERT(0);
+    return OCR_ENOTSUP;
+}
+
+ocrSchedulerObject_t* prMqGetSchedulerObjectForLocation(ocrSchedulerObjectFactory_t *fact, ocrSchedulerObject_t *self, ocrSchedulerObjectKind kind, ocrLocation_t loc, ocrSchedulerObjectMappingKind mapping, u32 properties) {
+    // All workers share the whole multi-queue
+    return self;
+}
+
+u8 prMqSetLocationForSchedulerObject(ocrSchedulerObjectFactory_t *fact, ocrSchedulerObject_t *self, ocrLocation_t loc, ocrSchedulerObjectMappingKind mapping) {
+    self->loc = loc;
+    self->mapping = mapping;
+    return 0;
+}
+
+ocrSchedulerObjectActionSet_t* prMqSchedulerObjectNewActionSet(ocrSchedulerObjectFactory_t *fact, ocrSchedulerObject_t *self, u32 count) {
+    ASSERT(0);
+    return NULL;
+}
+
+u8 prMqSchedulerObjectDestroyActionSet(ocrSchedulerObjectFactory_t *fact, ocrSchedulerObjectActionSet_t *actionSet) {
+    ASSERT(0);
+    return OCR_ENOTSUP;
+}
+
+u8 prMqSchedulerObjectSwitchRunlevel(ocrSchedulerObject_t *self, ocrPolicyDomain_t *PD, ocrRunlevel_t runlevel,
+                                    phase_t phase, u32 properties, void (*callback)(ocrPolicyDomain_t*, u64), u64 val) {
+
+    u8 toReturn = 0;
+
+    // This is an inert module, we do not handle callbacks (caller needs to wait on us)
+    ASSERT(callback == NULL);
+
+    // Verify properties for this call
+    ASSERT((properties & RL_REQUEST) && !(properties & RL_RESPONSE)
+           && !(properties & RL_RELEASE));
+    ASSERT(!(properties & RL_FROM_MSG));
+
+    switch(runlevel) {
+    case RL_CONFIG_PARSE:
+        // On bring-up: Update PD->phasesPerRunlevel on phase 0
+        // and check compatibility on phase 1
+        break;
+    case RL_NETWORK_OK:
+        break;
+    case RL_PD_OK:
+        break;
+    case RL_MEMORY_OK:
+        DPRINTF(DEBUG_LVL_VVERB, "Runlevel: RL_MEMORY_OK\n");
+        if((properties & RL_BRING_UP) && RL_IS_FIRST_PHASE_UP(PD, RL_PD_OK, phase)) {
+            u32 i;
+            // The scheduler calls this before switching itself. Do we want
+            // to invert this?
+            for(i = 0; i < PD->schedulerObjectFactoryCount; ++i) {
+                if(PD->schedulerObjectFactories[i])
+                    PD->schedulerObjectFactories[i]->pd = PD;
+            }
+        }
+        break;
+    case RL_GUID_OK:
+        DPRINTF(DEBUG_LVL_VVERB, "Runlevel: RL_GUID_OK\n");
+        // Memory is up
+        if(properties & RL_BRING_UP) {
+            if(RL_IS_FIRST_PHASE_UP(PD, RL_MEMORY_OK, phase)) {
+                prMqSchedulerObjectStart(self, PD);
+            }
+        } else {
+            // Tear down
+            if(RL_IS_LAST_PHASE_DOWN(PD, RL_MEMORY_OK, phase)) {
+                prMqSchedulerObjectFinish(self, PD);
+            }
+        }
+        break;
+    case RL_COMPUTE_OK:
+        break;
+    case RL_USER_OK:
+        break;
+    default:
+        ASSERT(0);
+    }
+    return toReturn;
+}
+
+u8 prMqSchedulerObjectOcrPolicyMsgGetMsgSize(ocrSchedulerObjectFactory_t *fact, ocrPolicyMsg_t *msg, u64 *marshalledSize, u32 properties) {
+    ASSERT(0);
+    return OCR_ENOTSUP;
+}
+
+u8 prMqSchedulerObjectOcrPolicyMsgMarshallMsg(ocrSchedulerObjectFactory_t *fact, ocrPolicyMsg_t *msg, u8 *buffer, u32 properties) {
+    ASSERT(0);
+    return OCR_ENOTSUP;
+}
+
+u8 prMqSchedulerObjectOcrPolicyMsgUnMarshallMsg(ocrSchedulerObjectFactory_t *fact, ocrPolicyMsg_t *msg, u8 *localMainPtr, u8 *localAddlPtr, u32 properties) {
+    ASSERT(0);
+    return OCR_ENOTSUP;
+}
+
+/*********************************************************/
+/* OCR PR-MQ SCHEDULER_OBJECT FACTORY FUNCTIONS          */
+/*********************************************************/
+
+void destructSchedulerObjectFactoryPrMq(ocrSchedulerObjectFactory_t * factory) {
+    runtimeChunkFree((u64)factory, PERSISTENT_CHUNK);
+}
+
+ocrSchedulerObjectFactory_t * newOcrSchedulerObjectFactoryPrMq(ocrParamList_t *perType, u32 factoryId) {
+    ocrSchedulerObjectFactory_t *schedObjFact = (ocrSchedulerObjectFactory_t*) runtimeChunkAlloc(
+                                      sizeof(ocrSchedulerObjectFactoryPrMq_t), PERSISTENT_CHUNK);
+
+    schedObjFact->factoryId = schedulerObjectPrMq_id;
+    schedObjFact->kind = OCR_SCHEDULER_OBJECT_PR_MQ;
+    schedObjFact->pd = NULL;
+
+    schedObjFact->destruct = &destructSchedulerObjectFactoryPrMq;
+    schedObjFact->instantiate = &newSchedulerObjectPrMq;
+
+    schedObjFact->fcts.create = FUNC_ADDR(ocrSchedulerObject_t* (*)(ocrSchedulerObjectFactory_t*, ocrParamList_t*), prMqSchedulerObjectCreate);
+    schedObjFact->fcts.destroy = FUNC_ADDR(u8 (*)(ocrSchedulerObjectFactory_t*, ocrSchedulerObject_t*), prMqSchedulerObjectDestroy);
+    schedObjFact->fcts.insert = FUNC_ADDR(u8 (*)(ocrSchedulerObjectFactory_t*, ocrSchedulerObject_t*, ocrSchedulerObject_t*, ocrSchedulerObjectIterator_t*, u32), prMqSchedulerObjectInsert);
+    schedObjFact->fcts.remove = FUNC_ADDR(u8 (*)(ocrSchedulerObjectFactory_t*, ocrSchedulerObject_t*, ocrSchedulerObjectKind, u32, ocrSchedulerObject_t*, ocrSchedulerObjectIterator_t*, u32), prMqSchedulerObjectRemove);
+    schedObjFact->fcts.count = FUNC_ADDR(u64 (*)(ocrSchedulerObjectFactory_t*, ocrSchedulerObject_t*, u32), prMqSchedulerObjectCount);
+    schedObjFact->fcts.createIterator = FUNC_ADDR(ocrSchedulerObjectIterator_t* (*)(ocrSchedulerObjectFactory_t*, ocrSchedulerObject_t*, u32), prMqSchedulerObjectCreateIterator);
+    schedObjFact->fcts.destroyIterator = FUNC_ADDR(u8 (*)(ocrSchedulerObjectFactory_t*, ocrSchedulerObjectIterator_t*), prMqSchedulerObjectDestroyIterator);
+    schedObjFact->fcts.iterate = FUNC_ADDR(u8 (*)(ocrSchedulerObjectFactory_t*, ocrSchedulerObjectIterator_t*, u32), prMqSchedulerObjectIterate);
+    schedObjFact->fcts.setLocationForSchedulerObject = FUNC_ADDR(u8 (*)(ocrSchedulerObjectFactory_t*, ocrSchedulerObject_t*, ocrLocation_t, ocrSchedulerObjectMappingKind), prMqSetLocationForSchedulerObject);
+    schedObjFact->fcts.getSchedulerObjectForLocation = FUNC_ADDR(ocrSchedulerObject_t* (*)(ocrSchedulerObjectFactory_t*, ocrSchedulerObject_t*, ocrSchedulerObjectKind, ocrLocation_t, ocrSchedulerObjectMappingKind, u32), prMqGetSchedulerObjectForLocation);
+    schedObjFact->fcts.createActionSet = FUNC_ADDR(ocrSchedulerObjectActionSet_t* (*)(ocrSchedulerObjectFactory_t*, ocrSchedulerObject_t*, u32), prMqSchedulerObjectNewActionSet);
+    schedObjFact->fcts.destroyActionSet = FUNC_ADDR(u8 (*)(ocrSchedulerObjectFactory_t*, ocrSchedulerObjectActionSet_t*), prMqSchedulerObjectDestroyActionSet);
+    schedObjFact->fcts.switchRunlevel = FUNC_ADDR(u8 (*)(ocrSchedulerObject_t*, ocrPolicyDomain_t*, ocrRunlevel_t,
+                                                        phase_t, u32, void (*)(ocrPolicyDomain_t*, u64), u64), prMqSchedulerObjectSwitchRunlevel);
+    schedObjFact->fcts.ocrPolicyMsgGetMsgSize = FUNC_ADDR(u8 (*)(ocrSchedulerObjectFactory_t*, ocrPolicyMsg_t*, u64*, u32), prMqSchedulerObjectOcrPolicyMsgGetMsgSize);
+    schedObjFact->fcts.ocrPolicyMsgMarshallMsg = FUNC_ADDR(u8 (*)(ocrSchedulerObjectFactory_t*, ocrPolicyMsg_t*, u8*, u32), prMqSchedulerObjectOcrPolicyMsgMarshallMsg);
+    schedObjFact->fcts.ocrPolicyMsgUnMarshallMsg = FUNC_ADDR(u8 (*)(ocrSchedulerObjectFactory_t*, ocrPolicyMsg_t*, u8*, u8*, u32), prMqSchedulerObjectOcrPolicyMsgUnMarshallMsg);
+    return schedObjFact;
+}
+
+#endif /* ENABLE_SCHEDULER_OBJECT_PR_MQ */
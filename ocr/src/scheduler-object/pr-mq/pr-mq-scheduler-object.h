@@ -0,0 +1,74 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#ifndef __PR_MQ_SCHEDULER_OBJECT_H__
+#define __PR_MQ_SCHEDULER_OBJECT_H__
+
+#include "ocr-config.h"
+#ifdef ENABLE_SCHEDULER_OBJECT_PR_MQ
+
+#include "ocr-scheduler-object.h"
+#include "ocr-types.h"
+#include "utils/ocr-utils.h"
+#include "utils/bin-heap.h"
+
+/****************************************************/
+/* OCR PR_MQ SCHEDULER_OBJECT                       */
+/* (relaxed priority multi-queue)                   */
+/****************************************************/
+
+// Default number of heaps per worker. The object holds
+// relax * workerCount heaps; a pop returns the best of two
+// randomly sampled heap tops so the expected rank error grows
+// with that product. A relax of 0 degenerates to a single
+// heap, i.e. strict priority order.
+#ifndef PR_MQ_RELAX_FACTOR
+#define PR_MQ_RELAX_FACTOR 2
+#endif
+
+typedef struct _paramListSchedulerObjectPrMq_t {
+    paramListSchedulerObject_t base;
+    u32 relax;                      /* Heaps per worker (0 for a single heap) */
+} paramListSchedulerObjectPrMq_t;
+
+typedef struct _prMqHeap_t {
+    volatile u32 lock;
+    volatile u32 count;             /* Copy of heap->count, for racy peeks */
+    volatile s64 top;               /* Priority of the top element, valid if count != 0 */
+    binHeap_t *heap;                /* non-concurrent heap, protected by lock */
+    u8 padding[64-2*sizeof(u32)-sizeof(s64)-sizeof(binHeap_t*)];
+} prMqHeap_t;
+
+typedef struct _prMqSeed_t {
+    u64 state;                      /* per-worker xorshift state */
+    u8 padding[64-sizeof(u64)];
+} prMqSeed_t;
+
+typedef struct _ocrSchedulerObjectPrMq_t {
+    ocrSchedulerObject_t base;
+    u32 relax;                      /* Heaps per worker */
+    u32 heapCount;                  /* Total number of heaps */
+    prMqHeap_t *heaps;
+    u32 seedCount;
+    prMqSeed_t *seeds;              /* Indexed by worker id */
+} ocrSchedulerObjectPrMq_t;
+
+/****************************************************/
+/* OCR PR_MQ SCHEDULER_OBJECT FACTORY               */
+/****************************************************/
+
+typedef struct _ocrSchedulerObjectFactoryPrMq_t {
+    ocrSchedulerObjectFactory_t base;
+} ocrSchedulerObjectFactoryPrMq_t;
+
+typedef struct _paramListSchedulerObjectFactPrMq_t {
+    paramListSchedulerObjectFact_t base;
+} paramListSchedulerObjectFactPrMq_t;
+
+ocrSchedulerObjectFactory_t * newOcrSchedulerObjectFactoryPrMq(ocrParamList_t *perType, u32 factoryId);
+
+#endif /* ENABLE_SCHEDULER_OBJECT_PR_MQ */
+#endif /* __PR_MQ_SCHEDULER_OBJECT_H__ */
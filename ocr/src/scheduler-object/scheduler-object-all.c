@@ -37,6 +37,9 @@ const char * schedulerObject_types[] = {
 #endif
 #ifdef ENABLE_SCHEDULER_OBJECT_BIN_HEAP
     "BIN_HEAP",
+#endif
+#ifdef ENABLE_SCHEDULER_OBJECT_PR_MQ
+    "PR_MQ",
 #endif
     NULL
 };
@@ -82,6 +85,10 @@ ocrSchedulerObjectFactory_t * newSchedulerObjectFactory(schedulerObjectType_t ty
 #ifdef ENABLE_SCHEDULER_OBJECT_BIN_HEAP
     case schedulerObjectBinHeap_id:
         return newOcrSchedulerObjectFactoryBinHeap(perType, (u32)type);
+#endif
+#ifdef ENABLE_SCHEDULER_OBJECT_PR_MQ
+    case schedulerObjectPrMq_id:
+        return newOcrSchedulerObjectFactoryPrMq(perType, (u32)type);
 #endif
     default:
         ASSERT(0);
@@ -41,6 +41,9 @@
 #ifdef ENABLE_SCHEDULER_OBJECT_BIN_HEAP
 #include "scheduler-object/bin-heap/bin-heap-scheduler-object.h"
 #endif
+#ifdef ENABLE_SCHEDULER_OBJECT_PR_MQ
+#include "scheduler-object/pr-mq/pr-mq-scheduler-object.h"
+#endif
 
 typedef enum _schedulerObjectType_t {
 #ifdef ENABLE_SCHEDULER_OBJECT_NULL
@@ -72,6 +75,9 @@ typedef enum _schedulerObjectType_t {
 #endif
 #ifdef ENABLE_SCHEDULER_OBJECT_BIN_HEAP
     schedulerObjectBinHeap_id,
+#endif
+#ifdef ENABLE_SCHEDULER_OBJECT_PR_MQ
+    schedulerObjectPrMq_id,
 #endif
     schedulerObjectMax_id
 } schedulerObjectType_t;
@@ -44,6 +44,10 @@ static void wstSchedulerObjectStart(ocrSchedulerObject_t *self, ocrPolicyDomain_
     params.base.guidRequired = 0;
     params.type = WORK_STEALING_DEQUE;
     ocrSchedulerObjectFactory_t *dequeFactory = pd->schedulerObjectFactories[schedulerObjectDeq_id];
+    if (wstSchedObj->config == SCHEDULER_OBJECT_WST_CONFIG_LOCKED) {
+        // Any worker may push to any deque
+        params.type = LOCKED_DEQUE;
+    }
     for (i = 0, w = 0; i < numDeques; i++) {
         if (wstSchedObj->config == SCHEDULER_OBJECT_WST_CONFIG_STATIC) {
             params.type = SEMI_CONCURRENT_DEQUE;
@@ -99,6 +103,7 @@ static void wstSchedulerObjectInitialize(ocrSchedulerObjectFactory_t *fact, ocrS
     switch(paramsWst->config) {
     case SCHEDULER_OBJECT_WST_CONFIG_REGULAR:
     case SCHEDULER_OBJECT_WST_CONFIG_STATIC:
+    case SCHEDULER_OBJECT_WST_CONFIG_LOCKED:
         break;
     default:
         ASSERT(0);
@@ -223,7 +223,7 @@ u8 commonSchedulerMonitorProgress(ocrScheduler_t *self, ocrMonitorProgress_t typ
     // Current implementation assumes the worker is blocked.
     ocrWorker_t * worker;
     getCurrentEnv(NULL, &worker, NULL, NULL);
-    handleWorkerNotProgressing(worker);
+    handleWorkerNotProgressing(worker, type, monitoree);
 #endif
     return 0;
 }
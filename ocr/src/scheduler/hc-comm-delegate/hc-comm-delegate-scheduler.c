@@ -9,8 +9,7 @@
 
 #include "debug.h"
 #include "ocr-sysboot.h"
-#include "utils/deque.h"
-#include "utils/list.h"
+#include "ocr-comm-platform.h"
 #include "worker/hc/hc-worker.h"
 #include "scheduler/hc-comm-delegate/hc-comm-delegate-scheduler.h"
 #include "comm-api/delegate/delegate-comm-api.h"
@@ -23,8 +22,9 @@
  * comp-workers produce and give communication work to the scheduler
  * while comm-workers take and consume communication work.
  *
- * IMPL: There is one outbox deque per worker. Communication workers can
- *       steal handlers from other workers outbox.
+ * IMPL: There is one outbox per communication worker, each in charge of
+ *       the PDs of a lane (see commPlatformLaneOf), and one inbox per
+ *       worker. Both are lock-free MPSC queues.
  */
 
 u8 hcCommSchedulerSwitchRunlevel(ocrScheduler_t *self, ocrPolicyDomain_t *PD, ocrRunlevel_t runlevel,
@@ -55,32 +55,44 @@ u8 hcCommSchedulerSwitchRunlevel(ocrScheduler_t *self, ocrPolicyDomain_t *PD, oc
         ASSERT(self->pd == PD);
         if((properties & RL_BRING_UP) && RL_IS_LAST_PHASE_UP(PD, RL_GUID_OK, phase)) {
             //Note: pd should have been set in base implementation
-            //Create outbox queues for each worker
-            u64 boxCount = PD->workerCount;
-            commSched->outboxesCount = boxCount;
-            commSched->outboxes = PD->fcts.pdMalloc(PD, sizeof(deque_t *) * boxCount);
+            //Create an outbox per comm-worker. They come first among workers.
+            u64 laneCount = 0;
+            while ((laneCount < PD->workerCount) &&
+                   (((ocrWorkerHc_t *) PD->workers[laneCount])->hcType == HC_WORKER_COMM)) {
+                laneCount++;
+            }
+            ASSERT(laneCount > 0);
+            commSched->outboxesCount = laneCount;
+            commSched->outboxes = PD->fcts.pdMalloc(PD, sizeof(mpscQueue_t) * laneCount);
             u64 i;
-            for(i = 0; i < boxCount; ++i) {
-                commSched->outboxes[i] = newDeque(PD, NULL, WORK_STEALING_DEQUE);
+            for(i = 0; i < laneCount; ++i) {
+                mpscQueueInit(&(commSched->outboxes[i]));
             }
             //Create inbox queues for each worker
+            u64 boxCount = PD->workerCount;
             commSched->inboxesCount = boxCount;
-            commSched->inboxes = PD->fcts.pdMalloc(PD, sizeof(deque_t *) * boxCount);
+            commSched->inboxes = PD->fcts.pdMalloc(PD, sizeof(mpscQueue_t) * boxCount);
+            commSched->stashes = PD->fcts.pdMalloc(PD, sizeof(mpscQueueNode_t *) * boxCount);
             for(i = 0; i < boxCount; ++i) {
-                commSched->inboxes[i] = newDeque(PD, NULL, SEMI_CONCURRENT_DEQUE);
+                mpscQueueInit(&(commSched->inboxes[i]));
+                commSched->stashes[i] = NULL;
             }
         }
         if ((properties & RL_TEAR_DOWN) && RL_IS_FIRST_PHASE_DOWN(PD, RL_GUID_OK, phase)) {
             // deallocate all pdMalloc-ed structures
+#ifdef OCR_ASSERT
             u64 i;
             for(i = 0; i < commSched->outboxesCount; ++i) {
-                commSched->outboxes[i]->destruct(PD, commSched->outboxes[i]);
+                ASSERT(mpscQueueIsEmpty(&(commSched->outboxes[i])));
             }
             for(i = 0; i < commSched->inboxesCount; ++i) {
-                commSched->inboxes[i]->destruct(PD, commSched->inboxes[i]);
+                ASSERT(mpscQueueIsEmpty(&(commSched->inboxes[i])));
+                ASSERT(commSched->stashes[i] == NULL);
             }
+#endif
             PD->fcts.pdFree(PD, commSched->outboxes);
             PD->fcts.pdFree(PD, commSched->inboxes);
+            PD->fcts.pdFree(PD, commSched->stashes);
         }
         commSched->baseSwitchRunlevel(self, PD, runlevel, phase, properties, callback, val);
         break;
@@ -111,90 +123,61 @@ u8 hcCommSchedulerTakeComm(ocrScheduler_t *self, u32* count, ocrFatGuid_t * fatH
     u64 wid = worker->id;
 
     if (((ocrWorkerHc_t *) worker)->hcType == HC_WORKER_COMM) {
-        // Steal from other worker's outbox
-        //PERF: use real randomized iterator here
-        // Try a round of stealing on other worker's outbox
-        //NOTE: If we don't care about wasting a steal on self, we wouldn't need
-        //      the whole worker ID business
-        //NOTE: It's debatable whether we should steal a bunch from each outbox
-        //      or go over all outboxes
-        deque_t ** outboxes = commSched->outboxes;
-        u64 outboxesCount = commSched->outboxesCount;
+        // Drain the outbox of the lane this comm-worker is in charge of.
+        // Any worker may be pushing to it concurrently.
+        ASSERT(wid < commSched->outboxesCount);
+        mpscQueue_t * outbox = &(commSched->outboxes[wid]);
         u32 success = 0;
-
-#ifdef HYBRID_COMM_COMP_WORKER // Experimental see documentation
-        // Try to pop from own outbox first (support HYBRID_COMM_COMP_WORKER mode)
-        ocrMsgHandle_t* handle = outboxes[wid]->popFromTail(outboxes[wid], 1);
-        if (handle != NULL) {
-            fatHandlers[success].metaDataPtr = handle;
-            success++;
-        }
-#endif
-
-        u64 i = (wid+1); // skip over 'self' outbox
-        while ((i < (wid+outboxesCount)) && (success < *count)) {
-            deque_t * deque = outboxes[i%outboxesCount];
-            ocrMsgHandle_t* handle = deque->popFromHead(deque, 1);
-            if (handle != NULL) {
-                fatHandlers[success].metaDataPtr = handle;
-                success++;
+        while (success < *count) {
+            mpscQueueNode_t * node = mpscQueuePop(outbox);
+            if (node == NULL) {
+                break;
             }
-            i++;
+            fatHandlers[success].metaDataPtr = DELEGATE_HANDLE_OF_NODE(node);
+            success++;
         }
         *count = success;
     } else {
-        //BUG #586 Should really revisit this implementation. It sounds awfully slow.
         ASSERT(((ocrWorkerHc_t *) worker)->hcType == HC_WORKER_COMP);
-        deque_t * inbox = commSched->inboxes[wid];
+        mpscQueue_t * inbox = &(commSched->inboxes[wid]);
         u32 curIdx = 0;
-        linkedlist_t * candidateList = NULL;
         while(curIdx < *count) {
             ocrMsgHandle_t ** target = (ocrMsgHandle_t **) fatHandlers[curIdx].metaDataPtr;
             bool isSpecificTarget = ((target != NULL) && (*target != NULL));
+            // Don't think we go through this but double check
+            ASSERT(isSpecificTarget && "comp-worker poll for any");
             ocrMsgHandle_t * candidate = NULL;
-            if (isSpecificTarget && (candidateList != NULL)) {
-                //Look through previous steals
-                iterator_t * iterator = candidateList->iterator(candidateList);
-                while (iterator->hasNext(iterator)) {
-                    ocrMsgHandle_t * handle = (ocrMsgHandle_t *) iterator->next(iterator);
-                    if (handle == *target) {
-                        // found a candidate in the previous steals
-                        candidate = handle;
-                        iterator->removeCurrent(iterator);
-                        fatHandlers[curIdx].metaDataPtr = candidate;
-                        curIdx++;
-                        break;
-                    }
+            // Look through handles previous takes came across. The stash is private
+            // to this worker: the inbox only ever holds responses to its own requests.
+            mpscQueueNode_t * volatile * prev = &(commSched->stashes[wid]);
+            while (*prev != NULL) {
+                if (!isSpecificTarget || ((ocrMsgHandle_t *) DELEGATE_HANDLE_OF_NODE(*prev) == *target)) {
+                    candidate = (ocrMsgHandle_t *) DELEGATE_HANDLE_OF_NODE(*prev);
+                    *prev = (*prev)->next;
+                    break;
                 }
-                iterator->destruct(iterator);
+                prev = &((*prev)->next);
             }
-            if (candidate == NULL) {
-                // 'steal' from own inbox, comm-worker pushes to it
-                candidate = (ocrMsgHandle_t *) inbox->popFromHead(inbox, 0);
-                if (candidate == NULL) {
-                    // No message available
+            // Pop from own inbox, comm-workers push to it
+            while (candidate == NULL) {
+                mpscQueueNode_t * node = mpscQueuePop(inbox);
+                if (node == NULL) {
                     break;
                 }
-                if (isSpecificTarget) {
-                    if (candidate != *target) {
-                        if (candidateList == NULL) {
-                            ocrPolicyDomain_t * pd;
-                            getCurrentEnv(&pd, NULL, NULL, NULL);
-                            candidateList = newLinkedList(pd);
-                        }
-                        candidateList->pushFront(candidateList, candidate);
-                    } else {
-                        fatHandlers[curIdx].metaDataPtr = candidate;
-                        curIdx++;
-                    }
+                ocrMsgHandle_t * handle = (ocrMsgHandle_t *) DELEGATE_HANDLE_OF_NODE(node);
+                if (!isSpecificTarget || (handle == *target)) {
+                    candidate = handle;
                 } else {
-                    // Found a handle and none specific was required.
-                    // Don't think we go through this but double check
-                    ASSERT(false && "comp-worker poll for any");
-                    fatHandlers[curIdx].metaDataPtr = candidate;
-                    curIdx++;
+                    node->next = commSched->stashes[wid];
+                    commSched->stashes[wid] = node;
                 }
             }
+            if (candidate == NULL) {
+                // No message available
+                break;
+            }
+            fatHandlers[curIdx].metaDataPtr = candidate;
+            curIdx++;
         }
         u32 i = curIdx;
         while (i < *count) { // nullify remaining handlers
@@ -202,18 +185,6 @@ u8 hcCommSchedulerTakeComm(ocrScheduler_t *self, u32* count, ocrFatGuid_t * fatH
             i++;
         }
         *count = curIdx;
-        if (candidateList != NULL) {
-            // Put stolen handles for which there's no interest back
-            iterator_t * iterator = candidateList->iterator(candidateList);
-            while (iterator->hasNext(iterator)) {
-                ocrMsgHandle_t * handle = (ocrMsgHandle_t *) iterator->next(iterator);
-                // Push is concurrent with comm-worker populating the inbox
-                inbox->pushAtTail(inbox, handle, 0);
-                iterator->removeCurrent(iterator);
-            }
-            iterator->destruct(iterator);
-            candidateList->destruct(candidateList);
-        }
     }
     return 0;
 }
@@ -226,64 +197,35 @@ u8 hcCommSchedulerTakeComm(ocrScheduler_t *self, u32* count, ocrFatGuid_t * fatH
  */
 u8 hcCommSchedulerGiveComm(ocrScheduler_t *self, u32* count, ocrFatGuid_t* fatHandlers, u32 properties) {
     ocrSchedulerHcCommDelegate_t * commSched = (ocrSchedulerHcCommDelegate_t *) self;
+    ocrPolicyDomain_t * pd = self->pd;
     ocrWorker_t *worker = NULL;
     getCurrentEnv(NULL, &worker, NULL, NULL);
-    //BUG #204 sep-concern: Do we need a way to register worker types somehow ?
-    if (((ocrWorkerHc_t *) worker)->hcType == HC_WORKER_COMM) {
-        u32 i=0;
-        while (i < *count) {
-            delegateMsgHandle_t* handle = (delegateMsgHandle_t *) fatHandlers[i].metaDataPtr;
-        #ifdef HYBRID_COMM_COMP_WORKER // Experimental see documentation
-            ocrPolicyMsg_t * message = (handle->handle.status == HDL_RESPONSE_OK) ? handle->handle.response : handle->handle.msg;
-            bool outgoingComm = (message->destLocation != self->pd->myLocation);
-            if (outgoingComm) {
-                // (support HYBRID_COMM_COMP_WORKER mode)
-                // The communication worker can process simple messages that
-                // are known to be short lived and are 'sterile' (i.e. do not generate
-                // new communication) beside responding to the message.
-                // In that case, the comm-worker should only be able to give outgoing responses to the scheduler
-                ASSERT(message->type & PD_MSG_RESPONSE);
-                // Push to the comm worker outbox
-                DPRINTF(DEBUG_LVL_VVERB,"[%"PRId32"] hc-comm-delegate-scheduler:: Comm-worker pushes outgoing to own outbox %"PRId32"\n",
-                    (int) self->pd->myLocation, worker->id);
-                deque_t * outbox = commSched->outboxes[worker->id];
-                outbox->pushAtTail(outbox, handle, 0);
-            } else {
-        #endif
-                // Comm-worker giving back to a worker's inbox
-                DPRINTF(DEBUG_LVL_VVERB,"[%"PRId32"] hc-comm-delegate-scheduler:: Comm-worker pushes at tail of box %"PRIu64"\n",
-                    (int) self->pd->myLocation, handle->boxId);
-                // Push is concurrent because the comp-worker may pushing/poping from inbox in parallel
-                deque_t * inbox = commSched->inboxes[handle->boxId];
-                inbox->pushAtTail(inbox, (ocrMsgHandle_t *) handle, 0);
-        #ifdef HYBRID_COMM_COMP_WORKER
-            }
-        #endif
-            i++;
-        }
-        *count = i;
-    } else {
-        // Comp-worker giving a message to send
-        u32 i=0;
-        while (i < *count) {
-            // Set delegate handle's box id.
-            delegateMsgHandle_t* delHandle = (delegateMsgHandle_t *) fatHandlers[i].metaDataPtr;
-#ifdef OCR_ASSERT
-            ocrPolicyMsg_t * message = (delHandle->handle.status == HDL_RESPONSE_OK) ? delHandle->handle.response : delHandle->handle.msg;
-            ASSERT((message->srcLocation == self->pd->myLocation) && (message->destLocation != self->pd->myLocation));
-#endif
+    u32 i=0;
+    while (i < *count) {
+        delegateMsgHandle_t* delHandle = (delegateMsgHandle_t *) fatHandlers[i].metaDataPtr;
+        ocrPolicyMsg_t * message = (delHandle->handle.status == HDL_RESPONSE_OK) ? delHandle->handle.response : delHandle->handle.msg;
+        if (message->destLocation != pd->myLocation) {
+            // Message to send. Usually given by a comp-worker, although a comm-worker
+            // processing a message may also send to a PD another lane is in charge of.
+            ASSERT(message->srcLocation == pd->myLocation);
             //BUG #587: boxId is defined in del-handle however only the scheduler is using it
             delHandle->boxId = worker->id;
-            DPRINTF(DEBUG_LVL_VVERB,"[%"PRId32"] hc-comm-delegate-scheduler:: Comp-worker pushes at tail of box %"PRIu64"\n",
-                (int) self->pd->myLocation, delHandle->boxId);
-            ASSERT((delHandle->boxId >= 0) && (delHandle->boxId < self->pd->workerCount));
-            // Put handle to worker's outbox
-            deque_t * outbox = commSched->outboxes[delHandle->boxId];
-            outbox->pushAtTail(outbox, (ocrMsgHandle_t *) delHandle, 0);
-            i++;
+            u32 lane = commPlatformLaneOf(pd->myLocation, message->destLocation, commSched->outboxesCount);
+            DPRINTF(DEBUG_LVL_VVERB,"[%"PRId32"] hc-comm-delegate-scheduler:: Worker %"PRIu64" pushes to outbox %"PRIu32"\n",
+                (int) pd->myLocation, delHandle->boxId, lane);
+            mpscQueuePush(&(commSched->outboxes[lane]), &(delHandle->queueNode));
+        } else {
+            //BUG #204 sep-concern: Do we need a way to register worker types somehow ?
+            ASSERT(((ocrWorkerHc_t *) worker)->hcType == HC_WORKER_COMM);
+            // Comm-worker giving back to a worker's inbox
+            DPRINTF(DEBUG_LVL_VVERB,"[%"PRId32"] hc-comm-delegate-scheduler:: Comm-worker pushes to inbox %"PRIu64"\n",
+                (int) pd->myLocation, delHandle->boxId);
+            ASSERT(delHandle->boxId < commSched->inboxesCount);
+            mpscQueuePush(&(commSched->inboxes[delHandle->boxId]), &(delHandle->queueNode));
         }
-        *count = i;
+        i++;
     }
+    *count = i;
     return 0;
 }
 
@@ -307,6 +249,7 @@ void initializeSchedulerHcComm(ocrSchedulerFactory_t * factory, ocrScheduler_t *
     commSched->outboxes = NULL;
     commSched->inboxesCount = 0;
     commSched->inboxes = NULL;
+    commSched->stashes = NULL;
     commSched->baseSwitchRunlevel = derivedFactory->baseSwitchRunlevel;
     commSched->baseMonitorProgress = derivedFactory->baseMonitorProgress;
 }
@@ -12,7 +12,7 @@
 
 #include "ocr-types.h"
 #include "utils/ocr-utils.h"
-#include "utils/deque.h"
+#include "utils/mpsc-queue.h"
 #include "scheduler/hc/hc-scheduler.h"
 
 typedef struct {
@@ -27,10 +27,11 @@ typedef struct {
 
 typedef struct {
     ocrSchedulerHc_t base;
-    u64 outboxesCount;
-    deque_t ** outboxes;
-    u64 inboxesCount;
-    deque_t ** inboxes;
+    u64 outboxesCount;      // One per comm-worker (lane)
+    mpscQueue_t * outboxes; // Messages to send, drained by the lane's comm-worker
+    u64 inboxesCount;       // One per worker
+    mpscQueue_t * inboxes;  // Responses, filled by comm-workers
+    mpscQueueNode_t ** stashes; // Per worker, handles popped from the inbox while looking for another one
     // cached base function pointers
     u8 (*baseSwitchRunlevel)(struct _ocrScheduler_t* self, struct _ocrPolicyDomain_t *PD, ocrRunlevel_t runlevel,
                              phase_t phase, u32 properties, void (*callback)(struct _ocrPolicyDomain_t*,u64), u64 val);
@@ -305,7 +305,7 @@ u8 hcSchedulerMonitorProgress(ocrScheduler_t *self, ocrMonitorProgress_t type, v
     // Current implementation assumes the worker is blocked.
     ocrWorker_t * worker;
     getCurrentEnv(NULL, &worker, NULL, NULL);
-    handleWorkerNotProgressing(worker);
+    handleWorkerNotProgressing(worker, type, monitoree);
 #endif
     return 0;
 }
@@ -49,7 +49,19 @@ static u8 masterHelper(ocrWorker_t * worker) {
  *
  *
  */
-u8 handleWorkerNotProgressing(ocrWorker_t * worker) {
+u8 handleWorkerNotProgressing(ocrWorker_t * worker, ocrMonitorProgress_t type, void * monitoree) {
+#ifdef ENABLE_WORKER_HC_FIBER
+    // When the blocked code runs on a fiber, park it and let the worker's
+    // scheduling loop resume it later. Otherwise (runtime code running on
+    // the worker's own stack) fall back to helping.
+    if (((ocrWorkerHc_t *) worker)->curFiber != NULL) {
+        // Waiting for the response to a specific message: it lands in the
+        // worker's inbox, which wakes the worker up if it parked
+        bool wakeable = (type == MONITOR_PROGRESS_COMM) && (monitoree != NULL);
+        hcFiberPark((ocrWorkerHc_t *) worker, wakeable);
+        return 0;
+    }
+#endif
     #ifdef HELPER_MODE
     return masterHelper(worker);
     #endif
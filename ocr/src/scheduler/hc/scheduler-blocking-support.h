@@ -11,9 +11,11 @@
 #include "ocr-config.h"
 #ifdef ENABLE_SCHEDULER_BLOCKING_SUPPORT
 
+#include "ocr-runtime-types.h"
+
 struct _ocrWorker_t;
 
-u8 handleWorkerNotProgressing(struct _ocrWorker_t * worker);
+u8 handleWorkerNotProgressing(struct _ocrWorker_t * worker, ocrMonitorProgress_t type, void * monitoree);
 
 #endif /* ENABLE_SCHEDULER_BLOCKING_SUPPORT */
 #endif /* __SCHEDULER_BLOCKING_SUPPORT_H__ */
@@ -34,6 +34,10 @@ extern struct _dbWeightStruct gDbWeights[] __attribute__((weak));
 #endif
 #endif /* OCR_ENABLE_STATISTICS */
 
+#ifdef ENABLE_EDT_STATS
+#include "utils/edt-stats.h"
+#endif
+
 #include "utils/profiler/profiler.h"
 
 #define DEBUG_TYPE TASK
@@ -300,7 +304,7 @@ static u8 initTaskHcInternal(ocrTaskHc_t *task, ocrPolicyDomain_t * pd,
     // If we are creating a finish-edt
     if (hasProperty(properties, EDT_PROP_FINISH)) {
         PD_MSG_STACK(msg);
-        getCurrentEnv(NULL, NULL, NULL, &msg);
+        PD_MSG_INIT_FROM_PD(pd, &msg);
         ocrFatGuid_t edtCheckin;
         edtCheckin.guid = task->base.guid;
         edtCheckin.metaDataPtr = task;
@@ -326,13 +330,13 @@ static u8 initTaskHcInternal(ocrTaskHc_t *task, ocrPolicyDomain_t * pd,
         if (!(ocrGuidIsNull(parentLatch.guid))) {
             DPRINTF(DEBUG_LVL_INFO, "Checkin "GUIDF" on parent flatch "GUIDF"\n", GUIDA(task->base.guid), GUIDA(parentLatch.guid));
             // Check in current finish latch
-            getCurrentEnv(NULL, NULL, NULL, &msg);
+            PD_MSG_INIT_FROM_PD(pd, &msg);
             RESULT_PROPAGATE(finishLatchCheckin(pd, &msg, edtCheckin, latchFGuid, parentLatch));
         }
 
         // Check in the new finish scope
         // This will also link outputEvent to latchFGuid
-        getCurrentEnv(NULL, NULL, NULL, &msg);
+        PD_MSG_INIT_FROM_PD(pd, &msg);
         DPRINTF(DEBUG_LVL_INFO, "Checkin "GUIDF" on self flatch "GUIDF"\n", GUIDA(task->base.guid), GUIDA(latchFGuid.guid));
         RESULT_PROPAGATE(finishLatchCheckin(pd, &msg, edtCheckin, outputEvent, latchFGuid));
         // Set edt's ELS to the new latch
@@ -342,7 +346,7 @@ static u8 initTaskHcInternal(ocrTaskHc_t *task, ocrPolicyDomain_t * pd,
         // but is not a finish-edt itself, just register to the scope
         if(!(ocrGuidIsNull(parentLatch.guid))) {
             PD_MSG_STACK(msg);
-            getCurrentEnv(NULL, NULL, NULL, &msg);
+            PD_MSG_INIT_FROM_PD(pd, &msg);
             DPRINTF(DEBUG_LVL_INFO, "Checkin "GUIDF" on current flatch "GUIDF"\n", GUIDA(task->base.guid), GUIDA(parentLatch.guid));
             // Check in current finish latch
             ocrFatGuid_t edtCheckin;
@@ -354,11 +358,15 @@ static u8 initTaskHcInternal(ocrTaskHc_t *task, ocrPolicyDomain_t * pd,
     return 0;
 }
 
+// Dependence vectors up to this size are sorted with an insertion sort
+#ifndef OCR_EDT_SORT_INSERTION_MAX
+#define OCR_EDT_SORT_INSERTION_MAX 32
+#endif
+
 /**
- * @brief sort an array of regNode_t according to their GUID
- * Warning. 'notifyDbReleaseTaskHc' relies on this sort to be stable !
+ * @brief Insertion sort of an array of regNode_t according to their GUID
  */
- static void sortRegNode(regNode_t * array, u32 length) {
+ static void insertionSortRegNode(regNode_t * array, u32 length) {
      if (length >= 2) {
         int idx;
         int sorted = 0;
@@ -378,9 +386,123 @@ static u8 initTaskHcInternal(ocrTaskHc_t *task, ocrPolicyDomain_t * pd,
     }
 }
 
+// Key with the same ordering as ocrGuidIsLt when compared unsigned
+#ifdef ENABLE_128_BIT_GUID
+#define REGNODE_SORT_KEY(node) (((u64) (node).guid.lower) ^ (1ULL << 63))
+#else
+#define REGNODE_SORT_KEY(node) (((u64) (node).guid.guid) ^ (1ULL << 63))
+#endif
+
+/**
+ * @brief LSD radix sort of an array of regNode_t according to their GUID
+ * Digits shared by all the GUIDs, typically the high-order bits, are skipped.
+ */
+static void radixSortRegNode(regNode_t * array, u32 length) {
+    ocrPolicyDomain_t * pd = NULL;
+    getCurrentEnv(&pd, NULL, NULL, NULL);
+    regNode_t * tmp = (regNode_t *) pd->fcts.pdMalloc(pd, sizeof(regNode_t) * length);
+    regNode_t * src = array;
+    regNode_t * dst = tmp;
+    u32 count[256];
+    u32 shift, i;
+    for (shift = 0; shift < 64; shift += 8) {
+        for (i = 0; i < 256; ++i) {
+            count[i] = 0;
+        }
+        for (i = 0; i < length; ++i) {
+            count[(REGNODE_SORT_KEY(src[i]) >> shift) & 0xFF]++;
+        }
+        if (count[(REGNODE_SORT_KEY(src[0]) >> shift) & 0xFF] == length) {
+            continue;
+        }
+        u32 offset = 0;
+        for (i = 0; i < 256; ++i) {
+            u32 c = count[i];
+            count[i] = offset;
+            offset += c;
+        }
+        for (i = 0; i < length; ++i) {
+            dst[count[(REGNODE_SORT_KEY(src[i]) >> shift) & 0xFF]++] = src[i];
+        }
+        regNode_t * swap = src;
+        src = dst;
+        dst = swap;
+    }
+    if (src != array) {
+        hal_memCopy(array, src, sizeof(regNode_t) * length, false);
+    }
+    pd->fcts.pdFree(pd, tmp);
+}
+
+/**
+ * @brief sort an array of regNode_t according to their GUID
+ * Warning. 'notifyDbReleaseTaskHc' relies on this sort to be stable !
+ */
+static void sortRegNode(regNode_t * array, u32 length) {
+    if (length > OCR_EDT_SORT_INSERTION_MAX) {
+        radixSortRegNode(array, length);
+    } else {
+        insertionSortRegNode(array, length);
+    }
+}
+
+/**
+ * @brief Issue the acquire of the DB at index 'i' of the GUID-sorted signaler vector
+ * Returns true if the acquire is pending, in which case the response is
+ * delivered through dependenceResolvedTaskHc.
+ */
+static bool acquireFrontierDb(ocrTask_t *self, u32 i) {
+    ocrTaskHc_t * rself = ((ocrTaskHc_t *) self);
+    regNode_t * depv = rself->signalers;
+    ocrPolicyDomain_t * pd = NULL;
+    PD_MSG_STACK(msg);
+    getCurrentEnv(&pd, NULL, NULL, &msg);
+#define PD_MSG (&msg)
+#define PD_TYPE PD_MSG_DB_ACQUIRE
+    msg.type = PD_MSG_DB_ACQUIRE | PD_MSG_REQUEST | PD_MSG_REQ_RESPONSE;
+    PD_MSG_FIELD_IO(guid.guid) = depv[i].guid; // DB guid
+    PD_MSG_FIELD_IO(guid.metaDataPtr) = NULL;
+    PD_MSG_FIELD_IO(edt.guid) = self->guid; // EDT guid
+    PD_MSG_FIELD_IO(edt.metaDataPtr) = self;
+    PD_MSG_FIELD_IO(edtSlot) = self->depc + 1; // RT slot
+    PD_MSG_FIELD_IO(properties) = depv[i].mode;
+    u8 returnCode = pd->fcts.processMessage(pd, &msg, false);
+    // DB_ACQUIRE is potentially asynchronous, check completion.
+    // In shmem and dist HC PD, ACQUIRE is two-way, processed asynchronously
+    // (the false in 'processMessage'). For now the CE/XE PD do not support this
+    // mode so we need to check for the returnDetail of the acquire message instead.
+    if ((returnCode == OCR_EPEND) || (PD_MSG_FIELD_O(returnDetail) == OCR_EBUSY)) {
+        return true;
+    }
+    // else, acquire took place and was successful
+    ASSERT(msg.type & PD_MSG_RESPONSE); // 2x check
+    rself->resolvedDeps[depv[i].slot].ptr = PD_MSG_FIELD_O(ptr);
+#ifdef ENABLE_EDT_STATS
+    // Asynchronous grants are accounted for by the PD when it processes the
+    // acquire response, before calling dependenceResolved
+    self->dbBytes += PD_MSG_FIELD_O(size);
+#endif
+#undef PD_MSG
+#undef PD_TYPE
+    return false;
+}
+
+/**
+ * @brief Remember slots acquiring the same DB as the previous one to avoid double release
+ */
+static void markDuplicateDb(ocrTaskHc_t *rself, u32 i) {
+    regNode_t * depv = rself->signalers;
+    // If the below asserts, rebuild OCR with a higher OCR_MAX_MULTI_SLOT (in build/common.mk)
+    ASSERT(depv[i].slot / 64 < OCR_MAX_MULTI_SLOT);
+    rself->doNotReleaseSlots[depv[i].slot / 64] |= (1ULL << (depv[i].slot % 64));
+}
+
 /**
  * @brief Advance the DB iteration frontier to the next DB
  * This implementation iterates on the GUID-sorted signaler vector
+ * Acquires are issued one at a time so that an EDT never holds a DB while
+ * waiting on one with a lower GUID. Even RO acquires may wait on other EDTs
+ * (behind a proxy DB in use in another mode for instance).
  * Returns false when the end of depv is reached
  */
 static u8 iterateDbFrontier(ocrTask_t *self) {
@@ -396,37 +518,11 @@ static u8 iterateDbFrontier(ocrTask_t *self) {
             // and remember them to avoid double release
             if ((i > 0) && (ocrGuidIsEq(depv[i-1].guid, depv[i].guid))) {
                 rself->resolvedDeps[depv[i].slot].ptr = rself->resolvedDeps[depv[i-1].slot].ptr;
-                // If the below asserts, rebuild OCR with a higher OCR_MAX_MULTI_SLOT (in build/common.mk)
-                ASSERT(depv[i].slot / 64 < OCR_MAX_MULTI_SLOT);
-                rself->doNotReleaseSlots[depv[i].slot / 64] |= (1ULL << (depv[i].slot % 64));
-            } else {
-                // Issue acquire request
-                ocrPolicyDomain_t * pd = NULL;
-                PD_MSG_STACK(msg);
-                getCurrentEnv(&pd, NULL, NULL, &msg);
-#define PD_MSG (&msg)
-#define PD_TYPE PD_MSG_DB_ACQUIRE
-                msg.type = PD_MSG_DB_ACQUIRE | PD_MSG_REQUEST | PD_MSG_REQ_RESPONSE;
-                PD_MSG_FIELD_IO(guid.guid) = depv[i].guid; // DB guid
-                PD_MSG_FIELD_IO(guid.metaDataPtr) = NULL;
-                PD_MSG_FIELD_IO(edt.guid) = self->guid; // EDT guid
-                PD_MSG_FIELD_IO(edt.metaDataPtr) = self;
-                PD_MSG_FIELD_IO(edtSlot) = self->depc + 1; // RT slot
-                PD_MSG_FIELD_IO(properties) = depv[i].mode;
-                u8 returnCode = pd->fcts.processMessage(pd, &msg, false);
-                // DB_ACQUIRE is potentially asynchronous, check completion.
-                // In shmem and dist HC PD, ACQUIRE is two-way, processed asynchronously
-                // (the false in 'processMessage'). For now the CE/XE PD do not support this
-                // mode so we need to check for the returnDetail of the acquire message instead.
-                if ((returnCode == OCR_EPEND) || (PD_MSG_FIELD_O(returnDetail) == OCR_EBUSY)) {
-                    return true;
-                }
-                // else, acquire took place and was successful, continue iterating
-                ASSERT(msg.type & PD_MSG_RESPONSE); // 2x check
-                rself->resolvedDeps[depv[i].slot].ptr = PD_MSG_FIELD_O(ptr);
-#undef PD_MSG
-#undef PD_TYPE
+                markDuplicateDb(rself, i);
+            } else if (acquireFrontierDb(self, i)) {
+                return true;
             }
+            // else, acquire took place and was successful, continue iterating
         }
     }
     return false;
@@ -550,7 +646,7 @@ u8 destructTaskHc(ocrTask_t* base) {
         // Clean up output-event
         if (!(ocrGuidIsNull(base->outputEvent))) {
             PD_MSG_STACK(msg);
-            getCurrentEnv(NULL, NULL, NULL, &msg);
+            PD_MSG_INIT_FROM_PD(pd, &msg);
 #define PD_MSG (&msg)
 #define PD_TYPE PD_MSG_EVT_DESTROY
             msg.type = PD_MSG_EVT_DESTROY | PD_MSG_REQUEST;
@@ -568,7 +664,7 @@ u8 destructTaskHc(ocrTask_t* base) {
         // If this is a finish EDT and it hasn't ran yet just destroy
         if (!(ocrGuidIsNull(base->finishLatch))) {
             PD_MSG_STACK(msg);
-            getCurrentEnv(NULL, NULL, NULL, &msg);
+            PD_MSG_INIT_FROM_PD(pd, &msg);
 #define PD_MSG (&msg)
 #define PD_TYPE PD_MSG_EVT_DESTROY
             msg.type = PD_MSG_EVT_DESTROY | PD_MSG_REQUEST;
@@ -586,7 +682,7 @@ u8 destructTaskHc(ocrTask_t* base) {
         // Need to decrement the parent latch since the EDT didn't run
         if (!(ocrGuidIsNull(base->parentLatch))) {
             PD_MSG_STACK(msg);
-            getCurrentEnv(NULL, NULL, NULL, &msg);
+            PD_MSG_INIT_FROM_PD(pd, &msg);
 #define PD_MSG (&msg)
 #define PD_TYPE PD_MSG_DEP_SATISFY
             //TODO ABA issue here if not REQ_RESP ?
@@ -666,7 +762,7 @@ u8 newTaskHc(ocrTaskFactory_t* factory, ocrFatGuid_t * edtGuid, ocrFatGuid_t edt
     if (outputEventPtr != NULL || hasProperty(properties, EDT_PROP_FINISH) ||
             !(ocrGuidIsNull(parentLatch.guid))) {
         PD_MSG_STACK(msg);
-        getCurrentEnv(NULL, NULL, NULL, &msg);
+        PD_MSG_INIT_FROM_PD(pd, &msg);
 #define PD_MSG (&msg)
 #define PD_TYPE PD_MSG_EVT_CREATE
         msg.type = PD_MSG_EVT_CREATE | PD_MSG_REQUEST | PD_MSG_REQ_RESPONSE;
@@ -692,7 +788,7 @@ u8 newTaskHc(ocrTaskFactory_t* factory, ocrFatGuid_t * edtGuid, ocrFatGuid_t edt
 
     PD_MSG_STACK(msg);
     // Create the task itself by getting a GUID
-    getCurrentEnv(NULL, NULL, NULL, &msg);
+    PD_MSG_INIT_FROM_PD(pd, &msg);
 #define PD_MSG (&msg)
 #define PD_TYPE PD_MSG_GUID_CREATE
     msg.type = PD_MSG_GUID_CREATE | PD_MSG_REQUEST | PD_MSG_REQ_RESPONSE;
@@ -728,6 +824,10 @@ u8 newTaskHc(ocrTaskFactory_t* factory, ocrFatGuid_t * edtGuid, ocrFatGuid_t edt
     base->depc = depc;
     base->flags = 0;
     base->fctId = factory->factoryId;
+#ifdef ENABLE_EDT_STATS
+    base->readyTime = 0;
+    base->dbBytes = 0;
+#endif
     for(i = 0; i < paramc; ++i) {
         base->paramv[i] = paramv[i];
     }
@@ -819,6 +919,9 @@ u8 newTaskHc(ocrTaskFactory_t* factory, ocrFatGuid_t * edtGuid, ocrFatGuid_t edt
         DPRINTF(DEBUG_LVL_INFO,
                 "Scheduling task "GUIDF" due to initial satisfactions\n", GUIDA(base->guid));
         OCR_TOOL_TRACE(false, OCR_TRACE_TYPE_EDT, OCR_ACTION_RUNNABLE);
+#ifdef ENABLE_EDT_STATS
+        base->readyTime = salGetTime();
+#endif
         RESULT_PROPAGATE2(taskAllDepvSatisfied(base), 1);
     }
 
@@ -895,6 +998,9 @@ u8 satisfyTaskHc(ocrTask_t * base, ocrFatGuid_t data, u32 slot) {
         DPRINTF(DEBUG_LVL_VERB, "Scheduling task "GUIDF", satisfied dependences %"PRId32"/%"PRId32"\n",
                 GUIDA(self->base.guid), self->slotSatisfiedCount , base->depc);
         OCR_TOOL_TRACE(false, OCR_TRACE_TYPE_EDT, OCR_ACTION_RUNNABLE);
+#ifdef ENABLE_EDT_STATS
+        base->readyTime = salGetTime();
+#endif
 
         hal_unlock32(&(self->lock));
         // All dependences have been satisfied, schedule the edt
@@ -1198,7 +1304,7 @@ u8 taskExecute(ocrTask_t* base) {
     ocrGuid_t retGuid = NULL_GUID;
     {
 
-#ifdef OCR_ENABLE_VISUALIZER
+#if defined(OCR_ENABLE_VISUALIZER) || defined(ENABLE_EDT_STATS)
         u64 startTime = salGetTime();
 #endif
 #ifdef OCR_TRACE
@@ -1225,9 +1331,20 @@ u8 taskExecute(ocrTask_t* base) {
                 base->funcPtr, base->guid, location);
 #endif
 
-#ifdef OCR_ENABLE_VISUALIZER
+#if defined(OCR_ENABLE_VISUALIZER) || defined(ENABLE_EDT_STATS)
         u64 endTime = salGetTime();
+#endif
+#ifdef OCR_ENABLE_VISUALIZER
         DPRINTF(DEBUG_LVL_INFO, "Execute "GUIDF" FctName: %s Start: %"PRIu64" End: %"PRIu64"\n", GUIDA(base->guid), base->name, startTime, endTime);
+#endif
+#ifdef ENABLE_EDT_STATS
+        // A blocked EDT may resume on another worker, account on the one finishing it
+        getCurrentEnv(NULL, &curWorker, NULL, NULL);
+        if(curWorker->edtStats != NULL) {
+            edtStatsRecord(curWorker->edtStats, base->funcPtr, endTime - startTime,
+                           ((base->readyTime != 0) && (startTime > base->readyTime)) ? (startTime - base->readyTime) : 0,
+                           base->dbBytes);
+        }
 #endif
     }
 
@@ -1246,7 +1363,7 @@ u8 taskExecute(ocrTask_t* base) {
             if ((!(ocrGuidIsNull(depv[i].guid))) &&
                ((j >= OCR_MAX_MULTI_SLOT) || (derived->doNotReleaseSlots[j] == 0) ||
                 ((j < OCR_MAX_MULTI_SLOT) && (((1ULL << (i % 64)) & derived->doNotReleaseSlots[j]) == 0)))) {
-                getCurrentEnv(NULL, NULL, NULL, &msg);
+                PD_MSG_INIT_FROM_PD(pd, &msg);
 #define PD_MSG (&msg)
 #define PD_TYPE PD_MSG_DB_RELEASE
                 msg.type = PD_MSG_DB_RELEASE | PD_MSG_REQUEST | PD_MSG_REQ_RESPONSE;
@@ -1273,7 +1390,7 @@ u8 taskExecute(ocrTask_t* base) {
         ocrGuid_t *extraToFree = derived->unkDbs;
         u64 count = derived->countUnkDbs;
         while(count) {
-            getCurrentEnv(NULL, NULL, NULL, &msg);
+            PD_MSG_INIT_FROM_PD(pd, &msg);
 #define PD_MSG (&msg)
 #define PD_TYPE PD_MSG_DB_RELEASE
             msg.type = PD_MSG_DB_RELEASE | PD_MSG_REQUEST | PD_MSG_REQ_RESPONSE;
@@ -1299,10 +1416,13 @@ u8 taskExecute(ocrTask_t* base) {
     // If marked to be rescheduled, do not satisfy output
     // event and do not update the task state to reaping
     if (base->state == RUNNING_EDTSTATE) {
+        // Reaping from now on: satisfying the output event checks the EDT
+        // out of its finish scope, nothing may check in on its behalf anymore
+        base->state = REAPING_EDTSTATE;
         // Now deal with the output event
         if(!(ocrGuidIsNull(base->outputEvent))) {
             if(!(ocrGuidIsNull(retGuid))) {
-                getCurrentEnv(NULL, NULL, NULL, &msg);
+                PD_MSG_INIT_FROM_PD(pd, &msg);
         #define PD_MSG (&msg)
         #define PD_TYPE PD_MSG_DEP_ADD
                 msg.type = PD_MSG_DEP_ADD | PD_MSG_REQUEST;
@@ -1321,7 +1441,7 @@ u8 taskExecute(ocrTask_t* base) {
         #undef PD_MSG
         #undef PD_TYPE
             } else {
-                getCurrentEnv(NULL, NULL, NULL, &msg);
+                PD_MSG_INIT_FROM_PD(pd, &msg);
         #define PD_MSG (&msg)
         #define PD_TYPE PD_MSG_DEP_SATISFY
                 msg.type = PD_MSG_DEP_SATISFY | PD_MSG_REQUEST;
@@ -1345,7 +1465,6 @@ u8 taskExecute(ocrTask_t* base) {
             // Because the output event is non-persistent it is deallocated automatically
             base->outputEvent = NULL_GUID;
         }
-        base->state = REAPING_EDTSTATE;
     }
 #ifdef ENABLE_EXTENSION_BLOCKING_SUPPORT
     else { // else EDT must be rescheduled
@@ -36,8 +36,10 @@ void binHeapDestroy(ocrPolicyDomain_t *pd, binHeap_t* heap) {
  */
 static void _baseBinHeapInit(binHeap_t* heap, ocrPolicyDomain_t *pd) {
     heap->count = 0;
+    heap->capacity = INIT_BIN_HEAP_CAPACITY;
+    heap->pd = pd;
     heap->data = NULL;
-    heap->data = pd->fcts.pdMalloc(pd, sizeof(void*)*INIT_BIN_HEAP_CAPACITY);
+    heap->data = pd->fcts.pdMalloc(pd, sizeof(ocrBinHeapEntry_t)*INIT_BIN_HEAP_CAPACITY);
     ASSERT(heap->data != NULL);
     heap->destruct = binHeapDestroy;
     // Set by derived implementation
@@ -75,6 +77,20 @@ static binHeap_t * _newBaseBinHeap(ocrPolicyDomain_t *pd, ocrBinHeapType_t type)
 /* NON CONCURRENT BIN_HEAP BASED OPERATIONS         */
 /****************************************************/
 
+// Shrink when the heap is less than 1/BIN_HEAP_SHRINK_RATIO full
+#define BIN_HEAP_SHRINK_RATIO 8
+
+static void _resize(binHeap_t *heap, u32 capacity) {
+    ASSERT(heap->count <= capacity);
+    ocrPolicyDomain_t *pd = heap->pd;
+    ocrBinHeapEntry_t *data = pd->fcts.pdMalloc(pd, sizeof(ocrBinHeapEntry_t)*capacity);
+    ASSERT(data != NULL);
+    hal_memCopy(data, heap->data, sizeof(ocrBinHeapEntry_t)*heap->count, false);
+    pd->fcts.pdFree(pd, heap->data);
+    heap->data = data;
+    heap->capacity = capacity;
+}
+
 static inline u32 _left(u32 i) { return 2*i + 1; }
 static inline u32 _right(u32 i) { return 2*i + 2; }
 static inline u32 _parent(u32 i) { return (i-1)/2; }
@@ -140,8 +156,8 @@ static void _checkHeap(binHeap_t *heap) {
  */
 void nonConcBinHeapPush(binHeap_t *heap, void *entry, s64 priority, u8 doTry) {
     const u32 n = heap->count;
-    if (n == INIT_BIN_HEAP_CAPACITY) { /* binHeap looks full */
-        ASSERT("Binary heap full, increase bin-heap's size" && 0);
+    if (n == heap->capacity) { /* binHeap full, grow it */
+        _resize(heap, heap->capacity << 1);
     }
     heap->count++;
     ocrBinHeapEntry_t node = { priority, entry };
@@ -160,6 +176,10 @@ void *nonConcBinHeapPop(binHeap_t *heap, u8 doTry) {
     heap->data[0] = heap->data[n];
     _trickleDown(heap, 0);
     _checkHeap(heap);
+    if ((heap->capacity > INIT_BIN_HEAP_CAPACITY) &&
+        (n < (heap->capacity / BIN_HEAP_SHRINK_RATIO))) {
+        _resize(heap, heap->capacity >> 1);
+    }
     return rt;
 }
 
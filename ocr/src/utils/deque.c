@@ -71,6 +71,7 @@ static void baseDequeInit(deque_t* self, ocrPolicyDomain_t *pd, void * initValue
     self->tail = 0;
     self->data = (volatile void **)pd->fcts.pdMalloc(pd, sizeof(void*)*INIT_DEQUE_CAPACITY);
     ASSERT(self->data != NULL);
+    self->capacity = INIT_DEQUE_CAPACITY;
 
     // This may not be necessary depending on the intented use
     u32 i=0;
@@ -170,44 +171,121 @@ void * nonConcDequePopHead(deque_t * self, u8 doTry) {
 /* CONCURRENT DEQUE BASED OPERATIONS                */
 /****************************************************/
 
+/*
+ * Growable work-stealing deque after Chase and Lev, "Dynamic circular
+ * work-stealing deque" (SPAA'05) with the memory orderings of Le et al.,
+ * "Correct and efficient work-stealing for weak memory models" (PPoPP'13).
+ *
+ * 'head' and 'tail' are monotonic logical indices, the circular array
+ * is indexed modulo its capacity. The owner replaces the array when it
+ * is full (or mostly empty) by copying the live range [head, tail) at
+ * the same logical indices into a new array.
+ */
+
+// Shrink when the deque is less than 1/WST_DEQUE_SHRINK_RATIO full
+#define WST_DEQUE_SHRINK_RATIO 8
+
+static dequeWstBuffer_t * wstDequeNewBuffer(ocrPolicyDomain_t *pd, u32 capacity) {
+    ASSERT((capacity & (capacity - 1)) == 0);
+    dequeWstBuffer_t * buffer = (dequeWstBuffer_t *)pd->fcts.pdMalloc(pd,
+                                    sizeof(dequeWstBuffer_t) + sizeof(void*)*capacity);
+    ASSERT(buffer != NULL);
+    buffer->capacity = capacity;
+    buffer->next = NULL;
+    return buffer;
+}
+
+/*
+ * Free arrays retired by previous resizes if no thief can still see them.
+ * Called by the owner only, after a new array has been published.
+ */
+static void wstDequeReclaim(dequeWst_t * dself) {
+    // Pairs with the increment in wstDequePopHead: either we see the thief
+    // or the thief sees the newly published array.
+    hal_fence();
+    if ((dself->retired == NULL) || (dself->thieves != 0)) {
+        return;
+    }
+    dequeWstBuffer_t * buffer = dself->retired;
+    while (buffer != NULL) {
+        dequeWstBuffer_t * next = buffer->next;
+        dself->pd->fcts.pdFree(dself->pd, buffer);
+        buffer = next;
+    }
+    dself->retired = NULL;
+}
+
+/*
+ * Replace the current array with one of 'capacity' slots (owner only)
+ */
+static dequeWstBuffer_t * wstDequeResize(dequeWst_t * dself, dequeWstBuffer_t * old,
+                                         s32 head, s32 tail, u32 capacity) {
+    ASSERT((u32)(tail - head) <= capacity);
+    dequeWstBuffer_t * buffer = wstDequeNewBuffer(dself->pd, capacity);
+    u32 oldMask = old->capacity - 1;
+    u32 mask = capacity - 1;
+    s32 i;
+    for (i = head; i < tail; ++i) {
+        buffer->slots[((u32)i) & mask] = old->slots[((u32)i) & oldMask];
+    }
+    DPRINTF(DEBUG_LVL_VERB, "Resizing conc deque @ 0x%p from %"PRIu32" to %"PRIu32" h:%"PRId32" t:%"PRId32"\n",
+            dself, old->capacity, capacity, head, tail);
+    // Publish the copy before thieves can observe the new array
+    hal_storeRelease(&dself->buffer, buffer);
+    dself->base.data = buffer->slots;
+    dself->base.capacity = capacity;
+    old->next = dself->retired;
+    dself->retired = old;
+    wstDequeReclaim(dself);
+    return buffer;
+}
+
 /*
  * push an entry onto the tail of the deque
  */
 void wstDequePushTail(deque_t* self, void* entry, u8 doTry) {
-    s32 head = self->head;
+    dequeWst_t * dself = (dequeWst_t *)self;
     s32 tail = self->tail;
-    if (tail == INIT_DEQUE_CAPACITY + head) { /* deque looks full */
-        /* may not grow the deque if some interleaving steal occur */
-        ASSERT("DEQUE full, increase deque's size" && 0);
+    s32 head = hal_loadAcquire(&self->head);
+    dequeWstBuffer_t * buffer = dself->buffer;
+    if ((u32)(tail - head) >= buffer->capacity) { /* deque looks full */
+        buffer = wstDequeResize(dself, buffer, head, tail, buffer->capacity << 1);
     }
-    s32 n = (self->tail) % INIT_DEQUE_CAPACITY;
-    self->data[n] = entry;
-    DPRINTF(DEBUG_LVL_VERB, "Pushing h:%"PRId32" t:%"PRId32" deq[%"PRId32"] elt:0x%p into conc deque @ 0x%p\n",
-            head, self->tail, n, entry, self);
-    hal_fence();
-    ++(self->tail);
+    u32 n = ((u32)tail) & (buffer->capacity - 1);
+    buffer->slots[n] = entry;
+    DPRINTF(DEBUG_LVL_VERB, "Pushing h:%"PRId32" t:%"PRId32" deq[%"PRIu32"] elt:0x%p into conc deque @ 0x%p\n",
+            head, tail, n, entry, self);
+    // Makes the entry visible to thieves before the new tail
+    hal_storeRelease(&self->tail, tail + 1);
 }
 
 /*
  * pop the task out of the deque from the tail
  */
 void * wstDequePopTail(deque_t * self, u8 doTry) {
-    hal_fence();
-    s32 tail = self->tail;
-    --tail;
+    dequeWst_t * dself = (dequeWst_t *)self;
+    dequeWstBuffer_t * buffer = dself->buffer;
+    s32 tail = self->tail - 1;
     self->tail = tail;
+    // The tail decrement must be visible before head is read
+    // (store-load ordering, the only full fence on the owner's path)
     hal_fence();
     s32 head = self->head;
 
     if (tail < head) {
-        self->tail = self->head;
+        hal_storeRelease(&self->tail, head);
         return NULL;
     }
-    void * rt = (void*) self->data[(tail) % INIT_DEQUE_CAPACITY];
+    u32 n = ((u32)tail) & (buffer->capacity - 1);
+    void * rt = (void*) buffer->slots[n];
 
     if (tail > head) {
-        DPRINTF(DEBUG_LVL_VERB, "Popping (tail) h:%"PRId32" t:%"PRId32" deq[%"PRId32"] elt:0x%"PRIx64" from conc deque @ 0x%"PRIx64"\n",
-                head, tail, tail % INIT_DEQUE_CAPACITY, (u64)rt, (u64)self);
+        DPRINTF(DEBUG_LVL_VERB, "Popping (tail) h:%"PRId32" t:%"PRId32" deq[%"PRIu32"] elt:0x%"PRIx64" from conc deque @ 0x%"PRIx64"\n",
+                head, tail, n, (u64)rt, (u64)self);
+        if ((buffer->capacity > INIT_WST_DEQUE_CAPACITY) &&
+            ((u32)(tail - head) < (buffer->capacity / WST_DEQUE_SHRINK_RATIO))) {
+            wstDequeResize(dself, buffer, head, tail, buffer->capacity >> 1);
+        }
         return rt;
     }
 
@@ -216,9 +294,9 @@ void * wstDequePopTail(deque_t * self, u8 doTry) {
         rt = NULL; /* losing in competition */
 
     /* now the deque is empty */
-    self->tail = self->head;
-    DPRINTF(DEBUG_LVL_VERB, "Popping (tail 2) h:%"PRId32" t:%"PRId32" deq[%"PRId32"] elt:0x%"PRIx64" from conc deque @ 0x%"PRIx64"\n",
-            head, tail, tail % INIT_DEQUE_CAPACITY, (u64)rt, (u64)self);
+    hal_storeRelease(&self->tail, head + 1);
+    DPRINTF(DEBUG_LVL_VERB, "Popping (tail 2) h:%"PRId32" t:%"PRId32" deq[%"PRIu32"] elt:0x%"PRIx64" from conc deque @ 0x%"PRIx64"\n",
+            head, tail, n, (u64)rt, (u64)self);
     return rt;
 }
 
@@ -226,30 +304,81 @@ void * wstDequePopTail(deque_t * self, u8 doTry) {
  * the steal protocol
  */
 void * wstDequePopHead(deque_t * self, u8 doTry) {
+    dequeWst_t * dself = (dequeWst_t *)self;
+    void * rt = NULL;
     s32 head, tail;
+    // Registering the steal is a full barrier and prevents the owner
+    // from freeing an array we may read from (see wstDequeReclaim)
+    hal_xadd32(&dself->thieves, 1);
     do {
-        head = self->head;
+        head = hal_loadAcquire(&self->head);
+        // Orders the head read before the tail read (pairs with the owner's
+        // fence in wstDequePopTail). Folded in the atomic increment on x86.
         hal_fence();
-        tail = self->tail;
+        tail = hal_loadAcquire(&self->tail);
         if (tail <= head) {
-            return NULL;
+            rt = NULL;
+            break;
         }
 
         // The data must be read here, BEFORE the cas succeeds.
         // If the tail wraps around the buffer, so that H=x and T=H+N
         // as soon as the steal has done the cas, a push could happen
         // at index 'x' and overwrite the value to be stolen.
-
-        void * rt = (void *) self->data[head % INIT_DEQUE_CAPACITY];
+        // The array is read after the tail so that it is at least as
+        // recent as the array the tail entry was pushed into.
+        dequeWstBuffer_t * buffer = hal_loadAcquire(&dself->buffer);
+        rt = (void *) buffer->slots[((u32)head) & (buffer->capacity - 1)];
 
         /* compete with other thieves and possibly the owner (if the size == 1) */
         if (hal_cmpswap32(&self->head, head, head + 1) == head) { /* competing */
-            DPRINTF(DEBUG_LVL_VERB, "Popping (head) h:%"PRId32" t:%"PRId32" deq[%"PRId32"] elt:0x%"PRIx64" from conc deque @ 0x%"PRIx64"\n",
-                     head, tail, head % INIT_DEQUE_CAPACITY, (u64)rt, (u64)self);
-            return rt;
+            DPRINTF(DEBUG_LVL_VERB, "Popping (head) h:%"PRId32" t:%"PRId32" deq[%"PRIu32"] elt:0x%"PRIx64" from conc deque @ 0x%"PRIx64"\n",
+                     head, tail, ((u32)head) & (buffer->capacity - 1), (u64)rt, (u64)self);
+            break;
         }
+        rt = NULL;
     } while (doTry == 0);
-    return NULL;
+    hal_xadd32(&dself->thieves, -1);
+    return rt;
+}
+
+/*
+ * Work-stealing deque destroy
+ */
+static void wstDequeDestroy(ocrPolicyDomain_t *pd, deque_t* self) {
+    dequeWst_t * dself = (dequeWst_t *)self;
+    ASSERT(dself->thieves == 0);
+    dequeWstBuffer_t * buffer = dself->retired;
+    while (buffer != NULL) {
+        dequeWstBuffer_t * next = buffer->next;
+        pd->fcts.pdFree(pd, buffer);
+        buffer = next;
+    }
+    pd->fcts.pdFree(pd, dself->buffer);
+    pd->fcts.pdFree(pd, self);
+}
+
+static void wstDequeInit(dequeWst_t* self, ocrPolicyDomain_t *pd, void * initValue) {
+    deque_t * base = (deque_t *)self;
+    self->pd = pd;
+    self->buffer = wstDequeNewBuffer(pd, INIT_WST_DEQUE_CAPACITY);
+    self->retired = NULL;
+    self->thieves = 0;
+    u32 i = 0;
+    while(i < INIT_WST_DEQUE_CAPACITY) {
+        self->buffer->slots[i] = initValue;
+        ++i;
+    }
+    base->head = 0;
+    base->tail = 0;
+    base->data = self->buffer->slots;
+    base->capacity = INIT_WST_DEQUE_CAPACITY;
+    base->destruct = wstDequeDestroy;
+    base->size = wstDequeSize;
+    base->pushAtTail = wstDequePushTail;
+    base->popFromTail = wstDequePopTail;
+    base->pushAtHead = NULL;
+    base->popFromHead = wstDequePopHead;
 }
 
 /******************************************************/
@@ -398,13 +527,9 @@ deque_t * newDeque(ocrPolicyDomain_t *pd, void * initValue, ocrDequeType_t type)
     deque_t* self = NULL;
     switch(type) {
     case WORK_STEALING_DEQUE:
-        self = newBaseDeque(pd, initValue, NO_LOCK_BASE_DEQUE);
-        // Specialize push/pop implementations
-        self->size = wstDequeSize;
-        self->pushAtTail = wstDequePushTail;
-        self->popFromTail = wstDequePopTail;
-        self->pushAtHead = NULL;
-        self->popFromHead = wstDequePopHead;
+        // Does not derive from the base deque as its array is growable
+        self = (deque_t*) pd->fcts.pdMalloc(pd, sizeof(dequeWst_t));
+        wstDequeInit((dequeWst_t*)self, pd, initValue);
         break;
     case NON_CONCURRENT_DEQUE:
         self = newBaseDeque(pd, initValue, NO_LOCK_BASE_DEQUE);
@@ -0,0 +1,226 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#include "ocr-config.h"
+#ifdef ENABLE_EDT_STATS
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "debug.h"
+#include "ocr-db.h"
+#include "ocr-policy-domain.h"
+#include "ocr-worker.h"
+#include "utils/edt-stats.h"
+
+#define DEBUG_TYPE UTIL
+
+COMPILE_ASSERT((EDT_STATS_TABLE_SIZE & (EDT_STATS_TABLE_SIZE - 1)) == 0);
+
+static void resetEntry(ocrEdtStats_t *entry) {
+    u32 i;
+    entry->funcPtr = NULL;
+    entry->count = 0;
+    entry->totalTime = 0;
+    entry->minTime = (u64)-1;
+    entry->maxTime = 0;
+    entry->readyTime = 0;
+    entry->dbBytes = 0;
+    for(i = 0; i < OCR_EDT_STATS_HISTOGRAM_SIZE; ++i) {
+        entry->histogram[i] = 0;
+    }
+}
+
+edtStatsTable_t * edtStatsCreate(ocrPolicyDomain_t *pd) {
+    edtStatsTable_t *table = (edtStatsTable_t *) pd->fcts.pdMalloc(pd, sizeof(edtStatsTable_t));
+    u32 i;
+    table->count = 0;
+    table->overflow = 0;
+    for(i = 0; i < EDT_STATS_TABLE_SIZE; ++i) {
+        resetEntry(&(table->entries[i]));
+    }
+    return table;
+}
+
+void edtStatsDestroy(ocrPolicyDomain_t *pd, edtStatsTable_t *table) {
+    pd->fcts.pdFree(pd, table);
+}
+
+// Entry of 'funcPtr', claimed if needed. NULL if the table is full.
+static ocrEdtStats_t * lookupEntry(edtStatsTable_t *table, ocrEdt_t funcPtr) {
+    u64 hash = ((u64) funcPtr) * 0x9E3779B97F4A7C15ULL;
+    u32 idx = (u32) (hash ^ (hash >> 32)) & (EDT_STATS_TABLE_SIZE - 1);
+    u32 probes;
+    for(probes = 0; probes < EDT_STATS_TABLE_SIZE; ++probes) {
+        ocrEdtStats_t *entry = &(table->entries[idx]);
+        if(entry->funcPtr == funcPtr) {
+            return entry;
+        }
+        if(entry->funcPtr == NULL) {
+            entry->funcPtr = funcPtr;
+            table->count++;
+            return entry;
+        }
+        idx = (idx + 1) & (EDT_STATS_TABLE_SIZE - 1);
+    }
+    return NULL;
+}
+
+void edtStatsRecord(edtStatsTable_t *table, ocrEdt_t funcPtr, u64 execTime, u64 readyTime, u64 dbBytes) {
+    ocrEdtStats_t *entry = lookupEntry(table, funcPtr);
+    if(entry == NULL) {
+        table->overflow++;
+        return;
+    }
+    u64 us = execTime / 1000;
+    u32 bucket = (us == 0) ? 0 : (fls64(us) + 1);
+    if(bucket >= OCR_EDT_STATS_HISTOGRAM_SIZE) {
+        bucket = OCR_EDT_STATS_HISTOGRAM_SIZE - 1;
+    }
+    entry->count++;
+    entry->totalTime += execTime;
+    if(execTime < entry->minTime) {
+        entry->minTime = execTime;
+    }
+    if(execTime > entry->maxTime) {
+        entry->maxTime = execTime;
+    }
+    entry->readyTime += readyTime;
+    entry->dbBytes += dbBytes;
+    entry->histogram[bucket]++;
+}
+
+edtStatsTable_t * edtStatsMerge(ocrPolicyDomain_t *pd) {
+    edtStatsTable_t *merged = edtStatsCreate(pd);
+    u32 w, i, j;
+    // Tables are read while their workers may still update them: counters
+    // may be slightly behind but each one is consistent on its own
+    for(w = 0; w < pd->workerCount; ++w) {
+        edtStatsTable_t *table = pd->workers[w]->edtStats;
+        if(table == NULL) {
+            continue;
+        }
+        merged->overflow += table->overflow;
+        for(i = 0; i < EDT_STATS_TABLE_SIZE; ++i) {
+            ocrEdtStats_t *src = &(table->entries[i]);
+            if((src->funcPtr == NULL) || (src->count == 0)) {
+                continue;
+            }
+            ocrEdtStats_t *dst = lookupEntry(merged, src->funcPtr);
+            if(dst == NULL) {
+                merged->overflow += src->count;
+                continue;
+            }
+            dst->count += src->count;
+            dst->totalTime += src->totalTime;
+            if(src->minTime < dst->minTime) {
+                dst->minTime = src->minTime;
+            }
+            if(src->maxTime > dst->maxTime) {
+                dst->maxTime = src->maxTime;
+            }
+            dst->readyTime += src->readyTime;
+            dst->dbBytes += src->dbBytes;
+            for(j = 0; j < OCR_EDT_STATS_HISTOGRAM_SIZE; ++j) {
+                dst->histogram[j] += src->histogram[j];
+            }
+        }
+    }
+    // Compact the used entries at the front, by decreasing total time. The
+    // merged table is not looked up anymore so the hashing can be lost.
+    u32 count = 0;
+    for(i = 0; i < EDT_STATS_TABLE_SIZE; ++i) {
+        if(merged->entries[i].funcPtr == NULL) {
+            continue;
+        }
+        ocrEdtStats_t entry = merged->entries[i];
+        j = count;
+        while((j > 0) && (merged->entries[j-1].totalTime < entry.totalTime)) {
+            merged->entries[j] = merged->entries[j-1];
+            --j;
+        }
+        merged->entries[j] = entry;
+        ++count;
+    }
+    ASSERT(count == merged->count);
+    return merged;
+}
+
+void edtStatsDump(ocrPolicyDomain_t *pd) {
+    const char *format = getenv("OCR_EDT_STATS");
+    if(format == NULL) {
+        return;
+    }
+    bool json = (ocrStrcmp((u8*)format, (u8*)"json") == 0);
+    if(!json && (ocrStrcmp((u8*)format, (u8*)"csv") != 0)) {
+        DPRINTF(DEBUG_LVL_WARN, "OCR_EDT_STATS must be 'csv' or 'json', not '%s'\n", format);
+        return;
+    }
+    edtStatsTable_t *merged = edtStatsMerge(pd);
+    char fileName[64];
+    snprintf(fileName, sizeof(fileName), "edtStats.%"PRIu64".%s", (u64)pd->myLocation, format);
+    FILE *f = fopen(fileName, "w");
+    if(f == NULL) {
+        DPRINTF(DEBUG_LVL_WARN, "Cannot open %s to dump EDT statistics\n", fileName);
+        edtStatsDestroy(pd, merged);
+        return;
+    }
+    u32 i, j;
+    if(json) {
+        fprintf(f, "{\"location\":%"PRIu64",\"overflow\":%"PRIu64",\"edts\":[", (u64)pd->myLocation, merged->overflow);
+    } else {
+        fprintf(f, "funcPtr,count,totalNs,minNs,maxNs,readyNs,dbBytes");
+        for(j = 0; j < OCR_EDT_STATS_HISTOGRAM_SIZE; ++j) {
+            fprintf(f, ",hist%"PRIu32, j);
+        }
+        fprintf(f, "\n");
+    }
+    for(i = 0; i < merged->count; ++i) {
+        ocrEdtStats_t *entry = &(merged->entries[i]);
+        if(json) {
+            fprintf(f, "%s\n {\"funcPtr\":\"%p\",\"count\":%"PRIu64",\"totalNs\":%"PRIu64",\"minNs\":%"PRIu64
+                    ",\"maxNs\":%"PRIu64",\"readyNs\":%"PRIu64",\"dbBytes\":%"PRIu64",\"histogram\":[",
+                    (i == 0) ? "" : ",", entry->funcPtr, entry->count, entry->totalTime, entry->minTime,
+                    entry->maxTime, entry->readyTime, entry->dbBytes);
+            for(j = 0; j < OCR_EDT_STATS_HISTOGRAM_SIZE; ++j) {
+                fprintf(f, "%s%"PRIu64, (j == 0) ? "" : ",", entry->histogram[j]);
+            }
+            fprintf(f, "]}");
+        } else {
+            fprintf(f, "%p,%"PRIu64",%"PRIu64",%"PRIu64",%"PRIu64",%"PRIu64",%"PRIu64,
+                    entry->funcPtr, entry->count, entry->totalTime, entry->minTime, entry->maxTime,
+                    entry->readyTime, entry->dbBytes);
+            for(j = 0; j < OCR_EDT_STATS_HISTOGRAM_SIZE; ++j) {
+                fprintf(f, ",%"PRIu64, entry->histogram[j]);
+            }
+            fprintf(f, "\n");
+        }
+    }
+    if(json) {
+        fprintf(f, "\n]}\n");
+    }
+    fclose(f);
+    if(merged->overflow != 0) {
+        DPRINTF(DEBUG_LVL_WARN, "%"PRIu64" EDT executions not accounted for, raise EDT_STATS_TABLE_SIZE\n", merged->overflow);
+    }
+    edtStatsDestroy(pd, merged);
+}
+
+ocrGuid_t edtStatsQuery(void **result, u32 *size) {
+    ocrPolicyDomain_t *pd;
+    getCurrentEnv(&pd, NULL, NULL, NULL);
+    edtStatsTable_t *merged = edtStatsMerge(pd);
+    ocrGuid_t dataDb;
+    ocrEdtStats_t *entries;
+    *size = merged->count * sizeof(ocrEdtStats_t);
+    ocrDbCreate(&dataDb, (void **)&entries, (merged->count > 0) ? *size : sizeof(ocrEdtStats_t), 0, NULL_HINT, NO_ALLOC);
+    hal_memCopy(entries, merged->entries, *size, false);
+    *result = entries;
+    edtStatsDestroy(pd, merged);
+    return dataDb;
+}
+
+#endif /* ENABLE_EDT_STATS */
@@ -435,6 +435,810 @@ bool hashtableConcBucketLockedRemove(hashtable_t * hashtable, void * key, void *
 }
 
 
+/******************************************************/
+/* CONCURRENT RESIZABLE HASHTABLE                     */
+/******************************************************/
+
+// Number of stripe locks serializing writers of the same key
+#ifndef HASHTABLE_RESIZABLE_NB_LOCKS
+#define HASHTABLE_RESIZABLE_NB_LOCKS 1024
+#endif
+
+// Number of slots a writer migrates per operation while a resize is in progress
+#ifndef HASHTABLE_RESIZABLE_MIGRATE_CHUNK
+#define HASHTABLE_RESIZABLE_MIGRATE_CHUNK 64
+#endif
+
+// Number of counters operations register with (by thread) so that
+// migrated tables can be freed once no operation uses them anymore
+#ifndef HASHTABLE_RESIZABLE_NB_READERS
+#define HASHTABLE_RESIZABLE_NB_READERS 32
+#endif
+
+// Reserved keys and values. Lock-free readers stop probing on the first
+// EMPTY (or BLOCKED) slot so a key only goes back to EMPTY when the run of
+// tombstones it ends is not followed by any other key (see htrCleanup) or
+// by keys probed for through the run (see htrPurge).
+#define HTR_KEY_EMPTY    ((void *) 0x0)
+#define HTR_KEY_MOVED    ((void *) ~((u64) 0x0))  /* Empty slot of a migrated table */
+#define HTR_KEY_BLOCKED  ((void *) ~((u64) 0x1))  /* Empty slot that cannot be claimed yet */
+#define HTR_VAL_DELETED  ((void *) ~((u64) 0x0))  /* Tombstone, may be reused */
+#define HTR_VAL_RECLAIM  ((void *) ~((u64) 0x1))  /* Tombstone being reused for another key */
+#define HTR_VAL_MOVED    ((void *) ~((u64) 0x2))  /* Entry copied to the next table */
+#define HTR_VAL_CLEANING ((void *) ~((u64) 0x3))  /* Tombstone going back to EMPTY */
+
+#define HTR_IS_LIVE(v) (((v) != NULL) && ((u64)(v) < (u64) HTR_VAL_CLEANING))
+#define HTR_IS_KEY(k) (((k) != HTR_KEY_EMPTY) && ((u64)(k) < (u64) HTR_KEY_BLOCKED))
+
+// Range passed to the user hashing function before scrambling its result.
+// Keys are often generated in sequence which would otherwise fill slots
+// contiguously and make linear probing degenerate.
+#define HTR_HASH_RANGE 0x7FFFFFFF
+#define HTR_HASH_MULT 0x9E3779B97F4A7C15ULL
+
+typedef struct _hashtableResizableSlot_t {
+    void * volatile key;
+    void * volatile value;
+} hashtableResizableSlot_t;
+
+typedef struct _hashtableResizableTable_t {
+    u32 capacity;
+    u32 shift;                  /* log2(capacity) */
+    volatile u32 used;          /* Slots claimed from EMPTY */
+    volatile u32 resizing;
+    volatile u32 migrateCursor; /* Next slot to hand out for migration */
+    volatile u32 migrateDone;   /* Number of slots migrated */
+    volatile u32 migrated;      /* Set once the migration completed */
+    volatile u32 retireEpoch;   /* Epoch in which the table stopped being current */
+    struct _hashtableResizableTable_t * volatile next;
+    hashtableResizableSlot_t slots[];
+} hashtableResizableTable_t;
+
+typedef struct _hashtableResizableReaders_t {
+    volatile u32 count[2];      /* Operations in progress, by parity of the epoch they started in */
+    u32 padding[14];            /* Keep counters on different cache lines */
+} hashtableResizableReaders_t;
+
+typedef struct _hashtableResizable_t {
+    hashtable_t base;
+    hashtableResizableTable_t * volatile current;
+    // Oldest table not freed yet, chained through 'next' up to 'current'.
+    // Tables before 'current' are freed once the operations that may have
+    // seen them are done (see htrReclaim)
+    hashtableResizableTable_t * volatile first;
+    volatile u32 epoch;         /* Advanced while migrated tables wait to be freed */
+    u32 reclaimLock;
+    hashtableResizableReaders_t * readers;
+    u32 * stripeLock;
+#ifdef STATS_HASHTABLE
+    u32 nbResize;
+#endif
+} hashtableResizable_t;
+
+typedef enum {
+    HTR_OP_PUT,
+    HTR_OP_TRYPUT,
+    HTR_OP_REMOVE
+} htrOp_t;
+
+static hashtableResizableTable_t * htrNewTable(ocrPolicyDomain_t * pd, u32 capacity) {
+    hashtableResizableTable_t * table = pd->fcts.pdMalloc(pd,
+        sizeof(hashtableResizableTable_t) + capacity*sizeof(hashtableResizableSlot_t));
+    table->capacity = capacity;
+    table->shift = 0;
+    while ((((u32)1) << table->shift) < capacity) {
+        table->shift++;
+    }
+    table->used = 0;
+    table->resizing = 0;
+    table->migrateCursor = 0;
+    table->migrateDone = 0;
+    table->migrated = 0;
+    table->retireEpoch = (u32)-1;
+    table->next = NULL;
+    u32 i;
+    for (i=0; i < capacity; i++) {
+        table->slots[i].key = HTR_KEY_EMPTY;
+        table->slots[i].value = NULL;
+    }
+    return table;
+}
+
+static u32 htrHome(hashtableResizable_t * rhashtable, hashtableResizableTable_t * table, void * key) {
+    u64 hash = rhashtable->base.hashing(key, HTR_HASH_RANGE);
+    return (u32) ((hash * HTR_HASH_MULT) >> (64 - table->shift));
+}
+
+static u32 * htrStripeLock(hashtableResizable_t * rhashtable, void * key) {
+    return &rhashtable->stripeLock[rhashtable->base.hashing(key, HASHTABLE_RESIZABLE_NB_LOCKS)];
+}
+
+/**
+ * @brief Register an operation on the hashtable with the current epoch.
+ * Returns the counters to pass to htrLeave once the operation is done,
+ * along with 'epoch'.
+ */
+static hashtableResizableReaders_t * htrEnter(hashtableResizable_t * rhashtable, u32 * epoch) {
+    // Any counter works, the stack page spreads threads over them
+    // more cheaply than looking up the current worker
+    u64 page = ((u64) &rhashtable) >> 12;
+    hashtableResizableReaders_t * readers =
+        &rhashtable->readers[((page * HTR_HASH_MULT) >> 32) % HASHTABLE_RESIZABLE_NB_READERS];
+    while (true) {
+        u32 current = rhashtable->epoch;
+        // The increment is a full fence: if the epoch is still the same
+        // afterwards, whoever changes it next will see us registered
+        hal_xadd32(&readers->count[current & 1], 1);
+        if (rhashtable->epoch == current) {
+            *epoch = current;
+            return readers;
+        }
+        hal_xadd32(&readers->count[current & 1], (u32)-1);
+    }
+}
+
+/**
+ * @brief Check that no operation registered with an epoch of parity 'parity' is in progress
+ */
+static bool htrQuiescent(hashtableResizable_t * rhashtable, u32 parity) {
+    u32 i;
+    for (i = 0; i < HASHTABLE_RESIZABLE_NB_READERS; i++) {
+        if (rhashtable->readers[i].count[parity] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Free the migrated tables no operation in progress may still use.
+ * A table retired in epoch r is only seen by operations registered in
+ * epochs up to r. The epoch only moves from e to e+1 once the operations
+ * of epoch e-1 are done, so operations in progress are from the current
+ * and previous epochs only.
+ */
+static void htrReclaim(hashtableResizable_t * rhashtable) {
+    hal_lock32(&rhashtable->reclaimLock);
+    while (true) {
+        hashtableResizableTable_t * table = rhashtable->first;
+        if (table == hal_loadAcquire(&rhashtable->current)) {
+            break;
+        }
+        // Only set once 'current' moved past the table
+        u32 retireEpoch = hal_loadAcquire(&table->retireEpoch);
+        u32 epoch = rhashtable->epoch;
+        if ((retireEpoch == (u32)-1) || !htrQuiescent(rhashtable, (epoch - 1) & 1)) {
+            break;
+        }
+        if (retireEpoch == epoch) {
+            // Operations of the current epoch may use it, wait for them
+            hal_xadd32(&rhashtable->epoch, 1);
+            continue;
+        }
+        hal_storeRelease(&rhashtable->first, table->next);
+        rhashtable->base.pd->fcts.pdFree(rhashtable->base.pd, table);
+    }
+    hal_unlock32(&rhashtable->reclaimLock);
+}
+
+static void htrLeave(hashtableResizable_t * rhashtable, hashtableResizableReaders_t * readers, u32 epoch) {
+    // The last operation of an epoch past may be what kept tables from being freed
+    if ((hal_xadd32(&readers->count[epoch & 1], (u32)-1) == 1) && (rhashtable->epoch != epoch) &&
+        (rhashtable->first != rhashtable->current)) {
+        htrReclaim(rhashtable);
+    }
+}
+
+/**
+ * @brief Turn the run of tombstones ending at 'idx' back into EMPTY slots.
+ * Claims of the run's slots are blocked for the duration of the cleanup.
+ * The caller makes sure that no key is probed for through the run.
+ */
+static void htrClearRun(hashtableResizableTable_t * table, u32 idx) {
+    u32 mask = table->capacity - 1;
+    u32 cleaned = 0;
+    u32 i = idx;
+    while (hal_cmpswap64((u64*)&table->slots[i].value, (u64)HTR_VAL_DELETED, (u64)HTR_VAL_CLEANING) == (u64)HTR_VAL_DELETED) {
+        hal_storeRelease(&table->slots[i].key, HTR_KEY_BLOCKED);
+        hal_storeRelease(&table->slots[i].value, NULL);
+        cleaned++;
+        i = (i-1) & mask;
+    }
+    while (cleaned > 0) {
+        i = (i+1) & mask;
+        hal_storeRelease(&table->slots[i].key, HTR_KEY_EMPTY);
+        hal_xadd32(&table->used, (u32)-1);
+        cleaned--;
+    }
+}
+
+/**
+ * @brief Turn the run of tombstones ending at 'idx' back into EMPTY slots.
+ * Only done when the run is followed by an EMPTY slot, which is blocked
+ * for the duration of the cleanup so that no key gets inserted behind
+ * the run.
+ */
+static void htrCleanup(hashtableResizableTable_t * table, u32 idx) {
+    u32 mask = table->capacity - 1;
+    hashtableResizableSlot_t * end = &table->slots[(idx+1) & mask];
+    if ((end->key != HTR_KEY_EMPTY) ||
+        (hal_cmpswap64((u64*)&end->key, (u64)HTR_KEY_EMPTY, (u64)HTR_KEY_BLOCKED) != (u64)HTR_KEY_EMPTY)) {
+        return;
+    }
+    htrClearRun(table, idx);
+    hal_storeRelease(&end->key, HTR_KEY_EMPTY);
+}
+
+/**
+ * @brief Clear the tombstones of 'table' in place where it is safe.
+ * A run of tombstones can go back to EMPTY when none of the keys between
+ * the run and the next EMPTY slot has its home in or before the run.
+ * Writers are kept out for the duration, readers do not probe through the
+ * runs cleared. Must not be called while 'table' is migrated.
+ */
+static void htrPurge(hashtableResizable_t * rhashtable, hashtableResizableTable_t * table) {
+    u32 mask = table->capacity - 1;
+    u32 i;
+    for (i = 0; i < HASHTABLE_RESIZABLE_NB_LOCKS; i++) {
+        hal_lock32(&rhashtable->stripeLock[i]);
+    }
+    for (i = 0; i < table->capacity; i++) {
+        if ((table->slots[i].value != HTR_VAL_DELETED) ||
+            (table->slots[(i+1) & mask].value == HTR_VAL_DELETED)) {
+            continue;
+        }
+        // 'i' ends a run, look at what follows it
+        u32 j = (i+1) & mask;
+        if (table->slots[j].key == HTR_KEY_EMPTY) {
+            htrCleanup(table, i);
+            continue;
+        }
+        u32 n;
+        for (n = 1; n < table->capacity; n++, j = (j+1) & mask) {
+            void * slotKey = table->slots[j].key;
+            if (slotKey == HTR_KEY_EMPTY) {
+                htrClearRun(table, i);
+                break;
+            }
+            if (!HTR_IS_KEY(slotKey) ||
+                (((j - htrHome(rhashtable, table, slotKey)) & mask) >= ((j - i) & mask))) {
+                break;
+            }
+        }
+    }
+    for (i = 0; i < HASHTABLE_RESIZABLE_NB_LOCKS; i++) {
+        hal_unlock32(&rhashtable->stripeLock[i]);
+    }
+}
+
+/**
+ * @brief Check that nothing stops a probe from 'home' before it gets to 'slot'.
+ * A slot found EMPTY or a tombstone may have been cleaned up and claimed
+ * again between the probe and the claim, and the slots before it cleaned
+ * up along with it. Once claimed, the slots before it cannot go back to
+ * EMPTY if they are all keys.
+ */
+static bool htrReachable(hashtableResizableTable_t * table, u32 home, hashtableResizableSlot_t * slot) {
+    u32 mask = table->capacity - 1;
+    u32 i;
+    for (i = home; &table->slots[i] != slot; i = (i+1) & mask) {
+        if (!HTR_IS_KEY(hal_loadAcquire(&table->slots[i].key))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Apply 'op' for 'key' starting from 'table'.
+ * The caller must own the key's stripe lock. Entries for 'key' found in a table
+ * that is being migrated are moved forward first so that the operation always
+ * applies to the newest table. Returns true if the key was found.
+ */
+static bool htrApply(hashtableResizable_t * rhashtable, hashtableResizableTable_t * table,
+                     void * key, void * value, htrOp_t op, void ** valueBack, bool * needResize) {
+    while (true) {
+        hashtableResizableTable_t * next = hal_loadAcquire(&table->next);
+        u32 mask = table->capacity - 1;
+        u32 home = htrHome(rhashtable, table, key);
+        u32 idx = home;
+        hashtableResizableSlot_t * found = NULL;
+        hashtableResizableSlot_t * reuse = NULL;
+        bool forward = false;
+        bool blocked = false;
+        u32 n;
+        for (n = 0; n < table->capacity; n++, idx = (idx+1) & mask) {
+            hashtableResizableSlot_t * slot = &table->slots[idx];
+            void * slotKey = slot->key;
+            if (slotKey == key) {
+                void * slotValue = slot->value;
+                if (slotValue == HTR_VAL_RECLAIM) {
+                    // Being reused for another key, or given back if that failed
+                    blocked = true;
+                    break;
+                }
+                if (slotValue == HTR_VAL_CLEANING) {
+                    continue;
+                }
+                if (slotValue == HTR_VAL_MOVED) {
+                    forward = true;
+                } else {
+                    found = slot;
+                }
+                break;
+            }
+            if (slotKey == HTR_KEY_EMPTY) {
+                if (reuse == NULL) {
+                    reuse = slot;
+                }
+                break;
+            }
+            if (slotKey == HTR_KEY_MOVED) {
+                forward = true;
+                break;
+            }
+            if (slotKey == HTR_KEY_BLOCKED) {
+                blocked = true;
+                break;
+            }
+            if ((reuse == NULL) && (slot->value == HTR_VAL_DELETED)) {
+                reuse = slot;
+            }
+        }
+        if (blocked) {
+            // Wait for a concurrent cleanup or reuse to complete
+            hal_pause();
+            continue;
+        }
+        if (n == table->capacity) {
+            // Went around a full table, only possible while it is migrated
+            forward = true;
+        }
+        if (forward || ((found == NULL) && (next != NULL))) {
+            table = hal_loadAcquire(&table->next);
+            ASSERT(table != NULL);
+            continue;
+        }
+        if (found != NULL) {
+            void * slotValue = hal_loadAcquire(&found->value);
+            if ((slotValue == HTR_VAL_RECLAIM) || (slotValue == HTR_VAL_CLEANING) ||
+                (hal_loadAcquire(&found->key) != key)) {
+                // Our tombstone is being, or has been, reused or cleaned up
+                continue;
+            }
+            if (next != NULL) {
+                // Move the entry to the next table before operating there
+                if (slotValue == HTR_VAL_DELETED) {
+                    hal_cmpswap64((u64*)&found->value, (u64)HTR_VAL_DELETED, (u64)HTR_VAL_MOVED);
+                } else {
+                    if (HTR_IS_LIVE(slotValue)) {
+                        htrApply(rhashtable, next, key, slotValue, HTR_OP_PUT, NULL, needResize);
+                    }
+                    hal_storeRelease(&found->value, HTR_VAL_MOVED);
+                }
+                table = next;
+                continue;
+            }
+            if (HTR_IS_LIVE(slotValue)) {
+                if (op == HTR_OP_TRYPUT) {
+                    *valueBack = slotValue;
+                } else if (op == HTR_OP_PUT) {
+                    hal_storeRelease(&found->value, value);
+                } else {
+                    if (valueBack != NULL) {
+                        *valueBack = slotValue;
+                    }
+                    hal_storeRelease(&found->value, HTR_VAL_DELETED);
+                    htrCleanup(table, found - table->slots);
+                }
+                return true;
+            }
+            if (op == HTR_OP_REMOVE) {
+                return false;
+            }
+            // Revive the key's own tombstone. It may have been cleaned up and
+            // reused by another key since we looked at it: reserve it first.
+            if (hal_cmpswap64((u64*)&found->value, (u64)HTR_VAL_DELETED, (u64)HTR_VAL_RECLAIM) != (u64)HTR_VAL_DELETED) {
+                continue;
+            }
+            if (found->key != key) {
+                hal_storeRelease(&found->value, HTR_VAL_DELETED);
+                continue;
+            }
+            hal_storeRelease(&found->value, value);
+            return false;
+        }
+        // Key is absent from the newest table
+        if (op == HTR_OP_REMOVE) {
+            return false;
+        }
+        ASSERT(reuse != NULL);
+        if (reuse->key == HTR_KEY_EMPTY) {
+            if (hal_cmpswap64((u64*)&reuse->key, (u64)HTR_KEY_EMPTY, (u64)key) != (u64)HTR_KEY_EMPTY) {
+                continue;
+            }
+            u32 used = hal_xadd32(&table->used, 1) + 1;
+            if ((used * 2) > table->capacity) {
+                *needResize = true;
+            }
+            if (!htrReachable(table, home, reuse)) {
+                // Leave an unreachable tombstone behind and look again
+                hal_storeRelease(&reuse->value, HTR_VAL_DELETED);
+                continue;
+            }
+            hal_storeRelease(&reuse->value, value);
+        } else {
+            if (hal_cmpswap64((u64*)&reuse->value, (u64)HTR_VAL_DELETED, (u64)HTR_VAL_RECLAIM) != (u64)HTR_VAL_DELETED) {
+                continue;
+            }
+            if (!htrReachable(table, home, reuse)) {
+                hal_storeRelease(&reuse->value, HTR_VAL_DELETED);
+                continue;
+            }
+            // Readers check the key again after reading the value
+            hal_storeRelease(&reuse->key, key);
+            hal_storeRelease(&reuse->value, value);
+        }
+        return false;
+    }
+}
+
+/**
+ * @brief Migrate one slot of 'table' to its successor.
+ */
+static void htrMigrateSlot(hashtableResizable_t * rhashtable, hashtableResizableTable_t * table,
+                           hashtableResizableSlot_t * slot) {
+    while (true) {
+        void * slotKey = slot->key;
+        if (slotKey == HTR_KEY_MOVED) {
+            return;
+        }
+        if (slotKey == HTR_KEY_EMPTY) {
+            if (hal_cmpswap64((u64*)&slot->key, (u64)HTR_KEY_EMPTY, (u64)HTR_KEY_MOVED) == (u64)HTR_KEY_EMPTY) {
+                return;
+            }
+            continue;
+        }
+        if (slotKey == HTR_KEY_BLOCKED) {
+            hal_pause();
+            continue;
+        }
+        u32 * lock = htrStripeLock(rhashtable, slotKey);
+        hal_lock32(lock);
+        void * slotValue = slot->value;
+        if ((slot->key != slotKey) || (slotValue == HTR_VAL_RECLAIM) || (slotValue == HTR_VAL_CLEANING)) {
+            // The tombstone is being reused or cleaned up, wait for it to settle
+            hal_unlock32(lock);
+            hal_pause();
+            continue;
+        }
+        if (slotValue == HTR_VAL_DELETED) {
+            bool moved = (hal_cmpswap64((u64*)&slot->value, (u64)HTR_VAL_DELETED, (u64)HTR_VAL_MOVED) == (u64)HTR_VAL_DELETED);
+            hal_unlock32(lock);
+            if (moved) {
+                return;
+            }
+            continue;
+        }
+        if (slotValue != HTR_VAL_MOVED) {
+            if (HTR_IS_LIVE(slotValue)) {
+                bool needResize = false;
+                htrApply(rhashtable, table->next, slotKey, slotValue, HTR_OP_PUT, NULL, &needResize);
+            }
+            hal_storeRelease(&slot->value, HTR_VAL_MOVED);
+        }
+        hal_unlock32(lock);
+        return;
+    }
+}
+
+/**
+ * @brief Make 'table', whose slots have all been migrated, stop being current.
+ * New operations start from the next table and 'table' is freed once the
+ * operations that started before are done.
+ */
+static void htrCompleteMigrate(hashtableResizable_t * rhashtable, hashtableResizableTable_t * table) {
+    if (hal_cmpswap32(&table->migrated, 0, 1) != 0) {
+        return;
+    }
+    hal_storeRelease(&rhashtable->current, table->next);
+    // Read the epoch only once 'current' moved: operations that registered
+    // later cannot see 'table' anymore
+    hal_fence();
+    hal_storeRelease(&table->retireEpoch, rhashtable->epoch);
+    htrReclaim(rhashtable);
+}
+
+/**
+ * @brief Migrate a chunk of the current table if a resize is in progress.
+ * Returns true if there was migration work left to grab.
+ */
+static bool htrHelpMigrate(hashtableResizable_t * rhashtable) {
+    hashtableResizableTable_t * table = hal_loadAcquire(&rhashtable->current);
+    hashtableResizableTable_t * next = hal_loadAcquire(&table->next);
+    if (next == NULL) {
+        return false;
+    }
+    u32 capacity = table->capacity;
+    if (table->migrateCursor >= capacity) {
+        return false;
+    }
+    u32 start = hal_xadd32(&table->migrateCursor, HASHTABLE_RESIZABLE_MIGRATE_CHUNK);
+    if (start >= capacity) {
+        return false;
+    }
+    u32 end = start + HASHTABLE_RESIZABLE_MIGRATE_CHUNK;
+    if (end > capacity) {
+        end = capacity;
+    }
+    u32 i;
+    for (i = start; i < end; i++) {
+        htrMigrateSlot(rhashtable, table, &table->slots[i]);
+    }
+    if ((hal_xadd32(&table->migrateDone, end-start) + (end-start)) == capacity) {
+        htrCompleteMigrate(rhashtable, table);
+    }
+    return true;
+}
+
+/**
+ * @brief Migrate whatever is left of the current table's migration.
+ * Used when all chunks are handed out but some are not done yet: their
+ * owners may not be running and the next table must not fill up in the
+ * meantime. Migrating a slot twice is harmless.
+ */
+static void htrFinishMigrate(hashtableResizable_t * rhashtable) {
+    hashtableResizableTable_t * table = hal_loadAcquire(&rhashtable->current);
+    if (hal_loadAcquire(&table->next) == NULL) {
+        return;
+    }
+    u32 i;
+    for (i = 0; i < table->capacity; i++) {
+        hashtableResizableSlot_t * slot = &table->slots[i];
+        if ((slot->key != HTR_KEY_MOVED) && (slot->value != HTR_VAL_MOVED)) {
+            htrMigrateSlot(rhashtable, table, slot);
+        }
+    }
+    htrCompleteMigrate(rhashtable, table);
+}
+
+/**
+ * @brief Start migrating 'table' to a new table sized after its live entries.
+ */
+static void htrResize(hashtableResizable_t * rhashtable, hashtableResizableTable_t * table) {
+    if ((table->next != NULL) || (table->resizing != 0) ||
+        (hal_cmpswap32(&table->resizing, 0, 1) != 0)) {
+        return;
+    }
+    // Only one migration at a time: finish the one that produced 'table'
+    while (hal_loadAcquire(&rhashtable->current) != table) {
+        if (!htrHelpMigrate(rhashtable)) {
+            htrFinishMigrate(rhashtable);
+        }
+    }
+    // Approximate count, writers keep going while we scan
+    u32 live = 0;
+    u32 i;
+    for (i = 0; i < table->capacity; i++) {
+        if (HTR_IS_LIVE(table->slots[i].value)) {
+            live++;
+        }
+    }
+    // Keep the new table at most a quarter full so that it does not
+    // need to grow again before the migration is over.
+    u32 capacity = rhashtable->base.nbBuckets;
+    while (capacity < (live * 4)) {
+        capacity *= 2;
+    }
+    if (capacity == table->capacity) {
+        // Mostly tombstones: try to get rid of them without migrating
+        htrPurge(rhashtable, table);
+        if ((table->used * 2) <= table->capacity) {
+            DPRINTF(DEBUG_LVL_VERB, "Hashtable@%p purged in place (%"PRIu32" used)\n", rhashtable, table->used);
+            table->resizing = 0;
+            return;
+        }
+    }
+    DPRINTF(DEBUG_LVL_VERB, "Hashtable@%p resize %"PRIu32" -> %"PRIu32" slots (%"PRIu32" live)\n",
+            rhashtable, table->capacity, capacity, live);
+    hashtableResizableTable_t * next = htrNewTable(rhashtable->base.pd, capacity);
+#ifdef STATS_HASHTABLE
+    rhashtable->nbResize++;
+#endif
+    hal_storeRelease(&table->next, next);
+}
+
+void * hashtableConcResizableGet(hashtable_t * hashtable, void * key) {
+    hashtableResizable_t * rhashtable = (hashtableResizable_t *) hashtable;
+    u32 epoch;
+    hashtableResizableReaders_t * readers = htrEnter(rhashtable, &epoch);
+    void * value = NULL;
+    hashtableResizableTable_t * table = hal_loadAcquire(&rhashtable->current);
+    while (table != NULL) {
+        u32 mask = table->capacity - 1;
+        u32 idx = htrHome(rhashtable, table, key);
+        u32 n;
+        for (n = 0; n < table->capacity; n++, idx = (idx+1) & mask) {
+            hashtableResizableSlot_t * slot = &table->slots[idx];
+            void * slotKey = hal_loadAcquire(&slot->key);
+            if (slotKey == key) {
+                void * slotValue = hal_loadAcquire(&slot->value);
+                if ((slotValue == HTR_VAL_RECLAIM) || (slotValue == HTR_VAL_CLEANING) ||
+                    (hal_loadAcquire(&slot->key) != key)) {
+                    // Tombstone reused for another key or cleaned up
+                    continue;
+                }
+                if (slotValue != HTR_VAL_MOVED) {
+                    value = (slotValue == HTR_VAL_DELETED) ? NULL : slotValue;
+                    table = NULL;
+                }
+                break;
+            }
+            if (!HTR_IS_KEY(slotKey)) {
+                // EMPTY, BLOCKED or MOVED: nothing further for this key here
+                break;
+            }
+        }
+        if (table != NULL) {
+            table = hal_loadAcquire(&table->next);
+        }
+    }
+    htrLeave(rhashtable, readers, epoch);
+    return value;
+}
+
+/**
+ * @brief Wait for the newest table to be resized if it is getting full.
+ * Insertions past half the capacity trigger a resize but keep going while
+ * it is in progress, which is only a problem if it lags far behind.
+ */
+static void htrThrottle(hashtableResizable_t * rhashtable) {
+    while (true) {
+        hashtableResizableTable_t * table = hal_loadAcquire(&rhashtable->current);
+        while (table->next != NULL) {
+            table = table->next;
+        }
+        if ((table->used * 4) <= (table->capacity * 3)) {
+            return;
+        }
+        htrResize(rhashtable, table);
+        if (table->next == NULL) {
+            hal_pause();
+        }
+    }
+}
+
+static bool htrConcApply(hashtable_t * hashtable, void * key, void * value, htrOp_t op, void ** valueBack) {
+    hashtableResizable_t * rhashtable = (hashtableResizable_t *) hashtable;
+    ASSERT(HTR_IS_KEY(key));
+    ASSERT((op == HTR_OP_REMOVE) || ((u64)value < (u64)HTR_VAL_CLEANING));
+    u32 epoch;
+    hashtableResizableReaders_t * readers = htrEnter(rhashtable, &epoch);
+    htrHelpMigrate(rhashtable);
+    htrThrottle(rhashtable);
+    bool needResize = false;
+    u32 * lock = htrStripeLock(rhashtable, key);
+    hal_lock32(lock);
+    bool found = htrApply(rhashtable, hal_loadAcquire(&rhashtable->current), key, value, op, valueBack, &needResize);
+    hal_unlock32(lock);
+    if (needResize) {
+        // Resize without holding any lock since it may have to migrate other keys
+        hashtableResizableTable_t * table = hal_loadAcquire(&rhashtable->current);
+        while (table->next != NULL) {
+            table = table->next;
+        }
+        htrResize(rhashtable, table);
+    }
+    htrLeave(rhashtable, readers, epoch);
+    return found;
+}
+
+bool hashtableConcResizablePut(hashtable_t * hashtable, void * key, void * value) {
+    htrConcApply(hashtable, key, value, HTR_OP_PUT, NULL);
+    return true;
+}
+
+void * hashtableConcResizableTryPut(hashtable_t * hashtable, void * key, void * value) {
+    void * current = value;
+    htrConcApply(hashtable, key, value, HTR_OP_TRYPUT, &current);
+    return current;
+}
+
+bool hashtableConcResizableRemove(hashtable_t * hashtable, void * key, void ** value) {
+    return htrConcApply(hashtable, key, NULL, HTR_OP_REMOVE, value);
+}
+
+/**
+ * @brief Create a new resizable hashtable instance that uses the specified hashing function.
+ */
+hashtable_t * newHashtableResizable(ocrPolicyDomain_t * pd, u32 nbBuckets, hashFct hashing) {
+    hashtableResizable_t * rhashtable = pd->fcts.pdMalloc(pd, sizeof(hashtableResizable_t));
+    hashtable_t * hashtable = (hashtable_t *) rhashtable;
+    u32 capacity = HASHTABLE_RESIZABLE_MIGRATE_CHUNK;
+    while (capacity < nbBuckets) {
+        capacity *= 2;
+    }
+    hashtable->pd = pd;
+    hashtable->nbBuckets = capacity;
+    hashtable->table = NULL;
+    hashtable->hashing = hashing;
+    rhashtable->current = htrNewTable(pd, capacity);
+    rhashtable->first = rhashtable->current;
+    rhashtable->epoch = 0;
+    rhashtable->reclaimLock = 0;
+    hashtableResizableReaders_t * readers = pd->fcts.pdMalloc(pd, HASHTABLE_RESIZABLE_NB_READERS*sizeof(hashtableResizableReaders_t));
+    u32 i;
+    for (i=0; i < HASHTABLE_RESIZABLE_NB_READERS; i++) {
+        readers[i].count[0] = 0;
+        readers[i].count[1] = 0;
+    }
+    rhashtable->readers = readers;
+    u32 * stripeLock = pd->fcts.pdMalloc(pd, HASHTABLE_RESIZABLE_NB_LOCKS*sizeof(u32));
+    for (i=0; i < HASHTABLE_RESIZABLE_NB_LOCKS; i++) {
+        stripeLock[i] = 0;
+    }
+    rhashtable->stripeLock = stripeLock;
+#ifdef STATS_HASHTABLE
+    rhashtable->nbResize = 0;
+#endif
+    return hashtable;
+}
+
+/**
+ * @brief Destruct the hashtable and all its entries (do not deallocate keys and values pointers).
+ */
+void destructHashtableResizable(hashtable_t * hashtable, deallocFct entryDeallocator, void * deallocatorParam) {
+    ocrPolicyDomain_t * pd = hashtable->pd;
+    hashtableResizable_t * rhashtable = (hashtableResizable_t *) hashtable;
+#ifdef STATS_HASHTABLE
+    DPRINTF(DEBUG_LVL_WARN, "Hashtable@%p statistics\n", hashtable);
+    DPRINTF(DEBUG_LVL_WARN, "Resizes=%"PRIu32" Capacity=%"PRIu32"\n", rhashtable->nbResize, rhashtable->current->capacity);
+#endif
+    hashtableResizableTable_t * table = rhashtable->first;
+    while (table != NULL) {
+        hashtableResizableTable_t * next = table->next;
+        if (entryDeallocator != NULL) {
+            u32 i;
+            for (i=0; i < table->capacity; i++) {
+                void * slotKey = table->slots[i].key;
+                void * slotValue = table->slots[i].value;
+                if (HTR_IS_KEY(slotKey) && HTR_IS_LIVE(slotValue)) {
+                    entryDeallocator(slotKey, slotValue, deallocatorParam);
+                }
+            }
+        }
+        pd->fcts.pdFree(pd, table);
+        table = next;
+    }
+    pd->fcts.pdFree(pd, rhashtable->readers);
+    pd->fcts.pdFree(pd, rhashtable->stripeLock);
+    pd->fcts.pdFree(pd, hashtable);
+}
+
+void hashtableFctsInit(hashtableFcts_t * fcts, hashtableType_t type) {
+    switch(type) {
+    case HASHTABLE_RESIZABLE:
+        fcts->create = newHashtableResizable;
+        fcts->destruct = destructHashtableResizable;
+        fcts->get = hashtableConcResizableGet;
+        fcts->put = hashtableConcResizablePut;
+        fcts->tryPut = hashtableConcResizableTryPut;
+        fcts->remove = hashtableConcResizableRemove;
+        break;
+    case HASHTABLE_BUCKET_LOCKED:
+        fcts->create = newHashtableBucketLocked;
+        fcts->destruct = destructHashtableBucketLocked;
+        fcts->get = hashtableConcBucketLockedGet;
+        fcts->put = hashtableConcBucketLockedPut;
+        fcts->tryPut = hashtableConcBucketLockedTryPut;
+        fcts->remove = hashtableConcBucketLockedRemove;
+        break;
+    default:
+        ASSERT(false && "Unknown hashtable type");
+    }
+}
+
+
 //
 // Variants of the generic hashtable through hashing function specialization
 //
@@ -454,3 +1258,7 @@ hashtable_t * newHashtableModulo(ocrPolicyDomain_t * pd, u32 nbBuckets) {
 hashtable_t * newHashtableBucketLockedModulo(ocrPolicyDomain_t * pd, u32 nbBuckets) {
     return newHashtableBucketLocked(pd, nbBuckets, hashModulo);
 }
+
+hashtable_t * newHashtableResizableModulo(ocrPolicyDomain_t * pd, u32 nbBuckets) {
+    return newHashtableResizable(pd, nbBuckets, hashModulo);
+}
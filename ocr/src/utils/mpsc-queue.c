@@ -0,0 +1,66 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#include "ocr-config.h"
+
+#include "ocr-hal.h"
+#include "debug.h"
+#include "utils/mpsc-queue.h"
+
+#define DEBUG_TYPE UTIL
+
+//
+// Intrusive MPSC queue (Vyukov). Producers swap themselves in as the new
+// head and then link the previous head to them. The consumer follows the
+// 'next' links from the tail. A stub node keeps the list non-empty so that
+// producers never have to touch the tail.
+//
+
+void mpscQueueInit(mpscQueue_t * queue) {
+    queue->stub.next = NULL;
+    queue->head = &queue->stub;
+    queue->tail = &queue->stub;
+}
+
+void mpscQueuePush(mpscQueue_t * queue, mpscQueueNode_t * node) {
+    node->next = NULL;
+    mpscQueueNode_t * prev = (mpscQueueNode_t *) hal_swap64((u64 *) &queue->head, (u64) node);
+    // Between the swap and this store the consumer sees 'prev' as the last node
+    hal_storeRelease(&prev->next, node);
+}
+
+mpscQueueNode_t * mpscQueuePop(mpscQueue_t * queue) {
+    mpscQueueNode_t * tail = queue->tail;
+    mpscQueueNode_t * next = hal_loadAcquire(&tail->next);
+    if (tail == &queue->stub) {
+        if (next == NULL) {
+            return NULL;
+        }
+        queue->tail = next;
+        tail = next;
+        next = hal_loadAcquire(&next->next);
+    }
+    if (next != NULL) {
+        queue->tail = next;
+        return tail;
+    }
+    if (tail != hal_loadAcquire(&queue->head)) {
+        // A producer is in the middle of linking after 'tail'
+        return NULL;
+    }
+    // 'tail' is the last node: push the stub behind it so it can be unlinked
+    mpscQueuePush(queue, &queue->stub);
+    next = hal_loadAcquire(&tail->next);
+    if (next != NULL) {
+        queue->tail = next;
+        return tail;
+    }
+    return NULL;
+}
+
+bool mpscQueueIsEmpty(mpscQueue_t * queue) {
+    return (queue->tail == &queue->stub) && (hal_loadAcquire(&queue->head) == &queue->stub);
+}
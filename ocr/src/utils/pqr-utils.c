@@ -38,7 +38,7 @@ ocrGuid_t hcDumpNextEdt(ocrWorker_t *worker, u32 *size){
     wstObj = (ocrSchedulerObjectWst_t *)schedObj;
     deqObj = (ocrSchedulerObjectDeq_t *)wstObj->deques[worker->id];
 
-    u32 tail = (deqObj->deque->tail%INIT_DEQUE_CAPACITY);
+    u32 tail = (deqObj->deque->tail%deqObj->deque->capacity);
     u32 deqSize = deqObj->deque->size(deqObj->deque);
 
     if(deqSize > 0){
@@ -121,8 +121,8 @@ ocrGuid_t hcQueryAllEdts(ocrPolicyDomainHc_t *rself, void **result, u32 *qsize){
         wstObj = (ocrSchedulerObjectWst_t *)schedObj;
         deqObj = (ocrSchedulerObjectDeq_t *)wstObj->deques[i];
 
-        u32 head = (deqObj->deque->head%INIT_DEQUE_CAPACITY);
-        u32 tail = (deqObj->deque->tail%INIT_DEQUE_CAPACITY);
+        u32 head = (deqObj->deque->head%deqObj->deque->capacity);
+        u32 tail = (deqObj->deque->tail%deqObj->deque->capacity);
         u32 deqSize = tail-head;
 
         if(deqSize > 0){
@@ -143,8 +143,8 @@ ocrGuid_t hcQueryAllEdts(ocrPolicyDomainHc_t *rself, void **result, u32 *qsize){
         wstObj = (ocrSchedulerObjectWst_t *)schedObj;
         deqObj = (ocrSchedulerObjectDeq_t *)wstObj->deques[i];
 
-        u32 head = (deqObj->deque->head%INIT_DEQUE_CAPACITY);
-        u32 tail = (deqObj->deque->tail%INIT_DEQUE_CAPACITY);
+        u32 head = (deqObj->deque->head%deqObj->deque->capacity);
+        u32 tail = (deqObj->deque->tail%deqObj->deque->capacity);
         u32 deqSize = tail-head;
 
         if(deqSize > 0){
@@ -0,0 +1,327 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#include "ocr-config.h"
+#ifdef ENABLE_SLAB_CACHE
+
+#include <stdlib.h>
+
+#include "debug.h"
+#include "ocr-allocator.h"
+#include "ocr-hal.h"
+#include "ocr-policy-domain.h"
+#include "ocr-worker.h"
+#include "utils/slab-cache.h"
+
+#define DEBUG_TYPE ALLOCATOR
+
+// The type must fit in the header's low bits, next to the class address
+COMPILE_ASSERT(allocatorMax_id <= POOL_HEADER_TYPE_MASK);
+COMPILE_ASSERT(SLAB_CACHE_MAX_SIZE_LOG2 >= 7);
+COMPILE_ASSERT(SLAB_CACHE_PAGE_SIZE >= (sizeof(slabPage_t) + sizeof(u64) + SLAB_CACHE_MAX_SIZE));
+
+// Size classes: 16, 32, 48, 64 then four evenly spaced classes in each
+// (2^k, 2^(k+1)] range: 80, 96, 112, 128, 160, 192, ...
+static u32 slabClassOf(u64 size) {
+    if(size <= 64) {
+        return (size == 0) ? 0 : (u32) ((size - 1) >> 4);
+    }
+    u32 log = fls64(size - 1);
+    return 4 + (log - 6) * 4 + (u32) (((size - 1) >> (log - 2)) & 3);
+}
+
+static u64 slabClassSize(u32 idx) {
+    if(idx < 4) {
+        return (idx + 1) << 4;
+    }
+    u32 log = 6 + (idx - 4) / 4;
+    return (1ULL << log) + (((idx - 4) % 4) + 1) * (1ULL << (log - 2));
+}
+
+slabCache_t * slabCacheCreate(ocrPolicyDomain_t *pd) {
+    // Not allocated through pdMalloc so that it never comes from another cache
+    ocrAllocator_t *allocator = pd->allocators[0];
+    slabCache_t *cache = (slabCache_t *) allocator->fcts.allocate(allocator, sizeof(slabCache_t), 0);
+    ASSERT(cache != NULL);
+    u32 i;
+    cache->pd = pd;
+    cache->remotePending = 0;
+    cache->fallbackCount = 0;
+    for(i = 0; i < SLAB_CACHE_CLASS_COUNT; ++i) {
+        slabClassCache_t *cls = &(cache->classes[i]);
+        cls->partial = NULL;
+        cls->full = NULL;
+        cls->cache = cache;
+        cls->size = slabClassSize(i);
+        cls->emptyPages = 0;
+        cls->remoteFree = NULL;
+        cls->allocCount = 0;
+        cls->freeCount = 0;
+        cls->requestedBytes = 0;
+        cls->pageCount = 0;
+        cls->pageAllocCount = 0;
+        cls->pageReleaseCount = 0;
+        ASSERT(slabClassOf(cls->size) == i);
+    }
+    return cache;
+}
+
+static void slabFreePages(slabPage_t *page) {
+    while(page != NULL) {
+        slabPage_t *next = page->next;
+        allocatorFreeFunction(page);
+        page = next;
+    }
+}
+
+void slabCacheDestroy(ocrPolicyDomain_t *pd, slabCache_t *cache) {
+    u32 i;
+    for(i = 0; i < SLAB_CACHE_CLASS_COUNT; ++i) {
+        slabFreePages(cache->classes[i].partial);
+        slabFreePages(cache->classes[i].full);
+    }
+    allocatorFreeFunction(cache);
+}
+
+static void slabPageUnlink(slabPage_t **list, slabPage_t *page) {
+    if(page->prev == NULL) {
+        *list = page->next;
+    } else {
+        page->prev->next = page->next;
+    }
+    if(page->next != NULL) {
+        page->next->prev = page->prev;
+    }
+}
+
+static void slabPagePush(slabPage_t **list, slabPage_t *page) {
+    page->prev = NULL;
+    page->next = *list;
+    if(*list != NULL) {
+        (*list)->prev = page;
+    }
+    *list = page;
+}
+
+static inline u64 slabStride(slabClassCache_t *cls) {
+    return sizeof(u64) + cls->size;
+}
+
+static inline bool slabPageExhausted(slabPage_t *page) {
+    return (page->freeList == NULL) &&
+        ((page->carve + slabStride(page->cls)) > (((u8 *) page) + SLAB_CACHE_PAGE_SIZE));
+}
+
+// Takes a new empty page from the allocator and makes it the class' first partial page
+static slabPage_t * slabPageCreate(slabClassCache_t *cls) {
+    ocrAllocator_t *allocator = cls->cache->pd->allocators[0];
+    slabPage_t *page = (slabPage_t *) allocator->fcts.allocate(allocator, SLAB_CACHE_PAGE_SIZE, 0);
+    if(page == NULL) {
+        return NULL;
+    }
+    page->cls = cls;
+    page->freeList = NULL;
+    page->carve = (u8 *) (page + 1);
+    page->used = 0;
+    slabPagePush(&(cls->partial), page);
+    cls->emptyPages++;
+    cls->pageCount++;
+    cls->pageAllocCount++;
+    return page;
+}
+
+// Hands out an object of 'page', which must not be exhausted
+static void * slabPageTake(slabPage_t *page) {
+    slabClassCache_t *cls = page->cls;
+    u64 *header;
+    void *obj = page->freeList;
+    if(obj != NULL) {
+        page->freeList = *((void **) obj);
+        header = ((u64 *) obj) - 1;
+    } else {
+        header = (u64 *) page->carve;
+        *header = ((u64) page) | SLAB_CACHE_TYPE_ID;
+        page->carve += slabStride(cls);
+    }
+    if(page->used++ == 0) {
+        cls->emptyPages--;
+    }
+    if(slabPageExhausted(page)) {
+        slabPageUnlink(&(cls->partial), page);
+        slabPagePush(&(cls->full), page);
+    }
+    return header + 1;
+}
+
+// Gives an object back to its page, done by the owning worker only. An
+// empty page beyond the class' high-water mark goes back to the allocator.
+static void slabPagePut(slabPage_t *page, void *addr) {
+    slabClassCache_t *cls = page->cls;
+    if(slabPageExhausted(page)) {
+        slabPageUnlink(&(cls->full), page);
+        slabPagePush(&(cls->partial), page);
+    }
+    *((void **) addr) = page->freeList;
+    page->freeList = addr;
+    if(--page->used == 0) {
+        if(cls->emptyPages >= SLAB_CACHE_CLASS_MAX_EMPTY_PAGES) {
+            slabPageUnlink(&(cls->partial), page);
+            allocatorFreeFunction(page);
+            cls->pageCount--;
+            cls->pageReleaseCount++;
+        } else {
+            cls->emptyPages++;
+        }
+    }
+}
+
+static void slabClassDrain(slabClassCache_t *cls) {
+    // The owner only ever takes the whole list so there is no ABA problem
+    void *obj = (void *) hal_swap64((u64 *) &(cls->remoteFree), (u64) NULL);
+    while(obj != NULL) {
+        void *next = *((void **) obj);
+        slabPagePut((slabPage_t *) (((u64 *) obj)[-1] & POOL_HEADER_ADDR_MASK), obj);
+        obj = next;
+    }
+}
+
+void slabCacheDrain(slabCache_t *cache) {
+    if(cache->remotePending == 0) {
+        return;
+    }
+    // Cleared before looking at the lists: an object pushed after a list
+    // is taken sets the flag again for the next drain
+    cache->remotePending = 0;
+    hal_fence();
+    u32 i;
+    for(i = 0; i < SLAB_CACHE_CLASS_COUNT; ++i) {
+        if(cache->classes[i].remoteFree != NULL) {
+            slabClassDrain(&(cache->classes[i]));
+        }
+    }
+}
+
+void * slabCacheAlloc(slabCache_t *cache, u64 size) {
+    if(size > SLAB_CACHE_MAX_SIZE) {
+        cache->fallbackCount++;
+        return NULL;
+    }
+    slabClassCache_t *cls = &(cache->classes[slabClassOf(size)]);
+    slabPage_t *page = cls->partial;
+    if((page == NULL) && (cls->remoteFree != NULL)) {
+        // Take back all the objects other threads freed before growing
+        slabClassDrain(cls);
+        page = cls->partial;
+    }
+    if(page == NULL) {
+        page = slabPageCreate(cls);
+        if(page == NULL) {
+            cache->fallbackCount++;
+            return NULL;
+        }
+    }
+    cls->allocCount++;
+    cls->requestedBytes += size;
+    return slabPageTake(page);
+}
+
+void slabCacheFree(slabCache_t *cache, void *addr) {
+    slabPage_t *page = (slabPage_t *) (((u64 *) addr)[-1] & POOL_HEADER_ADDR_MASK);
+    slabClassCache_t *cls = page->cls;
+    if(cls->cache == cache) {
+        slabPagePut(page, addr);
+        cls->freeCount++;
+        return;
+    }
+    void *head;
+    do {
+        head = cls->remoteFree;
+        *((void **) addr) = head;
+    } while(hal_cmpswap64((u64 *) &(cls->remoteFree), (u64) head, (u64) addr) != (u64) head);
+    if(cls->cache->remotePending == 0) {
+        cls->cache->remotePending = 1;
+    }
+}
+
+static u64 slabListLength(void *head) {
+    u64 count = 0;
+    while(head != NULL) {
+        head = *((void **) head);
+        ++count;
+    }
+    return count;
+}
+
+// Objects handed out of the pages of 'page''s list and not freed to them yet
+static u64 slabPagesUsed(slabPage_t *page) {
+    u64 count = 0;
+    while(page != NULL) {
+        count += page->used;
+        page = page->next;
+    }
+    return count;
+}
+
+void slabCacheDump(ocrPolicyDomain_t *pd) {
+    char *enabled = getenv("OCR_SLAB_STATS");
+    if((enabled == NULL) || (enabled[0] == '\0')) {
+        return;
+    }
+    u64 allocs[SLAB_CACHE_CLASS_COUNT], frees[SLAB_CACHE_CLASS_COUNT];
+    u64 remoteFrees[SLAB_CACHE_CLASS_COUNT], live[SLAB_CACHE_CLASS_COUNT];
+    u64 pageCount = 0, pageAllocCount = 0, pageReleaseCount = 0;
+    u64 fallbackCount = 0, requestedBytes = 0, classBytes = 0;
+    u64 liveBytes = 0;
+    u32 w, i;
+    for(i = 0; i < SLAB_CACHE_CLASS_COUNT; ++i) {
+        allocs[i] = frees[i] = remoteFrees[i] = live[i] = 0;
+    }
+    for(w = 0; w < pd->workerCount; ++w) {
+        slabCache_t *cache = pd->workers[w]->slabCache;
+        if(cache == NULL) {
+            continue;
+        }
+        fallbackCount += cache->fallbackCount;
+        for(i = 0; i < SLAB_CACHE_CLASS_COUNT; ++i) {
+            slabClassCache_t *cls = &(cache->classes[i]);
+            // Objects freed remotely but not drained yet are still counted
+            // by their page
+            u64 inUse = slabPagesUsed(cls->partial) + slabPagesUsed(cls->full) -
+                slabListLength(cls->remoteFree);
+            allocs[i] += cls->allocCount;
+            frees[i] += cls->freeCount;
+            remoteFrees[i] += cls->allocCount - cls->freeCount - inUse;
+            live[i] += inUse;
+            requestedBytes += cls->requestedBytes;
+            classBytes += cls->allocCount * cls->size;
+            liveBytes += inUse * cls->size;
+            pageCount += cls->pageCount;
+            pageAllocCount += cls->pageAllocCount;
+            pageReleaseCount += cls->pageReleaseCount;
+        }
+    }
+    PRINTF("Slab cache statistics for PD %"PRIu64"\n", (u64) pd->myLocation);
+    PRINTF("size\tallocs\tfrees\tremoteFrees\tlive\n");
+    for(i = 0; i < SLAB_CACHE_CLASS_COUNT; ++i) {
+        if(allocs[i] == 0) {
+            continue;
+        }
+        PRINTF("%"PRIu64"\t%"PRIu64"\t%"PRIu64"\t%"PRIu64"\t%"PRIu64"\n",
+               slabClassSize(i), allocs[i], frees[i], remoteFrees[i], live[i]);
+    }
+    u64 pageBytes = pageCount * SLAB_CACHE_PAGE_SIZE;
+    // Internal: rounding requests up to their class. External: page bytes
+    // not holding live objects (free objects, headers, uncarved space).
+    PRINTF("Pages: %"PRIu64" (%"PRIu64" KB), live objects: %"PRIu64" KB\n",
+           pageCount, pageBytes >> 10, liveBytes >> 10);
+    PRINTF("Fragmentation: internal %"PRIu64"%%, external %"PRIu64"%%\n",
+           (classBytes == 0) ? 0 : (100 * (classBytes - requestedBytes)) / classBytes,
+           (pageBytes == 0) ? 0 : (100 * (pageBytes - liveBytes)) / pageBytes);
+    PRINTF("Requests handed to the allocator: %"PRIu64", page allocations: %"PRIu64", pages given back: %"PRIu64"\n",
+           fallbackCount, pageAllocCount, pageReleaseCount);
+}
+
+#endif /* ENABLE_SLAB_CACHE */
@@ -29,6 +29,8 @@ const char *action_type[] = {
     "SATISFY",
     "EXECUTE",
     "FINISH",
+    "DB_ACQUIRE",
+    "DB_RELEASE",
 };
 
 #endif /* __TRACE_EVENTS_H__ */
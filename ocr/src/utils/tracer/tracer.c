@@ -7,19 +7,21 @@
 #include "utils/ocr-utils.h"
 #include "ocr-types.h"
 #include "utils/tracer/tracer.h"
-#include "utils/deque.h"
 #include "worker/hc/hc-worker.h"
 
 
-static bool isDequeFull(deque_t *deq){
-    if(deq == NULL) return false;
-    s32 head = deq->head;
-    s32 tail = deq->tail;
-    if(tail == (INIT_DEQUE_CAPACITY + head)){
-        return true;
-    }else{
-        return false;
-    }
+COMPILE_ASSERT((TRACE_RING_CAPACITY & (TRACE_RING_CAPACITY - 1)) == 0);
+
+ocrTraceRing_t * traceRingCreate(ocrPolicyDomain_t *pd){
+    ocrTraceRing_t *ring = pd->fcts.pdMalloc(pd, sizeof(ocrTraceRing_t));
+    ring->head = 0;
+    ring->tail = 0;
+    ring->dropped = 0;
+    return ring;
+}
+
+void traceRingDestroy(ocrPolicyDomain_t *pd, ocrTraceRing_t *ring){
+    pd->fcts.pdFree(pd, ring);
 }
 
 static bool isSystem(ocrPolicyDomain_t *pd){
@@ -40,7 +42,7 @@ static bool isSupportedTraceType(bool evtType, ocrTraceType_t ttype, ocrTraceAct
             (evtType == true || evtType == false));
 }
 
-//Create a trace object subject to trace type, and push to HC worker's deque, to be processed by system worker.
+//Fill a trace object subject to trace type in the HC worker's ring, to be flushed by system worker.
 static void populateTraceObject(u64 location, bool evtType, ocrTraceType_t objType, ocrTraceAction_t actionType,
                                 u64 workerId, u64 timestamp, ocrGuid_t parent, va_list ap){
 
@@ -50,11 +52,19 @@ static void populateTraceObject(u64 location, bool evtType, ocrTraceType_t objTy
     ocrEdt_t func = NULL;
     u64 size = 0;
 
-    ocrPolicyDomain_t *pd = NULL;
     ocrWorker_t *worker;
-    getCurrentEnv(&pd, &worker, NULL, NULL);
-
-    ocrTraceObj_t * tr = pd->fcts.pdMalloc(pd, sizeof(ocrTraceObj_t));
+    getCurrentEnv(NULL, &worker, NULL, NULL);
+
+    ocrTraceRing_t *ring = ((ocrWorkerHc_t *)worker)->traceRing;
+    if(ring == NULL) return;
+    //Only this worker moves the tail, the system worker moves the head
+    u64 tail = ring->tail;
+    if((tail - hal_loadAcquire(&ring->head)) == TRACE_RING_CAPACITY){
+        //Ring full: never wait for the system worker, lose the record instead
+        ring->dropped++;
+        return;
+    }
+    ocrTraceObj_t * tr = &(ring->records[tail & (TRACE_RING_CAPACITY - 1)]);
 
     //Populate fields common to all trace objects.
     tr->typeSwitch = objType;
@@ -188,12 +198,8 @@ static void populateTraceObject(u64 location, bool evtType, ocrTraceType_t objTy
         break;
     }
 
-    while(isDequeFull(((ocrWorkerHc_t*)worker)->sysDeque)){
-        hal_pause();
-    }
-
-    //Trace object populated. Push to my deque
-    ((ocrWorkerHc_t *)worker)->sysDeque->pushAtTail(((ocrWorkerHc_t *)worker)->sysDeque, tr, 0);
+    //Trace object populated. Publish it to the system worker
+    hal_storeRelease(&ring->tail, tail + 1);
 
 }
 
@@ -182,6 +182,41 @@ typedef struct {
     }type;
 }ocrTraceObj_t;
 
+// Number of records each worker's trace ring holds (must be a power of 2)
+#ifndef TRACE_RING_CAPACITY
+#define TRACE_RING_CAPACITY 4096
+#endif
+
+/**
+ * @brief Per-worker ring of trace records
+ *
+ * Single producer (the owning worker), single consumer (the system worker).
+ * Records are written in place so tracing does not allocate. A worker
+ * never waits on the system worker: when the ring is full the record is
+ * dropped and counted in 'dropped'. The two indices are on separate cache
+ * lines so the producer and the consumer do not share a line.
+ */
+typedef struct _ocrTraceRing_t {
+    volatile u64 head;      /**< Next record to flush, only advanced by the system worker */
+    u8 headPad[56];
+    volatile u64 tail;      /**< Next free slot, only advanced by the owning worker */
+    volatile u64 dropped;   /**< Records lost because the ring was full */
+    u8 tailPad[48];
+    ocrTraceObj_t records[TRACE_RING_CAPACITY];
+} ocrTraceRing_t;
+
+struct _ocrPolicyDomain_t;
+
+/**
+ * @brief Allocates an empty trace ring out of the PD's memory
+ */
+ocrTraceRing_t * traceRingCreate(struct _ocrPolicyDomain_t *pd);
+
+/**
+ * @brief Frees a ring created by traceRingCreate
+ */
+void traceRingDestroy(struct _ocrPolicyDomain_t *pd, ocrTraceRing_t *ring);
+
 #endif /* ENABLE_WORKER_SYSTEM */
 void doTrace(u64 location, u64 wrkr, ocrGuid_t taskGuid, ...);
 
@@ -21,6 +21,10 @@
 #include "extensions/ocr-affinity.h"
 #include "extensions/ocr-hints.h"
 
+#ifdef ENABLE_SLAB_CACHE
+#include "utils/slab-cache.h"
+#endif
+
 #define DEBUG_TYPE WORKER
 
 // Phase numbering is ad-hoc. We just know the last phase of
@@ -233,12 +237,15 @@ static void workerLoopHcCommInternal(ocrWorker_t * worker, ocrPolicyDomain_t *pd
     // - Loop until pollMessage says there's no more outgoing
     //   messages to be processed by the underlying comm-platform.
     // In regular mode:
-    // - Try to take from the scheduler and send outgoing communication
-    // - Poll to receive an incoming communication
+    // - Take from the scheduler and send up to HC_COMM_WORKER_MSG_BATCH
+    //   outgoing communications
+    // - Poll to receive up to HC_COMM_WORKER_MSG_BATCH incoming communications
     u8 ret;
+    u32 sendCount = 0;
+    u32 recvCount = 0;
     do {
         ret = takeFromSchedulerAndSend(worker, pd);
-    } while (flushOutgoingComm && (ret == POLL_MORE_MESSAGE));
+    } while ((flushOutgoingComm || (++sendCount < HC_COMM_WORKER_MSG_BATCH)) && (ret == POLL_MORE_MESSAGE));
 
     do {
         ocrMsgHandle_t * handle = NULL;
@@ -336,12 +343,17 @@ static void workerLoopHcCommInternal(ocrWorker_t * worker, ocrPolicyDomain_t *pd
                 //then be 'wrapped' in an EDT and pushed to the deque for load-balancing purpose.
             }
         }
-    } while (flushOutgoingComm && !(ret & POLL_NO_OUTGOING_MESSAGE));
+    } while ((flushOutgoingComm && !(ret & POLL_NO_OUTGOING_MESSAGE)) ||
+             ((ret == POLL_MORE_MESSAGE) && (++recvCount < HC_COMM_WORKER_MSG_BATCH)));
 }
 
 static void workShiftHcComm(ocrWorker_t * worker) {
     ocrWorkerHcComm_t * rworker = (ocrWorkerHcComm_t *) worker;
     workerLoopHcCommInternal(worker, worker->pd, rworker->processRequestTemplate, rworker->flushOutgoingComm);
+#ifdef ENABLE_SLAB_CACHE
+    if (worker->slabCache != NULL)
+        slabCacheDrain(worker->slabCache);
+#endif
 }
 
 static void workerLoopHcComm(ocrWorker_t * worker) {
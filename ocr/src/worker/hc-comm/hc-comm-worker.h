@@ -15,6 +15,13 @@
 #include "utils/list.h"
 #include "ocr-worker.h"
 
+// Maximum number of outgoing messages sent and of incoming messages
+// received per work shift when not flushing. Values greater than one let
+// the comm-platform coalesce messages sent in bursts.
+#ifndef HC_COMM_WORKER_MSG_BATCH
+#define HC_COMM_WORKER_MSG_BATCH 32
+#endif
+
 typedef struct {
     ocrWorkerFactoryHc_t base;
     void (*baseInitialize) (struct _ocrWorkerFactory_t * factory,
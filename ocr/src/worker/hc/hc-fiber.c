@@ -0,0 +1,226 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#include "ocr-config.h"
+#ifdef ENABLE_WORKER_HC_FIBER
+
+#include "debug.h"
+#include "ocr-policy-domain.h"
+#include "ocr-task.h"
+#include "ocr-worker.h"
+#include "worker/hc/hc-worker.h"
+#include "worker/hc/hc-fiber.h"
+
+#include <sys/mman.h>
+
+#define DEBUG_TYPE WORKER
+
+#if !defined(__x86_64__)
+#error ENABLE_WORKER_HC_FIBER is only supported on x86-64
+#endif
+
+// Lowest page of each stack is left inaccessible to catch overflows
+#define HC_FIBER_GUARD_SIZE 4096
+
+// Default MXCSR (all exceptions masked) and x87 control word for new fibers
+#define HC_FIBER_INIT_CSR (0x1F80ULL | (0x037FULL << 32))
+
+/**
+ * @brief Switches from the context being executed to 'to'
+ *
+ * The callee-saved registers, MXCSR and the x87 control word are pushed
+ * on the current stack whose pointer is stored in 'from'. They are then
+ * popped from the stack of 'to'.
+ */
+void hcFiberSwitch(hcFiberCtx_t * from, hcFiberCtx_t * to) __attribute__((visibility("hidden")));
+void hcFiberTrampoline(void) __attribute__((visibility("hidden")));
+void hcFiberMain(hcFiber_t * fiber) __attribute__((visibility("hidden"), noreturn, used));
+
+__asm__ (
+    ".text\n"
+    ".p2align 4\n"
+    ".globl hcFiberSwitch\n"
+    ".hidden hcFiberSwitch\n"
+    ".type hcFiberSwitch, @function\n"
+    "hcFiberSwitch:\n"
+    "    pushq %rbp\n"
+    "    pushq %rbx\n"
+    "    pushq %r12\n"
+    "    pushq %r13\n"
+    "    pushq %r14\n"
+    "    pushq %r15\n"
+    "    subq $8, %rsp\n"
+    "    stmxcsr (%rsp)\n"
+    "    fnstcw 4(%rsp)\n"
+    "    movq %rsp, (%rdi)\n"
+    "    movq (%rsi), %rsp\n"
+    "    ldmxcsr (%rsp)\n"
+    "    fldcw 4(%rsp)\n"
+    "    addq $8, %rsp\n"
+    "    popq %r15\n"
+    "    popq %r14\n"
+    "    popq %r13\n"
+    "    popq %r12\n"
+    "    popq %rbx\n"
+    "    popq %rbp\n"
+    "    ret\n"
+    ".size hcFiberSwitch, .-hcFiberSwitch\n"
+    // First frame of a fiber: the fiber descriptor was stashed in %rbx
+    ".p2align 4\n"
+    ".globl hcFiberTrampoline\n"
+    ".hidden hcFiberTrampoline\n"
+    ".type hcFiberTrampoline, @function\n"
+    "hcFiberTrampoline:\n"
+    "    movq %rbx, %rdi\n"
+    "    call hcFiberMain\n"
+    "    ud2\n"
+    ".size hcFiberTrampoline, .-hcFiberTrampoline\n"
+);
+
+// Body of every fiber. A fiber runs one task per iteration and goes
+// back to the worker's scheduling context when the task returns, which
+// lets pooled fibers be reused without setting their stack up again.
+void hcFiberMain(hcFiber_t * fiber) {
+    while (true) {
+        ocrPolicyDomain_t * pd = NULL;
+        getCurrentEnv(&pd, NULL, NULL, NULL);
+        pd->taskFactories[fiber->factoryId]->fcts.execute(fiber->task);
+        fiber->task = NULL; // Signals completion to the scheduling context
+        ocrWorker_t * worker = NULL;
+        getCurrentEnv(NULL, &worker, NULL, NULL);
+        hcFiberSwitch(&(fiber->ctx), &(((ocrWorkerHc_t *) worker)->baseCtx));
+    }
+}
+
+static hcFiber_t * fiberAcquire(ocrWorkerHc_t * worker) {
+    hcFiber_t * fiber = worker->fiberPool;
+    if (fiber != NULL) {
+        worker->fiberPool = fiber->next;
+        worker->fiberPoolCount--;
+        return fiber;
+    }
+    u8 * stack = (u8 *) mmap(NULL, HC_FIBER_STACK_SIZE, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_STACK, -1, 0);
+    if (stack == (u8 *) MAP_FAILED) {
+        DPRINTF(DEBUG_LVL_WARN, "Unable to map a %"PRIu64" bytes fiber stack\n", (u64) HC_FIBER_STACK_SIZE);
+        ASSERT(false);
+        return NULL;
+    }
+    RESULT_ASSERT(mprotect(stack, HC_FIBER_GUARD_SIZE, PROT_NONE), ==, 0);
+    // The descriptor lives at the top of its own stack
+    fiber = (hcFiber_t *) ((((u64) stack) + HC_FIBER_STACK_SIZE - sizeof(hcFiber_t)) & ~15ULL);
+    fiber->stack = stack;
+    fiber->next = NULL;
+    fiber->task = NULL;
+    // Initial frame popped by hcFiberSwitch. The 16-byte aligned top makes
+    // the trampoline's call enter hcFiberMain with an ABI-conformant stack.
+    u64 * sp = (u64 *) fiber;
+    *(--sp) = (u64) &hcFiberTrampoline; // return address
+    *(--sp) = 0;                         // rbp
+    *(--sp) = (u64) fiber;               // rbx
+    *(--sp) = 0;                         // r12
+    *(--sp) = 0;                         // r13
+    *(--sp) = 0;                         // r14
+    *(--sp) = 0;                         // r15
+    *(--sp) = HC_FIBER_INIT_CSR;         // mxcsr, x87 control word
+    fiber->ctx.sp = sp;
+    return fiber;
+}
+
+static void fiberFree(hcFiber_t * fiber) {
+    RESULT_ASSERT(munmap(fiber->stack, HC_FIBER_STACK_SIZE), ==, 0);
+}
+
+static void fiberRelease(ocrWorkerHc_t * worker, hcFiber_t * fiber) {
+    if (worker->fiberPoolCount < HC_FIBER_POOL_MAX) {
+        fiber->next = worker->fiberPool;
+        worker->fiberPool = fiber;
+        worker->fiberPoolCount++;
+    } else {
+        fiberFree(fiber);
+    }
+}
+
+// Runs 'fiber' until its task completes or parks. Returns true on completion.
+static bool fiberEnter(ocrWorkerHc_t * worker, hcFiber_t * fiber) {
+    ASSERT(worker->curFiber == NULL);
+    worker->curFiber = fiber;
+    hcFiberSwitch(&(worker->baseCtx), &(fiber->ctx));
+    worker->curFiber = NULL;
+    if (fiber->task == NULL) {
+        fiberRelease(worker, fiber);
+        return true;
+    }
+    return false;
+}
+
+bool hcFiberRunTask(ocrWorkerHc_t * worker, ocrTask_t * task, u32 factoryId) {
+    hcFiber_t * fiber = fiberAcquire(worker);
+    fiber->task = task;
+    fiber->factoryId = factoryId;
+    return fiberEnter(worker, fiber);
+}
+
+ocrTask_t * hcFiberResumeParked(ocrWorkerHc_t * worker) {
+    hcFiber_t * fiber = worker->parkedHead;
+    if (fiber == NULL) {
+        return NULL;
+    }
+    worker->parkedHead = fiber->next;
+    if (worker->parkedHead == NULL) {
+        worker->parkedTail = NULL;
+    }
+    worker->parkedCount--;
+    if (!fiber->wakeable) {
+        worker->parkedPolling--;
+    }
+    ocrTask_t * task = fiber->task;
+    DPRINTF(DEBUG_LVL_VERB, "Worker resuming EDT GUID "GUIDF"\n", GUIDA(task->guid));
+    worker->worker.curTask = task;
+    bool done = fiberEnter(worker, fiber);
+    worker->worker.curTask = NULL;
+    return done ? task : NULL;
+}
+
+void hcFiberPark(ocrWorkerHc_t * worker, bool wakeable) {
+    hcFiber_t * fiber = worker->curFiber;
+    ASSERT(fiber != NULL);
+    DPRINTF(DEBUG_LVL_VERB, "Worker parking EDT GUID "GUIDF"\n", GUIDA(fiber->task->guid));
+    fiber->next = NULL;
+    fiber->wakeable = wakeable;
+    worker->parkedCount++;
+    if (!wakeable) {
+        worker->parkedPolling++;
+    }
+    if (worker->parkedTail == NULL) {
+        worker->parkedHead = fiber;
+    } else {
+        worker->parkedTail->next = fiber;
+    }
+    worker->parkedTail = fiber;
+    hcFiberSwitch(&(fiber->ctx), &(worker->baseCtx));
+}
+
+void hcFiberPoolDestruct(ocrWorkerHc_t * worker) {
+    while (worker->fiberPool != NULL) {
+        hcFiber_t * fiber = worker->fiberPool;
+        worker->fiberPool = fiber->next;
+        fiberFree(fiber);
+    }
+    worker->fiberPoolCount = 0;
+    // EDTs still blocked at this point will never complete
+    while (worker->parkedHead != NULL) {
+        hcFiber_t * fiber = worker->parkedHead;
+        DPRINTF(DEBUG_LVL_WARN, "EDT GUID "GUIDF" was still blocked at shutdown\n", GUIDA(fiber->task->guid));
+        worker->parkedHead = fiber->next;
+        fiberFree(fiber);
+    }
+    worker->parkedTail = NULL;
+    worker->parkedCount = 0;
+    worker->parkedPolling = 0;
+}
+
+#endif /* ENABLE_WORKER_HC_FIBER */
@@ -0,0 +1,92 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#ifndef __HC_FIBER_H__
+#define __HC_FIBER_H__
+
+#include "ocr-config.h"
+#ifdef ENABLE_WORKER_HC_FIBER
+
+#include "ocr-types.h"
+
+/**
+ * @brief User-level stacks for the HC worker's EDTs
+ *
+ * When enabled, an HC worker runs each EDT on a fiber taken from a
+ * per-worker pool instead of on its own thread's stack. An EDT that blocks
+ * in the runtime parks its fiber and the worker goes back to its scheduling
+ * loop; parked fibers are resumed by the worker that parked them (the
+ * comm-delegate inboxes are per-worker so a blocked EDT polls for its
+ * response there). The worker resumes all its parked fibers at the start
+ * of each shift. While an EDT waits for a response, the worker may park
+ * when idle since the response wakes it up. Any other blocked EDT keeps
+ * its worker from parking. The context switch is hand-written for x86-64.
+ */
+
+// Size of a fiber's stack (virtual, pages are committed on first touch)
+#ifndef HC_FIBER_STACK_SIZE
+#define HC_FIBER_STACK_SIZE (8*1024*1024)
+#endif
+
+// Number of idle fibers a worker keeps around for reuse
+#ifndef HC_FIBER_POOL_MAX
+#define HC_FIBER_POOL_MAX 16
+#endif
+
+struct _ocrWorkerHc_t;
+struct _ocrTask_t;
+
+/**
+ * @brief Saved execution context. Only the stack pointer is stored
+ * here, callee-saved registers are pushed on the stack being left.
+ */
+typedef struct _hcFiberCtx_t {
+    void * sp;
+} hcFiberCtx_t;
+
+typedef struct _hcFiber_t {
+    hcFiberCtx_t ctx;
+    struct _hcFiber_t * next;    /**< Next fiber in the pool or parked list */
+    struct _ocrTask_t * task;    /**< Task being run, NULL once it has completed */
+    u32 factoryId;               /**< Task factory to execute 'task' with */
+    bool wakeable;               /**< Parked on something that wakes the worker up */
+    u8 * stack;                  /**< Base of the mapping (guard page included) */
+} hcFiber_t;
+
+/**
+ * @brief Runs 'task' on a fiber of 'worker'
+ *
+ * Must be called from the worker's scheduling context.
+ * @return true if the task completed, false if it got parked
+ */
+bool hcFiberRunTask(struct _ocrWorkerHc_t * worker, struct _ocrTask_t * task, u32 factoryId);
+
+/**
+ * @brief Resumes the oldest fiber parked on 'worker', if any
+ *
+ * Must be called from the worker's scheduling context. A fiber parking
+ * again goes to the back of the list, so calling this 'parkedCount' times
+ * gives every parked fiber one chance to run.
+ * @return The task the fiber was running if it completed, NULL otherwise
+ */
+struct _ocrTask_t * hcFiberResumeParked(struct _ocrWorkerHc_t * worker);
+
+/**
+ * @brief Parks the calling fiber and switches back to the worker's
+ * scheduling context. Returns once the fiber has been resumed.
+ *
+ * @param wakeable  true if what the fiber waits for wakes the worker up
+ *                  (see hcSchedulerHeuristicWakeWorker) when it happens
+ */
+void hcFiberPark(struct _ocrWorkerHc_t * worker, bool wakeable);
+
+/**
+ * @brief Releases the fibers (pooled and parked) owned by 'worker'
+ */
+void hcFiberPoolDestruct(struct _ocrWorkerHc_t * worker);
+
+#endif /* ENABLE_WORKER_HC_FIBER */
+#endif /* __HC_FIBER_H__ */
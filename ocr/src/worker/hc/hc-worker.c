@@ -31,18 +31,68 @@
 #include "utils/profiler/profiler.h"
 #endif
 
+#ifdef ENABLE_WORKER_SYSTEM
+#include "utils/tracer/tracer.h"
+#endif
+
+#ifdef ENABLE_SLAB_CACHE
+#include "utils/slab-cache.h"
+#endif
+
 #define DEBUG_TYPE WORKER
 
 /******************************************************/
 /* OCR-HC WORKER                                      */
 /******************************************************/
 
+// Notifies the scheduler that the task is done executing (or must be rescheduled)
+static void hcWorkerNotifyDone(ocrPolicyDomain_t * pd, ocrFatGuid_t taskGuid) {
+    PD_MSG_STACK(msg);
+    PD_MSG_INIT_FROM_PD(pd, &msg);
+#define PD_MSG (&msg)
+#define PD_TYPE PD_MSG_SCHED_NOTIFY
+    msg.type = PD_MSG_SCHED_NOTIFY | PD_MSG_REQUEST;
+    PD_MSG_FIELD_IO(schedArgs).kind = OCR_SCHED_NOTIFY_EDT_DONE;
+    PD_MSG_FIELD_IO(schedArgs).OCR_SCHED_ARG_FIELD(OCR_SCHED_NOTIFY_EDT_DONE).guid.guid = taskGuid.guid;
+    PD_MSG_FIELD_IO(schedArgs).OCR_SCHED_ARG_FIELD(OCR_SCHED_NOTIFY_EDT_DONE).guid.metaDataPtr = taskGuid.metaDataPtr;
+    RESULT_ASSERT(pd->fcts.processMessage(pd, &msg, false), ==, 0);
+#undef PD_MSG
+#undef PD_TYPE
+}
+
+// Wraps up a task that returned from its user function
+static void hcWorkerTaskDone(ocrWorker_t * worker, ocrPolicyDomain_t * pd, ocrTask_t * task) {
+    ocrWorkerHc_t *hcWorker = (ocrWorkerHc_t *) worker;
+    //Store state at worker level to report most recent state on pause.
+    hcWorker->templateGuid = task->templateGuid;
+    hcWorker->edtGuid = task->guid;
+    hcWorker->fctPtr  = task->funcPtr;
+#ifdef OCR_ENABLE_EDT_NAMING
+    hcWorker->name = task->name;
+#endif
+    ocrFatGuid_t taskGuid = {.guid = task->guid, .metaDataPtr = task};
+    hcWorkerNotifyDone(pd, taskGuid);
+}
+
 static void hcWorkShift(ocrWorker_t * worker) {
     ocrPolicyDomain_t * pd;
     PD_MSG_STACK(msg);
     getCurrentEnv(&pd, NULL, NULL, &msg);
 
+#if defined(ENABLE_WORKER_HC_FIBER) || defined(ENABLE_EXTENSION_BLOCKING_SUPPORT)
     ocrWorkerHc_t *hcWorker = (ocrWorkerHc_t *) worker;
+#endif
+
+#ifdef ENABLE_WORKER_HC_FIBER
+    // Give every blocked EDT a chance to make progress before picking up new work
+    u32 resumeCount = hcWorker->parkedCount;
+    while (resumeCount-- != 0) {
+        ocrTask_t * resumedTask = hcFiberResumeParked(hcWorker);
+        if (resumedTask != NULL) {
+            hcWorkerTaskDone(worker, pd, resumedTask);
+        }
+    }
+#endif
 
 #define PD_MSG (&msg)
 #define PD_TYPE PD_MSG_SCHED_GET_WORK
@@ -54,39 +104,32 @@ static void hcWorkShift(ocrWorker_t * worker) {
         // We got a response
         ocrFatGuid_t taskGuid = PD_MSG_FIELD_IO(schedArgs).OCR_SCHED_ARG_FIELD(OCR_SCHED_WORK_EDT_USER).edt;
         if(!(ocrGuidIsNull(taskGuid.guid))){
-#ifdef ENABLE_EXTENSION_BLOCKING_SUPPORT
+            // Task sanity checks
+            ASSERT(taskGuid.metaDataPtr != NULL);
             ocrTask_t * curTask = (ocrTask_t*)taskGuid.metaDataPtr;
+#if defined(ENABLE_EXTENSION_BLOCKING_SUPPORT) && !defined(ENABLE_WORKER_HC_FIBER)
+            // With fibers a LONG EDT never runs on top of a blocked one
             if (((curTask->flags & OCR_TASK_FLAG_LONG) != 0) && (((ocrWorkerHc_t *) worker)->isHelping)) {
                 // Illegal to pick up a LONG EDT in that case to avoid creating a deadlock
                 curTask->state = RESCHED_EDTSTATE;
                 hcWorker->stealFirst = true;
+                hcWorkerNotifyDone(pd, taskGuid);
             } else {
 #endif
-                // Task sanity checks
-                ASSERT(taskGuid.metaDataPtr != NULL);
-                worker->curTask = (ocrTask_t*)taskGuid.metaDataPtr;
+                worker->curTask = curTask;
                 DPRINTF(DEBUG_LVL_VERB, "Worker shifting to execute EDT GUID "GUIDF"\n", GUIDA(taskGuid.guid));
                 u32 factoryId = PD_MSG_FIELD_O(factoryId);
-                pd->taskFactories[factoryId]->fcts.execute(worker->curTask);
-                //Store state at worker level to report most recent state on pause.
-                hcWorker->templateGuid = worker->curTask->templateGuid;
-                hcWorker->edtGuid = worker->curTask->guid;
-                hcWorker->fctPtr  = worker->curTask->funcPtr;
-#ifdef OCR_ENABLE_EDT_NAMING
-                hcWorker->name = worker->curTask->name;
+#ifdef ENABLE_WORKER_HC_FIBER
+                // If the task blocks, it is wrapped up once its fiber completes
+                if (hcFiberRunTask(hcWorker, curTask, factoryId))
+                    hcWorkerTaskDone(worker, pd, curTask);
+#else
+                pd->taskFactories[factoryId]->fcts.execute(curTask);
+                hcWorkerTaskDone(worker, pd, curTask);
 #endif
-#undef PD_TYPE
-#ifdef ENABLE_EXTENSION_BLOCKING_SUPPORT
+#if defined(ENABLE_EXTENSION_BLOCKING_SUPPORT) && !defined(ENABLE_WORKER_HC_FIBER)
             }
 #endif
-#define PD_TYPE PD_MSG_SCHED_NOTIFY
-            getCurrentEnv(NULL, NULL, NULL, &msg);
-            msg.type = PD_MSG_SCHED_NOTIFY | PD_MSG_REQUEST;
-            PD_MSG_FIELD_IO(schedArgs).kind = OCR_SCHED_NOTIFY_EDT_DONE;
-            PD_MSG_FIELD_IO(schedArgs).OCR_SCHED_ARG_FIELD(OCR_SCHED_NOTIFY_EDT_DONE).guid.guid = taskGuid.guid;
-            PD_MSG_FIELD_IO(schedArgs).OCR_SCHED_ARG_FIELD(OCR_SCHED_NOTIFY_EDT_DONE).guid.metaDataPtr = taskGuid.metaDataPtr;
-            RESULT_ASSERT(pd->fcts.processMessage(pd, &msg, false), ==, 0);
-
             // Important for this to be the last
             worker->curTask = NULL;
         }
@@ -95,6 +138,11 @@ static void hcWorkShift(ocrWorker_t * worker) {
     }
 #undef PD_MSG
 #undef PD_TYPE
+#ifdef ENABLE_SLAB_CACHE
+    // Take back what other workers freed, busy or idle alike
+    if (worker->slabCache != NULL)
+        slabCacheDrain(worker->slabCache);
+#endif
 #ifdef ENABLE_EXTENSION_PAUSE
     ocrPolicyDomainHc_t *self = (ocrPolicyDomainHc_t *)pd;
     if(self->pqrFlags.runtimePause == true) {
@@ -229,6 +277,9 @@ static void workerLoop(ocrWorker_t * worker) {
 }
 
 void destructWorkerHc(ocrWorker_t * base) {
+#ifdef ENABLE_WORKER_HC_FIBER
+    hcFiberPoolDestruct((ocrWorkerHc_t *) base);
+#endif
     runtimeChunkFree((u64)base, PERSISTENT_CHUNK);
 }
 
@@ -287,16 +338,25 @@ u8 hcWorkerSwitchRunlevel(ocrWorker_t *self, ocrPolicyDomain_t *PD, ocrRunlevel_
         break;
     case RL_MEMORY_OK:
         //Check that OCR has been configured to utilize system worker.
-        //worker[n-1] by convention. If so initialize deques
+        //worker[n-1] by convention. If so initialize trace rings
+#ifdef ENABLE_WORKER_SYSTEM
         if(PD->workers[(PD->workerCount)-1]->type == SYSTEM_WORKERTYPE){
             if(self->type == MASTER_WORKERTYPE || self->type == SLAVE_WORKERTYPE) {
-                if(((ocrWorkerHc_t *)self)->sysDeque == NULL){
-                    ((ocrWorkerHc_t*)self)->sysDeque = newDeque(self->pd, NULL, NON_CONCURRENT_DEQUE);
+                if((properties & RL_BRING_UP) && (((ocrWorkerHc_t *)self)->traceRing == NULL)){
+                    ((ocrWorkerHc_t*)self)->traceRing = traceRingCreate(self->pd);
                 }
             }
         }
+#endif
         break;
     case RL_GUID_OK:
+#ifdef ENABLE_WORKER_SYSTEM
+        // The system worker has flushed the ring when leaving RL_COMPUTE_OK
+        if((properties & RL_TEAR_DOWN) && (((ocrWorkerHc_t *)self)->traceRing != NULL)){
+            traceRingDestroy(self->pd, ((ocrWorkerHc_t *)self)->traceRing);
+            ((ocrWorkerHc_t*)self)->traceRing = NULL;
+        }
+#endif
         break;
     case RL_COMPUTE_OK:
         if((properties & RL_BRING_UP) && RL_IS_FIRST_PHASE_UP(PD, RL_COMPUTE_OK, phase)) {
@@ -480,10 +540,21 @@ void initializeWorkerHc(ocrWorkerFactory_t * factory, ocrWorker_t* self, ocrPara
         workerHc->hcType = HC_WORKER_COMP;
     }
     workerHc->legacySecondStart = false;
+    workerHc->traceRing = NULL;
 #ifdef ENABLE_EXTENSION_BLOCKING_SUPPORT
     workerHc->isHelping = 0;
     workerHc->stealFirst = 0;
 #endif
+#ifdef ENABLE_WORKER_HC_FIBER
+    workerHc->baseCtx.sp = NULL;
+    workerHc->curFiber = NULL;
+    workerHc->fiberPool = NULL;
+    workerHc->fiberPoolCount = 0;
+    workerHc->parkedHead = NULL;
+    workerHc->parkedTail = NULL;
+    workerHc->parkedCount = 0;
+    workerHc->parkedPolling = 0;
+#endif
 }
 
 /******************************************************/
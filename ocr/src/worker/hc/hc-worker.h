@@ -14,6 +14,7 @@
 #include "utils/ocr-utils.h"
 #include "ocr-worker.h"
 #include "utils/deque.h"
+#include "worker/hc/hc-fiber.h"
 
 typedef struct {
     ocrWorkerFactory_t base;
@@ -30,7 +31,7 @@ typedef enum {
     HC_WORKER_SYSTEM
 } hcWorkerType_t;
 
-typedef struct {
+typedef struct _ocrWorkerHc_t {
     ocrWorker_t worker;
     // The HC implementation relies on integer ids to
     // map workers, schedulers and workpiles together
@@ -45,11 +46,21 @@ typedef struct {
 #endif
     hcWorkerType_t hcType;
     u8 legacySecondStart;
-    deque_t *sysDeque;
+    struct _ocrTraceRing_t *traceRing; /**< Trace records for the system worker, if any */
 #ifdef ENABLE_EXTENSION_BLOCKING_SUPPORT
     u32 isHelping;
     bool stealFirst;
 #endif
+#ifdef ENABLE_WORKER_HC_FIBER
+    hcFiberCtx_t baseCtx;   /**< Scheduling context, on the thread's own stack */
+    hcFiber_t * curFiber;   /**< Fiber running curTask, NULL in the scheduling context */
+    hcFiber_t * fiberPool;  /**< Idle fibers kept for reuse */
+    u32 fiberPoolCount;
+    hcFiber_t * parkedHead; /**< Fibers of blocked EDTs, oldest first */
+    hcFiber_t * parkedTail;
+    u32 parkedCount;
+    u32 parkedPolling;      /**< Parked fibers nothing wakes the worker up for */
+#endif
 } ocrWorkerHc_t;
 
 ocrWorkerFactory_t* newOcrWorkerFactoryHc(ocrParamList_t *perType);
@@ -15,7 +15,6 @@
 #include "ocr-sysboot.h"
 #include "worker/hc/hc-worker.h"
 #include "worker/system/system-worker.h"
-#include "utils/deque.h"
 #include "utils/tracer/tracer.h"
 #include "utils/tracer/trace-events.h"
 
@@ -32,82 +31,83 @@
 #define IDX_OFFSET OCR_TRACE_TYPE_EDT
 
 //Utility functions
-bool allDequesEmpty(ocrPolicyDomain_t *pd){
-    u32 i;
-    for(i = 0; i < ((pd->workerCount)-1); i++){
-        s32 head = ((ocrWorkerHc_t *)pd->workers[i])->sysDeque->head;
-        s32 tail = ((ocrWorkerHc_t *)pd->workers[i])->sysDeque->tail;
-
-        if(tail-head > 0)
-            return false;
-    }
-    return true;
+static ocrTraceRing_t * traceRingOf(ocrPolicyDomain_t *pd, u32 i){
+    //WARNING:  Broken abstraction.  Currently only supported on x86 so system worker
+    //          looks directly into hc-worker. See bug #830
+    return ((ocrWorkerHc_t *)pd->workers[i])->traceRing;
 }
 
-//Do custom processing for trace objects if provided by DPRINTF.
 #ifdef OCR_TRACE_BINARY
-void processTraceObject(ocrTraceObj_t *trace, FILE *f){
-
-    fwrite(trace, sizeof(ocrTraceObj_t), 1, f);
-    return;
+//Write out all the records published in the ring so far, at most two
+//contiguous runs, and hand the slots back to the worker.
+static u64 flushTraceRing(ocrTraceRing_t *ring, FILE *f){
+    u64 head = ring->head;
+    u64 tail = hal_loadAcquire(&ring->tail);
+    u64 count = tail - head;
+    if(count == 0)
+        return 0;
+    u64 first = head & (TRACE_RING_CAPACITY - 1);
+    u64 run = (first + count > TRACE_RING_CAPACITY) ? (TRACE_RING_CAPACITY - first) : count;
+    fwrite(&(ring->records[first]), sizeof(ocrTraceObj_t), run, f);
+    if(run < count)
+        fwrite(&(ring->records[0]), sizeof(ocrTraceObj_t), count - run, f);
+    hal_storeRelease(&ring->head, tail);
+    return count;
 }
 #endif
 
-void drainAllDeques(FILE *f){
-    ocrPolicyDomain_t *pd;
-    getCurrentEnv(&pd, NULL, NULL, NULL);
+static u64 flushAllTraceRings(ocrPolicyDomain_t *pd, FILE *f){
+    u64 count = 0;
     u32 i;
-    //Iterate over each worker's deque
     for(i = 0; i < ((pd->workerCount)-1); i++){
-        deque_t *deq = ((ocrWorkerHc_t *)pd->workers[i])->sysDeque;
-        s32 head = deq->head;
-        s32 tail = deq->tail;
-        s32 remaining = tail-head;
-        u32 j;
-        for(j = 0; j < remaining; j++){
-            //Pop and process all remaining records
-            ocrTraceObj_t *tr = (ocrTraceObj_t *)(deq->popFromHead(deq,0));
-            ASSERT(tr != NULL);
-
+        ocrTraceRing_t *ring = traceRingOf(pd, i);
+        if(ring == NULL)
+            continue;
 #ifdef OCR_TRACE_BINARY
-            processTraceObject(tr, f);
+        count += flushTraceRing(ring, f);
+#else
+        //Nothing to write the records to, discard them
+        count += ring->tail - ring->head;
+        hal_storeRelease(&ring->head, hal_loadAcquire(&ring->tail));
 #endif
-            pd->fcts.pdFree(pd, tr);
+    }
+    return count;
+}
+
+static void reportTraceDrops(ocrPolicyDomain_t *pd){
+    u32 i;
+    for(i = 0; i < ((pd->workerCount)-1); i++){
+        ocrTraceRing_t *ring = traceRingOf(pd, i);
+        if((ring != NULL) && (ring->dropped != 0)){
+            //DPRINTFs are suppressed while tracing, report on the console directly
+            PRINTF("WARNING: PD 0x%"PRIx64" worker %"PRIu32" dropped %"PRIu64" trace records (ring of %"PRIu32" full)\n",
+                   (u64)pd->myLocation, i, ring->dropped, (u32)TRACE_RING_CAPACITY);
         }
     }
 }
 
-//workLoop for system worker: strictly responsible for querying/processing records in trace queues.
+//workLoop for system worker: strictly responsible for flushing records out of trace rings.
 void workerLoopSystem(ocrWorker_t *worker){
 
     ASSERT(worker->curState == GET_STATE(RL_USER_OK, (RL_GET_PHASE_COUNT_DOWN(worker->pd, RL_USER_OK))));
 
+    FILE *f = NULL;
 #ifdef OCR_TRACE_BINARY
-    //NP open file for binary writing
-    FILE *f = fopen("trace.bin", "a");
+    //NP open file for binary writing. Records are written in bulk through a
+    //large stdio buffer so the file system is only hit once per buffer.
+    char *fileBuffer = worker->pd->fcts.pdMalloc(worker->pd, TRACE_FLUSH_BUFFER_SIZE);
+    f = fopen("trace.bin", "a");
+    ASSERT(f != NULL);
+    setvbuf(f, fileBuffer, _IOFBF, TRACE_FLUSH_BUFFER_SIZE);
 #endif
 
     u8 continueLoop = true;
-    bool toDrain = false;
 
     do {
         while(worker->curState == worker->desiredState){
-            u32 i;
-            //Iterate over all comp. workers trace deques and pop records if they exist.
-            for(i = 0; i < ((worker->pd->workerCount)-1); i++){
-                //WARNING:  Broken abstraction.  Currently only supported on x86 so system worker
-                //          looks directly into hc-worker. See bug #830
-                deque_t *deq = ((ocrWorkerHc_t *)worker->pd->workers[i])->sysDeque;
-                s32 head = deq->head;
-                s32 tail = deq->tail;
-                if(tail-head > 0){
-                    //Trace record in deque. Pop
-                    ocrTraceObj_t *tr = (ocrTraceObj_t *)(deq->popFromHead(deq, 0));
-#ifdef OCR_TRACE_BINARY
-                    processTraceObject(tr, f);
-#endif
-                    worker->pd->fcts.pdFree(worker->pd, tr);
-                }
+            //Flush whatever comp. workers published since the last pass
+            if(flushAllTraceRings(worker->pd, f) == 0){
+                hal_pause();
             }
         }
 
@@ -129,10 +129,13 @@ void workerLoopSystem(ocrWorker_t *worker){
             if(RL_IS_FIRST_PHASE_DOWN(worker->pd, RL_COMPUTE_OK, phase)) {
                 worker->curState = worker->desiredState;
                 //We have succesfully shifted out of USER runlevel, and are breaking out of
-                //our workLoop... Check if deques still contain items.
-                if(!(allDequesEmpty(worker->pd))){
-                    toDrain = true;
-                }
+                //our workLoop... Comp. workers no longer trace, flush what is left.
+                flushAllTraceRings(worker->pd, f);
+                reportTraceDrops(worker->pd);
+#ifdef OCR_TRACE_BINARY
+                fclose(f);
+                worker->pd->fcts.pdFree(worker->pd, fileBuffer);
+#endif
 
                 if(worker->callback != NULL){
                     worker->callback(worker->pd, worker->callbackArg);
@@ -149,17 +152,6 @@ void workerLoopSystem(ocrWorker_t *worker){
             ASSERT(0);
         }
     } while(continueLoop);
-
-    if(toDrain){
-
-#ifdef OCR_TRACE_BINARY
-        drainAllDeques(f);
-        fclose(f);
-#endif
-
-    }
-
-
 }
 
 
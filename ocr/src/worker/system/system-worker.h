@@ -14,6 +14,12 @@
 #include "utils/ocr-utils.h"
 #include "ocr-worker.h"
 
+// Size in bytes of the buffer trace records are staged in before being
+// written to the trace file
+#ifndef TRACE_FLUSH_BUFFER_SIZE
+#define TRACE_FLUSH_BUFFER_SIZE (1024*1024)
+#endif
+
 
 typedef struct {
     ocrWorkerFactoryHc_t base;
@@ -73,5 +73,11 @@ void initializeWorkerOcr(ocrWorkerFactory_t * factory, ocrWorker_t * self, ocrPa
     self->callback = NULL;
     self->callbackArg = 0ULL;
     self->id = ((paramListWorkerInst_t *) perInstance)->workerId;
+#ifdef ENABLE_EDT_STATS
+    self->edtStats = NULL;
+#endif
+#ifdef ENABLE_SLAB_CACHE
+    self->slabCache = NULL;
+#endif
 }
 
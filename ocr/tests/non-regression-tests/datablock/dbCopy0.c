@@ -0,0 +1,65 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#include "ocr.h"
+
+/**
+ * DESC: ocrDbCopy a sub-range of a DB into another DB at an offset
+ */
+
+#define NB_ELEM 100
+#define SRC_OFFSET 10
+#define DST_OFFSET 30
+#define NB_COPY 50
+
+ocrGuid_t checkEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    // The completion event carries the destination DB
+    ASSERT(ocrGuidIsEq(depv[0].guid, (ocrGuid_t) depv[1].guid));
+    u64 * dst = (u64 *) depv[0].ptr;
+    u64 i = 0;
+    while (i < NB_ELEM) {
+        if ((i >= DST_OFFSET) && (i < (DST_OFFSET + NB_COPY))) {
+            ASSERT(dst[i] == (i - DST_OFFSET + SRC_OFFSET));
+        } else {
+            ASSERT(dst[i] == 0);
+        }
+        i++;
+    }
+    PRINTF("Everything went OK\n");
+    ocrShutdown();
+    return NULL_GUID;
+}
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t srcGuid, dstGuid;
+    u64 * src, * dst;
+    ocrDbCreate(&srcGuid, (void **) &src, sizeof(u64)*NB_ELEM, 0, NULL_HINT, NO_ALLOC);
+    ocrDbCreate(&dstGuid, (void **) &dst, sizeof(u64)*NB_ELEM, 0, NULL_HINT, NO_ALLOC);
+    u64 i = 0;
+    while (i < NB_ELEM) {
+        src[i] = i;
+        dst[i] = 0;
+        i++;
+    }
+    ocrDbRelease(srcGuid);
+    ocrDbRelease(dstGuid);
+
+    // Overlapping ranges of the same DB are rejected
+    ocrGuid_t copyEvt;
+    ASSERT(ocrDbCopy(srcGuid, 0, srcGuid, 8, 16, 0, &copyEvt) == OCR_EPERM);
+
+    ASSERT(ocrDbCopy(dstGuid, sizeof(u64)*DST_OFFSET, srcGuid, sizeof(u64)*SRC_OFFSET,
+                     sizeof(u64)*NB_COPY, 0, &copyEvt) == 0);
+
+    ocrGuid_t checkEdtGuid, checkEdtTemplateGuid;
+    ocrEdtTemplateCreate(&checkEdtTemplateGuid, checkEdt, 0, 2);
+    ocrEdtCreate(&checkEdtGuid, checkEdtTemplateGuid, 0, NULL, 2, NULL,
+                 EDT_PROP_NONE, NULL_HINT, NULL);
+    ocrAddDependence(copyEvt, checkEdtGuid, 0, DB_MODE_RO);
+    ocrAddDependence(dstGuid, checkEdtGuid, 1, DB_MODE_RO);
+    ocrEdtTemplateDestroy(checkEdtTemplateGuid);
+    return NULL_GUID;
+}
@@ -0,0 +1,56 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#include "ocr.h"
+
+/**
+ * DESC: ocrDbCopy of a large DB whose source is carried by an event
+ * satisfied after the copy is requested
+ */
+
+// Large enough to be split across workers, and not a multiple of anything
+#define NB_BYTES ((8 * 1024 * 1024) + 13)
+
+ocrGuid_t checkEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    u8 * dst = (u8 *) depv[0].ptr;
+    u64 i = 0;
+    while (i < NB_BYTES) {
+        ASSERT(dst[i] == (u8) (i * 7));
+        i++;
+    }
+    PRINTF("Everything went OK\n");
+    ocrShutdown();
+    return NULL_GUID;
+}
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t srcGuid, dstGuid;
+    u8 * src, * dst;
+    ocrDbCreate(&srcGuid, (void **) &src, NB_BYTES, 0, NULL_HINT, NO_ALLOC);
+    ocrDbCreate(&dstGuid, (void **) &dst, NB_BYTES, 0, NULL_HINT, NO_ALLOC);
+    u64 i = 0;
+    while (i < NB_BYTES) {
+        src[i] = (u8) (i * 7);
+        dst[i] = 0;
+        i++;
+    }
+    ocrDbRelease(srcGuid);
+    ocrDbRelease(dstGuid);
+
+    ocrGuid_t srcEvt, copyEvt;
+    ocrEventCreate(&srcEvt, OCR_EVENT_ONCE_T, EVT_PROP_TAKES_ARG);
+    ASSERT(ocrDbCopy(dstGuid, 0, srcEvt, 0, NB_BYTES, 0, &copyEvt) == 0);
+
+    ocrGuid_t checkEdtGuid, checkEdtTemplateGuid;
+    ocrEdtTemplateCreate(&checkEdtTemplateGuid, checkEdt, 0, 1);
+    ocrEdtCreate(&checkEdtGuid, checkEdtTemplateGuid, 0, NULL, 1, &copyEvt,
+                 EDT_PROP_NONE, NULL_HINT, NULL);
+    ocrEdtTemplateDestroy(checkEdtTemplateGuid);
+
+    // The copy can only start now
+    ocrEventSatisfy(srcEvt, srcGuid);
+    return NULL_GUID;
+}
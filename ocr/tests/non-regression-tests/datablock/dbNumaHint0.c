@@ -0,0 +1,58 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#include "ocr.h"
+
+/**
+ * DESC: Create datablocks with a NUMA node hint, for node 0 and for a
+ * node the PD has no memory on. Both are usable whichever allocator
+ * they end up in.
+ */
+
+#define NB_ELEM 1024
+#define NB_DBS 2
+
+ocrGuid_t checkEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    u32 i;
+    for (i = 0; i < NB_DBS; i++) {
+        u64 * dbPtr = (u64 *) depv[i].ptr;
+        u64 j = 0;
+        while (j < NB_ELEM) {
+            ASSERT(dbPtr[j] == (i * NB_ELEM + j));
+            j++;
+        }
+        ocrDbDestroy(depv[i].guid);
+    }
+    ocrShutdown();
+    return NULL_GUID;
+}
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    u64 nodes[NB_DBS] = {0, 63};
+    ocrGuid_t dbGuids[NB_DBS];
+    u32 i;
+    for (i = 0; i < NB_DBS; i++) {
+        ocrHint_t dbHint;
+        ocrHintInit(&dbHint, OCR_HINT_DB_T);
+        ocrSetHintValue(&dbHint, OCR_HINT_DB_NUMA_NODE, nodes[i]);
+        u64 * dbPtr;
+        ocrDbCreate(&dbGuids[i], (void **) &dbPtr, sizeof(u64) * NB_ELEM, DB_PROP_NONE, &dbHint, NO_ALLOC);
+        ASSERT(dbPtr != NULL);
+        u64 j = 0;
+        while (j < NB_ELEM) {
+            dbPtr[j] = i * NB_ELEM + j;
+            j++;
+        }
+        ocrDbRelease(dbGuids[i]);
+    }
+    ocrGuid_t edtGuid;
+    ocrGuid_t edtTplGuid;
+    ocrEdtTemplateCreate(&edtTplGuid, checkEdt, 0 /*paramc*/, NB_DBS /*depc*/);
+    ocrEdtCreate(&edtGuid, edtTplGuid, EDT_PARAM_DEF, NULL, NB_DBS, dbGuids,
+                 EDT_PROP_NONE, NULL_HINT, NULL);
+    ocrEdtTemplateDestroy(edtTplGuid);
+    return NULL_GUID;
+}
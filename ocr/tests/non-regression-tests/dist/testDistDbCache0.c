@@ -0,0 +1,127 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#include "ocr.h"
+#include "extensions/ocr-affinity.h"
+
+/**
+ * DESC: OCR-DIST - DB read several times in RO mode by remote EDTs between
+ *       updates done alternatively by a local and a remote EDT. The remote PD
+ *       may keep a copy of the DB between reads that must be given back
+ *       before each update and before the DB is destroyed.
+ */
+
+#define TYPE_ELEM_DB u64
+#define NB_ELEM_DB 64
+#define NB_ROUNDS 8
+#define NB_READS 4
+
+static ocrGuid_t pdAffinity(u64 round) {
+    u64 affinityCount;
+    ocrAffinityCount(AFFINITY_PD, &affinityCount);
+    ASSERT(affinityCount >= 1);
+    ocrGuid_t affinities[affinityCount];
+    ocrAffinityGet(AFFINITY_PD, &affinityCount, affinities);
+    return affinities[(round % 2) ? (affinityCount-1) : 0];
+}
+
+ocrGuid_t readerEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    u64 round = paramv[0];
+    TYPE_ELEM_DB * data = (TYPE_ELEM_DB *) depv[0].ptr;
+    u64 i = 0;
+    while (i < NB_ELEM_DB) {
+        ASSERT(data[i] == (i + round));
+        i++;
+    }
+    return NULL_GUID;
+}
+
+ocrGuid_t roundEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    u64 round = paramv[0];
+    ocrGuid_t dbGuid = depv[0].guid;
+    TYPE_ELEM_DB * data = (TYPE_ELEM_DB *) depv[0].ptr;
+    u64 i = 0;
+    while (i < NB_ELEM_DB) {
+        ASSERT(data[i] == (i + round));
+        i++;
+    }
+    if (round == NB_ROUNDS) {
+        ocrDbDestroy(dbGuid);
+        PRINTF("All rounds checked\n");
+        ocrShutdown();
+        return NULL_GUID;
+    }
+    i = 0;
+    while (i < NB_ELEM_DB) {
+        data[i] = i + round + 1;
+        i++;
+    }
+    ocrDbRelease(dbGuid);
+    round++;
+
+    // Chain of remote readers. Events are all linked before the DB is added
+    // so that no reader completes and destroys its output event too early.
+    ocrGuid_t readerEdtTemplateGuid;
+    ocrEdtTemplateCreate(&readerEdtTemplateGuid, readerEdt, 1, 2);
+    ocrHint_t edtHint;
+    ocrHintInit(&edtHint, OCR_HINT_EDT_T);
+    ocrSetHintValue(&edtHint, OCR_HINT_EDT_AFFINITY, ocrAffinityToHintValue(pdAffinity(1)));
+    ocrGuid_t readerEdtGuids[NB_READS];
+    ocrGuid_t prevEventGuid = NULL_GUID;
+    u32 r = 0;
+    while (r < NB_READS) {
+        ocrGuid_t outputEventGuid;
+        ocrEdtCreate(&readerEdtGuids[r], readerEdtTemplateGuid, 1, &round, 2, NULL,
+                     EDT_PROP_NONE, &edtHint, &outputEventGuid);
+        ocrAddDependence(prevEventGuid, readerEdtGuids[r], 1, DB_MODE_NULL);
+        prevEventGuid = outputEventGuid;
+        r++;
+    }
+    ocrEdtTemplateDestroy(readerEdtTemplateGuid);
+
+    // Next writer, alternatively local and remote
+    ocrGuid_t roundEdtTemplateGuid;
+    ocrEdtTemplateCreate(&roundEdtTemplateGuid, roundEdt, 1, 2);
+    ocrSetHintValue(&edtHint, OCR_HINT_EDT_AFFINITY, ocrAffinityToHintValue(pdAffinity(round)));
+    ocrGuid_t roundEdtGuid;
+    ocrEdtCreate(&roundEdtGuid, roundEdtTemplateGuid, 1, &round, 2, NULL,
+                 EDT_PROP_NONE, &edtHint, NULL);
+    ocrAddDependence(prevEventGuid, roundEdtGuid, 1, DB_MODE_NULL);
+    ocrEdtTemplateDestroy(roundEdtTemplateGuid);
+
+    r = 0;
+    while (r < NB_READS) {
+        ocrAddDependence(dbGuid, readerEdtGuids[r], 0, DB_MODE_RO);
+        r++;
+    }
+    ocrAddDependence(dbGuid, roundEdtGuid, 0, DB_MODE_RW);
+    return NULL_GUID;
+}
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    // Create the DB locally
+    void * dbPtr;
+    ocrGuid_t dbGuid;
+    ocrDbCreate(&dbGuid, &dbPtr, sizeof(TYPE_ELEM_DB) * NB_ELEM_DB, 0, NULL_HINT, NO_ALLOC);
+    TYPE_ELEM_DB * data = (TYPE_ELEM_DB *) dbPtr;
+    u64 i = 0;
+    while (i < NB_ELEM_DB) {
+        data[i] = i;
+        i++;
+    }
+    ocrDbRelease(dbGuid);
+
+    ocrGuid_t roundEdtTemplateGuid;
+    ocrEdtTemplateCreate(&roundEdtTemplateGuid, roundEdt, 1, 2);
+    u64 round = 0;
+    ocrGuid_t roundEdtGuid;
+    ocrEdtCreate(&roundEdtGuid, roundEdtTemplateGuid, 1, &round, 2, NULL,
+                 EDT_PROP_NONE, NULL_HINT, NULL);
+    ocrAddDependence(NULL_GUID, roundEdtGuid, 1, DB_MODE_NULL);
+    ocrAddDependence(dbGuid, roundEdtGuid, 0, DB_MODE_RW);
+    ocrEdtTemplateDestroy(roundEdtTemplateGuid);
+    return NULL_GUID;
+}
@@ -0,0 +1,66 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+#include "ocr.h"
+#include "extensions/ocr-affinity.h"
+
+/**
+ * DESC: OCR-DIST - ocrDbCopy from a local DB into a remote DB
+ */
+
+#define NB_ELEM_DB ((512 * 1024) + 3)
+
+ocrGuid_t checkEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    u64 * data = (u64 *) depv[0].ptr;
+    u64 i = 0;
+    while (i < NB_ELEM_DB) {
+        ASSERT(data[i] == (i + 1));
+        i++;
+    }
+    PRINTF("[remote] checkEdt: DB copy checked\n");
+    ocrShutdown();
+    return NULL_GUID;
+}
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    u64 affinityCount;
+    ocrAffinityCount(AFFINITY_PD, &affinityCount);
+    ASSERT(affinityCount >= 1);
+    ocrGuid_t affinities[affinityCount];
+    ocrAffinityGet(AFFINITY_PD, &affinityCount, affinities);
+    ocrGuid_t affinity = affinities[affinityCount-1];
+
+    // Source DB is local, destination DB is @ affinity
+    ocrGuid_t srcGuid, dstGuid;
+    u64 * src, * dst;
+    ocrDbCreate(&srcGuid, (void **) &src, sizeof(u64) * NB_ELEM_DB, 0, NULL_HINT, NO_ALLOC);
+    ocrHint_t dbHint;
+    ocrHintInit(&dbHint, OCR_HINT_DB_T);
+    ocrSetHintValue(&dbHint, OCR_HINT_DB_AFFINITY, ocrAffinityToHintValue(affinity));
+    ocrDbCreate(&dstGuid, (void **) &dst, sizeof(u64) * NB_ELEM_DB, 0, &dbHint, NO_ALLOC);
+    u64 i = 0;
+    while (i < NB_ELEM_DB) {
+        src[i] = i + 1;
+        dst[i] = 0;
+        i++;
+    }
+    ocrDbRelease(srcGuid);
+    ocrDbRelease(dstGuid);
+
+    ocrGuid_t copyEvt;
+    ASSERT(ocrDbCopy(dstGuid, 0, srcGuid, 0, sizeof(u64) * NB_ELEM_DB, 0, &copyEvt) == 0);
+
+    // Check the copy where the destination lives
+    ocrGuid_t checkEdtTemplateGuid;
+    ocrEdtTemplateCreate(&checkEdtTemplateGuid, checkEdt, 0, 1);
+    ocrHint_t edtHint;
+    ocrHintInit(&edtHint, OCR_HINT_EDT_T);
+    ocrSetHintValue(&edtHint, OCR_HINT_EDT_AFFINITY, ocrAffinityToHintValue(affinity));
+    ocrGuid_t checkEdtGuid;
+    ocrEdtCreate(&checkEdtGuid, checkEdtTemplateGuid, 0, NULL, 1, &copyEvt,
+                 EDT_PROP_NONE, &edtHint, NULL);
+    ocrEdtTemplateDestroy(checkEdtTemplateGuid);
+    return NULL_GUID;
+}
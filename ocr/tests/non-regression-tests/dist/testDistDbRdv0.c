@@ -0,0 +1,82 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#include "ocr.h"
+#include "extensions/ocr-affinity.h"
+
+/**
+ * DESC: OCR-DIST - Large DB acquired in RW mode by a remote EDT, then checked locally
+ *       (payload and write-back large enough to go through a rendezvous)
+ */
+
+#define TYPE_ELEM_DB u64
+#define NB_ELEM_DB (1024*1024)
+
+ocrGuid_t checkEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    TYPE_ELEM_DB * data = (TYPE_ELEM_DB *) depv[1].ptr;
+    u64 i = 0;
+    while (i < NB_ELEM_DB) {
+        ASSERT(data[i] == ((i * 2) + 1));
+        i++;
+    }
+    PRINTF("Write-back checked\n");
+    ocrShutdown();
+    return NULL_GUID;
+}
+
+ocrGuid_t remoteEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    TYPE_ELEM_DB * data = (TYPE_ELEM_DB *) depv[0].ptr;
+    u64 i = 0;
+    while (i < NB_ELEM_DB) {
+        ASSERT(data[i] == i);
+        data[i] = (i * 2) + 1;
+        i++;
+    }
+    PRINTF("Remote copy checked\n");
+    return NULL_GUID;
+}
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    u64 affinityCount;
+    ocrAffinityCount(AFFINITY_PD, &affinityCount);
+    ASSERT(affinityCount >= 1);
+    ocrGuid_t affinities[affinityCount];
+    ocrAffinityGet(AFFINITY_PD, &affinityCount, affinities);
+    ocrGuid_t affinity = affinities[affinityCount-1];
+
+    // Create the DB locally
+    void * dbPtr;
+    ocrGuid_t dbGuid;
+    ocrDbCreate(&dbGuid, &dbPtr, sizeof(TYPE_ELEM_DB) * NB_ELEM_DB, 0, NULL_HINT, NO_ALLOC);
+    TYPE_ELEM_DB * data = (TYPE_ELEM_DB *) dbPtr;
+    u64 i = 0;
+    while (i < NB_ELEM_DB) {
+        data[i] = i;
+        i++;
+    }
+    ocrDbRelease(dbGuid);
+
+    ocrGuid_t checkEdtTemplateGuid;
+    ocrEdtTemplateCreate(&checkEdtTemplateGuid, checkEdt, 0, 2);
+    ocrGuid_t checkEdtGuid;
+    ocrEdtCreate(&checkEdtGuid, checkEdtTemplateGuid, 0, NULL, 2, NULL,
+                 EDT_PROP_NONE, NULL_HINT, NULL);
+
+    // Remote writer @ affinity
+    ocrGuid_t remoteEdtTemplateGuid;
+    ocrEdtTemplateCreate(&remoteEdtTemplateGuid, remoteEdt, 0, 1);
+    ocrHint_t edtHint;
+    ocrHintInit( &edtHint, OCR_HINT_EDT_T );
+    ocrSetHintValue( & edtHint, OCR_HINT_EDT_AFFINITY, ocrAffinityToHintValue( affinity) );
+    ocrGuid_t outputEventGuid;
+    ocrGuid_t remoteEdtGuid;
+    ocrEdtCreate(&remoteEdtGuid, remoteEdtTemplateGuid, 0, NULL, 1, NULL,
+                 EDT_PROP_NONE, &edtHint, &outputEventGuid);
+    ocrAddDependence(outputEventGuid, checkEdtGuid, 0, DB_MODE_NULL);
+    ocrAddDependence(dbGuid, checkEdtGuid, 1, DB_MODE_RO);
+    ocrAddDependence(dbGuid, remoteEdtGuid, 0, DB_MODE_RW);
+    return NULL_GUID;
+}
@@ -0,0 +1,102 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#include "ocr.h"
+#include "extensions/ocr-affinity.h"
+
+/**
+ * DESC: OCR-DIST - DB repeatedly acquired in RO mode by remote EDTs and
+ *       updated in between by local EDTs. Each remote reader must see the
+ *       last update even though its PD may keep the proxy across releases.
+ */
+
+#define TYPE_ELEM_DB u64
+#define NB_ELEM_DB 64
+#define NB_ROUNDS 16
+
+static ocrGuid_t remoteAffinity() {
+    u64 affinityCount;
+    ocrAffinityCount(AFFINITY_PD, &affinityCount);
+    ASSERT(affinityCount >= 1);
+    ocrGuid_t affinities[affinityCount];
+    ocrAffinityGet(AFFINITY_PD, &affinityCount, affinities);
+    return affinities[affinityCount-1];
+}
+
+ocrGuid_t remoteEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    u64 round = paramv[0];
+    TYPE_ELEM_DB * data = (TYPE_ELEM_DB *) depv[0].ptr;
+    u64 i = 0;
+    while (i < NB_ELEM_DB) {
+        ASSERT(data[i] == (i + round));
+        i++;
+    }
+    return NULL_GUID;
+}
+
+ocrGuid_t roundEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    u64 round = paramv[0];
+    ocrGuid_t dbGuid = depv[0].guid;
+    TYPE_ELEM_DB * data = (TYPE_ELEM_DB *) depv[0].ptr;
+    if (round == NB_ROUNDS) {
+        PRINTF("All rounds checked\n");
+        ocrShutdown();
+        return NULL_GUID;
+    }
+    u64 i = 0;
+    while (i < NB_ELEM_DB) {
+        data[i] = i + round + 1;
+        i++;
+    }
+    ocrDbRelease(dbGuid);
+    round++;
+
+    // Remote reader @ affinity
+    ocrGuid_t remoteEdtTemplateGuid;
+    ocrEdtTemplateCreate(&remoteEdtTemplateGuid, remoteEdt, 1, 1);
+    ocrHint_t edtHint;
+    ocrHintInit(&edtHint, OCR_HINT_EDT_T);
+    ocrSetHintValue(&edtHint, OCR_HINT_EDT_AFFINITY, ocrAffinityToHintValue(remoteAffinity()));
+    ocrGuid_t outputEventGuid;
+    ocrGuid_t remoteEdtGuid;
+    ocrEdtCreate(&remoteEdtGuid, remoteEdtTemplateGuid, 1, &round, 1, NULL,
+                 EDT_PROP_NONE, &edtHint, &outputEventGuid);
+
+    // Next local writer
+    ocrGuid_t roundEdtTemplateGuid;
+    ocrEdtTemplateCreate(&roundEdtTemplateGuid, roundEdt, 1, 2);
+    ocrGuid_t roundEdtGuid;
+    ocrEdtCreate(&roundEdtGuid, roundEdtTemplateGuid, 1, &round, 2, NULL,
+                 EDT_PROP_NONE, NULL_HINT, NULL);
+    ocrAddDependence(outputEventGuid, roundEdtGuid, 1, DB_MODE_NULL);
+    ocrAddDependence(dbGuid, roundEdtGuid, 0, DB_MODE_RW);
+    ocrAddDependence(dbGuid, remoteEdtGuid, 0, DB_MODE_RO);
+    return NULL_GUID;
+}
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    // Create the DB locally
+    void * dbPtr;
+    ocrGuid_t dbGuid;
+    ocrDbCreate(&dbGuid, &dbPtr, sizeof(TYPE_ELEM_DB) * NB_ELEM_DB, 0, NULL_HINT, NO_ALLOC);
+    TYPE_ELEM_DB * data = (TYPE_ELEM_DB *) dbPtr;
+    u64 i = 0;
+    while (i < NB_ELEM_DB) {
+        data[i] = i;
+        i++;
+    }
+    ocrDbRelease(dbGuid);
+
+    ocrGuid_t roundEdtTemplateGuid;
+    ocrEdtTemplateCreate(&roundEdtTemplateGuid, roundEdt, 1, 2);
+    u64 round = 0;
+    ocrGuid_t roundEdtGuid;
+    ocrEdtCreate(&roundEdtGuid, roundEdtTemplateGuid, 1, &round, 2, NULL,
+                 EDT_PROP_NONE, NULL_HINT, NULL);
+    ocrAddDependence(NULL_GUID, roundEdtGuid, 1, DB_MODE_NULL);
+    ocrAddDependence(dbGuid, roundEdtGuid, 0, DB_MODE_RW);
+    return NULL_GUID;
+}
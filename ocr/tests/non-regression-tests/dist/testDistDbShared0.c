@@ -0,0 +1,123 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#include "ocr.h"
+#include "extensions/ocr-affinity.h"
+
+/**
+ * DESC: OCR-DIST - Write a DB from a remote PD, check and rewrite it locally, read it back remotely
+ *
+ * With the x86-shm comm-platform the remote EDTs access the owner's DB in
+ * place (shared pointer) instead of a copy, so both PDs must see each
+ * other's writes once the DB has been released.
+ */
+
+#define TYPE_ELEM_DB int
+#define NB_ELEM_DB 2000
+
+static void checkDb(TYPE_ELEM_DB * data, TYPE_ELEM_DB offset) {
+    u32 i = 0;
+    while (i < NB_ELEM_DB) {
+        ASSERT(data[i] == (TYPE_ELEM_DB) (i + offset));
+        i++;
+    }
+}
+
+static void writeDb(TYPE_ELEM_DB * data, TYPE_ELEM_DB offset) {
+    u32 i = 0;
+    while (i < NB_ELEM_DB) {
+        data[i] = (TYPE_ELEM_DB) (i + offset);
+        i++;
+    }
+}
+
+ocrGuid_t remoteReadEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    checkDb((TYPE_ELEM_DB *) depv[0].ptr, 2);
+    PRINTF("[remote] remoteReadEdt: DB checked\n");
+    ocrShutdown();
+    return NULL_GUID;
+}
+
+ocrGuid_t localEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t dbGuid = depv[0].guid;
+    TYPE_ELEM_DB * data = (TYPE_ELEM_DB *) depv[0].ptr;
+    checkDb(data, 1);
+    PRINTF("[local] localEdt: remote writes checked\n");
+    writeDb(data, 2);
+    ocrDbRelease(dbGuid);
+
+    // Read the DB back from the remote PD
+    u64 affinityCount;
+    ocrAffinityCount(AFFINITY_PD, &affinityCount);
+    ocrGuid_t affinities[affinityCount];
+    ocrAffinityGet(AFFINITY_PD, &affinityCount, affinities);
+    ocrGuid_t remoteAffinity = affinities[affinityCount-1];
+    ocrGuid_t remoteReadEdtTemplateGuid;
+    ocrEdtTemplateCreate(&remoteReadEdtTemplateGuid, remoteReadEdt, 0, 1);
+    ocrHint_t edtHint;
+    ocrHintInit( &edtHint, OCR_HINT_EDT_T );
+    ocrSetHintValue( & edtHint, OCR_HINT_EDT_AFFINITY, ocrAffinityToHintValue( remoteAffinity) );
+    ocrGuid_t remoteReadEdtGuid;
+    ocrEdtCreate(&remoteReadEdtGuid, remoteReadEdtTemplateGuid, 0, NULL, 1, NULL,
+                 EDT_PROP_NONE, &edtHint, NULL);
+    ocrAddDependence(dbGuid, remoteReadEdtGuid, 0, DB_MODE_RO);
+    ocrEdtTemplateDestroy(remoteReadEdtTemplateGuid);
+    return NULL_GUID;
+}
+
+ocrGuid_t remoteWriteEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    TYPE_ELEM_DB * data = (TYPE_ELEM_DB *) depv[0].ptr;
+    checkDb(data, 0);
+    writeDb(data, 1);
+    PRINTF("[remote] remoteWriteEdt: DB written\n");
+    return NULL_GUID;
+}
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    u64 affinityCount;
+    ocrAffinityCount(AFFINITY_PD, &affinityCount);
+    ASSERT(affinityCount >= 1);
+    ocrGuid_t affinities[affinityCount];
+    ocrAffinityGet(AFFINITY_PD, &affinityCount, affinities);
+    ocrGuid_t remoteAffinity = affinities[affinityCount-1];
+    ocrGuid_t localAffinity;
+    ocrAffinityGetCurrent(&localAffinity);
+
+    // Create the DB locally
+    void * dbPtr;
+    ocrGuid_t dbGuid;
+    ocrDbCreate(&dbGuid, &dbPtr, sizeof(TYPE_ELEM_DB) * NB_ELEM_DB, 0, NULL_HINT, NO_ALLOC);
+    writeDb((TYPE_ELEM_DB *) dbPtr, 0);
+    ocrDbRelease(dbGuid);
+
+    ocrHint_t edtHint;
+    ocrHintInit( &edtHint, OCR_HINT_EDT_T );
+
+    // Remote writer
+    ocrGuid_t remoteWriteEdtTemplateGuid;
+    ocrEdtTemplateCreate(&remoteWriteEdtTemplateGuid, remoteWriteEdt, 0, 1);
+    ocrSetHintValue( & edtHint, OCR_HINT_EDT_AFFINITY, ocrAffinityToHintValue( remoteAffinity) );
+    ocrGuid_t remoteWriteEdtGuid;
+    ocrGuid_t remoteWriteOutputGuid;
+    ocrEdtCreate(&remoteWriteEdtGuid, remoteWriteEdtTemplateGuid, 0, NULL, 1, NULL,
+                 EDT_PROP_NONE, &edtHint, &remoteWriteOutputGuid);
+
+    // Local checker, runs once the remote writer is done
+    ocrGuid_t localEdtTemplateGuid;
+    ocrEdtTemplateCreate(&localEdtTemplateGuid, localEdt, 0, 2);
+    ocrSetHintValue( & edtHint, OCR_HINT_EDT_AFFINITY, ocrAffinityToHintValue( localAffinity) );
+    ocrGuid_t localEdtGuid;
+    ocrEdtCreate(&localEdtGuid, localEdtTemplateGuid, 0, NULL, 2, NULL,
+                 EDT_PROP_NONE, &edtHint, NULL);
+    ocrAddDependence(dbGuid, localEdtGuid, 0, DB_MODE_RW);
+    ocrAddDependence(remoteWriteOutputGuid, localEdtGuid, 1, DB_DEFAULT_MODE);
+
+    ocrAddDependence(dbGuid, remoteWriteEdtGuid, 0, DB_MODE_RW);
+
+    ocrEdtTemplateDestroy(remoteWriteEdtTemplateGuid);
+    ocrEdtTemplateDestroy(localEdtTemplateGuid);
+    return NULL_GUID;
+}
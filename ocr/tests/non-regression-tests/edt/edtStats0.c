@@ -0,0 +1,145 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#include "ocr.h"
+
+// Only tested when OCR legacy interface is available: the statistics are
+// dumped when the runtime tears down, so they are checked once
+// ocrLegacyFinalize has returned.
+#ifdef ENABLE_EXTENSION_LEGACY
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+#include "extensions/ocr-legacy.h"
+
+/**
+ * DESC: OCR_EDT_STATS dump reports count, acquired bytes and min/max times
+ *
+ * The workers all acquire the same DB in EW mode while the root EDT still
+ * holds it, so most acquires are granted asynchronously by the DB once the
+ * previous user releases it. Every one of them must still be accounted for
+ * in the EDT's dbBytes.
+ */
+
+#define N 16
+#define DB_SIZE (sizeof(u64) * 128)
+// The single x86 policy domain is at location 0
+#define STATS_FILE "edtStats.0.csv"
+
+ocrGuid_t terminateEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    u64 * counter = (u64 *) depv[1].ptr;
+    ASSERT(counter[0] == N);
+    ocrShutdown();
+    return NULL_GUID;
+}
+
+ocrGuid_t workerEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    u64 * counter = (u64 *) depv[0].ptr;
+    counter[0]++;
+    return NULL_GUID;
+}
+
+ocrGuid_t rootEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t dbGuid = depv[0].guid;
+    ocrGuid_t workerEdtTemplateGuid;
+    ocrEdtTemplateCreate(&workerEdtTemplateGuid, workerEdt, 0 /*paramc*/, 1 /*depc*/);
+    u32 i;
+    for (i = 0; i < N; ++i) {
+        ocrGuid_t workerEdtGuid;
+        ocrEdtCreate(&workerEdtGuid, workerEdtTemplateGuid, EDT_PARAM_DEF, NULL, EDT_PARAM_DEF, NULL,
+                     EDT_PROP_NONE, NULL_HINT, NULL);
+        ocrAddDependence(dbGuid, workerEdtGuid, 0, DB_MODE_EW);
+    }
+    ocrEdtTemplateDestroy(workerEdtTemplateGuid);
+    return NULL_GUID;
+}
+
+static int checkStats() {
+    FILE * f = fopen(STATS_FILE, "r");
+    if (f == NULL) {
+        printf("Cannot open %s\n", STATS_FILE);
+        return 1;
+    }
+    char line[1024];
+    int found = 0;
+    // Skip the header
+    char * ret = fgets(line, sizeof(line), f);
+    while ((ret != NULL) && (fgets(line, sizeof(line), f) != NULL)) {
+        void * funcPtr;
+        uint64_t count, totalNs, minNs, maxNs, readyNs, dbBytes;
+        if (sscanf(line, "%p,%"SCNu64",%"SCNu64",%"SCNu64",%"SCNu64",%"SCNu64",%"SCNu64,
+                   &funcPtr, &count, &totalNs, &minNs, &maxNs, &readyNs, &dbBytes) != 7) {
+            printf("Malformed line: %s", line);
+            fclose(f);
+            return 1;
+        }
+        if (funcPtr != (void *) workerEdt) {
+            continue;
+        }
+        found = 1;
+        printf("workerEdt: count=%"PRIu64" dbBytes=%"PRIu64" minNs=%"PRIu64" maxNs=%"PRIu64"\n",
+               count, dbBytes, minNs, maxNs);
+        if ((count != N) || (dbBytes != (N * DB_SIZE)) || (minNs > maxNs) || (totalNs < maxNs)) {
+            fclose(f);
+            return 1;
+        }
+    }
+    fclose(f);
+    remove(STATS_FILE);
+    if (!found) {
+        printf("No statistics for workerEdt in %s\n", STATS_FILE);
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, const char * argv[]) {
+    setenv("OCR_EDT_STATS", "csv", 1);
+    remove(STATS_FILE);
+
+    ocrConfig_t ocrConfig;
+    ocrGuid_t legacyCtx;
+    ocrParseArgs(argc, argv, &ocrConfig);
+    ocrLegacyInit(&legacyCtx, &ocrConfig);
+
+    void * dbPtr;
+    ocrGuid_t dbGuid;
+    ocrDbCreate(&dbGuid, &dbPtr, DB_SIZE, 0, NULL_HINT, NO_ALLOC);
+    ((u64 *) dbPtr)[0] = 0;
+
+    // The root EDT is a finish EDT so its output event fires once all
+    // the workers are done
+    ocrGuid_t rootEdtTemplateGuid;
+    ocrEdtTemplateCreate(&rootEdtTemplateGuid, rootEdt, 0 /*paramc*/, 1 /*depc*/);
+    ocrGuid_t rootEdtGuid;
+    ocrGuid_t rootOutputGuid;
+    ocrEdtCreate(&rootEdtGuid, rootEdtTemplateGuid, EDT_PARAM_DEF, NULL, EDT_PARAM_DEF, NULL,
+                 EDT_PROP_FINISH, NULL_HINT, &rootOutputGuid);
+
+    ocrGuid_t terminateEdtTemplateGuid;
+    ocrEdtTemplateCreate(&terminateEdtTemplateGuid, terminateEdt, 0 /*paramc*/, 2 /*depc*/);
+    ocrGuid_t terminateEdtGuid;
+    ocrEdtCreate(&terminateEdtGuid, terminateEdtTemplateGuid, EDT_PARAM_DEF, NULL, EDT_PARAM_DEF, NULL,
+                 EDT_PROP_NONE, NULL_HINT, NULL);
+    ocrAddDependence(rootOutputGuid, terminateEdtGuid, 0, DB_DEFAULT_MODE);
+    ocrAddDependence(dbGuid, terminateEdtGuid, 1, DB_MODE_RO);
+    ocrDbRelease(dbGuid);
+    ocrAddDependence(dbGuid, rootEdtGuid, 0, DB_MODE_EW);
+
+    ocrLegacyFinalize(legacyCtx, true);
+    return checkStats();
+}
+
+#else
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrShutdown();
+    return NULL_GUID;
+}
+
+#endif
@@ -0,0 +1,66 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#include "ocr.h"
+
+/**
+ * DESC: Sticky and once events with thousands of waiters, satisfied after
+ * registration. Every waiter must see the payload and run exactly once.
+ */
+
+#define NB_WAITERS 5000
+
+ocrGuid_t waiterEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t latchGuid = {.guid = paramv[0]};
+    u64 * res = (u64 *) depv[0].ptr;
+    ASSERT(*res == 42);
+    ocrEventSatisfySlot(latchGuid, NULL_GUID, OCR_EVENT_LATCH_DECR_SLOT);
+    return NULL_GUID;
+}
+
+ocrGuid_t shutdownEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    PRINTF("Everything went OK\n");
+    ocrShutdown();
+    return NULL_GUID;
+}
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t stickyGuid, onceGuid, latchGuid;
+    ocrEventCreate(&stickyGuid, OCR_EVENT_STICKY_T, EVT_PROP_TAKES_ARG);
+    ocrEventCreate(&onceGuid, OCR_EVENT_ONCE_T, EVT_PROP_TAKES_ARG);
+    ocrEventCreate(&latchGuid, OCR_EVENT_LATCH_T, EVT_PROP_NONE);
+
+    ocrGuid_t shutdownTpl, shutdownGuid;
+    ocrEdtTemplateCreate(&shutdownTpl, shutdownEdt, 0, 1);
+    ocrEdtCreate(&shutdownGuid, shutdownTpl, EDT_PARAM_DEF, NULL, EDT_PARAM_DEF, &latchGuid,
+                 EDT_PROP_NONE, NULL_HINT, NULL);
+    ocrEventSatisfySlot(latchGuid, NULL_GUID, OCR_EVENT_LATCH_INCR_SLOT);
+
+    // Alternate waiters between the sticky and the once event
+    ocrGuid_t waiterTpl;
+    ocrEdtTemplateCreate(&waiterTpl, waiterEdt, 1, 1);
+    u64 nparamv[1] = {(u64) latchGuid.guid};
+    u32 i;
+    for (i = 0; i < NB_WAITERS; i++) {
+        ocrEventSatisfySlot(latchGuid, NULL_GUID, OCR_EVENT_LATCH_INCR_SLOT);
+        ocrGuid_t waiterGuid;
+        ocrGuid_t dep = (i & 1) ? onceGuid : stickyGuid;
+        ocrEdtCreate(&waiterGuid, waiterTpl, EDT_PARAM_DEF, nparamv, EDT_PARAM_DEF, &dep,
+                     EDT_PROP_NONE, NULL_HINT, NULL);
+    }
+    ocrEdtTemplateDestroy(waiterTpl);
+    ocrEdtTemplateDestroy(shutdownTpl);
+
+    u64 * k;
+    ocrGuid_t dbGuid;
+    ocrDbCreate(&dbGuid, (void **) &k, sizeof(u64), DB_PROP_NONE, NULL_HINT, NO_ALLOC);
+    *k = 42;
+    ocrDbRelease(dbGuid);
+    ocrEventSatisfy(stickyGuid, dbGuid);
+    ocrEventSatisfy(onceGuid, dbGuid);
+    ocrEventSatisfySlot(latchGuid, NULL_GUID, OCR_EVENT_LATCH_DECR_SLOT);
+    return NULL_GUID;
+}
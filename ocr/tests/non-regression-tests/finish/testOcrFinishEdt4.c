@@ -0,0 +1,106 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+
+
+#include "ocr.h"
+
+// More waiters than an event stores inline and than a single satisfy
+// batch handles, so that the satisfy is split across several EDTs
+#define N 1000
+
+/**
+ * DESC: Finish-edt whose child satisfies a sticky event with N waiters. All the waiters must have run before the finish-edt's output event is satisfied.
+ */
+
+// This edt is triggered when the output event of the finish edt is satisfied by the runtime
+ocrGuid_t terminateEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t evtGuid = {.guid = paramv[0]};
+    u64 * array = (u64*)depv[1].ptr;
+    u64 i = 0;
+    while (i < N) {
+        ASSERT(array[i] == i);
+        i++;
+    }
+    PRINTF("Everything went OK\n");
+    ocrEventDestroy(evtGuid);
+    ocrDbDestroy(depv[1].guid);
+    ocrShutdown(); // This is the last EDT to execute, terminate
+    return NULL_GUID;
+}
+
+ocrGuid_t waiterEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    u64 id = paramv[0];
+    u64 * array = (u64*)depv[1].ptr;
+    array[id] = id;
+    return NULL_GUID;
+}
+
+ocrGuid_t satisfyEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t evtGuid = {.guid = paramv[0]};
+    ocrEventSatisfy(evtGuid, NULL_GUID);
+    return NULL_GUID;
+}
+
+ocrGuid_t computeEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t evtGuid = {.guid = paramv[0]};
+    ocrGuid_t dbGuid = {.guid = paramv[1]};
+    ocrGuid_t waiterEdtTemplateGuid;
+    ocrEdtTemplateCreate(&waiterEdtTemplateGuid, waiterEdt, 1 /*paramc*/, 2 /*depc*/);
+    u64 i = 0;
+    while (i < N) {
+        ocrGuid_t waiterEdtGuid;
+        u64 nparamv = i;
+        ocrEdtCreate(&waiterEdtGuid, waiterEdtTemplateGuid, EDT_PARAM_DEF, &nparamv, EDT_PARAM_DEF, NULL, 0, NULL_HINT, NULL);
+        ocrAddDependence(dbGuid, waiterEdtGuid, 1, DB_MODE_RW);
+        ocrAddDependence(evtGuid, waiterEdtGuid, 0, DB_MODE_CONST);
+        i++;
+    }
+    ocrEdtTemplateDestroy(waiterEdtTemplateGuid);
+
+    ocrGuid_t satisfyEdtGuid;
+    ocrGuid_t satisfyEdtTemplateGuid;
+    ocrEdtTemplateCreate(&satisfyEdtTemplateGuid, satisfyEdt, 1 /*paramc*/, 0 /*depc*/);
+    ocrEdtCreate(&satisfyEdtGuid, satisfyEdtTemplateGuid, EDT_PARAM_DEF, paramv, EDT_PARAM_DEF, NULL, 0, NULL_HINT, NULL);
+    ocrEdtTemplateDestroy(satisfyEdtTemplateGuid);
+    return NULL_GUID;
+}
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t evtGuid;
+    ocrEventCreate(&evtGuid, OCR_EVENT_STICKY_T, EVT_PROP_NONE);
+    ocrGuid_t dbGuid;
+    u64 * array;
+    ocrDbCreate(&dbGuid, (void **)&array, sizeof(u64) * N, 0, NULL_HINT, NO_ALLOC);
+    u64 i = 0;
+    while (i < N) {
+        array[i] = N;
+        i++;
+    }
+    ocrDbRelease(dbGuid);
+
+    u64 nparamv[2];
+    nparamv[0] = (u64) evtGuid.guid;
+    nparamv[1] = (u64) dbGuid.guid;
+    ocrGuid_t finishEdtOutputEventGuid;
+    ocrGuid_t computeEdtGuid;
+    ocrGuid_t computeEdtTemplateGuid;
+    ocrEdtTemplateCreate(&computeEdtTemplateGuid, computeEdt, 2 /*paramc*/, 1 /*depc*/);
+    ocrEdtCreate(&computeEdtGuid, computeEdtTemplateGuid, EDT_PARAM_DEF, nparamv, EDT_PARAM_DEF, /*depv=*/NULL,
+                 /*properties=*/ EDT_PROP_FINISH, NULL_HINT, /*outEvent=*/&finishEdtOutputEventGuid);
+
+    ocrGuid_t terminateEdtGuid;
+    ocrGuid_t terminateEdtTemplateGuid;
+    ocrEdtTemplateCreate(&terminateEdtTemplateGuid, terminateEdt, 1 /*paramc*/, 2 /*depc*/);
+    ocrEdtCreate(&terminateEdtGuid, terminateEdtTemplateGuid, EDT_PARAM_DEF, nparamv, EDT_PARAM_DEF, /*depv=*/NULL,
+                 /*properties=*/0, NULL_HINT, /*outEvent=*/NULL);
+    ocrAddDependence(finishEdtOutputEventGuid, terminateEdtGuid, 0, DB_MODE_CONST);
+    ocrAddDependence(dbGuid, terminateEdtGuid, 1, DB_MODE_RO);
+    // Triggers the finish EDT
+    ocrAddDependence(NULL_GUID, computeEdtGuid, 0, DB_MODE_CONST);
+
+    return NULL_GUID;
+}
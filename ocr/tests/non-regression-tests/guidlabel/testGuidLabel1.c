@@ -14,7 +14,9 @@
  */
 
 ocrGuid_t mapFunc(ocrGuid_t startGuid, u64 stride, s64* params, s64* tuple) {
-    return (ocrGuid_t)(tuple[0]*stride + startGuid);
+    ocrGuid_t res;
+    res.guid = tuple[0]*stride + startGuid.guid;
+    return res;
 }
 
 ocrGuid_t shutEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
@@ -16,14 +16,16 @@
 #define NB_EDT 100
 
 ocrGuid_t mapFunc(ocrGuid_t startGuid, u64 stride, s64* params, s64* tuple) {
-    return (ocrGuid_t)(tuple[0]*stride + startGuid);
+    ocrGuid_t res;
+    res.guid = tuple[0]*stride + startGuid.guid;
+    return res;
 }
 
 ocrGuid_t shutEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
     ocrGuid_t db = NULL_GUID;
     int i = 0;
     while (i < NB_EDT) {
-        if (depv[i].guid != NULL_GUID) {
+        if (!ocrGuidIsNull(depv[i].guid)) {
             ASSERT(ocrGuidIsNull(db));
             db = depv[i].guid;
         }
@@ -34,7 +36,7 @@ ocrGuid_t shutEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
 }
 
 ocrGuid_t createEvtEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
-    ocrGuid_t mapGuid = (ocrGuid_t) paramv[0];
+    ocrGuid_t mapGuid = {.guid=paramv[0]};
     s64 val = 0;
     ocrGuid_t evtGuid;
     ocrGuidFromLabel(&evtGuid, mapGuid, &val);
@@ -65,7 +67,7 @@ ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
 
     ocrGuid_t crtEvtTmplGuid;
     ocrEdtTemplateCreate(&crtEvtTmplGuid, createEvtEdt, 1, 1);
-    u64 nparamv = (u64) mapGuid;
+    u64 nparamv = (u64) mapGuid.guid;
     u32 i = 0;
     while (i < NB_EDT) {
         ocrGuid_t outputEvtGuid;
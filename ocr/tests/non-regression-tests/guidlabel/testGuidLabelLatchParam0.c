@@ -16,7 +16,9 @@
 #define NB_EDT 10
 
 ocrGuid_t mapFunc(ocrGuid_t startGuid, u64 stride, s64* params, s64* tuple) {
-    return (ocrGuid_t)(tuple[0]*stride + startGuid);
+    ocrGuid_t res;
+    res.guid = tuple[0]*stride + startGuid.guid;
+    return res;
 }
 
 ocrGuid_t shutEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
@@ -25,8 +27,8 @@ ocrGuid_t shutEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
 }
 
 ocrGuid_t createEvtEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
-    ocrGuid_t mapGuid = (ocrGuid_t) paramv[0];
-    ocrGuid_t shutGuid = (ocrGuid_t) paramv[1];
+    ocrGuid_t mapGuid = {.guid=paramv[0]};
+    ocrGuid_t shutGuid = {.guid=paramv[1]};
     s64 val = 0;
     ocrGuid_t evtGuid;
     ocrGuidFromLabel(&evtGuid, mapGuid, &val);
@@ -51,16 +53,16 @@ ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
     ocrGuid_t templGuid;
     ocrEdtTemplateCreate(&templGuid, shutEdt, 0, 1);
     ocrGuid_t shutGuid;
-    ocrEdtCreate(&shutGuid, templGuid, 0, NULL, 1, NULL, EDT_PROP_NONE, NULL_GUID, NULL);
+    ocrEdtCreate(&shutGuid, templGuid, 0, NULL, 1, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
 
     ocrGuid_t crtEvtTmplGuid;
     ocrEdtTemplateCreate(&crtEvtTmplGuid, createEvtEdt, 2, 0);
     u64 nparamv[2];
-    nparamv[0] = (u64) mapGuid;
-    nparamv[1] = (u64) shutGuid;
+    nparamv[0] = (u64) mapGuid.guid;
+    nparamv[1] = (u64) shutGuid.guid;
     u32 i = 0;
     while (i < NB_EDT) {
-        ocrEdtCreate(NULL, crtEvtTmplGuid, 2, nparamv, 0, NULL, EDT_PROP_NONE, NULL_GUID, NULL);
+        ocrEdtCreate(NULL, crtEvtTmplGuid, 2, nparamv, 0, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
         i++;
     }
     return NULL_GUID;
@@ -0,0 +1,96 @@
+/*
+ * This file is subject to the license agreement located in the file LICENSE
+ * and cannot be distributed without it. This notice cannot be
+ * removed or modified.
+ */
+
+#include "ocr.h"
+
+// Only tested when OCR library interface is available
+#ifdef ENABLE_EXTENSION_LEGACY
+
+#include "extensions/ocr-legacy.h"
+
+/**
+ * DESC: Legacy code blocks on an idempotent event satisfied at the end of
+ *       a long chain of EDTs, then blocks again on the satisfied event
+ */
+
+#define MARK 999
+#define NB_LINKS 1000
+
+// paramv[0]: remaining links, paramv[1]: idempotent event to satisfy at the end
+ocrGuid_t linkEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t idemEvtGuid = {.guid = paramv[1]};
+    if (paramv[0] == 0) {
+        u64 * array;
+        ocrGuid_t dbGuid;
+        ocrDbCreate(&dbGuid,(void **) &array, sizeof(u64), 0, NULL_HINT, NO_ALLOC);
+        array[0] = MARK;
+        ocrDbRelease(dbGuid);
+        ocrEventSatisfy(idemEvtGuid, dbGuid);
+        return NULL_GUID;
+    }
+    ocrGuid_t template, edtGuid;
+    ocrEdtTemplateCreate(&template, linkEdt, 2, 0);
+    u64 nparamv[2] = {paramv[0] - 1, paramv[1]};
+    ocrEdtCreate(&edtGuid, template, EDT_PARAM_DEF, nparamv, EDT_PARAM_DEF, NULL,
+                 EDT_PROP_NONE, NULL_HINT, NULL);
+    ocrEdtTemplateDestroy(template);
+    return NULL_GUID;
+}
+
+void ocrBlock(ocrConfig_t cfg) {
+    ocrGuid_t legacyCtx;
+    ocrGuid_t template, handle, idemEvtGuid;
+
+    ocrGuid_t ctrlDep;
+    ocrGuid_t outputGuid;
+    void *result;
+    u64 size;
+
+    ocrLegacyInit(&legacyCtx, &cfg);
+    ocrEventCreate(&idemEvtGuid, OCR_EVENT_IDEM_T, EVT_PROP_TAKES_ARG);
+    ocrEdtTemplateCreate(&template, linkEdt, 2, 1);
+
+    ctrlDep = NULL_GUID;
+    u64 paramv[2] = {NB_LINKS, (u64) idemEvtGuid.guid};
+    ocrLegacySpawnOCR(&handle, template, 2, paramv, 1, &ctrlDep, legacyCtx);
+
+    // Most likely blocks before the end of the chain
+    ocrLegacyBlockProgress(idemEvtGuid, &outputGuid, &result, &size, LEGACY_PROP_NONE);
+    ASSERT(!(ocrGuidIsNull(outputGuid)));
+    ASSERT(result != NULL);
+    ASSERT(((u64 *) result)[0] == MARK);
+    ASSERT(size == sizeof(u64));
+
+    // The event is satisfied already, this returns right away
+    ocrGuid_t outputGuid2;
+    ocrLegacyBlockProgress(idemEvtGuid, &outputGuid2, NULL, NULL, LEGACY_PROP_NONE);
+    ASSERT(ocrGuidIsEq(outputGuid, outputGuid2));
+
+    ocrLegacyBlockProgress(handle, NULL, NULL, NULL, LEGACY_PROP_NONE);
+    ocrEventDestroy(handle);
+    ocrEventDestroy(idemEvtGuid);
+    ocrEdtTemplateDestroy(template);
+    ocrShutdown();
+    ocrLegacyFinalize(legacyCtx, true);
+}
+
+int main(int argc, const char *argv[]) {
+    ocrConfig_t ocrConfig;
+    ocrParseArgs(argc, argv, &ocrConfig);
+    PRINTF("Legacy code...\n");
+    ocrBlock(ocrConfig);
+    PRINTF("Back to legacy code, done.\n");
+    return 0;
+}
+
+#else
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrShutdown();
+    return NULL_GUID;
+}
+
+#endif
@@ -16,6 +16,10 @@ long elapsed_usec(struct timeval * start, struct timeval * stop);
 
 double avg_usec(long * array, int length);
 
+/* Fine-grained timer for per-operation latencies */
+
+unsigned long long get_time_nsec();
+
 
 /* Conversion functions */
 
@@ -29,4 +33,6 @@ void summary_throughput_timer(timestamp_t * start_t, timestamp_t * stop_t, unsig
 
 void summary_throughput_dbl(double secs, unsigned long long instances);
 
+void print_latency_percentiles(char * timer_name, unsigned long long * samples_nsec, unsigned long long nb_samples);
+
 #endif
@@ -0,0 +1,67 @@
+#include "perfs.h"
+#include "ocr.h"
+
+// DESC: Chain of 'NB_ITERS' ocrDbCopy ping-ponging 'DB_SZ' bytes between
+//       two DBs. Each copy takes the completion event of the previous one
+//       as its source so that all copies are issued upfront.
+// TIME: Issuing of the first copy to completion of the last one
+// FREQ: Done 'NB_ITERS' times
+//
+// VARIABLES:
+// - NB_ITERS
+// - DB_SZ
+
+ocrGuid_t terminateEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    timestamp_t * timers = (timestamp_t *) depv[1].ptr;
+    get_time(&timers[1]);
+    summary_throughput_timer(&timers[0], &timers[1], NB_ITERS);
+    ocrShutdown(); // This is the last EDT to execute, terminate
+    return NULL_GUID;
+}
+
+ocrGuid_t headEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    timestamp_t * timers = (timestamp_t *) depv[0].ptr;
+    ocrGuid_t terminateEdtGuid = {.guid = paramv[0]};
+    ocrGuid_t dbGuids[2];
+    u8 * dbPtr;
+    ocrDbCreate(&dbGuids[0], (void **)&dbPtr, DB_SZ, 0, NULL_HINT, NO_ALLOC);
+    ocrDbRelease(dbGuids[0]);
+    ocrDbCreate(&dbGuids[1], (void **)&dbPtr, DB_SZ, 0, NULL_HINT, NO_ALLOC);
+    ocrDbRelease(dbGuids[1]);
+
+    get_time(&timers[0]);
+    ocrGuid_t source = dbGuids[0];
+    u64 i;
+    for (i = 0; i < NB_ITERS; i++) {
+        ocrGuid_t copyEvt;
+        ocrDbCopy(dbGuids[(i + 1) & 1], 0, source, 0, DB_SZ, 0, &copyEvt);
+        source = copyEvt;
+    }
+    ocrAddDependence(source, terminateEdtGuid, 0, DB_MODE_RO);
+    return NULL_GUID;
+}
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t terminateEdtTemplateGuid;
+    ocrEdtTemplateCreate(&terminateEdtTemplateGuid, terminateEdt, 0, 2);
+    ocrGuid_t terminateEdtGuid;
+    ocrEdtCreate(&terminateEdtGuid, terminateEdtTemplateGuid,
+                 0, NULL, 2, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+
+    timestamp_t * dbPtr;
+    ocrGuid_t dbGuid;
+    ocrDbCreate(&dbGuid, (void **)&dbPtr, (sizeof(timestamp_t)*2), 0, NULL_HINT, NO_ALLOC);
+    ocrDbRelease(dbGuid);
+
+    ocrGuid_t headEdtTemplateGuid;
+    ocrEdtTemplateCreate(&headEdtTemplateGuid, headEdt, 1, 1);
+    ocrGuid_t headEdtGuid;
+    u64 paramv2[1];
+    paramv2[0] = (u64) terminateEdtGuid.guid;
+    ocrEdtCreate(&headEdtGuid, headEdtTemplateGuid,
+                 1, paramv2, 1, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+    ocrAddDependence(dbGuid, headEdtGuid, 0, DB_MODE_RW);
+
+    ocrAddDependence(dbGuid, terminateEdtGuid, 1, DB_MODE_RW);
+    return NULL_GUID;
+}
@@ -0,0 +1,103 @@
+#define ENABLE_EXTENSION_LEGACY
+#include "perfs.h"
+#include "ocr.h"
+#include "extensions/ocr-legacy.h"
+
+// DESC: A chain of 'NB_ITERS' EDTs where EDT i satisfies the event EDT i-1
+//       blocks on and then blocks in ocrWait until EDT i+1 satisfies its own
+//       event. Every EDT but the last is suspended while the next ones run,
+//       which exercises how the worker handles blocked EDTs (fibers or
+//       helper mode). Requires a platform with blocking support (x86-mpi).
+// TIME: Creation of the chain to completion of all EDTs
+// FREQ: 'NB_ITERS' blocking EDTs executed once
+//
+// VARIABLES:
+// - NB_ITERS
+
+ocrGuid_t terminateEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    timestamp_t * timers = (timestamp_t *) depv[1].ptr;
+    get_time(&timers[1]);
+    summary_throughput_timer(&timers[0], &timers[1], NB_ITERS);
+    ocrShutdown(); // This is the last EDT to execute, terminate
+    return NULL_GUID;
+}
+
+// paramv: latch, event to satisfy (or NULL), event to wait on (or NULL)
+ocrGuid_t chainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t latchGuid = {.guid = paramv[0]};
+    ocrGuid_t prevGuid = {.guid = paramv[1]};
+    ocrGuid_t waitGuid = {.guid = paramv[2]};
+    if (!ocrGuidIsNull(prevGuid)) {
+        ocrEventSatisfy(prevGuid, NULL_GUID);
+    }
+    if (!ocrGuidIsNull(waitGuid)) {
+        ocrWait(waitGuid);
+        ocrEventDestroy(waitGuid);
+    }
+    ocrEventSatisfySlot(latchGuid, NULL_GUID, OCR_EVENT_LATCH_DECR_SLOT);
+    return NULL_GUID;
+}
+
+ocrGuid_t headEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t latchGuid = {.guid = paramv[0]};
+    timestamp_t * dbPtr = depv[0].ptr;
+
+    ocrGuid_t * evts;
+    ocrGuid_t evtsDbGuid;
+    ocrDbCreate(&evtsDbGuid, (void **)&evts, sizeof(ocrGuid_t) * NB_ITERS, 0, NULL_HINT, NO_ALLOC);
+    u64 i;
+    for (i = 0; i < NB_ITERS; i++) {
+        ocrEventCreate(&evts[i], OCR_EVENT_STICKY_T, EVT_PROP_NONE);
+        ocrEventSatisfySlot(latchGuid, NULL_GUID, OCR_EVENT_LATCH_INCR_SLOT);
+    }
+    ocrGuid_t chainEdtTemplateGuid;
+    ocrEdtTemplateCreate(&chainEdtTemplateGuid, chainEdt, 3, 0);
+    get_time(&dbPtr[0]);
+    // Created backward so that LIFO work-piles start at the head of the chain
+    for (i = NB_ITERS; i > 0; i--) {
+        u64 nparamv[3];
+        nparamv[0] = paramv[0];
+        nparamv[1] = (i > 1) ? (u64) evts[i-2].guid : (u64) NULL_GUID.guid;
+        nparamv[2] = (i < NB_ITERS) ? (u64) evts[i-1].guid : (u64) NULL_GUID.guid;
+        ocrGuid_t chainEdtGuid;
+        ocrEdtCreate(&chainEdtGuid, chainEdtTemplateGuid,
+                     3, nparamv, 0, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+    }
+    // The last EDT never blocks so its event is left unused
+    ocrEventDestroy(evts[NB_ITERS-1]);
+    ocrDbDestroy(evtsDbGuid);
+    ocrEdtTemplateDestroy(chainEdtTemplateGuid);
+    // Release the count taken at creation
+    ocrEventSatisfySlot(latchGuid, NULL_GUID, OCR_EVENT_LATCH_DECR_SLOT);
+    return NULL_GUID;
+}
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t latchGuid;
+    ocrEventCreate(&latchGuid, OCR_EVENT_LATCH_T, EVT_PROP_NONE);
+    ocrEventSatisfySlot(latchGuid, NULL_GUID, OCR_EVENT_LATCH_INCR_SLOT);
+
+    ocrGuid_t terminateEdtTemplateGuid;
+    ocrEdtTemplateCreate(&terminateEdtTemplateGuid, terminateEdt, 0, 2);
+    ocrGuid_t terminateEdtGuid;
+    ocrEdtCreate(&terminateEdtGuid, terminateEdtTemplateGuid,
+                 0, NULL, 2, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+    ocrEdtTemplateDestroy(terminateEdtTemplateGuid);
+
+    timestamp_t * dbPtr;
+    ocrGuid_t dbGuid;
+    ocrDbCreate(&dbGuid, (void **)&dbPtr, (sizeof(timestamp_t)*2), 0, NULL_HINT, NO_ALLOC);
+    ocrDbRelease(dbGuid);
+
+    ocrAddDependence(latchGuid, terminateEdtGuid, 0, DB_MODE_CONST);
+    ocrAddDependence(dbGuid, terminateEdtGuid, 1, DB_MODE_RW);
+
+    ocrGuid_t headEdtTemplateGuid;
+    ocrEdtTemplateCreate(&headEdtTemplateGuid, headEdt, 1, 1);
+    u64 nparamv[1] = {(u64) latchGuid.guid};
+    ocrGuid_t headEdtGuid;
+    ocrEdtCreate(&headEdtGuid, headEdtTemplateGuid,
+                 1, nparamv, 1, &dbGuid, EDT_PROP_NONE, NULL_HINT, NULL);
+    ocrEdtTemplateDestroy(headEdtTemplateGuid);
+    return NULL_GUID;
+}
@@ -0,0 +1,98 @@
+#include "perfs.h"
+#include "ocr.h"
+
+// DESC: 'NB_CREATORS' EDTs each create their share of the tasks in
+//       parallel. Each task depends on a once event its creator
+//       satisfies right away. Tasks are mostly executed, and their
+//       metadata freed, by other workers than the one that created them.
+//       Sink EDT depends on all tasks through the output-event of a
+//       finish EDT.
+// TIME: Creation and execution of all tasks
+// FREQ: Create 'NB_INSTANCES' EDTs once
+//
+// VARIABLES:
+// - NB_INSTANCES
+// - NB_CREATORS
+
+#ifndef NB_CREATORS
+#define NB_CREATORS 8
+#endif
+
+ocrGuid_t terminateEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    timestamp_t * timers = (timestamp_t *) depv[1].ptr;
+    get_time(&timers[1]);
+    summary_throughput_timer(&timers[0], &timers[1], NB_INSTANCES);
+    ocrShutdown(); // This is the last EDT to execute, terminate
+    return NULL_GUID;
+}
+
+ocrGuid_t workEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    return NULL_GUID;
+}
+
+// paramv[0]: number of tasks to create
+ocrGuid_t creatorEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t workEdtTemplateGuid;
+    ocrEdtTemplateCreate(&workEdtTemplateGuid, workEdt, 0, 1);
+
+    u64 i = 0;
+    while (i < paramv[0]) {
+        ocrGuid_t evtGuid;
+        ocrEventCreate(&evtGuid, OCR_EVENT_ONCE_T, EVT_PROP_NONE);
+        ocrGuid_t workEdtGuid;
+        ocrEdtCreate(&workEdtGuid, workEdtTemplateGuid,
+                     0, NULL, 1, &evtGuid, EDT_PROP_NONE, NULL_HINT, NULL);
+        ocrEventSatisfy(evtGuid, NULL_GUID);
+        i++;
+    }
+    ocrEdtTemplateDestroy(workEdtTemplateGuid);
+    return NULL_GUID;
+}
+
+ocrGuid_t finishEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    timestamp_t * dbPtr = (timestamp_t *) depv[0].ptr;
+    get_time(&dbPtr[0]);
+
+    ocrGuid_t creatorEdtTemplateGuid;
+    ocrEdtTemplateCreate(&creatorEdtTemplateGuid, creatorEdt, 1, 0);
+
+    u64 i = 0;
+    while (i < NB_CREATORS) {
+        // The first creators take the remainder
+        u64 nbTasks = (NB_INSTANCES / NB_CREATORS) + ((i < (NB_INSTANCES % NB_CREATORS)) ? 1 : 0);
+        ocrGuid_t creatorEdtGuid;
+        ocrEdtCreate(&creatorEdtGuid, creatorEdtTemplateGuid,
+                     1, &nbTasks, 0, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+        i++;
+    }
+    ocrEdtTemplateDestroy(creatorEdtTemplateGuid);
+    return NULL_GUID;
+}
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+
+    ocrGuid_t terminateEdtTemplateGuid;
+    ocrEdtTemplateCreate(&terminateEdtTemplateGuid, terminateEdt, 0, 2);
+
+    ocrGuid_t terminateEdtGuid;
+    ocrEdtCreate(&terminateEdtGuid, terminateEdtTemplateGuid,
+                 0, NULL, 2, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+
+    timestamp_t * dbPtr;
+    ocrGuid_t dbGuid;
+    ocrDbCreate(&dbGuid, (void **)&dbPtr, (sizeof(timestamp_t)*2), 0, NULL_HINT, NO_ALLOC);
+    ocrAddDependence(dbGuid, terminateEdtGuid, 1, DB_MODE_CONST);
+    ocrDbRelease(dbGuid);
+
+    ocrGuid_t oEvtGuid;
+    ocrGuid_t finishEdtTemplateGuid;
+    ocrEdtTemplateCreate(&finishEdtTemplateGuid, finishEdt, 0, 1);
+    ocrGuid_t finishEdtGuid;
+    ocrEdtCreate(&finishEdtGuid, finishEdtTemplateGuid,
+                 0, NULL, 1, NULL,  EDT_PROP_FINISH, NULL_HINT, &oEvtGuid);
+
+    ocrAddDependence(oEvtGuid, terminateEdtGuid, 0, DB_MODE_CONST);
+    ocrAddDependence(dbGuid, finishEdtGuid, 0, DB_MODE_RW);
+
+    return NULL_GUID;
+}
@@ -0,0 +1,141 @@
+#include "perfs.h"
+#include "ocr.h"
+
+// DESC: Create an EDT that has 'DEPV_SZ' distinct DB dependences
+//       added in a random order with respect to their GUIDs
+// TIME: Duration of add-dependence + execution of the EDT
+// FREQ: Done 'NB_ITERS' times
+//
+// VARIABLES:
+// - NB_ITERS
+// - DEPV_SZ
+
+//fwd declaration
+ocrGuid_t driverEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]);
+
+ocrGuid_t edtCode(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+
+    // Timer is the first DB so that releasing it works for any DEPV_SZ
+    timestamp_t * timersPtr = (timestamp_t *) depv[0].ptr;
+    get_time(&timersPtr[1]);
+
+    ocrGuid_t dbTimerGuid = depv[0].guid;
+    ocrDbRelease(dbTimerGuid);
+
+    u64 driverIteration = paramv[0];
+    long timerUsAcc = (long) paramv[1];
+    ocrGuid_t dbAllGuids = {.guid=paramv[2]};
+
+    // Spawn the next driver iteration
+    ocrGuid_t edtDriverTemplateGuid;
+    ocrEdtTemplateCreate(&edtDriverTemplateGuid, driverEdt, 2, 2);
+    u64 paramvDriverEdt[2];
+    paramvDriverEdt[0] = driverIteration+1;
+    paramvDriverEdt[1] = (u64) timerUsAcc;
+    ocrGuid_t edtDriverGuid;
+    ocrEdtCreate(&edtDriverGuid, edtDriverTemplateGuid,
+                 2, paramvDriverEdt, 2, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+    ocrAddDependence(dbAllGuids, edtDriverGuid, 0, DB_MODE_RO);
+    ocrAddDependence(dbTimerGuid, edtDriverGuid, 1, DB_MODE_RW);
+    ocrEdtTemplateDestroy(edtDriverTemplateGuid);
+    return NULL_GUID;
+}
+
+// Two paramv: [driverIteration,timerUsAcc]
+// Two depc  : [dbAllGuids,dbTimer]
+ocrGuid_t driverEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    u64 driverIteration = paramv[0];
+    long timerUsAcc = (long) paramv[1];
+    ocrGuid_t dbAllGuids = depv[0].guid;
+    ocrGuid_t * dbGuids = (ocrGuid_t *) depv[0].ptr;
+    ocrGuid_t dbTimerGuid = depv[1].guid;
+    timestamp_t * timersPtr = (timestamp_t *) depv[1].ptr;
+
+    if (driverIteration == NB_ITERS) {
+        ocrDbRelease(dbAllGuids);
+        ocrDbRelease(dbTimerGuid);
+        summary_throughput_dbl(usec_to_sec(timerUsAcc), NB_ITERS);
+        ocrShutdown();
+    } else {
+        timerUsAcc += elapsed_usec(&timersPtr[0], &timersPtr[1]);
+
+        ocrGuid_t edtCodeTemplateGuid;
+        // Has DEPV_SZ dependences + the DB containing the timer
+        ocrEdtTemplateCreate(&edtCodeTemplateGuid, edtCode, 3, DEPV_SZ+1);
+
+        // Prepare the next edt code
+        u64 paramvEdtCode[3];
+        paramvEdtCode[0] = driverIteration;
+        paramvEdtCode[1] = (u64) timerUsAcc;
+        paramvEdtCode[2] = (u64) dbAllGuids.guid;
+
+        ocrGuid_t edtGuid;
+        ocrEdtCreate(&edtGuid, edtCodeTemplateGuid,
+                     3, paramvEdtCode, DEPV_SZ+1, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+        ocrEdtTemplateDestroy(edtCodeTemplateGuid);
+
+        // Time and add dependences
+        get_time(&timersPtr[0]);
+        ocrDbRelease(dbTimerGuid);
+        int i = 0;
+        while (i < DEPV_SZ) {
+            ocrAddDependence(dbGuids[i], edtGuid, i+1, DB_MODE_RO);
+            i++;
+        }
+        // Add timer dependence
+        ocrAddDependence(dbTimerGuid, edtGuid, 0, DB_MODE_RW);
+    }
+
+    return NULL_GUID;
+}
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+
+    ocrGuid_t * dbAllPtr;
+    ocrGuid_t dbAllGuids;
+    ocrDbCreate(&dbAllGuids, (void **)&dbAllPtr, (sizeof(ocrGuid_t)*DEPV_SZ), 0, NULL_HINT, NO_ALLOC);
+
+    // Create all DBs and record their guid in dbAllPtr
+    int i = 0;
+    while (i < DEPV_SZ) {
+        u64 * dbPtr;
+        ocrDbCreate(&dbAllPtr[i], (void **)&dbPtr, sizeof(u64), 0, NULL_HINT, NO_ALLOC);
+        ocrDbRelease(dbAllPtr[i]);
+        i++;
+    }
+    // Shuffle so that dependences are not added in GUID order
+    u64 seed = 42;
+    i = DEPV_SZ;
+    while (i > 1) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        int j = (int) ((seed >> 33) % i);
+        i--;
+        ocrGuid_t swap = dbAllPtr[i];
+        dbAllPtr[i] = dbAllPtr[j];
+        dbAllPtr[j] = swap;
+    }
+    ocrDbRelease(dbAllGuids);
+
+    timestamp_t * dbTimerPtr;
+    ocrGuid_t dbTimerGuid;
+    ocrDbCreate(&dbTimerGuid, (void **)&dbTimerPtr, sizeof(timestamp_t)*2, 0, NULL_HINT, NO_ALLOC);
+    // The first driver iteration accounts for an empty interval
+    get_time(&dbTimerPtr[0]);
+    dbTimerPtr[1] = dbTimerPtr[0];
+    ocrDbRelease(dbTimerGuid);
+
+    ocrGuid_t edtDriverTemplateGuid;
+    ocrEdtTemplateCreate(&edtDriverTemplateGuid, driverEdt, 2, 2);
+
+    u64 paramvDriverEdt[2];
+    paramvDriverEdt[0] = 0;       //driverIteration
+    paramvDriverEdt[1] = (u64) 0; //timerUsAcc
+    ocrGuid_t driverEdtGuid;
+    ocrEdtCreate(&driverEdtGuid, edtDriverTemplateGuid,
+                 2, paramvDriverEdt, 2, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+    ocrAddDependence(dbAllGuids, driverEdtGuid, 0, DB_MODE_RO);
+    ocrAddDependence(dbTimerGuid, driverEdtGuid, 1, DB_MODE_RW);
+    ocrEdtTemplateDestroy(edtDriverTemplateGuid);
+
+    return NULL_GUID;
+}
@@ -0,0 +1,99 @@
+#include "perfs.h"
+#include "ocr.h"
+
+// DESC: 'FAN_OUT' spawner EDTs each create their share of 'NB_INSTANCES'
+//       EDTs with a pseudo-random priority hint, so that all workers push
+//       to and pop from the scheduler's ready queue concurrently.
+//       Meant to be run with the PRIORITY scheduler to compare its ready
+//       queues, e.g. CFGARG_SCHEDULER=PRIORITY with CFGARG_PRQUEUE set to
+//       BIN_HEAP (single locked heap) or MULTIQUEUE (see CFGARG_PRRELAX).
+// TIME: Creation of the spawners to completion of all tasks
+// FREQ: Create 'NB_INSTANCES' EDTs once
+//
+// VARIABLES:
+// - NB_INSTANCES
+// - FAN_OUT
+
+#define NB_PRIORITIES 1024
+
+ocrGuid_t terminateEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    timestamp_t * timers = (timestamp_t *) depv[1].ptr;
+    get_time(&timers[1]);
+    summary_throughput_timer(&timers[0], &timers[1], NB_INSTANCES);
+    ocrShutdown(); // This is the last EDT to execute, terminate
+    return NULL_GUID;
+}
+
+ocrGuid_t workEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    return NULL_GUID;
+}
+
+ocrGuid_t spawnerEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t workEdtTemplateGuid = {.guid = paramv[0]};
+    u64 first = paramv[1];
+    u64 last = paramv[2];
+    ocrHint_t edtHint;
+    ocrHintInit(&edtHint, OCR_HINT_EDT_T);
+    u64 i;
+    for (i = first; i < last; i++) {
+        // Knuth's multiplicative hash spreads priorities across spawners
+        u64 priority = ((i * 2654435761ULL) >> 8) % NB_PRIORITIES;
+        ocrSetHintValue(&edtHint, OCR_HINT_EDT_PRIORITY, priority);
+        ocrGuid_t workEdtGuid;
+        ocrEdtCreate(&workEdtGuid, workEdtTemplateGuid,
+                     0, NULL, 0, NULL, EDT_PROP_NONE, &edtHint, NULL);
+    }
+    return NULL_GUID;
+}
+
+ocrGuid_t headEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    timestamp_t * dbPtr = depv[0].ptr;
+
+    ocrGuid_t workEdtTemplateGuid;
+    ocrEdtTemplateCreate(&workEdtTemplateGuid, workEdt, 0, 0);
+    ocrGuid_t spawnerEdtTemplateGuid;
+    ocrEdtTemplateCreate(&spawnerEdtTemplateGuid, spawnerEdt, 3, 0);
+
+    get_time(&dbPtr[0]);
+    u64 chunk = (NB_INSTANCES + FAN_OUT - 1) / FAN_OUT;
+    u64 paramv2[3];
+    paramv2[0] = (u64) workEdtTemplateGuid.guid;
+    u64 first = 0;
+    while (first < NB_INSTANCES) {
+        u64 last = first + chunk;
+        paramv2[1] = first;
+        paramv2[2] = (last < NB_INSTANCES) ? last : NB_INSTANCES;
+        ocrGuid_t spawnerEdtGuid;
+        ocrEdtCreate(&spawnerEdtGuid, spawnerEdtTemplateGuid,
+                     3, paramv2, 0, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+        first = paramv2[2];
+    }
+    ocrEdtTemplateDestroy(spawnerEdtTemplateGuid);
+    return NULL_GUID;
+}
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t terminateEdtTemplateGuid;
+    ocrEdtTemplateCreate(&terminateEdtTemplateGuid, terminateEdt, 0, 2);
+    ocrGuid_t terminateEdtGuid;
+    ocrEdtCreate(&terminateEdtGuid, terminateEdtTemplateGuid,
+                 0, NULL, 2, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+
+    timestamp_t * dbPtr;
+    ocrGuid_t dbGuid;
+    ocrDbCreate(&dbGuid, (void **)&dbPtr, (sizeof(timestamp_t)*2), 0, NULL_HINT, NO_ALLOC);
+    ocrDbRelease(dbGuid);
+
+    ocrGuid_t headEdtTemplateGuid;
+    ocrEdtTemplateCreate(&headEdtTemplateGuid, headEdt, 0, 1);
+    ocrGuid_t headEdtGuid;
+    ocrGuid_t outEvent;
+    ocrEdtCreate(&headEdtGuid, headEdtTemplateGuid,
+                 0, NULL, 1, NULL, EDT_PROP_FINISH, NULL_HINT, &outEvent);
+
+    ocrAddDependence(outEvent, terminateEdtGuid, 0, DB_MODE_CONST);
+    ocrAddDependence(dbGuid, terminateEdtGuid, 1, DB_MODE_RW);
+
+    ocrAddDependence(dbGuid, headEdtGuid, 0, DB_MODE_RW);
+    return NULL_GUID;
+}
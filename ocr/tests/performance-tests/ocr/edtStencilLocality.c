@@ -0,0 +1,207 @@
+#include <pthread.h>
+
+#include "perfs.h"
+#include "ocr.h"
+
+// DESC: 1D Jacobi stencil over 'DB_NBS' blocks of 'DB_NB_ELT' doubles.
+//       Each iteration, a finish EDT creates one EDT per block that updates
+//       the block in place (RW) from its neighbors' halos of the previous
+//       iteration (CONST). Block EDTs carry the OCR_HINT_EDT_SLOT_MAX_ACCESS
+//       hint on their block's slot so that CFGARG_SCHEDULER=HC_LOCALITY runs
+//       them where the block was last written. Compare with the default HC
+//       scheduler, and with 'perf stat -e cache-misses' around both runs,
+//       using a block size that fits a core's private caches.
+//       Also reports how often a block was updated by the same worker
+//       thread as the previous time.
+// TIME: First iteration start to completion of the last iteration
+// FREQ: 'NB_ITERS' iterations of 'DB_NBS' block updates
+//
+// VARIABLES:
+// - DB_NBS
+// - DB_NB_ELT
+// - NB_ITERS
+
+#define NB_EDT_DEPS 4
+
+typedef struct {
+    u64 lastWorker; // Thread of the last update, 0 before the first
+    u64 sameWorker; // Updates that ran on the same thread as the previous one
+    u64 updates;
+} blockHeader_t;
+
+typedef struct {
+    double left;
+    double right;
+} halo_t;
+
+// Parity-indexed halos: iteration 't' reads 'halos[t%2]' and writes 'halos[(t+1)%2]'
+typedef struct {
+    timestamp_t start;
+    ocrGuid_t blockEdtTemplateGuid;
+    ocrGuid_t blocks[DB_NBS];
+    ocrGuid_t halos[2][DB_NBS];
+} meta_t;
+
+#define BLOCK_DATA(header) ((double *) (((blockHeader_t *) (header)) + 1))
+
+ocrGuid_t terminateEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    timestamp_t stop;
+    get_time(&stop);
+    meta_t * meta = (meta_t *) depv[0].ptr;
+    u64 sameWorker = 0;
+    u64 updates = 0;
+    u32 i;
+    for (i = 0; i < DB_NBS; i++) {
+        blockHeader_t * header = (blockHeader_t *) depv[i+1].ptr;
+        sameWorker += header->sameWorker;
+        updates += header->updates;
+    }
+    summary_throughput_timer(&meta->start, &stop, ((u64) NB_ITERS) * DB_NBS);
+    printf("Same worker updates: %"PRIu64"/%"PRIu64" (%.1f%%)\n", sameWorker, updates,
+           (updates == 0) ? 0.0 : (100.0 * sameWorker) / updates);
+    ocrEdtTemplateDestroy(meta->blockEdtTemplateGuid);
+    ocrShutdown(); // This is the last EDT to execute, terminate
+    return NULL_GUID;
+}
+
+ocrGuid_t blockEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    blockHeader_t * header = (blockHeader_t *) depv[0].ptr;
+    halo_t * haloOut = (halo_t *) depv[1].ptr;
+    halo_t * haloLeft = (halo_t *) depv[2].ptr;
+    halo_t * haloRight = (halo_t *) depv[3].ptr;
+
+    u64 worker = (u64) pthread_self();
+    if (header->lastWorker == worker) {
+        header->sameWorker++;
+    }
+    header->lastWorker = worker;
+    header->updates++;
+
+    // In place 3-point average, 'prev' keeps the old value of the left neighbor
+    double * data = BLOCK_DATA(header);
+    double prev = (haloLeft != NULL) ? haloLeft->right : 0.0;
+    double next = (haloRight != NULL) ? haloRight->left : 0.0;
+    u64 j;
+    for (j = 0; j < DB_NB_ELT; j++) {
+        double cur = data[j];
+        double right = (j == (DB_NB_ELT - 1)) ? next : data[j+1];
+        data[j] = (prev + cur + right) / 3.0;
+        prev = cur;
+    }
+    haloOut->left = data[0];
+    haloOut->right = data[DB_NB_ELT - 1];
+    return NULL_GUID;
+}
+
+// Finish EDT creating the block EDTs of iteration 'paramv[0]'
+ocrGuid_t sweepEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    meta_t * meta = (meta_t *) depv[0].ptr;
+    u64 t = paramv[0];
+    u32 in = t % 2;
+    u32 out = (t + 1) % 2;
+    ocrHint_t edtHint;
+    ocrHintInit(&edtHint, OCR_HINT_EDT_T);
+    ocrSetHintValue(&edtHint, OCR_HINT_EDT_SLOT_MAX_ACCESS, 0);
+    u64 i;
+    for (i = 0; i < DB_NBS; i++) {
+        ocrGuid_t deps[NB_EDT_DEPS];
+        deps[0] = meta->blocks[i];
+        deps[1] = meta->halos[out][i];
+        deps[2] = (i == 0) ? NULL_GUID : meta->halos[in][i-1];
+        deps[3] = (i == (DB_NBS - 1)) ? NULL_GUID : meta->halos[in][i+1];
+        ocrGuid_t blockEdtGuid;
+        ocrEdtCreate(&blockEdtGuid, meta->blockEdtTemplateGuid,
+                     0, NULL, NB_EDT_DEPS, NULL, EDT_PROP_NONE, &edtHint, NULL);
+        ocrAddDependence(deps[0], blockEdtGuid, 0, DB_MODE_RW);
+        ocrAddDependence(deps[1], blockEdtGuid, 1, DB_MODE_RW);
+        ocrAddDependence(deps[2], blockEdtGuid, 2, DB_MODE_CONST);
+        ocrAddDependence(deps[3], blockEdtGuid, 3, DB_MODE_CONST);
+    }
+    return NULL_GUID;
+}
+
+// Runs iteration 'paramv[0]' once the previous one is done
+ocrGuid_t stepEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    meta_t * meta = (meta_t *) depv[0].ptr;
+    ocrGuid_t metaGuid = depv[0].guid;
+    u64 t = paramv[0];
+    if (t == NB_ITERS) {
+        ocrGuid_t terminateEdtTemplateGuid;
+        ocrEdtTemplateCreate(&terminateEdtTemplateGuid, terminateEdt, 0, DB_NBS + 1);
+        ocrGuid_t terminateEdtGuid;
+        ocrEdtCreate(&terminateEdtGuid, terminateEdtTemplateGuid,
+                     0, NULL, DB_NBS + 1, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+        ocrAddDependence(metaGuid, terminateEdtGuid, 0, DB_MODE_CONST);
+        u32 i;
+        for (i = 0; i < DB_NBS; i++) {
+            ocrAddDependence(meta->blocks[i], terminateEdtGuid, i+1, DB_MODE_CONST);
+        }
+        ocrEdtTemplateDestroy(terminateEdtTemplateGuid);
+        return NULL_GUID;
+    }
+
+    ocrGuid_t sweepEdtTemplateGuid;
+    ocrEdtTemplateCreate(&sweepEdtTemplateGuid, sweepEdt, 1, 1);
+    ocrGuid_t sweepEdtGuid;
+    ocrGuid_t sweepDoneGuid;
+    ocrEdtCreate(&sweepEdtGuid, sweepEdtTemplateGuid,
+                 1, &t, 1, NULL, EDT_PROP_FINISH, NULL_HINT, &sweepDoneGuid);
+    ocrEdtTemplateDestroy(sweepEdtTemplateGuid);
+
+    ocrGuid_t stepEdtTemplateGuid;
+    ocrEdtTemplateCreate(&stepEdtTemplateGuid, stepEdt, 1, 2);
+    u64 next = t + 1;
+    ocrGuid_t stepEdtGuid;
+    ocrEdtCreate(&stepEdtGuid, stepEdtTemplateGuid,
+                 1, &next, 2, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+    ocrEdtTemplateDestroy(stepEdtTemplateGuid);
+    ocrAddDependence(metaGuid, stepEdtGuid, 0, DB_MODE_CONST);
+    ocrAddDependence(sweepDoneGuid, stepEdtGuid, 1, DB_MODE_CONST);
+
+    ocrAddDependence(metaGuid, sweepEdtGuid, 0, DB_MODE_CONST);
+    return NULL_GUID;
+}
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    meta_t * meta;
+    ocrGuid_t metaGuid;
+    ocrDbCreate(&metaGuid, (void **)&meta, sizeof(meta_t), 0, NULL_HINT, NO_ALLOC);
+    ocrEdtTemplateCreate(&meta->blockEdtTemplateGuid, blockEdt, 0, NB_EDT_DEPS);
+
+    u32 i, p;
+    u64 j;
+    for (i = 0; i < DB_NBS; i++) {
+        blockHeader_t * header;
+        ocrDbCreate(&meta->blocks[i], (void **)&header,
+                    sizeof(blockHeader_t) + (DB_NB_ELT * sizeof(double)), 0, NULL_HINT, NO_ALLOC);
+        header->lastWorker = 0;
+        header->sameWorker = 0;
+        header->updates = 0;
+        double * data = BLOCK_DATA(header);
+        for (j = 0; j < DB_NB_ELT; j++) {
+            data[j] = (double) (i * DB_NB_ELT + j);
+        }
+        for (p = 0; p < 2; p++) {
+            halo_t * halo;
+            ocrDbCreate(&meta->halos[p][i], (void **)&halo, sizeof(halo_t), 0, NULL_HINT, NO_ALLOC);
+            halo->left = data[0];
+            halo->right = data[DB_NB_ELT - 1];
+            ocrDbRelease(meta->halos[p][i]);
+        }
+        ocrDbRelease(meta->blocks[i]);
+    }
+
+    get_time(&meta->start);
+    ocrDbRelease(metaGuid);
+
+    ocrGuid_t stepEdtTemplateGuid;
+    ocrEdtTemplateCreate(&stepEdtTemplateGuid, stepEdt, 1, 2);
+    u64 first = 0;
+    ocrGuid_t stepEdtGuid;
+    ocrEdtCreate(&stepEdtGuid, stepEdtTemplateGuid,
+                 1, &first, 2, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+    ocrEdtTemplateDestroy(stepEdtTemplateGuid);
+    ocrAddDependence(metaGuid, stepEdtGuid, 0, DB_MODE_CONST);
+    ocrAddDependence(NULL_GUID, stepEdtGuid, 1, DB_MODE_CONST);
+    return NULL_GUID;
+}
@@ -3,6 +3,7 @@
 
 // DESC: Creates NB_INSTANCES counted events, then destroy them.
 // TIME: Creation of NB_INSTANCES counted events taking NB_EVT_COUNTED_DEPS dependences measured 'NB_ITERS' times
+//       Latency percentiles of resolving each created event's GUID once
 // FREQ: Done 'NB_ITERS' times.
 //
 // VARIABLES:
@@ -12,6 +13,7 @@
 
 #define TIME_CREATION 1
 #define TIME_DESTRUCTION 0
+#define TIME_RESOLVE 1
 
 // Can clean-up non-persistent event here because events
 // are only created but not satisfied in this test.
@@ -3,6 +3,7 @@
 
 // DESC: Creates NB_INSTANCES events, then destroy them.
 // TIME: Creation of NB_INSTANCES events, measured 'NB_ITERS' times
+//       Latency percentiles of resolving each created event's GUID once
 // FREQ: Done 'NB_ITERS' times.
 //
 // VARIABLES:
@@ -11,6 +12,7 @@
 
 #define TIME_CREATION 1
 #define TIME_DESTRUCTION 0
+#define TIME_RESOLVE 1
 #define TIME_ALL 0
 #define CLEAN_UP_ITERATION 1
 
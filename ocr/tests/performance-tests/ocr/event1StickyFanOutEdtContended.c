@@ -0,0 +1,107 @@
+#include "perfs.h"
+#include "ocr.h"
+
+// DESC: 'FAN_OUT' spawner EDTs concurrently create 'NB_ITERS' consumer EDTs
+//       each, all depending on the same sticky event. The first spawner
+//       satisfies the event half-way through, so registrations race with
+//       the satisfy and the remaining ones find the event already satisfied.
+// TIME: Creation of the spawners to completion of all consumers
+// FREQ: 'NB_ITERS' * 'FAN_OUT' consumers created once
+//
+// VARIABLES:
+// - NB_ITERS
+// - FAN_OUT
+
+ocrGuid_t terminateEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t stickyGuid = {.guid = paramv[0]};
+    timestamp_t * timers = (timestamp_t *) depv[1].ptr;
+    get_time(&timers[1]);
+    summary_throughput_timer(&timers[0], &timers[1], NB_ITERS * FAN_OUT);
+    ocrEventDestroy(stickyGuid);
+    ocrShutdown(); // This is the last EDT to execute, terminate
+    return NULL_GUID;
+}
+
+ocrGuid_t consumerEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t latchGuid = {.guid = paramv[0]};
+    ocrEventSatisfySlot(latchGuid, NULL_GUID, OCR_EVENT_LATCH_DECR_SLOT);
+    return NULL_GUID;
+}
+
+ocrGuid_t spawnerEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t stickyGuid = {.guid = paramv[0]};
+    ocrGuid_t latchGuid = {.guid = paramv[1]};
+    ocrGuid_t consumerEdtTemplateGuid = {.guid = paramv[2]};
+    u64 spawnerId = paramv[3];
+    u64 i;
+    for (i = 0; i < NB_ITERS; i++) {
+        if ((spawnerId == 0) && (i == (NB_ITERS / 2))) {
+            ocrEventSatisfy(stickyGuid, NULL_GUID);
+        }
+        ocrEventSatisfySlot(latchGuid, NULL_GUID, OCR_EVENT_LATCH_INCR_SLOT);
+        ocrGuid_t consumerEdtGuid;
+        ocrEdtCreate(&consumerEdtGuid, consumerEdtTemplateGuid,
+                     1, &paramv[1], 1, &stickyGuid, EDT_PROP_NONE, NULL_HINT, NULL);
+    }
+    // Release the count the head EDT took on our behalf
+    ocrEventSatisfySlot(latchGuid, NULL_GUID, OCR_EVENT_LATCH_DECR_SLOT);
+    return NULL_GUID;
+}
+
+ocrGuid_t headEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t latchGuid = {.guid = paramv[1]};
+    timestamp_t * dbPtr = depv[0].ptr;
+
+    ocrGuid_t consumerEdtTemplateGuid;
+    ocrEdtTemplateCreate(&consumerEdtTemplateGuid, consumerEdt, 1, 1);
+    ocrGuid_t spawnerEdtTemplateGuid;
+    ocrEdtTemplateCreate(&spawnerEdtTemplateGuid, spawnerEdt, 4, 0);
+    u32 i;
+    for (i = 0; i < FAN_OUT; i++) {
+        ocrEventSatisfySlot(latchGuid, NULL_GUID, OCR_EVENT_LATCH_INCR_SLOT);
+    }
+    u64 nparamv[4];
+    nparamv[0] = paramv[0];
+    nparamv[1] = paramv[1];
+    nparamv[2] = (u64) consumerEdtTemplateGuid.guid;
+    get_time(&dbPtr[0]);
+    for (i = 0; i < FAN_OUT; i++) {
+        nparamv[3] = i;
+        ocrGuid_t spawnerEdtGuid;
+        ocrEdtCreate(&spawnerEdtGuid, spawnerEdtTemplateGuid,
+                     4, nparamv, 0, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+    }
+    ocrEdtTemplateDestroy(spawnerEdtTemplateGuid);
+    return NULL_GUID;
+}
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t stickyGuid;
+    ocrEventCreate(&stickyGuid, OCR_EVENT_STICKY_T, EVT_PROP_NONE);
+    ocrGuid_t latchGuid;
+    ocrEventCreate(&latchGuid, OCR_EVENT_LATCH_T, EVT_PROP_NONE);
+    u64 nparamv[2] = {(u64) stickyGuid.guid, (u64) latchGuid.guid};
+
+    ocrGuid_t terminateEdtTemplateGuid;
+    ocrEdtTemplateCreate(&terminateEdtTemplateGuid, terminateEdt, 1, 2);
+    ocrGuid_t terminateEdtGuid;
+    ocrEdtCreate(&terminateEdtGuid, terminateEdtTemplateGuid,
+                 1, nparamv, 2, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+    ocrEdtTemplateDestroy(terminateEdtTemplateGuid);
+
+    timestamp_t * dbPtr;
+    ocrGuid_t dbGuid;
+    ocrDbCreate(&dbGuid, (void **)&dbPtr, (sizeof(timestamp_t)*2), 0, NULL_HINT, NO_ALLOC);
+    ocrDbRelease(dbGuid);
+
+    ocrAddDependence(latchGuid, terminateEdtGuid, 0, DB_MODE_CONST);
+    ocrAddDependence(dbGuid, terminateEdtGuid, 1, DB_MODE_RW);
+
+    ocrGuid_t headEdtTemplateGuid;
+    ocrEdtTemplateCreate(&headEdtTemplateGuid, headEdt, 2, 1);
+    ocrGuid_t headEdtGuid;
+    ocrEdtCreate(&headEdtGuid, headEdtTemplateGuid,
+                 2, nparamv, 1, &dbGuid, EDT_PROP_NONE, NULL_HINT, NULL);
+    ocrEdtTemplateDestroy(headEdtTemplateGuid);
+    return NULL_GUID;
+}
@@ -0,0 +1,81 @@
+#include "perfs.h"
+#include "ocr.h"
+
+// DESC: 'FAN_OUT' EDTs concurrently increment and decrement a single latch
+//       event 'NB_ITERS' times each. The latch only fires once every EDT is
+//       done, so this measures contention on the latch's counter.
+// TIME: Creation of the EDTs to the latch firing
+// FREQ: 2 * 'NB_ITERS' * 'FAN_OUT' satisfies done once
+//
+// VARIABLES:
+// - NB_ITERS
+// - FAN_OUT
+
+ocrGuid_t terminateEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    timestamp_t * timers = (timestamp_t *) depv[1].ptr;
+    get_time(&timers[1]);
+    summary_throughput_timer(&timers[0], &timers[1], 2 * NB_ITERS * FAN_OUT);
+    ocrShutdown(); // This is the last EDT to execute, terminate
+    return NULL_GUID;
+}
+
+ocrGuid_t workEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t latchGuid = {.guid = paramv[0]};
+    u64 i;
+    for (i = 0; i < NB_ITERS; i++) {
+        ocrEventSatisfySlot(latchGuid, NULL_GUID, OCR_EVENT_LATCH_INCR_SLOT);
+        ocrEventSatisfySlot(latchGuid, NULL_GUID, OCR_EVENT_LATCH_DECR_SLOT);
+    }
+    // Release the count the head EDT took on our behalf
+    ocrEventSatisfySlot(latchGuid, NULL_GUID, OCR_EVENT_LATCH_DECR_SLOT);
+    return NULL_GUID;
+}
+
+ocrGuid_t headEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t latchGuid = {.guid = paramv[0]};
+    timestamp_t * dbPtr = depv[0].ptr;
+
+    ocrGuid_t workEdtTemplateGuid;
+    ocrEdtTemplateCreate(&workEdtTemplateGuid, workEdt, 1, 0);
+    u32 i;
+    for (i = 0; i < FAN_OUT; i++) {
+        ocrEventSatisfySlot(latchGuid, NULL_GUID, OCR_EVENT_LATCH_INCR_SLOT);
+    }
+    get_time(&dbPtr[0]);
+    for (i = 0; i < FAN_OUT; i++) {
+        ocrGuid_t workEdtGuid;
+        ocrEdtCreate(&workEdtGuid, workEdtTemplateGuid,
+                     1, paramv, 0, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+    }
+    ocrEdtTemplateDestroy(workEdtTemplateGuid);
+    return NULL_GUID;
+}
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t latchGuid;
+    ocrEventCreate(&latchGuid, OCR_EVENT_LATCH_T, EVT_PROP_NONE);
+
+    ocrGuid_t terminateEdtTemplateGuid;
+    ocrEdtTemplateCreate(&terminateEdtTemplateGuid, terminateEdt, 0, 2);
+    ocrGuid_t terminateEdtGuid;
+    ocrEdtCreate(&terminateEdtGuid, terminateEdtTemplateGuid,
+                 0, NULL, 2, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+    ocrEdtTemplateDestroy(terminateEdtTemplateGuid);
+
+    timestamp_t * dbPtr;
+    ocrGuid_t dbGuid;
+    ocrDbCreate(&dbGuid, (void **)&dbPtr, (sizeof(timestamp_t)*2), 0, NULL_HINT, NO_ALLOC);
+    ocrDbRelease(dbGuid);
+
+    ocrAddDependence(latchGuid, terminateEdtGuid, 0, DB_MODE_CONST);
+    ocrAddDependence(dbGuid, terminateEdtGuid, 1, DB_MODE_RW);
+
+    ocrGuid_t headEdtTemplateGuid;
+    ocrEdtTemplateCreate(&headEdtTemplateGuid, headEdt, 1, 1);
+    u64 nparamv[1] = {(u64) latchGuid.guid};
+    ocrGuid_t headEdtGuid;
+    ocrEdtCreate(&headEdtGuid, headEdtTemplateGuid,
+                 1, nparamv, 1, &dbGuid, EDT_PROP_NONE, NULL_HINT, NULL);
+    ocrEdtTemplateDestroy(headEdtTemplateGuid);
+    return NULL_GUID;
+}
@@ -0,0 +1,136 @@
+#include "perfs.h"
+#include "ocr.h"
+#include "extensions/ocr-affinity.h"
+
+// DESC: 'FAN_OUT' EDTs on the first policy-domain each satisfy a latch event
+//       living on the last policy-domain 'NB_ITERS' times. Every satisfy is
+//       a small one-way message, so this measures the message rate of the
+//       communication layer. Meant to be run on two nodes (i.e. mpirun -np 2).
+// TIME: Creation of the satisfying EDTs to the remote latch firing
+// FREQ: 'NB_ITERS' * 'FAN_OUT' remote satisfies done once
+//
+// VARIABLES:
+// - NB_ITERS
+// - FAN_OUT
+
+ocrGuid_t terminateEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    timestamp_t * timers = (timestamp_t *) depv[1].ptr;
+    get_time(&timers[1]);
+    summary_throughput_timer(&timers[0], &timers[1], NB_ITERS * FAN_OUT);
+    ocrShutdown(); // This is the last EDT to execute, terminate
+    return NULL_GUID;
+}
+
+ocrGuid_t satisfyEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t latchGuid = {.guid = paramv[0]};
+    u64 i;
+    for (i = 0; i < NB_ITERS; i++) {
+        ocrEventSatisfySlot(latchGuid, NULL_GUID, OCR_EVENT_LATCH_DECR_SLOT);
+    }
+    return NULL_GUID;
+}
+
+// Runs on the last policy-domain once the latch fires
+ocrGuid_t doneEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t doneEvtGuid = {.guid = paramv[0]};
+    ocrEventSatisfy(doneEvtGuid, NULL_GUID);
+    return NULL_GUID;
+}
+
+// Runs on the first policy-domain once the remote latch exists
+ocrGuid_t headEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    timestamp_t * dbPtr = depv[0].ptr;
+    u64 * latchPtr = depv[1].ptr;
+    ocrGuid_t satisfyEdtTemplateGuid;
+    ocrEdtTemplateCreate(&satisfyEdtTemplateGuid, satisfyEdt, 1, 0);
+    // Keep the satisfying EDTs away from the latch's policy-domain
+    ocrGuid_t currentAffGuid;
+    ocrAffinityGetCurrent(&currentAffGuid);
+    ocrHint_t edtHint;
+    ocrHintInit(&edtHint, OCR_HINT_EDT_T);
+    ocrSetHintValue(&edtHint, OCR_HINT_EDT_AFFINITY, ocrAffinityToHintValue(currentAffGuid));
+    get_time(&dbPtr[0]);
+    u32 i;
+    for (i = 0; i < FAN_OUT; i++) {
+        ocrGuid_t satisfyEdtGuid;
+        ocrEdtCreate(&satisfyEdtGuid, satisfyEdtTemplateGuid,
+                     1, latchPtr, 0, NULL, EDT_PROP_NONE, &edtHint, NULL);
+    }
+    ocrEdtTemplateDestroy(satisfyEdtTemplateGuid);
+    ocrDbDestroy(depv[1].guid);
+    return NULL_GUID;
+}
+
+// Runs on the last policy-domain: creates the latch and an EDT waiting on
+// it to satisfy the done event, then hands the latch's GUID to the head EDT.
+// paramv: done event, head EDT
+ocrGuid_t remoteSetupEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    ocrGuid_t headEdtGuid = {.guid = paramv[1]};
+
+    ocrGuid_t latchGuid;
+    ocrEventParams_t params;
+    params.EVENT_LATCH.counter = NB_ITERS * FAN_OUT;
+    ocrEventCreateParams(&latchGuid, OCR_EVENT_LATCH_T, EVT_PROP_NONE, &params);
+    ocrGuid_t doneEdtTemplateGuid;
+    ocrEdtTemplateCreate(&doneEdtTemplateGuid, doneEdt, 1, 1);
+    ocrGuid_t doneEdtGuid;
+    ocrEdtCreate(&doneEdtGuid, doneEdtTemplateGuid,
+                 1, paramv, 1, &latchGuid, EDT_PROP_NONE, NULL_HINT, NULL);
+    ocrEdtTemplateDestroy(doneEdtTemplateGuid);
+
+    u64 * latchPtr;
+    ocrGuid_t latchDbGuid;
+    ocrDbCreate(&latchDbGuid, (void **)&latchPtr, sizeof(u64), 0, NULL_HINT, NO_ALLOC);
+    latchPtr[0] = (u64) latchGuid.guid;
+    ocrDbRelease(latchDbGuid);
+    ocrAddDependence(latchDbGuid, headEdtGuid, 1, DB_MODE_RO);
+    return NULL_GUID;
+}
+
+ocrGuid_t mainEdt(u32 paramc, u64* paramv, u32 depc, ocrEdtDep_t depv[]) {
+    u64 affinityCount;
+    ocrAffinityCount(AFFINITY_PD, &affinityCount);
+    ocrGuid_t firstAffGuid, lastAffGuid;
+    ocrAffinityGetCurrent(&firstAffGuid);
+    ocrAffinityGetAt(AFFINITY_PD, affinityCount-1, &lastAffGuid);
+
+    ocrGuid_t doneEvtGuid;
+    ocrEventCreate(&doneEvtGuid, OCR_EVENT_STICKY_T, EVT_PROP_NONE);
+
+    ocrGuid_t terminateEdtTemplateGuid;
+    ocrEdtTemplateCreate(&terminateEdtTemplateGuid, terminateEdt, 0, 2);
+    ocrGuid_t terminateEdtGuid;
+    ocrEdtCreate(&terminateEdtGuid, terminateEdtTemplateGuid,
+                 0, NULL, 2, NULL, EDT_PROP_NONE, NULL_HINT, NULL);
+    ocrEdtTemplateDestroy(terminateEdtTemplateGuid);
+
+    timestamp_t * dbPtr;
+    ocrGuid_t dbGuid;
+    ocrDbCreate(&dbGuid, (void **)&dbPtr, (sizeof(timestamp_t)*2), 0, NULL_HINT, NO_ALLOC);
+    ocrDbRelease(dbGuid);
+
+    ocrAddDependence(doneEvtGuid, terminateEdtGuid, 0, DB_MODE_NULL);
+    ocrAddDependence(dbGuid, terminateEdtGuid, 1, DB_MODE_RW);
+
+    // The head EDT's second slot receives the latch's GUID from the last policy-domain
+    ocrGuid_t headEdtTemplateGuid;
+    ocrEdtTemplateCreate(&headEdtTemplateGuid, headEdt, 0, 2);
+    ocrHint_t edtHint;
+    ocrHintInit(&edtHint, OCR_HINT_EDT_T);
+    ocrSetHintValue(&edtHint, OCR_HINT_EDT_AFFINITY, ocrAffinityToHintValue(firstAffGuid));
+    ocrGuid_t headEdtGuid;
+    ocrEdtCreate(&headEdtGuid, headEdtTemplateGuid,
+                 0, NULL, 2, NULL, EDT_PROP_NONE, &edtHint, NULL);
+    ocrEdtTemplateDestroy(headEdtTemplateGuid);
+    ocrAddDependence(dbGuid, headEdtGuid, 0, DB_MODE_RW);
+
+    ocrGuid_t remoteSetupEdtTemplateGuid;
+    ocrEdtTemplateCreate(&remoteSetupEdtTemplateGuid, remoteSetupEdt, 2, 0);
+    ocrSetHintValue(&edtHint, OCR_HINT_EDT_AFFINITY, ocrAffinityToHintValue(lastAffGuid));
+    u64 nparamv[2] = {(u64) doneEvtGuid.guid, (u64) headEdtGuid.guid};
+    ocrGuid_t remoteSetupEdtGuid;
+    ocrEdtCreate(&remoteSetupEdtGuid, remoteSetupEdtTemplateGuid,
+                 2, nparamv, 0, NULL, EDT_PROP_NONE, &edtHint, NULL);
+    ocrEdtTemplateDestroy(remoteSetupEdtTemplateGuid);
+    return NULL_GUID;
+}
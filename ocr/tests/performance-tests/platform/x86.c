@@ -1,5 +1,6 @@
 #include "helper.h"
 #include <inttypes.h>
+#include <time.h>
 
 double usec_to_sec (long usec) {
     double res = ((double)usec) / 1000000;
@@ -10,6 +11,12 @@ void get_time(struct timeval * t_time) {
     gettimeofday(t_time, NULL);
 }
 
+unsigned long long get_time_nsec() {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return ((unsigned long long) t.tv_sec)*1000000000ULL + t.tv_nsec;
+}
+
 long elapsed_usec(struct timeval * t_start, struct timeval * t_stop) {
     long start_usec = t_start->tv_sec*1000000+t_start->tv_usec;
     long stop_usec = t_stop->tv_sec*1000000+t_stop->tv_usec;
@@ -57,3 +64,21 @@ double avg_usec(long * array, int length) {
     double res = (((double)acc)/length);
     return res;
 }
+
+static int compare_ull(const void * a, const void * b) {
+    unsigned long long va = *((unsigned long long *) a);
+    unsigned long long vb = *((unsigned long long *) b);
+    return (va > vb) - (va < vb);
+}
+
+// Sorts 'samples_nsec' in place
+void print_latency_percentiles(char * timer_name, unsigned long long * samples_nsec, unsigned long long nb_samples) {
+    qsort(samples_nsec, nb_samples, sizeof(unsigned long long), compare_ull);
+    printf("Timer Name        : %s\n", timer_name);
+    printf("Samples     (unit): %"PRIu64"\n", nb_samples);
+    printf("Latency p50   (ns): %"PRIu64"\n", samples_nsec[(nb_samples*50)/100]);
+    printf("Latency p90   (ns): %"PRIu64"\n", samples_nsec[(nb_samples*90)/100]);
+    printf("Latency p99   (ns): %"PRIu64"\n", samples_nsec[(nb_samples*99)/100]);
+    printf("Latency p99.9 (ns): %"PRIu64"\n", samples_nsec[(nb_samples*999)/1000]);
+    printf("Latency max   (ns): %"PRIu64"\n", samples_nsec[nb_samples-1]);
+}